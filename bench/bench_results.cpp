@@ -0,0 +1,112 @@
+// Result-side throughput: listing matches and writing to them
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "bench_support.h"
+#include "synthetic_target.h"
+
+import core.match;          // MatchCollector
+import core.memory_writer;  // MemoryWriter
+import core.scanner;        // Scanner
+import scan.engine;         // runScan
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.types;          // ScanOptions, ScanDataType
+import value.core;          // UserValue
+import value.flags;         // MatchFlags
+
+namespace {
+
+// One swath with a B32 match on every int32 slot
+auto denseMatches(std::size_t count) -> scan::MatchesAndOldValuesArray {
+    scan::ByteBuffer bytes(count * sizeof(std::int32_t));
+    std::iota(bytes.begin(), bytes.end(), std::uint8_t{0});
+    scan::MatchesAndOldValuesSwath swath{reinterpret_cast<void*>(0x10000000),
+                                         std::move(bytes)};
+    for (std::size_t i = 0; i < count; ++i) {
+        swath.setMatch(i * sizeof(std::int32_t), MatchFlags::B32, 0);
+    }
+    scan::MatchesAndOldValuesArray matches;
+    matches.addSwath(std::move(swath));
+    return matches;
+}
+
+// Arguments: matches stored, page size, page offset
+void BM_MatchCollect(benchmark::State& state) {
+    const auto MATCHES = denseMatches(static_cast<std::size_t>(state.range(0)));
+    const core::MatchCollector COLLECTOR;
+    core::MatchCollectionOptions options;
+    options.limit = static_cast<std::size_t>(state.range(1));
+    options.offset = static_cast<std::size_t>(state.range(2));
+    options.collectRegion = false;
+    std::size_t rows = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        auto [entries, total] = COLLECTOR.collect(
+            {.matches = &MATCHES, .dataType = ScanDataType::INTEGER_32},
+            options);
+        rows += entries.size();
+        benchmark::DoNotOptimize(total);
+    }
+    state.counters["matches_per_s"] = benchmark::Counter(
+        static_cast<double>(rows), benchmark::Counter::kIsRate);
+    SCOPE.finish(state);
+}
+BENCHMARK(BM_MatchCollect)
+    ->ArgNames({"matches", "limit", "offset"})
+    ->Args({1 << 20, 100, 0})
+    ->Args({1 << 20, 100, (1 << 20) - 100})
+    ->Args({10'000'000, 100, 9'999'900})
+    ->Args({1 << 20, 1 << 16, 0});
+
+// Arguments: indices written per call
+void BM_MemoryWriter(benchmark::State& state) {
+    static bench::SyntheticTarget target{{.mappings = 4, .density = 0.01}};
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(
+        bench::SyntheticTarget::MARKER);
+    core::Scanner scanner(target.pid());
+    if (auto stats = runScan(target.pid(), opts, &VALUE, scanner.getMatches());
+        !stats) {
+        state.SkipWithError(stats.error().c_str());
+        return;
+    }
+    const auto BATCH = std::min<std::size_t>(
+        static_cast<std::size_t>(state.range(0)), scanner.getMatchCount());
+    std::vector<std::size_t> indices(BATCH);
+    std::iota(indices.begin(), indices.end(), std::size_t{0});
+
+    core::MemoryWriter writer(target.pid());
+    std::size_t written = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        // Rewrites the planted value, so the target stays unchanged
+        auto result = writer.writeToMatch(scanner, VALUE, indices);
+        if (!result) {
+            state.SkipWithError(result.error().c_str());
+            return;
+        }
+        written += result->successCount;
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(written * sizeof(std::int32_t)));
+    state.counters["writes_per_s"] = benchmark::Counter(
+        static_cast<double>(written), benchmark::Counter::kIsRate);
+    SCOPE.finish(state);
+}
+BENCHMARK(BM_MemoryWriter)->ArgName("batch")->Arg(1)->Arg(64)->Arg(4096)->Arg(
+    65536);
+
+}  // namespace
@@ -0,0 +1,429 @@
+// Scan and filter throughput against synthetic targets
+//
+// Arguments: mappings, MiB per mapping, planted values per million int32
+// slots. Bytes/s is the engine's bytesScanned (the whole target, not just
+// the synthetic mappings).
+
+#include <benchmark/benchmark.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "bench_support.h"
+#include "synthetic_target.h"
+
+import core.multi_scanner;  // MultiScanner
+import core.scanner;        // Scanner
+import scan.engine;         // runScan, runScanParallel
+import scan.filter;         // filterMatches, filterMatchesParallel
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.pointer_scan;   // PointerIndex
+import scan.types;          // ScanOptions, ScanDataType, ScanMatchType
+import value.core;          // UserValue
+
+namespace {
+
+auto layoutOf(const benchmark::State& state) -> bench::SyntheticLayout {
+    return {.mappings = static_cast<std::size_t>(state.range(0)),
+            .regionSize = static_cast<std::size_t>(state.range(1)) << 20,
+            .density = static_cast<double>(state.range(2)) / 1e6};
+}
+
+// Forking a target per benchmark run is slow; share one per layout
+auto targetFor(const benchmark::State& state) -> bench::SyntheticTarget& {
+    static std::map<std::tuple<long, long, long>,
+                    std::unique_ptr<bench::SyntheticTarget>>
+        targets;
+    auto& target =
+        targets[{state.range(0), state.range(1), state.range(2)}];
+    if (!target) {
+        target = std::make_unique<bench::SyntheticTarget>(layoutOf(state));
+    }
+    return *target;
+}
+
+auto markerOptions() -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    return opts;
+}
+
+void publish(benchmark::State& state, std::size_t bytes, std::size_t matches,
+             const bench::ResourceScope& scope) {
+    if (bytes > 0) {
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    }
+    state.counters["matches_per_s"] = benchmark::Counter(
+        static_cast<double>(matches), benchmark::Counter::kIsRate);
+    scope.finish(state);
+}
+
+void scanArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"maps", "mib", "ppm"})
+        ->ArgsProduct({{16}, {4}, {100, 10000}})
+        ->Args({256, 1, 1000})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+}
+
+void BM_RunScan(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    const auto OPTS = markerOptions();
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(bench::SyntheticTarget::MARKER);
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        scan::MatchesAndOldValuesArray out;
+        auto stats = runScan(target.pid(), OPTS, &VALUE, out);
+        if (!stats) {
+            state.SkipWithError(stats.error().c_str());
+            return;
+        }
+        bytes += stats->bytesScanned;
+        matches += stats->matches;
+        benchmark::DoNotOptimize(out);
+    }
+    publish(state, bytes, matches, SCOPE);
+}
+BENCHMARK(BM_RunScan)->Apply(scanArgs);
+
+void BM_RunScanParallel(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    const auto OPTS = markerOptions();
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(bench::SyntheticTarget::MARKER);
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        scan::MatchesAndOldValuesArray out;
+        auto stats = runScanParallel(target.pid(), OPTS, &VALUE, out, nullptr);
+        if (!stats) {
+            state.SkipWithError(stats.error().c_str());
+            return;
+        }
+        bytes += stats->bytesScanned;
+        matches += stats->matches;
+        benchmark::DoNotOptimize(out);
+    }
+    publish(state, bytes, matches, SCOPE);
+}
+BENCHMARK(BM_RunScanParallel)->Apply(scanArgs);
+
+// One group pass: MARKER anchors, each verified for a second MARKER within
+// 64 bytes (compare with BM_RunScan, which finds the anchors alone)
+void BM_GroupScan(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    ScanOptions opts;
+    opts.dataType = ScanDataType::GROUP;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    UserValue group;
+    group.group.push_back(
+        {.value = Value::of(bench::SyntheticTarget::MARKER), .offset = 0});
+    group.group.push_back({.value = Value::of(bench::SyntheticTarget::MARKER)});
+    group.groupWindow = UserValue::GROUP_WINDOW;
+    group.primary = group.group.front().value;
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        scan::MatchesAndOldValuesArray out;
+        auto stats = runScanParallel(target.pid(), opts, &group, out, nullptr);
+        if (!stats) {
+            state.SkipWithError(stats.error().c_str());
+            return;
+        }
+        bytes += stats->bytesScanned;
+        matches += stats->matches;
+        benchmark::DoNotOptimize(out);
+    }
+    publish(state, bytes, matches, SCOPE);
+}
+BENCHMARK(BM_GroupScan)->Apply(scanArgs);
+
+// Back-to-back snapshots through Scanner, keeping every int32 slot; peak
+// RSS shows whether the previous result outlives the next scan
+void BM_ScannerSnapshot(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    auto opts = markerOptions();
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    core::Scanner scanner(target.pid());
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        auto result = scanner.snapshot(opts);
+        if (!result.success) {
+            state.SkipWithError(result.error.value_or("snapshot failed").c_str());
+            return;
+        }
+        bytes += result.stats.bytesScanned;
+        matches += result.matchCount;
+    }
+    publish(state, bytes, matches, SCOPE);
+}
+BENCHMARK(BM_ScannerSnapshot)
+    ->ArgNames({"maps", "mib", "ppm"})
+    ->Args({64, 4, 1000})
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Consistent snapshot matching every int32 slot: the target is stopped
+// only while memory is copied, so pause_ms stays well under the scan time
+void BM_ConsistentSnapshot(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    auto opts = markerOptions();
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    opts.consistent = true;
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    double pauseMs = 0.0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        scan::MatchesAndOldValuesArray out;
+        auto stats = runScanParallel(target.pid(), opts, nullptr, out, nullptr);
+        if (!stats) {
+            state.SkipWithError(stats.error().c_str());
+            return;
+        }
+        bytes += stats->bytesScanned;
+        matches += stats->matches;
+        pauseMs += static_cast<double>(stats->pauseNs) / 1e6;
+        benchmark::DoNotOptimize(out);
+    }
+    state.counters["pause_ms"] = benchmark::Counter(
+        pauseMs, benchmark::Counter::kAvgIterations);
+    publish(state, bytes, matches, SCOPE);
+}
+BENCHMARK(BM_ConsistentSnapshot)
+    ->ArgNames({"maps", "mib", "ppm"})
+    ->Args({64, 4, 1000})
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Paused forks of this process, each holding the same synthetic mappings
+// as the target that is still mapped here
+class IdenticalCopies {
+   public:
+    explicit IdenticalCopies(std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const pid_t PID = ::fork();
+            if (PID == 0) {
+                ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+                while (true) {
+                    ::pause();
+                }
+            }
+            m_pids.push_back(PID);
+        }
+    }
+    ~IdenticalCopies() {
+        for (const pid_t PID : m_pids) {
+            if (PID > 0) {
+                ::kill(PID, SIGKILL);
+                ::waitpid(PID, nullptr, 0);
+            }
+        }
+    }
+    IdenticalCopies(const IdenticalCopies&) = delete;
+    auto operator=(const IdenticalCopies&) -> IdenticalCopies& = delete;
+
+    [[nodiscard]] auto pids() const -> const std::vector<pid_t>& {
+        return m_pids;
+    }
+
+   private:
+    std::vector<pid_t> m_pids;
+};
+
+// The same marker scan over "pids" identical processes: one Scanner after
+// another, or all at once through MultiScanner on one pool
+template <bool MULTI>
+void BM_MultiPidScan(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    const IdenticalCopies COPIES(static_cast<std::size_t>(state.range(3)));
+    const auto OPTS = markerOptions();
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(bench::SyntheticTarget::MARKER);
+    core::MultiScanner procs;
+    std::vector<std::unique_ptr<core::Scanner>> scanners;
+    for (const pid_t PID : COPIES.pids()) {
+        procs.attach(PID);
+        scanners.push_back(std::make_unique<core::Scanner>(PID));
+    }
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        if constexpr (MULTI) {
+            const auto RESULT = procs.snapshot(OPTS, VALUE);
+            if (RESULT.failed > 0) {
+                state.SkipWithError("snapshot failed");
+                return;
+            }
+            for (const auto& entry : RESULT.perPid) {
+                bytes += entry.result.stats.bytesScanned;
+            }
+            matches += RESULT.matchCount;
+        } else {
+            for (auto& scanner : scanners) {
+                auto result = scanner->snapshot(OPTS, VALUE);
+                if (!result.success) {
+                    state.SkipWithError(
+                        result.error.value_or("snapshot failed").c_str());
+                    return;
+                }
+                bytes += result.stats.bytesScanned;
+                matches += result.matchCount;
+            }
+        }
+    }
+    publish(state, bytes, matches, SCOPE);
+}
+BENCHMARK(BM_MultiPidScan<false>)
+    ->Name("BM_MultiPidScanSequential")
+    ->ArgNames({"maps", "mib", "ppm", "pids"})
+    ->Args({16, 4, 1000, 8})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_MultiPidScan<true>)
+    ->Name("BM_MultiPidScan")
+    ->ArgNames({"maps", "mib", "ppm", "pids"})
+    ->Args({16, 4, 1000, 8})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Delta filter through Scanner on an unchanging target: every match
+// survives, so each iteration is the same steady-state pass
+void BM_ScannerDeltaFilter(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    auto opts = markerOptions();
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(bench::SyntheticTarget::MARKER);
+    core::Scanner scanner(target.pid());
+    if (auto result = scanner.snapshot(opts, VALUE); !result.success) {
+        state.SkipWithError(result.error.value_or("snapshot failed").c_str());
+        return;
+    }
+    opts.matchType = ScanMatchType::MATCH_NOT_CHANGED;
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        auto result = scanner.filter(opts);
+        if (!result.success) {
+            state.SkipWithError(result.error.value_or("filter failed").c_str());
+            return;
+        }
+        matches += result.matchCount;
+    }
+    publish(state, 0, matches, SCOPE);
+}
+BENCHMARK(BM_ScannerDeltaFilter)
+    ->ArgNames({"maps", "mib", "ppm"})
+    ->Args({16, 4, 100000})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// One pointer index build over the whole target
+void BM_PointerIndex(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    std::size_t bytes = 0;
+    std::size_t records = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        auto index = scan::PointerIndex::build(target.pid());
+        if (!index) {
+            state.SkipWithError(index.error().c_str());
+            return;
+        }
+        bytes += index->sourceBytes();
+        records += index->size();
+    }
+    publish(state, bytes, records, SCOPE);
+}
+BENCHMARK(BM_PointerIndex)
+    ->ArgNames({"maps", "mib", "ppm"})
+    ->Args({64, 4, 1000})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Filters re-check every match; the copy of the baseline is not timed
+template <bool PARALLEL>
+void BM_FilterMatches(benchmark::State& state) {
+    auto& target = targetFor(state);
+    if (!target.valid()) {
+        state.SkipWithError("failed to start synthetic target");
+        return;
+    }
+    const auto OPTS = markerOptions();
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(bench::SyntheticTarget::MARKER);
+    scan::MatchesAndOldValuesArray baseline;
+    if (auto stats = runScan(target.pid(), OPTS, &VALUE, baseline); !stats) {
+        state.SkipWithError(stats.error().c_str());
+        return;
+    }
+    std::size_t matches = 0;
+    const bench::ResourceScope SCOPE;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto work = baseline;
+        state.ResumeTiming();
+        auto stats = PARALLEL ? filterMatchesParallel(target.pid(), OPTS, &VALUE,
+                                                      work)
+                              : filterMatches(target.pid(), OPTS, &VALUE, work);
+        if (!stats) {
+            state.SkipWithError(stats.error().c_str());
+            return;
+        }
+        matches += baseline.matchCount();
+        benchmark::DoNotOptimize(work);
+    }
+    publish(state, 0, matches, SCOPE);
+}
+BENCHMARK(BM_FilterMatches<false>)->Name("BM_FilterMatches")->Apply(scanArgs);
+BENCHMARK(BM_FilterMatches<true>)
+    ->Name("BM_FilterMatchesParallel")
+    ->Apply(scanArgs);
+
+}  // namespace
@@ -0,0 +1,110 @@
+#ifndef NEWSCANMEM_BENCH_SUPPORT_H
+#define NEWSCANMEM_BENCH_SUPPORT_H
+
+// Counters shared by the benchmarks: peak RSS and syscalls issued
+
+#include <benchmark/benchmark.h>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+
+namespace bench {
+
+/**
+ * @brief Counts syscalls of this process and threads started after it
+ *
+ * Uses the raw_syscalls:sys_enter tracepoint through perf_event_open;
+ * where tracefs or perf is unavailable (perf_event_paranoid, containers)
+ * it stays disabled and the counter is left out of the results.
+ */
+class SyscallCounter {
+   public:
+    SyscallCounter() {
+        std::uint64_t id = 0;
+        for (const char* path :
+             {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+              "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"}) {
+            std::ifstream in(path);
+            if (in >> id) {
+                break;
+            }
+        }
+        if (id == 0) {
+            return;
+        }
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_TRACEPOINT;
+        attr.size = sizeof(attr);
+        attr.config = id;
+        attr.inherit = 1;  // worker threads too
+        m_fd = static_cast<int>(
+            ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~SyscallCounter() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+    SyscallCounter(const SyscallCounter&) = delete;
+    auto operator=(const SyscallCounter&) -> SyscallCounter& = delete;
+
+    [[nodiscard]] auto enabled() const noexcept -> bool { return m_fd >= 0; }
+
+    [[nodiscard]] auto read() const -> std::uint64_t {
+        std::uint64_t value = 0;
+        if (m_fd < 0 || ::read(m_fd, &value, sizeof(value)) != sizeof(value)) {
+            return 0;
+        }
+        return value;
+    }
+
+    /** @brief Process-wide counter, opened before any worker thread */
+    static auto instance() -> SyscallCounter& {
+        static SyscallCounter counter;
+        return counter;
+    }
+
+   private:
+    int m_fd{-1};
+};
+
+// Open the counter during static init so every pool thread inherits it
+inline const bool SYSCALL_COUNTER_READY = (SyscallCounter::instance(), true);
+
+/** @brief Peak resident set size of this process in MiB */
+inline auto peakRssMiB() -> double {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;  // ru_maxrss: KiB
+}
+
+/**
+ * @brief Scope measuring syscalls across a benchmark loop
+ *
+ * finish() publishes syscalls per iteration and peak RSS as counters.
+ */
+class ResourceScope {
+   public:
+    ResourceScope() : m_start(SyscallCounter::instance().read()) {}
+
+    void finish(benchmark::State& state) const {
+        const auto& counter = SyscallCounter::instance();
+        if (counter.enabled()) {
+            state.counters["syscalls"] = benchmark::Counter(
+                static_cast<double>(counter.read() - m_start),
+                benchmark::Counter::kAvgIterations);
+        }
+        state.counters["peak_rss_mib"] = peakRssMiB();
+    }
+
+   private:
+    std::uint64_t m_start;
+};
+
+}  // namespace bench
+
+#endif  // NEWSCANMEM_BENCH_SUPPORT_H
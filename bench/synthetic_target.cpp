@@ -0,0 +1,58 @@
+// Standalone synthetic target: maps a layout and waits to be scanned
+//
+//   synthetic_target [--maps N] [--mib M] [--ppm P] [--seed S]
+//
+// Prints its PID and the planted MARKER count, then sleeps until SIGINT
+// or SIGTERM.
+
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "synthetic_target.h"
+
+namespace {
+
+volatile std::sig_atomic_t gRunning = 1;  // NOLINT
+
+void handleSignal(int /*unused*/) { gRunning = 0; }
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+    bench::SyntheticLayout layout;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const auto VALUE = std::strtoull(argv[i + 1], nullptr, 10);
+        if (std::strcmp(argv[i], "--maps") == 0) {
+            layout.mappings = VALUE;
+        } else if (std::strcmp(argv[i], "--mib") == 0) {
+            layout.regionSize = VALUE << 20;
+        } else if (std::strcmp(argv[i], "--ppm") == 0) {
+            layout.density = static_cast<double>(VALUE) / 1e6;
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            layout.seed = static_cast<std::uint32_t>(VALUE);
+        } else {
+            std::cerr << "unknown option " << argv[i] << "\n";
+            return 2;
+        }
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    const bench::SyntheticMemory MEMORY{layout};
+    if (!MEMORY.mapped()) {
+        std::cerr << "mmap failed\n";
+        return 1;
+    }
+    std::cout << "PID: " << ::getpid() << "\n"
+              << "MARKER: " << bench::SyntheticMemory::MARKER << "\n"
+              << "PLANTED: " << MEMORY.planted() << "\n"
+              << "BYTES: " << MEMORY.bytes() << std::endl;
+    while (gRunning != 0) {
+        ::pause();
+    }
+    return 0;
+}
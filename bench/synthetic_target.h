@@ -0,0 +1,140 @@
+#ifndef NEWSCANMEM_BENCH_SYNTHETIC_TARGET_H
+#define NEWSCANMEM_BENCH_SYNTHETIC_TARGET_H
+
+// Synthetic scan targets for the benchmarks (合成目标进程)
+//
+// A layout is mapped and filled in this process. SyntheticTarget then
+// forks: the child keeps an identical copy of every mapping and just
+// sleeps, so scans see a separate process with a known number of planted
+// values. The synthetic_target program maps a layout in itself instead.
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+struct SyntheticLayout {
+    std::size_t mappings{16};
+    std::size_t regionSize{4U << 20};  ///< Bytes per mapping
+    double density{0.001};             ///< Share of int32 slots holding MARKER
+    std::uint32_t seed{12345};
+};
+
+/**
+ * @brief Mappings of this process filled with noise and planted MARKERs
+ */
+class SyntheticMemory {
+   public:
+    static constexpr std::int32_t MARKER = 0x5eed1234;
+
+    explicit SyntheticMemory(const SyntheticLayout& layout) {
+        std::mt19937 rng{layout.seed};
+        std::bernoulli_distribution planted{layout.density};
+        const std::size_t SLOTS = layout.regionSize / sizeof(std::int32_t);
+        for (std::size_t m = 0; m < layout.mappings; ++m) {
+            void* base = ::mmap(nullptr, layout.regionSize,
+                                PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == MAP_FAILED) {
+                continue;
+            }
+            m_regions.push_back({base, layout.regionSize});
+            auto* slots = static_cast<std::int32_t*>(base);
+            for (std::size_t i = 0; i < SLOTS; ++i) {
+                auto noise = static_cast<std::int32_t>(rng());
+                slots[i] = noise == MARKER ? noise + 1 : noise;
+                if (planted(rng)) {
+                    slots[i] = MARKER;
+                    ++m_planted;
+                }
+            }
+        }
+    }
+
+    ~SyntheticMemory() {
+        for (const auto& region : m_regions) {
+            ::munmap(region.base, region.size);
+        }
+    }
+
+    SyntheticMemory(const SyntheticMemory&) = delete;
+    auto operator=(const SyntheticMemory&) -> SyntheticMemory& = delete;
+
+    [[nodiscard]] auto mapped() const noexcept -> bool {
+        return !m_regions.empty();
+    }
+    /** @brief MARKER values planted (aligned; unaligned hits come on top) */
+    [[nodiscard]] auto planted() const noexcept -> std::size_t {
+        return m_planted;
+    }
+    [[nodiscard]] auto bytes() const noexcept -> std::size_t {
+        std::size_t total = 0;
+        for (const auto& region : m_regions) {
+            total += region.size;
+        }
+        return total;
+    }
+
+   private:
+    struct Mapping {
+        void* base;
+        std::size_t size;
+    };
+
+    std::vector<Mapping> m_regions;
+    std::size_t m_planted{0};
+};
+
+/**
+ * @brief A sleeping child process holding a copy of SyntheticMemory
+ */
+class SyntheticTarget {
+   public:
+    static constexpr std::int32_t MARKER = SyntheticMemory::MARKER;
+
+    explicit SyntheticTarget(const SyntheticLayout& layout) : m_memory(layout) {
+        m_pid = ::fork();
+        if (m_pid == 0) {
+            ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+            while (true) {
+                ::pause();
+            }
+        }
+    }
+
+    ~SyntheticTarget() {
+        if (m_pid > 0) {
+            ::kill(m_pid, SIGKILL);
+            ::waitpid(m_pid, nullptr, 0);
+        }
+    }
+
+    SyntheticTarget(const SyntheticTarget&) = delete;
+    auto operator=(const SyntheticTarget&) -> SyntheticTarget& = delete;
+
+    [[nodiscard]] auto pid() const noexcept -> pid_t { return m_pid; }
+    [[nodiscard]] auto valid() const noexcept -> bool {
+        return m_pid > 0 && m_memory.mapped();
+    }
+    [[nodiscard]] auto memory() const noexcept -> const SyntheticMemory& {
+        return m_memory;
+    }
+
+   private:
+    SyntheticMemory m_memory;
+    pid_t m_pid{-1};
+};
+
+}  // namespace bench
+
+#endif  // NEWSCANMEM_BENCH_SYNTHETIC_TARGET_H
@@ -10,6 +10,7 @@ module;
 #include <bit>
 #include <cstddef>
 #include <expected>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -17,7 +18,9 @@ module;
 export module app.result_service;
 
 import core.match;
+import core.match_export;
 import core.region_classifier;
+import core.region_filter;
 import core.scanner;
 import utils.endianness;
 
@@ -27,6 +30,7 @@ struct CurrentMatchListRequest {
     const core::Scanner* scanner{nullptr};
     pid_t pid{0};
     std::size_t limit{20};
+    std::size_t offset{0};  // first match to list
     bool showRegion{true};
     bool showIndex{true};
     utils::Endianness endianness{(std::endian::native == std::endian::little
@@ -34,6 +38,13 @@ struct CurrentMatchListRequest {
                                       : utils::Endianness::BIG)};
 };
 
+struct MatchExportRequest {
+    const core::Scanner* scanner{nullptr};
+    std::string path;  ///< File, FIFO or "-" for stdout
+    core::ExportFormat format{core::ExportFormat::CSV};
+    core::RegionFilterConfig regionFilter;
+};
+
 class ResultService {
    public:
     /**
@@ -48,21 +59,43 @@ class ResultService {
             return std::unexpected("No scanner initialized. Run a scan first.");
         }
 
-        auto classifierResult = core::RegionClassifier::create(request.pid);
-        std::optional<core::RegionClassifier> classifier;
-        if (classifierResult) {
-            classifier = std::move(*classifierResult);
+        // The scanner's cache only reparses maps that changed
+        std::shared_ptr<const core::RegionClassifier> classifier;
+        if (auto cached = request.scanner->regionClassifier()) {
+            classifier = std::move(*cached);
         }
 
         core::MatchCollector collector{std::move(classifier)};
         core::MatchCollectionOptions collectOptions{
-            .limit = request.limit, .collectRegion = request.showRegion};
+            .limit = request.limit,
+            .offset = request.offset,
+            .collectRegion = request.showRegion};
 
         return collector.collect(
             {.matches = &request.scanner->getMatches(),
              .dataType = request.scanner->getLastDataType()},
             collectOptions);
     }
+
+    /**
+     * @brief Stream every current match to request.path
+     * @return Rows and bytes written or error
+     */
+    [[nodiscard]] static auto exportMatches(const MatchExportRequest& request)
+        -> std::expected<core::ExportStats, std::string> {
+        if (request.scanner == nullptr) {
+            return std::unexpected("No scanner initialized. Run a scan first.");
+        }
+        std::shared_ptr<const core::RegionClassifier> classifier;
+        if (auto cached = request.scanner->regionClassifier()) {
+            classifier = std::move(*cached);
+        }
+        const core::MatchExporter EXPORTER{
+            {.matches = &request.scanner->getMatches(),
+             .dataType = request.scanner->getLastDataType()},
+            std::move(classifier), request.regionFilter};
+        return EXPORTER.writeFile(request.path, request.format);
+    }
 };
 
 }  // namespace app
@@ -7,12 +7,15 @@ module;
 
 #include <cstddef>
 #include <expected>
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 export module app.scan_service;
 
 import core.maps;
+import core.scan_task;
 import core.scanner;
 import scan.types;
 import value.core;
@@ -31,6 +34,7 @@ struct ScanExecutionRequest {
     std::optional<UserValue> userValue;
     ScanExecutionMode mode{ScanExecutionMode::SNAPSHOT};
     bool saveToHistory{true};
+    ScanControl* control{nullptr};  ///< Progress and cancellation; optional
 };
 
 struct ScanExecutionResult {
@@ -47,18 +51,32 @@ class ScanService {
             return std::unexpected("Failed to initialize scanner");
         }
 
-        switch (request.mode) {
-            case ScanExecutionMode::SNAPSHOT:
-                return snapshot(request.scanner, request.options,
-                                request.userValue, request.saveToHistory);
-            case ScanExecutionMode::FILTER:
-                return filter(request.scanner, request.options,
-                              request.userValue, request.saveToHistory);
-            case ScanExecutionMode::RESCAN:
-                return rescan(request.scanner, request.options, request.userValue,
-                              request.saveToHistory);
+        return toExecutionResult(dispatch(request), request.mode);
+    }
+
+    /**
+     * @brief Run request on a ScanTask instead of the calling thread
+     *
+     * request.control is replaced by the task's own; collect the outcome
+     * with finish().
+     */
+    [[nodiscard]] static auto start(ScanExecutionRequest request)
+        -> std::expected<std::unique_ptr<core::ScanTask>, std::string> {
+        if (request.scanner == nullptr) {
+            return std::unexpected("Failed to initialize scanner");
         }
-        return std::unexpected("Unknown scan execution mode");
+        return std::make_unique<core::ScanTask>(
+            [request = std::move(request)](ScanControl& control) mutable {
+                request.control = &control;
+                return dispatch(request);
+            });
+    }
+
+    /** @brief Wait for a task from start() and convert its result */
+    [[nodiscard]] static auto finish(core::ScanTask& task,
+                                     ScanExecutionMode mode)
+        -> std::expected<ScanExecutionResult, std::string> {
+        return toExecutionResult(task.wait(), mode);
     }
 
     [[nodiscard]] static auto snapshot(core::Scanner* scanner,
@@ -111,6 +129,42 @@ class ScanService {
                                    .matchCount = response.matchCount,
                                    .isFiltered = false};
     }
+
+   private:
+    [[nodiscard]] static auto dispatch(const ScanExecutionRequest& request)
+        -> core::ScannerResult {
+        auto* scanner = request.scanner;
+        switch (request.mode) {
+            case ScanExecutionMode::SNAPSHOT:
+                return scanner->snapshot(request.options, request.userValue,
+                                         request.saveToHistory,
+                                         request.control);
+            case ScanExecutionMode::FILTER:
+                return scanner->filter(request.options, request.userValue,
+                                       request.saveToHistory, request.control);
+            case ScanExecutionMode::RESCAN:
+                return scanner->rescan(request.options, request.userValue,
+                                       request.saveToHistory, request.control);
+        }
+        return core::ScannerResult{.error = "Unknown scan execution mode"};
+    }
+
+    [[nodiscard]] static auto toExecutionResult(core::ScannerResult response,
+                                                ScanExecutionMode mode)
+        -> std::expected<ScanExecutionResult, std::string> {
+        if (!response.success) {
+            const char* fallback = mode == ScanExecutionMode::FILTER
+                                       ? "Filter failed"
+                                   : mode == ScanExecutionMode::RESCAN
+                                       ? "Rescan failed"
+                                       : "Snapshot failed";
+            return std::unexpected(response.error.value_or(fallback));
+        }
+        return ScanExecutionResult{
+            .stats = std::move(response.stats),
+            .matchCount = response.matchCount,
+            .isFiltered = mode == ScanExecutionMode::FILTER};
+    }
 };
 
 }  // namespace app
@@ -27,6 +27,11 @@ import cli.commands.snapshot;
 import cli.commands.list;
 import cli.commands.write;
 import cli.commands.watch;
+import cli.commands.freeze;
+import cli.commands.export_matches;
+import cli.commands.stats;
+import cli.commands.procs;
+import cli.commands.ptrscan;
 import ui.interface;
 import ui.console;
 import utils.logging;
@@ -180,10 +185,20 @@ class Application {
             std::make_unique<commands::SnapshotCommand>(m_session));
         registry.registerCommand(
             std::make_unique<commands::ListCommand>(m_session));
+        registry.registerCommand(
+            std::make_unique<commands::ExportCommand>(m_session));
         registry.registerCommand(
             std::make_unique<commands::WriteCommand>(m_session));
         registry.registerCommand(
             std::make_unique<commands::WatchCommand>(m_session));
+        registry.registerCommand(
+            std::make_unique<commands::FreezeCommand>(m_session));
+        registry.registerCommand(
+            std::make_unique<commands::StatsCommand>(m_session));
+        registry.registerCommand(
+            std::make_unique<commands::PtrscanCommand>(m_session));
+        registry.registerCommand(
+            std::make_unique<commands::ProcsCommand>(m_session));
     }
 
     auto buildPrompt() const -> std::string {
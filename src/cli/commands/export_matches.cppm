@@ -0,0 +1,79 @@
+/**
+ * @file export_matches.cppm
+ * @brief Export command: stream all matches to a file or pipe
+ */
+
+module;
+
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module cli.commands.export_matches;
+
+import app.result_service;
+import cli.command;
+import cli.session;
+import core.match_export;
+import ui.show_message;
+
+export namespace cli::commands {
+
+class ExportCommand : public Command {
+   public:
+    explicit ExportCommand(SessionState& session) : m_session(&session) {}
+
+    [[nodiscard]] auto getName() const -> std::string_view override {
+        return "export";
+    }
+
+    [[nodiscard]] auto getDescription() const -> std::string_view override {
+        return "Write all matches to a file (CSV or binary)";
+    }
+
+    [[nodiscard]] auto getUsage() const -> std::string_view override {
+        return "export csv|bin <file>\n"
+               "  csv: 每行 index,address,region,value (value 为十六进制)\n"
+               "  bin: 按列分块的二进制格式, 主机字节序\n"
+               "  file: 输出文件或管道, '-' 表示标准输出\n"
+               "  示例: export csv matches.csv / export bin - | analyze";
+    }
+
+    [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
+        -> std::expected<void, std::string> override {
+        if (args.size() != 2 || (args[0] != "csv" && args[0] != "bin")) {
+            return std::unexpected("Usage: export csv|bin <file>");
+        }
+        return {};
+    }
+
+    [[nodiscard]] auto execute(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> override {
+        if (m_session == nullptr || !m_session->scanner) {
+            return std::unexpected("No scanner initialized. Run a scan first.");
+        }
+
+        auto result = app::ResultService::exportMatches(
+            {.scanner = m_session->scanner.get(),
+             .path = args[1],
+             .format = args[0] == "csv" ? core::ExportFormat::CSV
+                                        : core::ExportFormat::BINARY});
+        if (!result) {
+            return std::unexpected(result.error());
+        }
+        // Keep stdout clean when the export itself goes there
+        if (args[1] != "-") {
+            ui::MessagePrinter::success(
+                std::format("Exported {} match(es) to {} ({} bytes)",
+                            result->rows, args[1], result->bytes));
+        }
+        return CommandResult{.success = true, .message = ""};
+    }
+
+   private:
+    SessionState* m_session;
+};
+
+}  // namespace cli::commands
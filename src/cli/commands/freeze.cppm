@@ -0,0 +1,226 @@
+/**
+ * @file freeze.cppm
+ * @brief Freeze command: keep rewriting values at matched addresses
+ */
+
+module;
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module cli.commands.freeze;
+
+import cli.command;
+import cli.session;
+import core.freezer;
+import core.memory_writer;
+import ui.show_message;
+import value.core;
+import value.parser;
+import scan.types;
+
+export namespace cli::commands {
+
+class FreezeCommand : public Command {
+   public:
+    explicit FreezeCommand(SessionState& session) : m_session(&session) {}
+
+    [[nodiscard]] auto getName() const -> std::string_view override {
+        return "freeze";
+    }
+
+    [[nodiscard]] auto getDescription() const -> std::string_view override {
+        return "Keep writing a value to matched addresses";
+    }
+
+    [[nodiscard]] auto getUsage() const -> std::string_view override {
+        return "freeze <value> [index] | list | remove <address> | clear | "
+               "rate <hz>\n"
+               "  value: 冻结的值, 按上次扫描的类型解析\n"
+               "  index (可选): 匹配索引 (默认: 冻结所有匹配)\n"
+               "  list: 列出冻结的地址\n"
+               "  remove <address>: 解除一个地址 (支持 0x...)\n"
+               "  clear: 解除全部\n"
+               "  rate <hz>: 每秒写入次数 (默认 60)";
+    }
+
+    [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
+        -> std::expected<void, std::string> override {
+        if (args.empty()) {
+            return std::unexpected("Usage: " + std::string(getUsage()));
+        }
+        return {};
+    }
+
+    [[nodiscard]] auto execute(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> override {
+        if (m_session == nullptr || m_session->pid <= 0) {
+            return std::unexpected("Set target pid first: pid <pid>");
+        }
+
+        const auto& action = args[0];
+        if (action == "list") {
+            return list();
+        }
+        if (action == "clear") {
+            if (m_session->freezer) {
+                m_session->freezer->clear();
+            }
+            ui::MessagePrinter::success("Cleared all frozen values");
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (action == "remove" && args.size() > 1) {
+            auto address = parseAddress(args[1]);
+            if (!address) {
+                return std::unexpected("Invalid address: " + args[1]);
+            }
+            if (!m_session->freezer || !m_session->freezer->remove(*address)) {
+                return std::unexpected(
+                    std::format("0x{:016x} is not frozen", *address));
+            }
+            ui::MessagePrinter::success(
+                std::format("Unfroze 0x{:016x}", *address));
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (action == "rate" && args.size() > 1) {
+            unsigned rate = 0;
+            const auto& text = args[1];
+            auto [ptr, ec] =
+                std::from_chars(text.data(), text.data() + text.size(), rate);
+            if (ec != std::errc{} || ptr != text.data() + text.size() ||
+                rate == 0 || rate > core::Freezer::MAX_RATE_HZ) {
+                return std::unexpected(
+                    std::format("Invalid rate: {} (1-{})", text,
+                                core::Freezer::MAX_RATE_HZ));
+            }
+            m_session->freezeRateHz = rate;
+            if (m_session->freezer) {
+                m_session->freezer->setRate(rate);
+            }
+            ui::MessagePrinter::info(std::format("Freeze rate: {} Hz", rate));
+            return CommandResult{.success = true, .message = ""};
+        }
+        return freeze(args);
+    }
+
+   private:
+    auto freeze(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> {
+        if (!m_session->scanner) {
+            return std::unexpected("No matches. Run a scan first.");
+        }
+        auto lastDataType = m_session->scanner->getLastDataType();
+        if (!lastDataType) {
+            return std::unexpected(
+                "No scan data type available. Run a scan first.");
+        }
+        std::vector<std::string> valueArgs{args[0]};
+        auto value = value::buildUserValue(
+            *lastDataType, ScanMatchType::MATCH_EQUAL_TO, valueArgs, 0);
+        if (!value) {
+            return std::unexpected("Invalid value for current scan type: " +
+                                   args[0]);
+        }
+
+        std::vector<std::size_t> indices;
+        if (args.size() > 1) {
+            try {
+                indices.push_back(std::stoull(args[1]));
+            } catch (...) {
+                return std::unexpected("Invalid index: " + args[1]);
+            }
+        } else {
+            indices.resize(m_session->scanner->getMatchCount());
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                indices[i] = i;
+            }
+        }
+        if (indices.empty()) {
+            return std::unexpected("No matches. Run a scan first.");
+        }
+
+        const core::MemoryWriter WRITER(m_session->pid, m_session->endianness);
+        const auto BYTES = WRITER.encodeValueBytes(*value);
+        if (BYTES.empty()) {
+            return std::unexpected("empty freeze value");
+        }
+        const auto ADDRESSES = core::MemoryWriter::resolveMatchAddresses(
+            m_session->scanner->getMatches(), indices);
+
+        if (!m_session->freezer) {
+            m_session->freezer = std::make_unique<core::Freezer>(
+                m_session->pid, m_session->freezeRateHz);
+        }
+        std::size_t frozen = 0;
+        for (std::size_t i = 0; i < ADDRESSES.size(); ++i) {
+            if (ADDRESSES[i]) {
+                m_session->freezer->set(*ADDRESSES[i], BYTES);
+                ++frozen;
+            }
+        }
+        if (frozen == 0) {
+            return std::unexpected(
+                std::format("match index {} out of range", indices.front()));
+        }
+        ui::MessagePrinter::success(
+            std::format("Froze {} value(s) at {} Hz ({} frozen in total)",
+                        frozen, m_session->freezer->rate(),
+                        m_session->freezer->size()));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    auto list() const -> std::expected<CommandResult, std::string> {
+        if (!m_session->freezer || m_session->freezer->size() == 0) {
+            ui::MessagePrinter::info("No frozen values");
+            return CommandResult{.success = true, .message = ""};
+        }
+        const auto ENTRIES = m_session->freezer->entries();
+        constexpr std::size_t LIMIT = 20;
+        for (std::size_t i = 0; i < std::min(LIMIT, ENTRIES.size()); ++i) {
+            std::string hex;
+            for (auto byte : ENTRIES[i].bytes) {
+                hex += std::format("{:02x} ", byte);
+            }
+            ui::MessagePrinter::info(
+                std::format("0x{:016x}  {}", ENTRIES[i].address, hex));
+        }
+        if (ENTRIES.size() > LIMIT) {
+            ui::MessagePrinter::info(
+                std::format("... and {} more", ENTRIES.size() - LIMIT));
+        }
+        ui::MessagePrinter::info(
+            std::format("{} frozen at {} Hz, {} ticks, {} failed writes",
+                        ENTRIES.size(), m_session->freezer->rate(),
+                        m_session->freezer->ticks(),
+                        m_session->freezer->failedWrites()));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    [[nodiscard]] static auto parseAddress(std::string_view text)
+        -> std::optional<std::uintptr_t> {
+        int base = 10;
+        if (text.starts_with("0x") || text.starts_with("0X")) {
+            text.remove_prefix(2);
+            base = 16;
+        }
+        std::uintptr_t address = 0;
+        auto [ptr, ec] =
+            std::from_chars(text.data(), text.data() + text.size(), address, base);
+        if (ec != std::errc{} || ptr != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return address;
+    }
+
+    SessionState* m_session;
+};
+
+}  // namespace cli::commands
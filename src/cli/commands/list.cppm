@@ -35,9 +35,11 @@ class ListCommand : public Command {
     }
 
     [[nodiscard]] auto getUsage() const -> std::string_view override {
-        return "list [limit]\n"
+        return "list [limit] [offset] | next\n"
                "  limit (可选): 显示的最大匹配数 (默认: 20)\n"
-               "  示例: list / list 50";
+               "  offset (可选): 从第几个匹配开始 (默认: 0)\n"
+               "  next: 接着上一页继续显示\n"
+               "  示例: list / list 50 / list 50 1000 / list next";
     }
 
     [[nodiscard]] auto execute(const std::vector<std::string>& args)
@@ -46,13 +48,26 @@ class ListCommand : public Command {
             return std::unexpected("No scanner initialized. Run a scan first.");
         }
 
-        // 解析 limit 参数
+        // 解析 limit / offset 参数
         size_t limit = 20;
-        if (!args.empty()) {
-            try {
-                limit = std::stoull(args[0]);
-            } catch (...) {
-                return std::unexpected("Invalid limit: " + args[0]);
+        size_t offset = 0;
+        if (!args.empty() && args[0] == "next") {
+            limit = m_lastLimit;
+            offset = m_nextOffset;
+        } else {
+            if (!args.empty()) {
+                try {
+                    limit = std::stoull(args[0]);
+                } catch (...) {
+                    return std::unexpected("Invalid limit: " + args[0]);
+                }
+            }
+            if (args.size() > 1) {
+                try {
+                    offset = std::stoull(args[1]);
+                } catch (...) {
+                    return std::unexpected("Invalid offset: " + args[1]);
+                }
             }
         }
 
@@ -61,6 +76,7 @@ class ListCommand : public Command {
             {.scanner = m_session->scanner.get(),
              .pid = m_session->pid,
              .limit = limit,
+             .offset = offset,
              .showRegion = true,
              .showIndex = true,
              .endianness = m_session->endianness});
@@ -82,14 +98,24 @@ class ListCommand : public Command {
                 entry.address, entry.value.size(), entry.region));
         }
         ui::MessagePrinter::plain("");
-        ui::MessagePrinter::plain(
-            std::format("Showing {} of {} matches", entries.size(), totalCount));
+        if (entries.empty()) {
+            ui::MessagePrinter::plain(
+                std::format("Showing 0 of {} matches", totalCount));
+        } else {
+            ui::MessagePrinter::plain(
+                std::format("Showing {}-{} of {} matches", offset + 1,
+                            offset + entries.size(), totalCount));
+        }
+        m_lastLimit = limit;
+        m_nextOffset = offset + entries.size();
 
         return CommandResult{.success = true, .message = ""};
     }
 
    private:
     SessionState* m_session;
+    size_t m_lastLimit{20};
+    size_t m_nextOffset{0};  // where 'list next' continues
 };
 
 }  // namespace cli::commands
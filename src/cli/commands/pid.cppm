@@ -83,8 +83,7 @@ class PidCommand : public Command {
         }
 
         // Set target process and reset scanner
-        m_session->pid = pid;
-        m_session->scanner.reset();
+        m_session->retarget(pid);
 
         ui::MessagePrinter::success("Successfully set target process to " +
                                     std::to_string(pid));
@@ -0,0 +1,234 @@
+/**
+ * @file procs.cppm
+ * @brief Procs command: scan several processes at once
+ */
+
+module;
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module cli.commands.procs;
+
+import cli.command;
+import cli.commands.scan;
+import cli.session;
+import core.multi_scanner;
+import scan.types;
+import ui.show_message;
+import utils.parserStr;
+import value.core;
+import value.parser;
+
+export namespace cli::commands {
+
+class ProcsCommand : public Command {
+   public:
+    explicit ProcsCommand(SessionState& session) : m_session(&session) {}
+
+    [[nodiscard]] auto getName() const -> std::string_view override {
+        return "procs";
+    }
+
+    [[nodiscard]] auto getDescription() const -> std::string_view override {
+        return "Scan several processes at once";
+    }
+
+    [[nodiscard]] auto getUsage() const -> std::string_view override {
+        return "procs add <pid>... | remove <pid>... | list | "
+               "scan <type> <match> [value [high]] | common [n] | reset | "
+               "clear\n"
+               "  add <pid>...: 加入目标进程, 所有进程共用一个扫描线程池\n"
+               "  remove <pid>...: 移除进程及其结果\n"
+               "  list: 列出进程及各自的匹配数\n"
+               "  scan ...: 参数同 scan 命令, 所有进程同时扫描; "
+               "已有结果的进程在其上过滤, 其余进程建立基线\n"
+               "  common [n]: 在所有进程中都匹配的地址 (默认前 20 个);\n"
+               "    只有同一父进程 fork 出的进程地址布局相同, 分别启动的进程\n"
+               "    因 ASLR 地址不同, 结果为空并不代表值不存在\n"
+               "  reset: 清除所有进程的结果\n"
+               "  clear: 移除所有进程";
+    }
+
+    [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
+        -> std::expected<void, std::string> override {
+        if (args.empty()) {
+            return std::unexpected("Usage: " + std::string(getUsage()));
+        }
+        const auto& action = args[0];
+        if (action == "scan") {
+            return ScanCommand{*m_session}.validateArgs(
+                {args.begin() + 1, args.end()});
+        }
+        if ((action == "add" || action == "remove") && args.size() < 2) {
+            return std::unexpected("Usage: procs " + action + " <pid>...");
+        }
+        if (action != "add" && action != "remove" && action != "list" &&
+            action != "common" && action != "reset" && action != "clear") {
+            return std::unexpected("Unknown procs action: " + action);
+        }
+        return {};
+    }
+
+    [[nodiscard]] auto execute(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> override {
+        if (m_session == nullptr) {
+            return std::unexpected("Session state unavailable");
+        }
+        const auto& action = args[0];
+        if (action == "add" || action == "remove") {
+            return change(action == "add", args);
+        }
+        if (action == "clear") {
+            m_session->procs.reset();
+            ui::MessagePrinter::success("Removed all processes");
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (!m_session->procs || m_session->procs->empty()) {
+            return std::unexpected("No processes. Add some: procs add <pid>...");
+        }
+        auto& procs = *m_session->procs;
+        if (action == "scan") {
+            return scan({args.begin() + 1, args.end()});
+        }
+        if (action == "common") {
+            std::size_t limit = DEFAULT_LIST;
+            if (args.size() > 1) {
+                auto count = utils::parseInteger<std::int64_t>(args[1]);
+                if (!count || *count <= 0) {
+                    return std::unexpected("Invalid count: " + args[1]);
+                }
+                limit = static_cast<std::size_t>(*count);
+            }
+            common(limit);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (action == "reset") {
+            procs.reset();
+            ui::MessagePrinter::success("Cleared matches of all processes");
+            return CommandResult{.success = true, .message = ""};
+        }
+        for (const pid_t PID : procs.pids()) {
+            ui::MessagePrinter::info(std::format(
+                "pid {}: {} match(es)", PID,
+                procs.scanner(PID)->getMatchCount()));
+        }
+        ui::MessagePrinter::info(std::format("Total: {} match(es) in {} pid(s)",
+                                             procs.getMatchCount(),
+                                             procs.size()));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+   private:
+    static constexpr std::size_t DEFAULT_LIST = 20;
+
+    auto change(bool add, const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> {
+        auto& procs = m_session->ensureProcs();
+        for (std::size_t i = 1; i < args.size(); ++i) {
+            auto pid = utils::parseInteger<std::int64_t>(args[i]);
+            if (!pid || *pid <= 0) {
+                return std::unexpected("Invalid process ID: " + args[i]);
+            }
+            const auto PID = static_cast<pid_t>(*pid);
+            if (!add) {
+                if (!procs.detach(PID)) {
+                    ui::MessagePrinter::warn(
+                        std::format("pid {} is not attached", PID));
+                }
+                continue;
+            }
+            if (!std::filesystem::exists(std::filesystem::path("/proc") /
+                                         std::to_string(PID))) {
+                return std::unexpected("Process " + std::to_string(PID) +
+                                       " does not exist");
+            }
+            if (!procs.attach(PID)) {
+                ui::MessagePrinter::warn(
+                    std::format("pid {} is already attached", PID));
+            }
+        }
+        ui::MessagePrinter::success(
+            std::format("{} process(es) attached", procs.size()));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    auto scan(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> {
+        auto& procs = *m_session->procs;
+        const auto DATA_TYPE = *value::parseDataType(args[0]);
+        const auto MATCH_TYPE = *value::parseMatchType(args[1]);
+        std::optional<UserValue> userVal;
+        if (matchNeedsUserValue(MATCH_TYPE)) {
+            userVal = value::buildUserValue(DATA_TYPE, MATCH_TYPE, args, 2);
+        }
+
+        ScanOptions options;
+        options.dataType = DATA_TYPE;
+        options.matchType = MATCH_TYPE;
+        options.regionLevel = m_session->regionLevel;
+        options.absentPages = m_session->absentPages;
+        options.consistent = m_session->consistent;
+        options.stringEncoding = m_session->stringEncoding;
+        options.stringOverlap = m_session->stringOverlap;
+        options.alignment = m_session->alignment;
+        options.unalignedRegions = m_session->unalignedRegions;
+        options.profile = m_session->profile;
+
+        const auto RESULT = procs.scan(options, userVal, true);
+        for (const auto& entry : RESULT.perPid) {
+            if (entry.result.success) {
+                ui::MessagePrinter::info(std::format(
+                    "pid {}: {} match(es)", entry.pid,
+                    entry.result.matchCount));
+            } else {
+                ui::MessagePrinter::warn(std::format(
+                    "pid {}: {}", entry.pid,
+                    entry.result.error.value_or("scan failed")));
+            }
+        }
+        if (RESULT.failed == RESULT.perPid.size()) {
+            return std::unexpected("Scan failed in every process");
+        }
+        ui::MessagePrinter::info(std::format(
+            "Total: {} match(es) in {} pid(s){}", RESULT.matchCount,
+            RESULT.perPid.size() - RESULT.failed,
+            RESULT.failed > 0 ? std::format(", {} failed", RESULT.failed)
+                              : std::string{}));
+        if (procs.size() > 1) {
+            common(DEFAULT_LIST);
+        }
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    void common(std::size_t limit) const {
+        const auto ADDRESSES = m_session->procs->commonAddresses();
+        ui::MessagePrinter::success(std::format(
+            "{} address(es) match in all {} pid(s)", ADDRESSES.size(),
+            m_session->procs->size()));
+        const std::size_t SHOWN = std::min(limit, ADDRESSES.size());
+        for (std::size_t i = 0; i < SHOWN; ++i) {
+            ui::MessagePrinter::info(
+                std::format("[{:3}] 0x{:016x}", i, ADDRESSES[i]));
+        }
+        if (SHOWN < ADDRESSES.size()) {
+            ui::MessagePrinter::info(std::format(
+                "... {} more; 'procs common <n>' shows more",
+                ADDRESSES.size() - SHOWN));
+        }
+    }
+
+    SessionState* m_session;
+};
+
+}  // namespace cli::commands
@@ -0,0 +1,197 @@
+/**
+ * @file ptrscan.cppm
+ * @brief Ptrscan command: static pointer paths to an address
+ */
+
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module cli.commands.ptrscan;
+
+import cli.command;
+import cli.session;
+import scan.pointer_scan;
+import ui.show_message;
+import utils.parserStr;
+
+export namespace cli::commands {
+
+class PtrscanCommand : public Command {
+   public:
+    explicit PtrscanCommand(SessionState& session) : m_session(&session) {}
+
+    [[nodiscard]] auto getName() const -> std::string_view override {
+        return "ptrscan";
+    }
+
+    [[nodiscard]] auto getDescription() const -> std::string_view override {
+        return "Find static pointer paths to an address";
+    }
+
+    [[nodiscard]] auto getUsage() const -> std::string_view override {
+        return "ptrscan <address> [depth] [max_offset] | index | "
+               "rescan <address> | list [n] | clear\n"
+               "  address: 目标地址 (十六进制, 支持 0x...)\n"
+               "  depth (可选): 最多解引用层数 (默认 5)\n"
+               "  max_offset (可选): 每层最大偏移, 十六进制 (默认 0x1000)\n"
+               "  index: 重新建立指针索引 (首次搜索时自动建立)\n"
+               "  rescan <address>: 目标重启后, 只保留仍指向 address 的路径\n"
+               "  list [n]: 列出保存的路径 (默认前 20 条)\n"
+               "  clear: 清除索引和路径";
+    }
+
+    [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
+        -> std::expected<void, std::string> override {
+        if (args.empty() || args.size() > 3) {
+            return std::unexpected("Usage: " + std::string(getUsage()));
+        }
+        return {};
+    }
+
+    [[nodiscard]] auto execute(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> override {
+        if (m_session == nullptr || m_session->pid <= 0) {
+            return std::unexpected("Set target pid first: pid <pid>");
+        }
+
+        const auto& action = args[0];
+        if (action == "index") {
+            return rebuild();
+        }
+        if (action == "list") {
+            std::size_t limit = DEFAULT_LIST;
+            if (args.size() > 1) {
+                auto count = utils::parseInteger<std::int64_t>(args[1]);
+                if (!count || *count <= 0) {
+                    return std::unexpected("Invalid count: " + args[1]);
+                }
+                limit = static_cast<std::size_t>(*count);
+            }
+            list(limit);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (action == "clear") {
+            m_session->pointerIndex.reset();
+            m_session->pointerPaths.clear();
+            ui::MessagePrinter::success("Cleared pointer index and paths");
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (action == "rescan" && args.size() == 2) {
+            return rescan(args[1]);
+        }
+        return search(args);
+    }
+
+   private:
+    static constexpr std::size_t DEFAULT_LIST = 20;
+    static constexpr std::int64_t MAX_DEPTH = 16;
+
+    auto rebuild() -> std::expected<CommandResult, std::string> {
+        scan::PointerIndexOptions opts;
+        opts.sourceLevel = m_session->regionLevel;
+        if (m_session->historyDir && !m_session->historyDir->empty()) {
+            opts.tempDir = *m_session->historyDir;
+        }
+        auto index = scan::PointerIndex::build(m_session->pid, opts);
+        if (!index) {
+            return std::unexpected(index.error());
+        }
+        m_session->pointerIndex =
+            std::make_unique<scan::PointerIndex>(std::move(*index));
+        const auto& built = *m_session->pointerIndex;
+        ui::MessagePrinter::info(std::format(
+            "Indexed {} pointer(s) from {:.1f} MiB{}", built.size(),
+            static_cast<double>(built.sourceBytes()) / (1024.0 * 1024.0),
+            built.fileBacked() ? " (file-backed)" : ""));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    auto search(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> {
+        auto target = utils::parseAddress(args[0]);
+        if (!target) {
+            return std::unexpected("Invalid address: " + args[0]);
+        }
+        scan::PointerSearchOptions opts;
+        if (args.size() > 1) {
+            auto depth = utils::parseInteger<std::int64_t>(args[1]);
+            if (!depth || *depth <= 0 || *depth > MAX_DEPTH) {
+                return std::unexpected(
+                    std::format("Invalid depth: {} (1-{})", args[1], MAX_DEPTH));
+            }
+            opts.maxDepth = static_cast<std::size_t>(*depth);
+        }
+        if (args.size() > 2) {
+            auto offset = utils::parseAddress(args[2]);
+            if (!offset) {
+                return std::unexpected("Invalid offset: " + args[2]);
+            }
+            opts.maxOffset = *offset;
+        }
+        if (!m_session->pointerIndex) {
+            if (auto built = rebuild(); !built) {
+                return built;
+            }
+        }
+
+        auto result =
+            scan::findPointerPaths(*m_session->pointerIndex, *target, opts);
+        m_session->pointerPaths = std::move(result.paths);
+        ui::MessagePrinter::success(std::format(
+            "Found {} path(s) to 0x{:016x}{}", m_session->pointerPaths.size(),
+            *target, result.truncated ? " (search limit reached)" : ""));
+        list(DEFAULT_LIST);
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    auto rescan(const std::string& text)
+        -> std::expected<CommandResult, std::string> {
+        auto target = utils::parseAddress(text);
+        if (!target) {
+            return std::unexpected("Invalid address: " + text);
+        }
+        if (m_session->pointerPaths.empty()) {
+            return std::unexpected("No pointer paths. Run ptrscan first.");
+        }
+        auto kept = scan::rescanPointerPaths(
+            m_session->pid, m_session->pointerPaths, *target);
+        if (!kept) {
+            return std::unexpected(kept.error());
+        }
+        ui::MessagePrinter::success(std::format(
+            "{} of {} path(s) still lead to 0x{:016x}", kept->size(),
+            m_session->pointerPaths.size(), *target));
+        m_session->pointerPaths = std::move(*kept);
+        list(DEFAULT_LIST);
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    void list(std::size_t limit) const {
+        const auto& paths = m_session->pointerPaths;
+        const std::size_t SHOWN = std::min(limit, paths.size());
+        for (std::size_t i = 0; i < SHOWN; ++i) {
+            ui::MessagePrinter::info(
+                std::format("[{:3}] {}", i, paths[i].toString()));
+        }
+        if (SHOWN < paths.size()) {
+            ui::MessagePrinter::info(std::format(
+                "... {} more; 'ptrscan list <n>' shows more",
+                paths.size() - SHOWN));
+        }
+    }
+
+    SessionState* m_session;
+};
+
+}  // namespace cli::commands
@@ -10,6 +10,7 @@ module;
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 export module cli.commands.scan;
@@ -17,6 +18,7 @@ export module cli.commands.scan;
 import app.result_service;
 import app.scan_service;
 import cli.command;
+import cli.scan_progress;
 import cli.session;
 import core.match_formatter;
 import scan.types;
@@ -43,12 +45,17 @@ class ScanCommand : public Command {
         return "scan <type> <match> [value [high]]\n"
                "  <type>: "
                "int|int8|i8|int16|i16|int32|i32|int64|i64|float|double|"
-               "string|str|bytearray|bytes|any|anyint|anyfloat\n"
+               "string|str|bytearray|bytes|group|any|anyint|anyfloat\n"
                "  <match>: "
                "any|=|eq|!=|neq|gt|lt|range|changed|notchanged|inc|dec|incby|"
                "decby\n"
+               "  bytes 值可含 ?? 通配, 多个特征码用 | 分隔, 一次扫描全部匹配\n"
+               "  group 只支持 =: 成员为 类型:值[@偏移], 第一个成员为锚点;\n"
+               "  无偏移的成员可位于锚点后 window:N 字节内 (默认 64)\n"
                "  示例: scan int64 = 123456 / scan int range 100 200 / scan "
-               "int changed / scan string = \"Hello\"";
+               "int changed / scan string = \"Hello\" / "
+               "scan bytes = 48 8B ?? | E8 ?? ?? 90 / "
+               "scan group = i32:100 i32:100@4 i16:30 window:64";
     }
 
     [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
@@ -79,7 +86,19 @@ class ScanCommand : public Command {
                                    std::to_string(valueCount) + " value(s)");
         }
 
-        if (args.size() > EXPECTED_SIZE) {
+        // Byte patterns and group members may be spread over several
+        // arguments
+        const auto DATA_TYPE = *value::parseDataType(args[0]);
+        const bool GROUP = DATA_TYPE == ScanDataType::GROUP;
+        if (GROUP && *matchType != ScanMatchType::MATCH_EQUAL_TO) {
+            return std::unexpected("Group scans only support '='");
+        }
+        if (GROUP && !value::buildUserValue(DATA_TYPE, *matchType, args, 2)) {
+            return std::unexpected(
+                "Invalid group; expected type:value[@offset] ... [window:N]");
+        }
+        const bool BYTES = DATA_TYPE == ScanDataType::BYTE_ARRAY;
+        if (args.size() > EXPECTED_SIZE && !BYTES && !GROUP) {
             return std::unexpected(
                 "Too many arguments for scan command; expected " +
                 std::to_string(EXPECTED_SIZE));
@@ -125,6 +144,13 @@ class ScanCommand : public Command {
         options.dataType = dataType;
         options.matchType = matchType;
         options.regionLevel = m_session->regionLevel;
+        options.absentPages = m_session->absentPages;
+        options.consistent = m_session->consistent;
+        options.stringEncoding = m_session->stringEncoding;
+        options.stringOverlap = m_session->stringOverlap;
+        options.alignment = m_session->alignment;
+        options.unalignedRegions = m_session->unalignedRegions;
+        options.profile = m_session->profile;
 
         auto mode = scanner->hasMatches() ? app::ScanExecutionMode::FILTER
                                           : app::ScanExecutionMode::SNAPSHOT;
@@ -133,7 +159,7 @@ class ScanCommand : public Command {
                                           .userValue = userVal,
                                           .mode = mode,
                                           .saveToHistory = true};
-        auto result = app::ScanService::execute(request);
+        auto result = runScanWithProgress(std::move(request));
         if (!result) {
             utils::Logger::instance().error("Scan failed: {}", result.error());
             return std::unexpected(result.error());
@@ -5,10 +5,14 @@
 
 module;
 
+#include <algorithm>
+#include <charconv>
 #include <expected>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 export module cli.commands.set;
@@ -18,10 +22,77 @@ import cli.session;
 import cli.app_config;
 import ui.show_message;
 import core.maps;
+import core.region_filter;
+import core.soft_dirty;
+import scan.types;
+import utils.thread_pool;
 
 // 确保显式使用 cli 命名空间
 using cli::AppConfig;
 
+namespace {
+
+// Parse "0-3,6" style CPU lists (as in taskset -c)
+auto parseCpuList(std::string_view text) -> std::optional<std::vector<int>> {
+    std::vector<int> cpus;
+    auto parseInt = [](std::string_view part) -> std::optional<int> {
+        int value = 0;
+        const auto* end = part.data() + part.size();
+        auto [ptr, ec] = std::from_chars(part.data(), end, value);
+        if (ec != std::errc{} || ptr != end || value < 0) {
+            return std::nullopt;
+        }
+        return value;
+    };
+    while (!text.empty()) {
+        const auto COMMA = text.find(',');
+        const auto PART = text.substr(0, COMMA);
+        text = COMMA == std::string_view::npos ? std::string_view{}
+                                               : text.substr(COMMA + 1);
+        const auto DASH = PART.find('-');
+        auto first = parseInt(PART.substr(0, DASH));
+        auto last = DASH == std::string_view::npos
+                        ? first
+                        : parseInt(PART.substr(DASH + 1));
+        if (!first || !last || *first > *last) {
+            return std::nullopt;
+        }
+        for (int cpu = *first; cpu <= *last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::ranges::sort(cpus);
+    cpus.erase(std::ranges::unique(cpus).begin(), cpus.end());
+    if (cpus.empty()) {
+        return std::nullopt;
+    }
+    return cpus;
+}
+
+auto formatCpuList(const std::vector<int>& cpus) -> std::string {
+    if (cpus.empty()) {
+        return "all";
+    }
+    std::string text;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!text.empty()) {
+            text += ',';
+        }
+        text += std::to_string(cpus[i]);
+        if (j > i) {
+            text += '-' + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return text;
+}
+
+}  // namespace
+
 export namespace cli::commands {
 
 class SetCommand : public Command {
@@ -35,7 +106,9 @@ class SetCommand : public Command {
 
     [[nodiscard]] auto getDescription() const -> std::string_view override {
         return "Set runtime options: "
-               "pid|debug|color|autoBaseline|exitOnError|init";
+               "pid|debug|color|autoBaseline|exitOnError|init|"
+               "threads|affinity|pin|incremental|consistent|absentPages|history|"
+               "historyDir|stringEncoding|stringOverlap|align|unaligned";
     }
 
     [[nodiscard]] auto getUsage() const -> std::string_view override {
@@ -48,7 +121,19 @@ class SetCommand : public Command {
                "  regionLevel "
                "ALL|ALL_RW|HEAP_STACK_EXECUTABLE|HEAP_STACK_EXECUTABLE_BSS "
                "设置扫描区域\n"
-               "  init <commands>      初始命令(原样保存)";
+               "  init <commands>      初始命令(原样保存)\n"
+               "  threads <n>|auto     扫描线程数\n"
+               "  affinity <cpus>|off  扫描线程可用的 CPU, 如 0-3,6\n"
+               "  pin on|off           每个线程绑定到单个 CPU\n"
+               "  incremental on|off   仅重读上次快照后写过的页(soft-dirty)\n"
+               "  consistent on|off    快照复制内存时暂停目标进程(SIGSTOP), 复制后恢复再匹配\n"
+               "  absentPages read|zero|skip 未驻留匿名页: 照常读取/按零填充/跳过\n"
+               "  history <n>          保留的扫描历史条数\n"
+               "  historyDir <dir>|ram 历史快照写入的目录, ram 仅保存在内存\n"
+               "  stringEncoding utf8|utf16|both 字符串扫描的编码(utf16 为 UTF-16LE)\n"
+               "  stringOverlap <n>    正则跨块匹配时回看的字节数(至多 65536)\n"
+               "  align none|natural   natural: 只在按类型宽度对齐的地址匹配\n"
+               "  unaligned <types>|off 在这些区域(如 heap,stack)仍不对齐扫描";
     }
 
     [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
@@ -83,9 +168,8 @@ class SetCommand : public Command {
             if (newPid <= 0) {
                 return std::unexpected("Invalid pid: " + pidStr);
             }
-            m_session->pid = newPid;
+            m_session->retarget(newPid);
             m_config->targetPid = newPid;
-            m_session->resetScanner();
             ui::MessagePrinter{}.info("PID set to {} (scanner reset)", newPid);
             return CommandResult{.success = true, .message = ""};
         }
@@ -140,10 +224,200 @@ class SetCommand : public Command {
                                       m_config->initialCommands->size());
             return CommandResult{.success = true, .message = ""};
         }
+        if (key == "incremental") {
+            const auto& value = args[1];
+            const bool ENABLED = (value == "on" || value == "1" || value == "true");
+            m_session->incremental = ENABLED;
+            if (m_session->scanner) {
+                m_session->scanner->setIncremental(ENABLED);
+            }
+            if (m_session->procs) {
+                m_session->procs->setIncremental(ENABLED);
+            }
+            if (ENABLED && !core::softDirtySupported()) {
+                ui::MessagePrinter{}.warn(
+                    "Incremental: ON, but this kernel has no soft-dirty "
+                    "tracking; scans stay full");
+            } else {
+                ui::MessagePrinter{}.info("Incremental: {}{}",
+                                          ENABLED ? "ON" : "OFF",
+                                          ENABLED ? " (from next snapshot)"
+                                                  : "");
+            }
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "consistent") {
+            const auto& value = args[1];
+            const bool ENABLED = (value == "on" || value == "1" || value == "true");
+            m_session->consistent = ENABLED;
+            ui::MessagePrinter{}.info("Consistent snapshots: {}",
+                                      ENABLED ? "ON" : "OFF");
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "absentPages") {
+            const auto& mode = args[1];
+            if (mode == "read") {
+                m_session->absentPages = AbsentPages::READ;
+            } else if (mode == "zero") {
+                m_session->absentPages = AbsentPages::ZERO;
+            } else if (mode == "skip") {
+                m_session->absentPages = AbsentPages::SKIP;
+            } else {
+                return std::unexpected("Invalid absentPages: " + mode +
+                                       ". Valid values: read, zero, skip");
+            }
+            ui::MessagePrinter{}.info("Absent pages: {}", mode);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "history") {
+            const auto& value = args[1];
+            std::size_t count = 0;
+            const auto* end = value.data() + value.size();
+            auto [ptr, ec] = std::from_chars(value.data(), end, count);
+            if (ec != std::errc{} || ptr != end || count == 0) {
+                return std::unexpected("Invalid history size: " + value);
+            }
+            m_session->historySize = count;
+            if (m_session->scanner) {
+                m_session->scanner->setHistoryCapacity(count);
+            }
+            ui::MessagePrinter{}.info("History: {} entries", count);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "historyDir") {
+            const std::string DIR = args[1] == "ram" ? "" : args[1];
+            m_session->historyDir = DIR;
+            if (m_session->scanner) {
+                m_session->scanner->setHistorySpillParent(DIR);
+            }
+            ui::MessagePrinter{}.info("History directory: {}",
+                                      DIR.empty() ? "RAM only" : DIR);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "stringEncoding") {
+            const auto& mode = args[1];
+            if (mode == "utf8") {
+                m_session->stringEncoding = StringEncoding::UTF8;
+            } else if (mode == "utf16") {
+                m_session->stringEncoding = StringEncoding::UTF16LE;
+            } else if (mode == "both") {
+                m_session->stringEncoding = StringEncoding::BOTH;
+            } else {
+                return std::unexpected("Invalid stringEncoding: " + mode +
+                                       ". Valid values: utf8, utf16, both");
+            }
+            ui::MessagePrinter{}.info("String encoding: {}", mode);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "stringOverlap") {
+            const auto& value = args[1];
+            std::size_t bytes = 0;
+            const auto* end = value.data() + value.size();
+            auto [ptr, ec] = std::from_chars(value.data(), end, bytes);
+            if (ec != std::errc{} || ptr != end) {
+                return std::unexpected("Invalid string overlap: " + value);
+            }
+            bytes = std::min(bytes, ScanOptions::MAX_STRING_OVERLAP);
+            m_session->stringOverlap = bytes;
+            ui::MessagePrinter{}.info("String overlap: {} bytes", bytes);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "align") {
+            const auto& mode = args[1];
+            if (mode == "none") {
+                m_session->alignment = ScanAlignment::NONE;
+            } else if (mode == "natural") {
+                m_session->alignment = ScanAlignment::NATURAL;
+            } else {
+                return std::unexpected("Invalid align: " + mode +
+                                       ". Valid values: none, natural");
+            }
+            ui::MessagePrinter{}.info("Alignment: {}", mode);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "unaligned") {
+            const auto& value = args[1];
+            if (value == "off") {
+                m_session->unalignedRegions = core::RegionFilter{};
+                ui::MessagePrinter{}.info("Unaligned regions: none");
+                return CommandResult{.success = true, .message = ""};
+            }
+            std::vector<std::string> names;
+            std::string_view rest = value;
+            while (!rest.empty()) {
+                const auto COMMA = rest.find(',');
+                names.emplace_back(rest.substr(0, COMMA));
+                rest = COMMA == std::string_view::npos ? std::string_view{}
+                                                       : rest.substr(COMMA + 1);
+            }
+            std::ranges::sort(names);
+            names.erase(std::ranges::unique(names).begin(), names.end());
+            auto filter = core::RegionFilter::fromTypeNames(names);
+            if (filter.getAllowedTypes().size() != names.size()) {
+                return std::unexpected(
+                    "Invalid region types: " + value +
+                    ". Valid values: exe, code, heap, stack, unknow");
+            }
+            m_session->unalignedRegions = std::move(filter);
+            ui::MessagePrinter{}.info("Unaligned regions: {}", value);
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (key == "threads" || key == "affinity" || key == "pin") {
+            return setThreadOption(key, args[1]);
+        }
         return std::unexpected("Unknown key: " + key);
     }
 
    private:
+    auto setThreadOption(const std::string& key, const std::string& value)
+        -> std::expected<CommandResult, std::string> {
+        auto options = m_session->threads;
+        if (key == "threads") {
+            if (value == "auto") {
+                options.threads = 0;
+            } else {
+                std::size_t count = 0;
+                const auto* end = value.data() + value.size();
+                auto [ptr, ec] = std::from_chars(value.data(), end, count);
+                if (ec != std::errc{} || ptr != end || count == 0) {
+                    return std::unexpected("Invalid thread count: " + value);
+                }
+                options.threads = count;
+            }
+        } else if (key == "affinity") {
+            if (value == "off") {
+                options.cpus.clear();
+            } else {
+                auto cpus = parseCpuList(value);
+                if (!cpus) {
+                    return std::unexpected("Invalid cpu list: " + value);
+                }
+                options.cpus = std::move(*cpus);
+            }
+        } else {
+            options.pin = (value == "on" || value == "1" || value == "true");
+        }
+
+        std::size_t workers = 0;
+        if (m_session->scanner) {
+            if (auto res = m_session->scanner->configureThreads(options);
+                !res) {
+                return std::unexpected("Thread pool: " + res.error());
+            }
+            workers = m_session->scanner->threadCount();
+        }
+        m_session->threads = options;
+
+        const std::string COUNT =
+            workers != 0 ? std::to_string(workers)
+            : options.threads != 0 ? std::to_string(options.threads)
+                                   : "auto";
+        ui::MessagePrinter{}.info("Threads: {}, affinity: {}, pin: {}", COUNT,
+                                  formatCpuList(options.cpus),
+                                  options.pin ? "ON" : "OFF");
+        return CommandResult{.success = true, .message = ""};
+    }
+
     cli::SessionState* m_session;
     AppConfig* m_config;
 };
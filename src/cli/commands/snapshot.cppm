@@ -1,6 +1,6 @@
 /**
  * @file snapshot.cppm
- * @brief Snapshot command: manually create baseline snapshot
+ * @brief Snapshot command: create, save and load baseline snapshots
  */
 
 module;
@@ -13,7 +13,9 @@ module;
 
 export module cli.commands.snapshot;
 
+import app.scan_service;
 import cli.command;
+import cli.scan_progress;
 import cli.session;
 import ui.show_message;
 import core.scanner;
@@ -36,15 +38,20 @@ class SnapshotCommand : public Command {
 
     [[nodiscard]] auto getUsage() const -> std::string_view override {
         return "snapshot [type]\n"
+               "snapshot save|load <file>\n"
                "  type (可选): int|int8|int16|int32|int64|float|double|any "
                "(默认: any)\n"
-               "  示例: snapshot / snapshot int64";
+               "  save/load: 将当前匹配写入快照文件 / 从快照文件恢复为基线\n"
+               "  示例: snapshot / snapshot int64 / snapshot save base.snap";
     }
 
     [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
         -> std::expected<void, std::string> override {
-        if (args.size() > 1) {
-            return std::unexpected("Usage: snapshot [type]");
+        const bool FILE_OP =
+            !args.empty() && (args[0] == "save" || args[0] == "load");
+        if ((FILE_OP && args.size() != 2) || (!FILE_OP && args.size() > 1)) {
+            return std::unexpected("Usage: snapshot [type] | snapshot "
+                                   "save|load <file>");
         }
         return {};
     }
@@ -59,6 +66,25 @@ class SnapshotCommand : public Command {
             return std::unexpected("Failed to initialize scanner");
         }
 
+        if (!args.empty() && args[0] == "save") {
+            if (auto err = scanner->saveSnapshot(args[1]); !err) {
+                return std::unexpected(err.error());
+            }
+            ui::MessagePrinter::info(
+                std::format("Snapshot saved to {} (matches={})", args[1],
+                            scanner->getMatchCount()));
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (!args.empty() && args[0] == "load") {
+            auto loaded = scanner->loadSnapshot(args[1]);
+            if (!loaded) {
+                return std::unexpected(loaded.error());
+            }
+            ui::MessagePrinter::info(std::format(
+                "Snapshot loaded from {} (matches={})", args[1], *loaded));
+            return CommandResult{.success = true, .message = ""};
+        }
+
         // 默认使用 ANY_NUMBER 类型
         ScanDataType dataType = ScanDataType::ANY_NUMBER;
         if (!args.empty()) {
@@ -72,16 +98,26 @@ class SnapshotCommand : public Command {
         ScanOptions opts;
         opts.dataType = dataType;
         opts.matchType = ScanMatchType::MATCH_ANY;
-
-        auto res = scanner->snapshot(opts, std::nullopt, true);
-        if (!res.success) {
-            return std::unexpected(res.error.value_or("Snapshot failed"));
+        opts.absentPages = m_session->absentPages;
+        opts.consistent = m_session->consistent;
+        opts.profile = m_session->profile;
+
+        auto res = runScanWithProgress({.scanner = scanner,
+                                        .options = opts,
+                                        .mode = app::ScanExecutionMode::SNAPSHOT,
+                                        .saveToHistory = true});
+        if (!res) {
+            return std::unexpected(res.error());
         }
 
         ui::MessagePrinter::info(std::format(
-            "Snapshot created: regions={}, bytes={}, matches={}",
-            res.stats.regionsVisited, res.stats.bytesScanned,
-            scanner->getMatchCount()));
+            "Snapshot created: regions={}, bytes={}, matches={}{}",
+            res->stats.regionsVisited, res->stats.bytesScanned,
+            scanner->getMatchCount(),
+            opts.consistent
+                ? std::format(", paused {:.2f} ms",
+                              static_cast<double>(res->stats.pauseNs) / 1e6)
+                : std::string{}));
 
         return CommandResult{.success = true, .message = ""};
     }
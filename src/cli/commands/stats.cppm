@@ -0,0 +1,113 @@
+/**
+ * @file stats.cppm
+ * @brief Stats command: toggle scan profiling and show the last profile
+ */
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module cli.commands.stats;
+
+import cli.command;
+import cli.session;
+import scan.types;
+import ui.show_message;
+
+export namespace cli::commands {
+
+class StatsCommand : public Command {
+   public:
+    explicit StatsCommand(SessionState& session) : m_session(&session) {}
+
+    [[nodiscard]] auto getName() const -> std::string_view override {
+        return "stats";
+    }
+
+    [[nodiscard]] auto getDescription() const -> std::string_view override {
+        return "Profile scans per phase and show where the last one spent time";
+    }
+
+    [[nodiscard]] auto getUsage() const -> std::string_view override {
+        return "stats [on|off]\n"
+               "  on/off: 开启或关闭扫描分阶段计时 (默认关闭)\n"
+               "  无参数: 显示最近一次计时扫描/过滤的各阶段耗时、读取次数、\n"
+               "          最慢任务及各工作线程利用率";
+    }
+
+    [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
+        -> std::expected<void, std::string> override {
+        if (args.size() > 1 ||
+            (args.size() == 1 && args[0] != "on" && args[0] != "off")) {
+            return std::unexpected("Usage: stats [on|off]");
+        }
+        return {};
+    }
+
+    [[nodiscard]] auto execute(const std::vector<std::string>& args)
+        -> std::expected<CommandResult, std::string> override {
+        if (m_session == nullptr) {
+            return std::unexpected("No session");
+        }
+        if (!args.empty()) {
+            m_session->profile = args[0] == "on";
+            ui::MessagePrinter::info(std::format(
+                "Scan profiling {}", m_session->profile ? "on" : "off"));
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (!m_session->scanner || !m_session->scanner->lastProfile().enabled) {
+            ui::MessagePrinter::info(
+                m_session->profile
+                    ? "No profiled scan yet"
+                    : "No profiled scan yet; enable with 'stats on'");
+            return CommandResult{.success = true, .message = ""};
+        }
+        print(m_session->scanner->lastProfile());
+        return CommandResult{.success = true, .message = ""};
+    }
+
+   private:
+    static auto ms(std::uint64_t nanos) -> double {
+        return static_cast<double>(nanos) / 1e6;
+    }
+
+    static void print(const ScanProfile& profile) {
+        ui::MessagePrinter::info(std::format(
+            "total {:.2f} ms: maps {:.2f}, scan {:.2f}, merge {:.2f}, "
+            "history {:.2f}",
+            ms(profile.totalNs), ms(profile.mapsNs), ms(profile.scanNs),
+            ms(profile.mergeNs), ms(profile.historyNs)));
+        ui::MessagePrinter::info(std::format(
+            "  thread time: io {:.2f} ms, match {:.2f} ms", ms(profile.ioNs),
+            ms(profile.matchNs)));
+        ui::MessagePrinter::info(std::format(
+            "  reads {} ({} bytes), short {}, failed {}", profile.reads,
+            profile.bytesRead, profile.shortReads, profile.failedReads));
+        if (profile.slowestTaskNs > 0) {
+            ui::MessagePrinter::info(std::format(
+                "  slowest task {:.2f} ms at 0x{:x} ({} bytes)",
+                ms(profile.slowestTaskNs), profile.slowestTaskAddress,
+                profile.slowestTaskBytes));
+        }
+        for (std::size_t i = 0; i < profile.workers.size(); ++i) {
+            const auto& worker = profile.workers[i];
+            const double BUSY =
+                profile.scanNs > 0 ? 100.0 * static_cast<double>(worker.busyNs) /
+                                         static_cast<double>(profile.scanNs)
+                                   : 0.0;
+            ui::MessagePrinter::info(
+                std::format("  worker {}: busy {:.0f}%, tasks {}, bytes {}", i,
+                            BUSY, worker.tasks, worker.bytes));
+        }
+    }
+
+    SessionState* m_session;
+};
+
+}  // namespace cli::commands
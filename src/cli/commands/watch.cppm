@@ -1,28 +1,29 @@
 /**
  * @file watch.cppm
- * @brief Watch command: monitor specific address for value changes
+ * @brief Watch command: monitor addresses for value changes in the
+ *        background
  */
 
 module;
 
-#include <sys/uio.h>
-#include <unistd.h>
-
-#include <bit>
+#include <algorithm>
 #include <charconv>
 #include <chrono>
 #include <cstdint>
 #include <expected>
 #include <format>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
-#include <thread>
 #include <vector>
 
 export module cli.commands.watch;
 
 import cli.command;
 import cli.session;
+import core.watcher;
+import scan.match_storage;
 import ui.show_message;
 
 export namespace cli::commands {
@@ -36,11 +37,26 @@ class WatchCommand : public Command {
     }
 
     [[nodiscard]] auto getDescription() const -> std::string_view override {
-        return "Monitor specific address for value changes";
+        return "Monitor addresses for value changes";
     }
 
     [[nodiscard]] auto getUsage() const -> std::string_view override {
-        return "watch <address> [interval_ms]";
+        return "watch <address> [interval_ms] | matches [interval_ms] | "
+               "events | list | remove <address> | stop\n"
+               "  address: 后台监视该地址的 8 字节 (支持 0x...)\n"
+               "  matches: 监视当前所有匹配\n"
+               "  events: 显示自上次以来的变化\n"
+               "  list: 列出监视的地址\n"
+               "  remove <address>: 取消监视一个地址\n"
+               "  stop: 停止全部监视";
+    }
+
+    [[nodiscard]] auto validateArgs(const std::vector<std::string>& args) const
+        -> std::expected<void, std::string> override {
+        if (args.empty()) {
+            return std::unexpected("Usage: " + std::string(getUsage()));
+        }
+        return {};
     }
 
     [[nodiscard]] auto execute(const std::vector<std::string>& args)
@@ -49,90 +65,152 @@ class WatchCommand : public Command {
             return std::unexpected("Set target pid first: pid <pid>");
         }
 
-        if (args.empty()) {
-            return std::unexpected("Usage: watch <address> [interval_ms]");
+        const auto& action = args[0];
+        if (action == "events") {
+            return showEvents();
         }
-
-        // 解析地址
-        const auto& addrStr = args[0];
-        std::uintptr_t addr = 0;
-
-        // 支持 0x 前缀
-        std::string_view addrStrView = addrStr;
-        int base = 10;
-        if (addrStrView.starts_with("0x") || addrStrView.starts_with("0X")) {
-            addrStrView.remove_prefix(2);
-            base = 16;
+        if (action == "list") {
+            return list();
         }
-
-        auto result =
-            std::from_chars(addrStrView.data(), addrStrView.data() + addrStrView.size(), addr, base);
-        if (result.ec != std::errc{}) {
-            return std::unexpected(std::format("Invalid address: {}", addrStr));
+        if (action == "stop") {
+            m_session->watcher.reset();
+            ui::MessagePrinter::success("Stopped watching");
+            return CommandResult{.success = true, .message = ""};
+        }
+        if (action == "remove" && args.size() > 1) {
+            auto address = parseNumber(args[1]);
+            if (!address) {
+                return std::unexpected("Invalid address: " + args[1]);
+            }
+            if (!m_session->watcher || !m_session->watcher->remove(*address)) {
+                return std::unexpected(
+                    std::format("0x{:016x} is not watched", *address));
+            }
+            ui::MessagePrinter::success(
+                std::format("Stopped watching 0x{:016x}", *address));
+            return CommandResult{.success = true, .message = ""};
         }
 
-        // 解析间隔（可选）
-        int intervalMs = 1000;
+        std::optional<std::chrono::milliseconds> interval;
         if (args.size() >= 2) {
-            auto result2 = std::from_chars(
-                args[1].data(), args[1].data() + args[1].size(), intervalMs);
-            if (result2.ec != std::errc{} || intervalMs <= 0) {
+            auto value = parseNumber(args[1]);
+            if (!value || *value == 0) {
                 return std::unexpected(
                     std::format("Invalid interval: {}", args[1]));
             }
+            interval = std::chrono::milliseconds(*value);
         }
 
-        ui::MessagePrinter::info(
-            std::format("Watching 0x{:016x} (Ctrl+C to stop)...", addr));
-
-        // 监控循环
-        std::uint64_t lastValue = 0;
-        bool firstRead = true;
-
-        try {
-            while (true) {
-                // 读取当前值
-                std::uint64_t currentValue = 0;
-                iovec local{.iov_base = &currentValue,
-                            .iov_len = sizeof(currentValue)};
-                iovec remote{.iov_base = std::bit_cast<void*>(addr),
-                             .iov_len = sizeof(currentValue)};
-
-                ssize_t bytesRead =
-                    process_vm_readv(m_session->pid, &local, 1, &remote, 1, 0);
-
-                if (bytesRead != sizeof(currentValue)) {
-                    ui::MessagePrinter::error(std::format(
-                        "Failed to read memory at 0x{:016x}", addr));
-                    break;
-                }
-
-                // 检测变化
-                if (firstRead) {
-                    ui::MessagePrinter::info(
-                        std::format("Initial value: 0x{:016x}", currentValue));
-                    lastValue = currentValue;
-                    firstRead = false;
-                } else if (currentValue != lastValue) {
-                    ui::MessagePrinter::info(
-                        std::format("Value changed: 0x{:016x} -> 0x{:016x}",
-                                    lastValue, currentValue));
-                    lastValue = currentValue;
-                }
-
-                // 等待
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(intervalMs));
-            }
-        } catch (const std::exception& e) {
-            return std::unexpected(
-                std::format("Watch interrupted: {}", e.what()));
+        if (action == "matches") {
+            return watchMatches(interval);
         }
 
-        return CommandResult{.shouldExit = false};
+        auto address = parseNumber(action);
+        if (!address) {
+            return std::unexpected(std::format("Invalid address: {}", action));
+        }
+        auto& watcher = ensureWatcher(interval);
+        watcher.add(*address);
+        ui::MessagePrinter::info(
+            std::format("Watching 0x{:016x} every {} ms ('watch events' to "
+                        "show changes)",
+                        *address, watcher.interval().count()));
+        return CommandResult{.success = true, .message = ""};
     }
 
    private:
+    auto ensureWatcher(std::optional<std::chrono::milliseconds> interval)
+        -> core::Watcher& {
+        if (!m_session->watcher) {
+            m_session->watcher = std::make_unique<core::Watcher>(
+                m_session->pid,
+                interval.value_or(core::Watcher::DEFAULT_INTERVAL));
+        } else if (interval) {
+            m_session->watcher->setInterval(*interval);
+        }
+        return *m_session->watcher;
+    }
+
+    auto watchMatches(std::optional<std::chrono::milliseconds> interval)
+        -> std::expected<CommandResult, std::string> {
+        if (!m_session->scanner || !m_session->scanner->hasMatches()) {
+            return std::unexpected("No matches. Run a scan first.");
+        }
+        auto& watcher = ensureWatcher(interval);
+        std::vector<core::Watcher::Entry> entries;
+        m_session->scanner->getMatches().forEachMatch(
+            [&](const scan::MatchView& match) {
+                entries.emplace_back(match.address, match.info.length);
+            });
+        watcher.add(entries);
+        ui::MessagePrinter::info(
+            std::format("Watching {} match(es) every {} ms", entries.size(),
+                        watcher.interval().count()));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    auto showEvents() -> std::expected<CommandResult, std::string> {
+        if (!m_session->watcher) {
+            ui::MessagePrinter::info("Nothing is watched");
+            return CommandResult{.success = true, .message = ""};
+        }
+        auto& watcher = *m_session->watcher;
+        const auto DRAINED = watcher.drain([](const core::WatchEvent& event) {
+            const auto WIDTH = static_cast<unsigned>(event.width) * 2;
+            ui::MessagePrinter::info(
+                std::format("0x{:016x}: 0x{:0{}x} -> 0x{:0{}x}", event.address,
+                            event.oldValue, WIDTH, event.newValue, WIDTH));
+        });
+        if (DRAINED == 0) {
+            ui::MessagePrinter::info("No changes");
+        }
+        if (watcher.droppedEvents() > 0) {
+            ui::MessagePrinter::warn(
+                std::format("{} change(s) dropped since the watch started; "
+                            "run 'watch events' more often",
+                            watcher.droppedEvents()));
+        }
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    auto list() const -> std::expected<CommandResult, std::string> {
+        if (!m_session->watcher || m_session->watcher->size() == 0) {
+            ui::MessagePrinter::info("Nothing is watched");
+            return CommandResult{.success = true, .message = ""};
+        }
+        const auto WATCHED = m_session->watcher->watched();
+        constexpr std::size_t LIMIT = 20;
+        for (std::size_t i = 0; i < std::min(LIMIT, WATCHED.size()); ++i) {
+            ui::MessagePrinter::info(std::format(
+                "0x{:016x}  {} byte(s)", WATCHED[i].first, WATCHED[i].second));
+        }
+        if (WATCHED.size() > LIMIT) {
+            ui::MessagePrinter::info(
+                std::format("... and {} more", WATCHED.size() - LIMIT));
+        }
+        ui::MessagePrinter::info(std::format(
+            "{} watched every {} ms, {} ticks", WATCHED.size(),
+            m_session->watcher->interval().count(), m_session->watcher->ticks()));
+        return CommandResult{.success = true, .message = ""};
+    }
+
+    // Decimal or 0x-prefixed hex
+    [[nodiscard]] static auto parseNumber(std::string_view text)
+        -> std::optional<std::uintptr_t> {
+        int base = 10;
+        if (text.starts_with("0x") || text.starts_with("0X")) {
+            text.remove_prefix(2);
+            base = 16;
+        }
+        std::uintptr_t value = 0;
+        auto [ptr, ec] =
+            std::from_chars(text.data(), text.data() + text.size(), value, base);
+        if (ec != std::errc{} || ptr != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
     SessionState* m_session;
 };
 
@@ -0,0 +1,134 @@
+/**
+ * @file scan_progress.cppm
+ * @brief Foreground scans with a progress line and Ctrl-C to cancel
+ *
+ * The scan runs on a core::ScanTask while the REPL thread redraws one
+ * status line on stderr (only when it is a terminal). SIGINT is caught
+ * for the duration and cancels the scan instead of ending the tool.
+ */
+
+module;
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <iostream>
+#include <string>
+#include <utility>
+
+export module cli.scan_progress;
+
+import app.scan_service;
+import core.scan_task;
+import scan.types;
+import ui.show_message;
+
+namespace cli {
+
+inline std::atomic<bool> g_interrupted{false};
+
+inline void onInterrupt(int /*signal*/) {
+    g_interrupted.store(true, std::memory_order_relaxed);
+}
+
+// Catches SIGINT while alive, restoring the previous action after
+class InterruptGuard {
+   public:
+    InterruptGuard() {
+        g_interrupted.store(false, std::memory_order_relaxed);
+        struct sigaction action{};
+        action.sa_handler = onInterrupt;
+        sigemptyset(&action.sa_mask);
+        m_installed = ::sigaction(SIGINT, &action, &m_previous) == 0;
+    }
+    ~InterruptGuard() {
+        if (m_installed) {
+            ::sigaction(SIGINT, &m_previous, nullptr);
+        }
+    }
+    InterruptGuard(const InterruptGuard&) = delete;
+    auto operator=(const InterruptGuard&) -> InterruptGuard& = delete;
+
+   private:
+    struct sigaction m_previous{};
+    bool m_installed{false};
+};
+
+inline auto mib(std::size_t bytes) -> double {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+inline auto formatProgress(const ScanProgress& progress, bool cancelling)
+    -> std::string {
+    std::string line =
+        progress.matchesTotal > 0
+            ? std::format("Filtering {:.1f}% ({}/{} matches)",
+                          progress.fraction() * 100.0, progress.matchesDone,
+                          progress.matchesTotal)
+            : std::format("Scanning {:.1f}% ({:.1f}/{:.1f} MiB, {}/{} regions)",
+                          progress.fraction() * 100.0, mib(progress.bytesDone),
+                          mib(progress.bytesTotal), progress.regionsDone,
+                          progress.regionsTotal);
+    if (cancelling) {
+        return line + ", cancelling...";
+    }
+    if (auto eta = progress.eta()) {
+        line += std::format(
+            ", ETA {}s",
+            std::chrono::ceil<std::chrono::seconds>(*eta).count());
+    }
+    return line + ", Ctrl-C to cancel";
+}
+
+/// How often the progress line is redrawn and Ctrl-C is checked
+export constexpr std::chrono::milliseconds PROGRESS_INTERVAL{100};
+
+/**
+ * @brief Run request in the background and wait, showing its progress
+ *
+ * A cancelled scan succeeds with ScanStats::cancelled set and the
+ * partial result in the scanner; a warning says so.
+ */
+export inline auto runScanWithProgress(app::ScanExecutionRequest request)
+    -> std::expected<app::ScanExecutionResult, std::string> {
+    const auto MODE = request.mode;
+    auto taskExp = app::ScanService::start(std::move(request));
+    if (!taskExp) {
+        return std::unexpected(taskExp.error());
+    }
+    auto& task = **taskExp;
+
+    const InterruptGuard GUARD;
+    const bool SHOW = ::isatty(STDERR_FILENO) != 0;
+    bool shown = false;
+    while (!task.waitFor(PROGRESS_INTERVAL)) {
+        if (g_interrupted.load(std::memory_order_relaxed)) {
+            task.cancel();
+        }
+        if (SHOW) {
+            std::cerr << '\r'
+                      << formatProgress(task.progress(), task.cancelRequested())
+                      << "\x1b[K" << std::flush;
+            shown = true;
+        }
+    }
+    if (shown) {
+        std::cerr << "\r\x1b[K" << std::flush;
+    }
+
+    auto result = app::ScanService::finish(task, MODE);
+    if (result && result->stats.cancelled) {
+        ui::MessagePrinter::warn(
+            MODE == app::ScanExecutionMode::FILTER
+                ? "Filter cancelled; matches not yet checked were kept"
+                : "Scan cancelled; matches cover the regions scanned so far");
+    }
+    return result;
+}
+
+}  // namespace cli
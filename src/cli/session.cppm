@@ -7,13 +7,25 @@ module;
 
 #include <sys/types.h>
 
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 export module cli.session;
 
+import core.freezer;
 import core.maps;
+import core.multi_scanner;
+import core.region_filter;
+import core.scan_history;
 import core.scanner;
+import core.watcher;
+import scan.pointer_scan;
+import scan.types;
 import utils.endianness;
+import utils.thread_pool;
 using core::Scanner;
 
 export namespace cli {
@@ -21,21 +33,52 @@ export namespace cli {
 struct SessionState {
     pid_t pid{0};
     std::unique_ptr<Scanner> scanner;
+    std::unique_ptr<core::Freezer> freezer;  ///< Created by the first freeze
+    unsigned freezeRateHz{core::Freezer::DEFAULT_RATE_HZ};
+    std::unique_ptr<core::Watcher> watcher;  ///< Created by the first watch
     core::RegionScanLevel regionLevel{core::RegionScanLevel::ALL_RW};
     utils::Endianness endianness{(std::endian::native == std::endian::little
                                       ? utils::Endianness::LITTLE
                                       : utils::Endianness::BIG)};
+    utils::ThreadPoolOptions threads;  ///< Scanner worker pool settings
+    bool incremental{false};           ///< Soft-dirty incremental scans
+    bool consistent{false};  ///< Stop the target while snapshots copy
+    AbsentPages absentPages{AbsentPages::SKIP};  ///< Untouched pages
+    std::size_t historySize{core::ScanHistory::DEFAULT_CAPACITY};
+    std::optional<std::string> historyDir;  ///< Spill parent; "" = RAM
+    StringEncoding stringEncoding{StringEncoding::UTF8};  ///< String scans
+    std::size_t stringOverlap{ScanOptions::STRING_OVERLAP};  ///< Regex look-behind
+    ScanAlignment alignment{ScanAlignment::NONE};  ///< Typed scan candidates
+    core::RegionFilter unalignedRegions;  ///< Exempt from NATURAL alignment
+    bool profile{false};  ///< Per-phase timing of scans ('stats on')
+    std::unique_ptr<scan::PointerIndex> pointerIndex;  ///< Built by ptrscan
+    std::vector<scan::PointerPath> pointerPaths;  ///< Last ptrscan result
+    std::unique_ptr<core::MultiScanner> procs;  ///< Pids added by 'procs add'
 
     auto ensureScanner() -> Scanner* {
         if (pid <= 0) {
             return nullptr;
         }
         if (!scanner) {
-            scanner = std::make_unique<Scanner>(pid);
+            scanner = std::make_unique<Scanner>(pid, threads);
+            scanner->setIncremental(incremental);
+            scanner->setHistoryCapacity(historySize);
+            if (historyDir) {
+                scanner->setHistorySpillParent(*historyDir);
+            }
         }
         return scanner.get();
     }
 
+    /** @brief Multi-pid scanner, created with the current thread settings */
+    auto ensureProcs() -> core::MultiScanner& {
+        if (!procs) {
+            procs = std::make_unique<core::MultiScanner>(threads);
+            procs->setIncremental(incremental);
+        }
+        return *procs;
+    }
+
     auto resetScanner() const -> void {
         if (scanner) {
             scanner->reset();
@@ -45,6 +88,22 @@ struct SessionState {
         endianness = mode;
         // 端序修改后，应重新建立扫描基线，由上层命令触发
     }
+
+    /**
+     * @brief Switch to another target; the scanner is rebuilt lazily
+     *
+     * The scanner's cached readers are bound to the old pid, so clearing
+     * its matches is not enough; values frozen or watched in the old
+     * target are released. Pointer paths are module relative and stay,
+     * for 'ptrscan rescan' on a restarted target; the index goes.
+     */
+    auto retarget(pid_t newPid) -> void {
+        pid = newPid;
+        scanner.reset();
+        freezer.reset();
+        watcher.reset();
+        pointerIndex.reset();
+    }
 };
 
 }  // namespace cli
@@ -0,0 +1,198 @@
+/**
+ * @file freezer.cppm
+ * @brief Background rewriting of frozen values (数值冻结)
+ *
+ * A Freezer owns one helper thread and one /proc/<pid>/mem handle. Every
+ * tick it pushes all frozen values out with ProcMemIO::writeRanges, so a
+ * thousand addresses cost a single process_vm_writev per tick rather than
+ * a thousand open/pwrite/close rounds. Adjacent values are merged into
+ * one range; the range list is only rebuilt when the set changes.
+ */
+
+module;
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+export module core.freezer;
+
+import core.proc_mem;
+import utils.periodic_worker;
+
+export namespace core {
+
+/** @brief One frozen value */
+struct FreezeEntry {
+    std::uintptr_t address{0};
+    std::vector<std::uint8_t> bytes;
+};
+
+/**
+ * @class Freezer
+ * @brief Rewrites a set of addresses at a fixed rate
+ *
+ * Thread-safe; the helper starts on construction and idles while the set
+ * is empty.
+ */
+class Freezer {
+   public:
+    static constexpr unsigned DEFAULT_RATE_HZ = 60;
+    static constexpr unsigned MAX_RATE_HZ = 1000;
+
+    explicit Freezer(pid_t pid, unsigned rateHz = DEFAULT_RATE_HZ)
+        : m_pid(pid),
+          m_rateHz(std::clamp(rateHz, 1U, MAX_RATE_HZ)),
+          m_memIO(pid) {
+        // Without a writable fd process_vm_writev still does the bulk
+        std::ignore = m_memIO.open(true);
+        m_worker.start({
+            .hasWork = [this]() { return !m_entries.empty(); },
+            .rebuild = [this]() { rebuild(); },
+            .period =
+                [this]() {
+                    return std::chrono::nanoseconds(std::chrono::seconds(1)) /
+                           m_rateHz;
+                },
+            .tick = [this]() { tick(); },
+        });
+    }
+
+    Freezer(const Freezer&) = delete;
+    auto operator=(const Freezer&) -> Freezer& = delete;
+    Freezer(Freezer&&) = delete;
+    auto operator=(Freezer&&) -> Freezer& = delete;
+
+    [[nodiscard]] auto pid() const noexcept -> pid_t { return m_pid; }
+
+    /** @brief Freeze bytes at address, replacing an earlier value there */
+    void set(std::uintptr_t address, std::vector<std::uint8_t> bytes) {
+        if (bytes.empty()) {
+            return;
+        }
+        m_worker.update([&]() {
+            m_entries[address] = std::move(bytes);
+            return true;
+        });
+    }
+
+    /** @brief Stop freezing address; false if it was not frozen */
+    auto remove(std::uintptr_t address) -> bool {
+        return m_worker.update(
+            [&]() { return m_entries.erase(address) != 0; });
+    }
+
+    void clear() {
+        m_worker.update([this]() {
+            m_entries.clear();
+            return true;
+        });
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t {
+        return m_worker.locked([this]() { return m_entries.size(); });
+    }
+
+    /** @brief Frozen values by address */
+    [[nodiscard]] auto entries() const -> std::vector<FreezeEntry> {
+        return m_worker.locked([this]() {
+            std::vector<FreezeEntry> out;
+            out.reserve(m_entries.size());
+            for (const auto& [address, bytes] : m_entries) {
+                out.push_back({.address = address, .bytes = bytes});
+            }
+            return out;
+        });
+    }
+
+    /** @brief Ticks per second, clamped to [1, MAX_RATE_HZ] */
+    void setRate(unsigned rateHz) {
+        m_worker.locked(
+            [&]() { m_rateHz = std::clamp(rateHz, 1U, MAX_RATE_HZ); });
+        m_worker.wake();
+    }
+
+    [[nodiscard]] auto rate() const -> unsigned {
+        return m_worker.locked([this]() { return m_rateHz; });
+    }
+
+    /** @brief Ticks that wrote at least one value */
+    [[nodiscard]] auto ticks() const noexcept -> std::uint64_t {
+        return m_ticks.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Range writes that came up short, over all ticks */
+    [[nodiscard]] auto failedWrites() const noexcept -> std::uint64_t {
+        return m_failed.load(std::memory_order_relaxed);
+    }
+
+   private:
+    // Snapshot of m_entries owned by the helper: bytes back to back, with
+    // adjacent entries merged into one range
+    struct Batch {
+        std::vector<std::uint8_t> bytes;
+        std::vector<std::pair<std::uintptr_t, std::size_t>> spans;  // addr, len
+        std::vector<WriteRange> ranges;
+        std::vector<std::size_t> written;
+    };
+
+    void rebuild() {
+        m_batch.bytes.clear();
+        m_batch.spans.clear();
+        for (const auto& [address, bytes] : m_entries) {
+            auto& spans = m_batch.spans;
+            if (!spans.empty() &&
+                spans.back().first + spans.back().second == address) {
+                spans.back().second += bytes.size();
+            } else {
+                spans.emplace_back(address, bytes.size());
+            }
+            m_batch.bytes.insert(m_batch.bytes.end(), bytes.begin(),
+                                 bytes.end());
+        }
+        m_batch.ranges.clear();
+        std::size_t offset = 0;
+        for (const auto& [address, length] : m_batch.spans) {
+            m_batch.ranges.push_back(
+                {.addr = reinterpret_cast<void*>(address),
+                 .bytes = std::span<const std::uint8_t>(m_batch.bytes)
+                              .subspan(offset, length)});
+            offset += length;
+        }
+        m_batch.written.resize(m_batch.ranges.size());
+    }
+
+    void tick() {
+        if (m_batch.ranges.empty() ||
+            !m_memIO.writeRanges(m_batch.ranges, m_batch.written)) {
+            return;
+        }
+        std::uint64_t failed = 0;
+        for (std::size_t i = 0; i < m_batch.ranges.size(); ++i) {
+            failed += m_batch.written[i] < m_batch.ranges[i].bytes.size();
+        }
+        m_failed.fetch_add(failed, std::memory_order_relaxed);
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    pid_t m_pid;
+    // Guarded by m_worker
+    std::map<std::uintptr_t, std::vector<std::uint8_t>> m_entries;
+    unsigned m_rateHz;
+    ProcMemIO m_memIO;  // helper only, like m_batch
+    Batch m_batch;
+    std::atomic<std::uint64_t> m_ticks{0};
+    std::atomic<std::uint64_t> m_failed{0};
+    utils::PeriodicWorker m_worker;
+};
+
+}  // namespace core
@@ -1,17 +1,21 @@
 module;
 
+#include <fcntl.h>
+#include <limits.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
 #include <cstdint>
 #include <cstring>
 #include <expected>
-#include <filesystem>
 #include <format>
-#include <fstream>
 #include <istream>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -101,6 +105,14 @@ struct Region {
     }
 };
 
+/**
+ * @class MapsReader
+ * @brief Parser for /proc/<pid>/maps
+ *
+ * The file is read into one buffer with plain read(2) and split into
+ * string_view fields, so a process with tens of thousands of mappings
+ * parses without iostreams or per-line allocations.
+ */
 class MapsReader {
    public:
     struct Error {
@@ -111,56 +123,112 @@ class MapsReader {
     [[nodiscard]] static auto readProcessMaps(
         pid_t pid, RegionScanLevel level = RegionScanLevel::ALL_RW)
         -> std::expected<std::vector<Region>, Error> {
-        auto mapsPath =
-            std::filesystem::path{"/proc"} / std::to_string(pid) / "maps";
-        auto exePath =
-            std::filesystem::path{"/proc"} / std::to_string(pid) / "exe";
-
-        if (!std::filesystem::exists(mapsPath)) {
-            return std::unexpected(
-                Error{.message = std::format("Maps file {} does not exist",
-                                             mapsPath.string()),
-                      .code = std::make_error_code(
-                          std::errc::no_such_file_or_directory)});
+        auto text = readMapsText(pid);
+        if (!text) {
+            return std::unexpected(text.error());
         }
+        return parseMaps(*text, exeNameOf(pid), level);
+    }
 
-        std::ifstream mapsFile{mapsPath};
-        if (!mapsFile) {
+    /**
+     * @brief Raw contents of /proc/<pid>/maps
+     *
+     * Two reads of identical text describe identical mappings, which makes
+     * the text itself a cheap cache key.
+     */
+    [[nodiscard]] static auto readMapsText(pid_t pid)
+        -> std::expected<std::string, Error> {
+        const std::string PATH = std::format("/proc/{}/maps", pid);
+        const int FD = ::open(PATH.c_str(), O_RDONLY | O_CLOEXEC);
+        if (FD < 0) {
+            const int ERR = errno;
             return std::unexpected(Error{
-                .message = std::format("Failed to open maps file {}",
-                                       mapsPath.string()),
-                .code = std::make_error_code(std::errc::permission_denied)});
+                .message = ERR == ENOENT
+                               ? std::format("Maps file {} does not exist", PATH)
+                               : std::format("Failed to open maps file {}: {}",
+                                             PATH, std::strerror(ERR)),
+                .code = std::error_code(ERR, std::generic_category())});
         }
 
-        std::string exeName;
-        if (std::filesystem::exists(exePath)) {
-            try {
-                exeName = std::filesystem::read_symlink(exePath).string();
-            } catch (const std::filesystem::filesystem_error&) {
-                // Ignore errors reading exe symlink
+        constexpr std::size_t INITIAL_BYTES = 64 * 1024;
+        std::string text(INITIAL_BYTES, '\0');
+        std::size_t used = 0;
+        while (true) {
+            if (used == text.size()) {
+                text.resize(text.size() * 2);
+            }
+            const ssize_t GOT = ::read(FD, text.data() + used, text.size() - used);
+            if (GOT < 0 && errno == EINTR) {
+                continue;
+            }
+            if (GOT < 0) {
+                const int ERR = errno;
+                ::close(FD);
+                return std::unexpected(Error{
+                    .message = std::format("Failed to read maps file {}: {}",
+                                           PATH, std::strerror(ERR)),
+                    .code = std::error_code(ERR, std::generic_category())});
             }
+            if (GOT == 0) {
+                break;
+            }
+            used += static_cast<std::size_t>(GOT);
         }
+        ::close(FD);
+        text.resize(used);
+        return text;
+    }
 
-        std::vector<Region> regions;
-        std::string line;
-
-        unsigned int codeRegions = 0;
-        unsigned int exeRegions = 0;
-        unsigned long prevEnd = 0;
-        unsigned long loadAddr = 0;
-        unsigned long exeLoad = 0;
-        bool isExe = false;
-        std::string binName;
+    /** @brief Target of /proc/<pid>/exe, or empty if unreadable */
+    [[nodiscard]] static auto exeNameOf(pid_t pid) -> std::string {
+        const std::string PATH = std::format("/proc/{}/exe", pid);
+        std::array<char, PATH_MAX> buffer{};
+        const ssize_t LEN = ::readlink(PATH.c_str(), buffer.data(), buffer.size());
+        if (LEN <= 0) {
+            return {};
+        }
+        return {buffer.data(), static_cast<std::size_t>(LEN)};
+    }
 
-        while (std::getline(mapsFile, line)) {
-            if (auto parsed = parseMapLine(line, exeName, codeRegions,
-                                           exeRegions, prevEnd, loadAddr,
-                                           exeLoad, isExe, binName, level)) {
-                parsed->id = regions.size();
-                regions.push_back(std::move(*parsed));
+    /** @brief Parse maps text; region ids are indices into the result */
+    [[nodiscard]] static auto parseMaps(std::string_view text,
+                                        const std::string& exeName,
+                                        RegionScanLevel level)
+        -> std::vector<Region> {
+        std::vector<Region> regions;
+        ParseState state;
+        while (!text.empty()) {
+            const auto NEWLINE = text.find('\n');
+            const auto LINE = text.substr(0, NEWLINE);
+            text = NEWLINE == std::string_view::npos ? std::string_view{}
+                                                     : text.substr(NEWLINE + 1);
+            if (auto parsed = parseMapLine(LINE, exeName, state)) {
+                if (keepForLevel(*parsed, exeName, level)) {
+                    parsed->id = regions.size();
+                    regions.push_back(std::move(*parsed));
+                }
             }
         }
+        return regions;
+    }
 
+    /**
+     * @brief Narrow regions parsed at RegionScanLevel::ALL down to level
+     *
+     * Equivalent to parsing again at level; ids are renumbered.
+     */
+    [[nodiscard]] static auto selectLevel(const std::vector<Region>& all,
+                                          const std::string& exeName,
+                                          RegionScanLevel level)
+        -> std::vector<Region> {
+        std::vector<Region> regions;
+        regions.reserve(all.size());
+        for (const auto& region : all) {
+            if (keepForLevel(region, exeName, level)) {
+                regions.push_back(region);
+                regions.back().id = regions.size() - 1;
+            }
+        }
         return regions;
     }
 
@@ -168,12 +236,15 @@ class MapsReader {
     [[nodiscard]] static auto parseMapsFromStream(
         std::istream& stream, const std::string& exeName,
         RegionScanLevel level = RegionScanLevel::ALL) -> std::vector<Region> {
-        std::vector<Region> regions;
-        std::string line;
-        std::string exeNameStr;
-        if (!exeName.empty()) {
-            exeNameStr = exeName;
-        }
+        const std::string TEXT{std::istreambuf_iterator<char>{stream},
+                               std::istreambuf_iterator<char>{}};
+        return parseMaps(TEXT, exeName, level);
+    }
+#endif
+
+   private:
+    // Code/exe detection state carried from line to line
+    struct ParseState {
         unsigned int codeRegions = 0;
         unsigned int exeRegions = 0;
         unsigned long prevEnd = 0;
@@ -181,33 +252,40 @@ class MapsReader {
         unsigned long exeLoad = 0;
         bool isExe = false;
         std::string binName;
-        while (std::getline(stream, line)) {
-            if (auto parsed = parseMapLine(line, exeNameStr, codeRegions,
-                                           exeRegions, prevEnd, loadAddr,
-                                           exeLoad, isExe, binName, level)) {
-                parsed->id = regions.size();
-                regions.push_back(std::move(*parsed));
-            }
+    };
+
+    // Split off the next blank-separated field
+    static auto nextField(std::string_view& line) -> std::string_view {
+        const auto BEGIN = line.find_first_not_of(" \t");
+        if (BEGIN == std::string_view::npos) {
+            line = {};
+            return {};
         }
-        return regions;
+        line.remove_prefix(BEGIN);
+        const auto END = line.find_first_of(" \t");
+        const auto FIELD = line.substr(0, END);
+        line = END == std::string_view::npos ? std::string_view{}
+                                             : line.substr(END);
+        return FIELD;
     }
-#endif
 
-   private:
-    static void parseFilenameFromLine(const std::string& line,
-                                      std::string& filename) {
-        auto spacePos = line.find_last_of(' ');
-        if (spacePos != std::string::npos && spacePos + 1 < line.size()) {
-            filename = line.substr(spacePos + 1);
+    static auto parseNumber(std::string_view text, int base)
+        -> std::optional<unsigned long> {
+        unsigned long value = 0;
+        const auto* end = text.data() + text.size();
+        auto [ptr, ec] = std::from_chars(text.data(), end, value, base);
+        if (text.empty() || ec != std::errc{} || ptr != end) {
+            return std::nullopt;
         }
+        return value;
     }
 
-    static void updateRegionState(
-        unsigned long start, unsigned long end, char exec,
-        const std::string& filename, const std::string& exeName,
-        unsigned int& codeRegions, unsigned int& exeRegions,
-        unsigned long& prevEnd, unsigned long& loadAddr, unsigned long& exeLoad,
-        bool& isExe, std::string& binName) {
+    static void updateRegionState(unsigned long start, unsigned long end,
+                                  char exec, const std::string& filename,
+                                  const std::string& exeName,
+                                  ParseState& state) {
+        auto& [codeRegions, exeRegions, prevEnd, loadAddr, exeLoad, isExe,
+               binName] = state;
         if (codeRegions > 0) {
             if (exec == 'x' ||
                 (filename != binName &&
@@ -289,81 +367,75 @@ class MapsReader {
         return false;
     }
 
-    static auto parseMapLine(const std::string& line,
-                             const std::string& exeName,
-                             unsigned int& codeRegions,
-                             unsigned int& exeRegions, unsigned long& prevEnd,
-                             unsigned long& loadAddr, unsigned long& exeLoad,
-                             bool& isExe, std::string& binName,
-                             RegionScanLevel level) -> std::optional<Region> {
-        unsigned long start = 0;
-        unsigned long end = 0;
-        char read = 0;
-        char write = 0;
-        char exec = 0;
-        char cow = 0;
-        int offset = 0;
-        int devMajor = 0;
-        int devMinor = 0;
-        int inode = 0;
-        std::string fnameBuf;
-
-        std::istringstream iss(line);
-        iss >> std::hex >> start;
-        iss.ignore(1, '-');
-        iss >> std::hex >> end;
-        iss >> read >> write >> exec >> cow;
-        iss >> std::hex >> offset;
-        iss >> devMajor;
-        iss.ignore(1, ':');
-        iss >> devMinor;
-        iss >> inode;
-        iss >> fnameBuf;
-
-        if (iss.fail()) {
-            return std::nullopt;
+    static auto keepForLevel(const Region& region, const std::string& exeName,
+                             RegionScanLevel level) -> bool {
+        if (!regionUsefulForLevel(region.type, region.filename, exeName,
+                                  level)) {
+            return false;
         }
+        // Skip non-writable regions for non-ALL scan levels
+        return level == RegionScanLevel::ALL || region.isWritable();
+    }
 
-        std::string filename = fnameBuf;
-
-        // Read the actual filename from the line (override if present)
-        parseFilenameFromLine(line, filename);
-
-        // Update code/exe detection state
-        updateRegionState(start, end, exec, filename, exeName, codeRegions,
-                          exeRegions, prevEnd, loadAddr, exeLoad, isExe,
-                          binName);
-
-        // Must have read permissions and non-zero size
-        if (read != 'r' || (end - start) == 0) {
+    /**
+     * @brief Parse one "start-end perms offset dev inode [path]" line
+     *
+     * Anonymous mappings have no path. The path is the rest of the line,
+     * so names with spaces and " (deleted)" suffixes survive.
+     */
+    static auto parseMapLine(std::string_view line, const std::string& exeName,
+                             ParseState& state) -> std::optional<Region> {
+        const auto RANGE = nextField(line);
+        const auto PERMS = nextField(line);
+        const auto OFFSET = nextField(line);
+        const auto DEVICE = nextField(line);
+        const auto INODE = nextField(line);
+        const auto DASH = RANGE.find('-');
+        if (DASH == std::string_view::npos || PERMS.size() < 4 ||
+            !parseNumber(OFFSET, 16) || DEVICE.find(':') == std::string_view::npos ||
+            !parseNumber(INODE, 10)) {
             return std::nullopt;
         }
-
-        // Determine region type
-        RegionType type = determineRegionType(isExe, codeRegions, filename);
-
-        // Check if region is useful based on scan level
-        if (!regionUsefulForLevel(type, filename, exeName, level)) {
+        const auto START = parseNumber(RANGE.substr(0, DASH), 16);
+        const auto END = parseNumber(RANGE.substr(DASH + 1), 16);
+        if (!START || !END || *END < *START) {
             return std::nullopt;
         }
+        const auto PATH_BEGIN = line.find_first_not_of(" \t");
+        std::string filename =
+            PATH_BEGIN == std::string_view::npos
+                ? std::string{}
+                : std::string{line.substr(PATH_BEGIN)};
+        while (!filename.empty() &&
+               (filename.back() == ' ' || filename.back() == '\r')) {
+            filename.pop_back();
+        }
+        const char READ = PERMS[0];
+        const char WRITE = PERMS[1];
+        const char EXEC = PERMS[2];
+        const char COW = PERMS[3];
 
-        // Skip non-writable regions for non-ALL scan levels
-        if (level != RegionScanLevel::ALL && write != 'w') {
+        // Update code/exe detection state
+        updateRegionState(*START, *END, EXEC, filename, exeName, state);
+
+        // Must have read permissions and non-zero size
+        if (READ != 'r' || *END == *START) {
             return std::nullopt;
         }
 
         Region result;
-        result.start = std::bit_cast<void*>(start);
-        result.size = end - start;
-        result.type = type;
-        result.loadAddr = std::bit_cast<void*>(loadAddr);
-        result.filename = filename;
+        result.start = std::bit_cast<void*>(*START);
+        result.size = *END - *START;
+        result.type =
+            determineRegionType(state.isExe, state.codeRegions, filename);
+        result.loadAddr = std::bit_cast<void*>(state.loadAddr);
+        result.filename = std::move(filename);
 
         result.flags.read = true;
-        result.flags.write = (write == 'w');
-        result.flags.exec = (exec == 'x');
-        result.flags.shared = (cow == 's');
-        result.flags.exclusive = (cow == 'p');
+        result.flags.write = (WRITE == 'w');
+        result.flags.exec = (EXEC == 'x');
+        result.flags.shared = (COW == 's');
+        result.flags.exclusive = (COW == 'p');
 
         return result;
     }
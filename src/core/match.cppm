@@ -5,10 +5,14 @@
 
 module;
 
-#include <bit>
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 export module core.match;
@@ -17,7 +21,7 @@ import core.region_classifier;
 import core.region_filter;
 import value.flags;
 import scan.types;         // for ScanDataType, bytesNeededForType
-import scan.match_storage; // for MatchesAndOldValuesSwath, OldValueAndMatchInfo
+import scan.match_storage; // for MatchesAndOldValuesArray, MatchView
 
 export namespace core {
 
@@ -38,6 +42,7 @@ struct MatchEntry {
  */
 struct MatchCollectionOptions {
     size_t limit = 100;         // 收集的最大匹配数
+    size_t offset = 0;          // 跳过的匹配数 (过滤后计数)
     bool collectRegion = true;  // 是否收集区域信息
     RegionFilterConfig
         regionFilter;  // Region filtering for export-time filtering
@@ -48,6 +53,160 @@ struct MatchSource {
     std::optional<ScanDataType> dataType;
 };
 
+/**
+ * @struct MatchRow
+ * @brief One match as a lightweight view, valid until the matches change
+ */
+struct MatchRow {
+    size_t index{0};                    // 匹配索引 (全局, 过滤前)
+    std::uintptr_t address{0};          // 内存地址
+    std::span<const std::uint8_t> value;  // 旧值字节, 可能短于 width
+    size_t width{0};                    // 值应有的字节数
+    RegionClassifier::RegionId region{RegionClassifier::NO_REGION};
+};
+
+/**
+ * @class MatchCursor
+ * @brief Resumable pager over the current matches
+ *
+ * Without an export-time filter, seek() is a rank-index lookup and a
+ * page costs only its own rows; the total comes from the rank index too.
+ * With a filter, positions count filtered matches, so seeking walks from
+ * the start and total() walks everything once (then it is cached).
+ */
+class MatchCursor {
+   public:
+    MatchCursor(MatchSource source,
+                std::shared_ptr<const RegionClassifier> classifier,
+                RegionFilterConfig regionFilter = {})
+        : m_source(source),
+          m_classifier(std::move(classifier)),
+          m_regionFilter(std::move(regionFilter)),
+          m_filtering(m_regionFilter.isExportTimeFilter() &&
+                      m_regionFilter.filter.isActive() && m_classifier) {
+        if (source.dataType) {
+            m_valueSize = bytesNeededForType(*source.dataType);
+            m_textual = *source.dataType == ScanDataType::STRING ||
+                        *source.dataType == ScanDataType::BYTE_ARRAY ||
+                        *source.dataType == ScanDataType::GROUP;
+        }
+    }
+
+    /** @brief Continue from the offset-th (filtered) match */
+    void seek(size_t offset) {
+        m_position = offset;
+        m_next = 0;
+        if (!m_filtering || offset == 0 || m_source.matches == nullptr) {
+            m_next = offset;
+            return;
+        }
+        // Global index of the offset-th match that passes the filter
+        size_t passed = 0;
+        size_t global = 0;
+        bool found = false;
+        m_source.matches->forEachMatchFrom(
+            0, [&](const scan::MatchView& match) {
+                if (passes(match.address) && passed++ == offset) {
+                    found = true;
+                    return false;
+                }
+                ++global;
+                return true;
+            });
+        m_next = found ? global : std::numeric_limits<size_t>::max();
+    }
+
+    /** @brief Up to limit rows from the current position on */
+    [[nodiscard]] auto next(size_t limit) -> std::vector<MatchRow> {
+        std::vector<MatchRow> rows;
+        if (m_source.matches == nullptr || limit == 0 ||
+            m_next == std::numeric_limits<size_t>::max()) {
+            return rows;
+        }
+        rows.reserve(std::min<size_t>(limit, 4096));
+        size_t global = m_next;
+        bool more = false;
+        m_source.matches->forEachMatchFrom(
+            m_next, [&](const scan::MatchView& match) {
+                if (rows.size() == limit) {
+                    more = true;
+                    return false;
+                }
+                if (!m_filtering || passes(match.address)) {
+                    rows.push_back(makeRow(global, match));
+                }
+                ++global;
+                return true;
+            });
+        m_position += rows.size();
+        m_next = more ? global : std::numeric_limits<size_t>::max();
+        return rows;
+    }
+
+    /** @brief Position of the next row among (filtered) matches */
+    [[nodiscard]] auto position() const noexcept -> size_t {
+        return m_position;
+    }
+
+    /** @brief Number of (filtered) matches */
+    [[nodiscard]] auto total() const -> size_t {
+        if (m_source.matches == nullptr) {
+            return 0;
+        }
+        if (!m_filtering) {
+            return m_source.matches->indexedMatchCount();
+        }
+        if (!m_filteredTotal) {
+            size_t count = 0;
+            m_source.matches->forEachMatch([&](const scan::MatchView& match) {
+                count += passes(match.address) ? 1 : 0;
+            });
+            m_filteredTotal = count;
+        }
+        return *m_filteredTotal;
+    }
+
+    /** @brief Region text of a row ("unk" without a classifier) */
+    [[nodiscard]] auto regionLabel(const MatchRow& row) const
+        -> const std::string& {
+        static const std::string UNKNOWN = "unk";
+        return m_classifier ? m_classifier->label(row.region) : UNKNOWN;
+    }
+
+    /** @brief Bytes a row's value should be shown with */
+    [[nodiscard]] auto valueSize(const scan::MatchInfo& info) const noexcept
+        -> size_t {
+        return m_textual && info.length > 0 ? info.length : m_valueSize;
+    }
+
+   private:
+    [[nodiscard]] auto passes(std::uintptr_t address) const -> bool {
+        return m_regionFilter.filter.isAddressAllowed(address, *m_classifier);
+    }
+
+    [[nodiscard]] auto makeRow(size_t global,
+                               const scan::MatchView& match) const -> MatchRow {
+        const size_t WIDTH = valueSize(match.info);
+        return {.index = global,
+                .address = match.address,
+                .value = match.oldBytes.first(
+                    std::min(WIDTH, match.oldBytes.size())),
+                .width = WIDTH,
+                .region = m_classifier ? m_classifier->regionId(match.address)
+                                       : RegionClassifier::NO_REGION};
+    }
+
+    MatchSource m_source;
+    std::shared_ptr<const RegionClassifier> m_classifier;
+    RegionFilterConfig m_regionFilter;
+    bool m_filtering;
+    size_t m_valueSize{1};
+    bool m_textual{false};
+    size_t m_position{0};
+    size_t m_next{0};  // global index to resume at; max() when done
+    mutable std::optional<size_t> m_filteredTotal;
+};
+
 /**
  * @class MatchCollector
  * @brief Collects match entries from scanner results
@@ -60,8 +219,28 @@ class MatchCollector {
      */
     explicit MatchCollector(
         std::optional<RegionClassifier> classifier = std::nullopt)
+        : m_classifier(classifier ? std::make_shared<const RegionClassifier>(
+                                        std::move(*classifier))
+                                  : nullptr) {}
+
+    /**
+     * @brief Create collector sharing a cached classifier
+     * @param classifier Classifier to use; may be null
+     */
+    explicit MatchCollector(std::shared_ptr<const RegionClassifier> classifier)
         : m_classifier(std::move(classifier)) {}
 
+    /** @brief Cursor over source using this collector's classifier */
+    [[nodiscard]] auto cursor(const MatchSource& source,
+                              const MatchCollectionOptions& options = {}) const
+        -> MatchCursor {
+        MatchCursor cursor{source,
+                           options.collectRegion ? m_classifier : nullptr,
+                           options.regionFilter};
+        cursor.seek(options.offset);
+        return cursor;
+    }
+
     /**
      * @brief Collect match entries from scanner
      * @param scanner Scanner with match results
@@ -72,109 +251,35 @@ class MatchCollector {
      * the global index (position among ALL matches), not the filtered index.
      * This ensures indices remain stable regardless of filtering.
      */
-    // NOLINTNEXTLINE
     [[nodiscard]] auto collect(const MatchSource& source,
                                const MatchCollectionOptions& options = {}) const
         -> std::pair<std::vector<MatchEntry>, size_t> {
         if (source.matches == nullptr) {
             return {{}, 0};
         }
-        const auto& matches = *source.matches;
-        auto dataType = source.dataType;
-        size_t valueSize = dataType ? bytesNeededForType(*dataType) : 1;
-
-        size_t globalIndex = 0;
-        size_t displayCount = 0;
-        size_t totalCount = 0;
-        size_t filteredCount = 0;
+        // The filter needs the classifier even when regions are not shown
+        MatchCursor pager{source, m_classifier, options.regionFilter};
+        pager.seek(options.offset);
+        const auto ROWS = pager.next(options.limit);
 
         std::vector<MatchEntry> entries;
-        entries.reserve(options.limit);
-
-        bool useExportFilter = options.regionFilter.isExportTimeFilter() &&
-                               options.regionFilter.filter.isActive();
-
-        for (const auto& swath : matches.swaths) {
-            auto* base = static_cast<std::uint8_t*>(swath.firstByteInChild);
-            if (base == nullptr) {
-                continue;
-            }
-
-            for (size_t i = 0; i < swath.data.size(); ++i) {
-                const auto& cell = swath.data[i];
-                if (cell.matchInfo == MatchFlags::EMPTY) {
-                    continue;
-                }
-
-                totalCount++;
-                auto addr = std::bit_cast<std::uintptr_t>(base + i);
-
-                bool passesFilter = true;
-                if (useExportFilter && m_classifier) {
-                    passesFilter = options.regionFilter.filter.isAddressAllowed(
-                        addr, *m_classifier);
-                }
-
-                if (passesFilter) {
-                    filteredCount++;
-
-                    if (displayCount < options.limit) {
-                        size_t actualSize =
-                            getActualValueSize(cell, valueSize, dataType);
-                        auto valueBytes =
-                            extractValueBytes(swath, i, actualSize);
-                        std::string region =
-                            getClassifiedRegion(addr, options.collectRegion);
-
-                        entries.push_back(
-                            MatchEntry{.index = globalIndex,
-                                       .address = addr,
-                                       .value = std::move(valueBytes),
-                                       .region = std::move(region)});
-                        displayCount++;
-                    }
-                }
-                globalIndex++;
-            }
+        entries.reserve(ROWS.size());
+        for (const auto& row : ROWS) {
+            std::vector<std::uint8_t> value(row.width);
+            std::ranges::copy(row.value, value.begin());
+            entries.push_back(
+                MatchEntry{.index = row.index,
+                           .address = row.address,
+                           .value = std::move(value),
+                           .region = options.collectRegion
+                                         ? pager.regionLabel(row)
+                                         : std::string{"unk"}});
         }
-
-        size_t effectiveTotal = useExportFilter ? filteredCount : totalCount;
-        return {entries, effectiveTotal};
+        return {std::move(entries), pager.total()};
     }
 
    private:
-    [[nodiscard]] static auto getActualValueSize(
-        const scan::OldValueAndMatchInfo& cell, size_t defaultValueSize,
-        std::optional<ScanDataType> dataType) -> size_t {
-        if (dataType && (*dataType == ScanDataType::STRING ||
-                         *dataType == ScanDataType::BYTE_ARRAY)) {
-            if (cell.matchLength > 0) {
-                return cell.matchLength;
-            }
-        }
-        return defaultValueSize;
-    }
-
-    [[nodiscard]] static auto extractValueBytes(
-        const scan::MatchesAndOldValuesSwath& swath, size_t startIndex,
-        size_t count) -> std::vector<std::uint8_t> {
-        std::vector<std::uint8_t> bytes(count);
-        for (size_t j = 0; j < count && (startIndex + j) < swath.data.size();
-             ++j) {
-            bytes[j] = swath.data[startIndex + j].oldByte;
-        }
-        return bytes;
-    }
-
-    [[nodiscard]] auto getClassifiedRegion(std::uintptr_t addr,
-                                           bool collectRegion) const
-        -> std::string {
-        if (m_classifier && collectRegion) {
-            return m_classifier->classify(addr);
-        }
-        return "unk";
-    }
-    std::optional<RegionClassifier> m_classifier;
+    std::shared_ptr<const RegionClassifier> m_classifier;
 };
 
 }  // namespace core
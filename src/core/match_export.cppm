@@ -0,0 +1,326 @@
+/**
+ * @file match_export.cppm
+ * @brief Streaming export of matches to a file or pipe (匹配导出)
+ *
+ * Rows come straight from a MatchCursor, a block at a time, so memory
+ * stays bounded by one block whatever the match count.
+ *
+ * CSV: "index,address,region,value" with the value as hex bytes, written
+ * through one large buffer.
+ *
+ * Binary, host byte order:
+ *   ExportFileHeader
+ *   region label table: per region u32 length, then the label bytes
+ *   blocks: ExportBlockHeader, then the columns
+ *     u64 index[rows], u64 address[rows], u32 region[rows],
+ *     u32 valueLength[rows], value bytes back to back
+ *   an empty block (rows == 0) ends the stream
+ * Region columns index the label table; NO_REGION means unknown. Each
+ * block goes out as a single writev of its columns.
+ */
+
+module;
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module core.match_export;
+
+import core.match;
+import core.region_classifier;
+import core.region_filter;
+import scan.snapshot_file;  // detail::writeAll
+import scan.types;
+
+export namespace core {
+
+enum class ExportFormat { CSV, BINARY };
+
+constexpr std::array<char, 8> EXPORT_MAGIC = {'S', 'C', 'A', 'N',
+                                              'E', 'X', 'P', 'T'};
+constexpr std::uint32_t EXPORT_VERSION = 1;
+
+/** @brief Fixed header of a binary export */
+struct ExportFileHeader {
+    std::array<char, 8> magic{EXPORT_MAGIC};
+    std::uint32_t version{EXPORT_VERSION};
+    std::uint32_t headerSize{sizeof(ExportFileHeader)};
+    std::uint32_t regionCount{0};
+    std::uint8_t hasDataType{0};
+    std::uint8_t dataType{0};  ///< ScanDataType when hasDataType
+    std::array<std::uint8_t, 2> reserved{};
+};
+
+/** @brief Precedes each block of a binary export */
+struct ExportBlockHeader {
+    std::uint32_t rows{0};
+    std::uint32_t valueBytes{0};  ///< Size of the value byte column
+};
+
+struct ExportStats {
+    std::size_t rows{0};
+    std::size_t bytes{0};  ///< Bytes written
+};
+
+/**
+ * @class MatchExporter
+ * @brief Writes all (filtered) matches in CSV or binary form
+ */
+class MatchExporter {
+   public:
+    static constexpr std::size_t BLOCK_ROWS = 64 * 1024;
+    static constexpr std::size_t CSV_BUFFER = 1 << 20;
+
+    MatchExporter(MatchSource source,
+                  std::shared_ptr<const RegionClassifier> classifier,
+                  RegionFilterConfig regionFilter = {})
+        : m_source(source),
+          m_classifier(std::move(classifier)),
+          m_regionFilter(std::move(regionFilter)) {}
+
+    /** @brief Export to an open descriptor, which stays open */
+    [[nodiscard]] auto write(int fd, ExportFormat format) const
+        -> std::expected<ExportStats, std::string> {
+        MatchCursor cursor{m_source, m_classifier, m_regionFilter};
+        return format == ExportFormat::CSV ? writeCsv(fd, cursor)
+                                           : writeBinary(fd, cursor);
+    }
+
+    /** @brief Export to path, created or truncated; "-" is stdout */
+    [[nodiscard]] auto writeFile(const std::string& path,
+                                 ExportFormat format) const
+        -> std::expected<ExportStats, std::string> {
+        if (path == "-") {
+            return write(STDOUT_FILENO, format);
+        }
+        const int FD =
+            ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (FD < 0) {
+            return std::unexpected{std::format("open {} failed: {}", path,
+                                               std::strerror(errno))};
+        }
+        auto stats = write(FD, format);
+        if (::close(FD) != 0 && stats) {
+            return std::unexpected{std::format("close {} failed: {}", path,
+                                               std::strerror(errno))};
+        }
+        if (!stats) {
+            return std::unexpected{std::format("{}: {}", path, stats.error())};
+        }
+        return stats;
+    }
+
+   private:
+    // CSV field for each region id, quoted when the label needs it
+    [[nodiscard]] auto csvLabels() const -> std::vector<std::string> {
+        std::vector<std::string> labels;
+        const std::size_t COUNT = m_classifier ? m_classifier->size() : 0;
+        labels.reserve(COUNT + 1);
+        for (std::size_t id = 0; id <= COUNT; ++id) {
+            const std::string& label =
+                id < COUNT ? m_classifier->label(
+                                 static_cast<RegionClassifier::RegionId>(id))
+                           : std::string{"unk"};
+            if (label.find_first_of(",\"\n") == std::string::npos) {
+                labels.push_back(label);
+                continue;
+            }
+            std::string quoted = "\"";
+            for (char chr : label) {
+                quoted += chr;
+                if (chr == '"') {
+                    quoted += '"';
+                }
+            }
+            labels.push_back(quoted + '"');
+        }
+        return labels;
+    }
+
+    [[nodiscard]] auto writeCsv(int fd, MatchCursor& cursor) const
+        -> std::expected<ExportStats, std::string> {
+        static constexpr std::string_view HEADER = "index,address,region,value\n";
+        static constexpr std::string_view HEX = "0123456789abcdef";
+        const auto LABELS = csvLabels();
+        ExportStats stats;
+        std::vector<char> buffer(CSV_BUFFER);
+        std::size_t used = 0;
+
+        auto flush = [&]() -> std::expected<void, std::string> {
+            if (auto err = scan::detail::writeAll(fd, buffer.data(), used); !err) {
+                return err;
+            }
+            stats.bytes += used;
+            used = 0;
+            return {};
+        };
+
+        std::memcpy(buffer.data(), HEADER.data(), HEADER.size());
+        used = HEADER.size();
+        while (true) {
+            const auto ROWS = cursor.next(BLOCK_ROWS);
+            if (ROWS.empty()) {
+                break;
+            }
+            for (const auto& row : ROWS) {
+                const auto& label =
+                    row.region < LABELS.size() - 1 ? LABELS[row.region]
+                                                   : LABELS.back();
+                // index, "0x" + 16 digits, label, value hex, separators
+                const std::size_t NEED =
+                    20 + 18 + label.size() + row.value.size() * 2 + 4;
+                if (buffer.size() - used < NEED) {
+                    if (auto err = flush(); !err) {
+                        return std::unexpected{err.error()};
+                    }
+                    if (buffer.size() < NEED) {
+                        buffer.resize(NEED);
+                    }
+                }
+                char* out = buffer.data() + used;
+                out = std::to_chars(out, out + 20, row.index).ptr;
+                *out++ = ',';
+                *out++ = '0';
+                *out++ = 'x';
+                for (int shift = 60; shift >= 0; shift -= 4) {
+                    *out++ = HEX[(row.address >> shift) & 0xF];
+                }
+                *out++ = ',';
+                out = std::ranges::copy(label, out).out;
+                *out++ = ',';
+                for (auto byte : row.value) {
+                    *out++ = HEX[byte >> 4];
+                    *out++ = HEX[byte & 0xF];
+                }
+                *out++ = '\n';
+                used = static_cast<std::size_t>(out - buffer.data());
+            }
+            stats.rows += ROWS.size();
+        }
+        if (auto err = flush(); !err) {
+            return std::unexpected{err.error()};
+        }
+        return stats;
+    }
+
+    [[nodiscard]] auto writeBinary(int fd, MatchCursor& cursor) const
+        -> std::expected<ExportStats, std::string> {
+        ExportStats stats;
+        // Header and label table are small; build them in one go
+        std::vector<std::uint8_t> head(sizeof(ExportFileHeader));
+        ExportFileHeader header;
+        header.regionCount = static_cast<std::uint32_t>(
+            m_classifier ? m_classifier->size() : 0);
+        header.hasDataType = m_source.dataType ? 1 : 0;
+        header.dataType = m_source.dataType
+                              ? static_cast<std::uint8_t>(*m_source.dataType)
+                              : 0;
+        std::memcpy(head.data(), &header, sizeof(header));
+        for (std::uint32_t id = 0; id < header.regionCount; ++id) {
+            const auto& label = m_classifier->label(id);
+            const auto LENGTH = static_cast<std::uint32_t>(label.size());
+            const auto* lengthBytes = reinterpret_cast<const std::uint8_t*>(&LENGTH);
+            head.insert(head.end(), lengthBytes, lengthBytes + sizeof(LENGTH));
+            head.insert(head.end(), label.begin(), label.end());
+        }
+        if (auto err = scan::detail::writeAll(fd, head.data(), head.size());
+            !err) {
+            return std::unexpected{err.error()};
+        }
+        stats.bytes += head.size();
+
+        std::vector<std::uint64_t> indices;
+        std::vector<std::uint64_t> addresses;
+        std::vector<std::uint32_t> regions;
+        std::vector<std::uint32_t> lengths;
+        std::vector<std::uint8_t> values;
+        while (true) {
+            const auto ROWS = cursor.next(BLOCK_ROWS);
+            indices.clear();
+            addresses.clear();
+            regions.clear();
+            lengths.clear();
+            values.clear();
+            for (const auto& row : ROWS) {
+                indices.push_back(row.index);
+                addresses.push_back(row.address);
+                regions.push_back(row.region);
+                lengths.push_back(static_cast<std::uint32_t>(row.value.size()));
+                values.insert(values.end(), row.value.begin(), row.value.end());
+            }
+            const ExportBlockHeader BLOCK{
+                .rows = static_cast<std::uint32_t>(ROWS.size()),
+                .valueBytes = static_cast<std::uint32_t>(values.size())};
+            std::array<iovec, 6> iov{{
+                {const_cast<ExportBlockHeader*>(&BLOCK), sizeof(BLOCK)},
+                {indices.data(), indices.size() * sizeof(std::uint64_t)},
+                {addresses.data(), addresses.size() * sizeof(std::uint64_t)},
+                {regions.data(), regions.size() * sizeof(std::uint32_t)},
+                {lengths.data(), lengths.size() * sizeof(std::uint32_t)},
+                {values.data(), values.size()},
+            }};
+            auto written = writevAll(fd, iov);
+            if (!written) {
+                return std::unexpected{written.error()};
+            }
+            stats.bytes += *written;
+            stats.rows += ROWS.size();
+            if (ROWS.empty()) {
+                return stats;
+            }
+        }
+    }
+
+    // writev until every iovec is out; advances iov in place
+    [[nodiscard]] static auto writevAll(int fd, std::span<iovec> iov)
+        -> std::expected<std::size_t, std::string> {
+        std::size_t total = 0;
+        while (!iov.empty()) {
+            const ssize_t DONE =
+                ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+            if (DONE < 0 && errno == EINTR) {
+                continue;
+            }
+            if (DONE < 0) {
+                return std::unexpected{
+                    std::format("write failed: {}", std::strerror(errno))};
+            }
+            total += static_cast<std::size_t>(DONE);
+            auto left = static_cast<std::size_t>(DONE);
+            while (!iov.empty() && left >= iov.front().iov_len) {
+                left -= iov.front().iov_len;
+                iov = iov.subspan(1);
+            }
+            if (!iov.empty()) {
+                iov.front().iov_base =
+                    static_cast<std::uint8_t*>(iov.front().iov_base) + left;
+                iov.front().iov_len -= left;
+            }
+        }
+        return total;
+    }
+
+    MatchSource m_source;
+    std::shared_ptr<const RegionClassifier> m_classifier;
+    RegionFilterConfig m_regionFilter;
+};
+
+}  // namespace core
@@ -11,9 +11,12 @@ module;
 #include <cstdint>
 #include <expected>
 #include <format>
+#include <numeric>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <string>
+#include <tuple>
 #include <vector>
 
 export module core.memory_writer;
@@ -72,11 +75,14 @@ export class MemoryWriter {
     }
 
     /**
-     * @brief Write value to a single matched address
+     * @brief Write value to matched addresses
      * @param scanner Scanner instance with matches
      * @param value Value to write
      * @param matchIndex  Vector: Index of the match to write to
      * @return Expected WriteResult or error string
+     *
+     * All indices are resolved in one walk over the matches and written
+     * through one /proc/<pid>/mem handle with vectored writes.
      */
     [[nodiscard]] auto writeToMatch(const Scanner& scanner,
                                     const UserValue& value,
@@ -94,48 +100,59 @@ export class MemoryWriter {
             return std::unexpected("empty write value");
         }
 
-        const auto& matches = scanner.getMatches();
         VecWriteResult summary{
             .successCount = 0,
             .failedCount = 0,
             .results = {},
             .errors = {},
         };
-
         summary.results.reserve(matchIndex.size());
 
-        for (const auto index : matchIndex) {
-            auto addressExp = resolveMatchAddress(matches, index);
-            if (!addressExp) {
+        const auto ADDRESSES =
+            resolveMatchAddresses(scanner.getMatches(), matchIndex);
+        std::vector<WriteRange> ranges;
+        std::vector<std::size_t> rangeIndex;  // position in matchIndex
+        ranges.reserve(matchIndex.size());
+        for (std::size_t i = 0; i < matchIndex.size(); ++i) {
+            if (!ADDRESSES[i]) {
                 summary.failedCount++;
-                summary.errors.push_back(addressExp.error());
+                summary.errors.push_back(std::format(
+                    "match index {} out of range", matchIndex[i]));
                 continue;
             }
+            ranges.push_back({.addr = std::bit_cast<void*>(*ADDRESSES[i]),
+                              .bytes = bytesToWrite});
+            rangeIndex.push_back(i);
+        }
 
-            const auto address = *addressExp;
-            auto writeExp =
-                core::writeBytes(m_pid, std::bit_cast<void*>(address), bytesToWrite);
-            if (!writeExp || *writeExp != bytesToWrite.size()) {
-                summary.failedCount++;
-                summary.errors.push_back(
-                    !writeExp
-                        ? std::format("match #{} write failed: {}", index,
-                                      writeExp.error())
-                        : std::format(
-                              "match #{} partial write: expected {} bytes, wrote {}",
-                              index, bytesToWrite.size(), *writeExp));
-                summary.results.push_back(
-                    {.address = address,
-                     .bytesWritten = writeExp ? *writeExp : 0,
-                     .success = false});
-                continue;
+        if (!ranges.empty()) {
+            ProcMemIO memIO{m_pid};
+            // Without a writable fd process_vm_writev still does the bulk
+            std::ignore = memIO.open(true);
+            std::vector<std::size_t> written(ranges.size());
+            if (auto err = memIO.writeRanges(ranges, written); !err) {
+                return std::unexpected(err.error());
+            }
+            for (std::size_t k = 0; k < ranges.size(); ++k) {
+                const auto INDEX = matchIndex[rangeIndex[k]];
+                const auto ADDRESS = *ADDRESSES[rangeIndex[k]];
+                const bool OK = written[k] == bytesToWrite.size();
+                if (OK) {
+                    summary.successCount++;
+                } else {
+                    summary.failedCount++;
+                    summary.errors.push_back(
+                        written[k] == 0
+                            ? std::format("match #{} write failed", INDEX)
+                            : std::format("match #{} partial write: expected "
+                                          "{} bytes, wrote {}",
+                                          INDEX, bytesToWrite.size(),
+                                          written[k]));
+                }
+                summary.results.push_back({.address = ADDRESS,
+                                           .bytesWritten = written[k],
+                                           .success = OK});
             }
-
-            summary.successCount++;
-            summary.results.push_back(
-                {.address = address,
-                 .bytesWritten = *writeExp,
-                 .success = true});
         }
 
         if (summary.successCount == 0) {
@@ -147,7 +164,9 @@ export class MemoryWriter {
         return summary;
     }
 
-   private:
+    /**
+     * @brief Bytes written for value, in the configured byte order
+     */
     [[nodiscard]] auto encodeValueBytes(const UserValue& value) const
         -> std::vector<std::uint8_t> {
         auto bytes = value.primary.bytes;
@@ -164,30 +183,45 @@ export class MemoryWriter {
         return bytes;
     }
 
-    [[nodiscard]] static auto resolveMatchAddress(
-        const scan::MatchesAndOldValuesArray& matches, std::size_t matchIndex)
-        -> std::expected<std::uintptr_t, std::string> {
-        std::size_t currentIndex = 0;
-        for (const auto& swath : matches.swaths) {
-            if (swath.firstByteInChild == nullptr) {
-                continue;
-            }
-            auto* base =
-                static_cast<const std::uint8_t*>(swath.firstByteInChild);
-            for (std::size_t i = 0; i < swath.data.size(); ++i) {
-                if (swath.data[i].matchInfo == MatchFlags::EMPTY) {
-                    continue;
-                }
-                if (currentIndex == matchIndex) {
-                    return std::bit_cast<std::uintptr_t>(base + i);
+    /** @brief Up to this many indices are looked up one by one */
+    static constexpr std::size_t RANDOM_ACCESS_LIMIT = 4096;
+
+    /**
+     * @brief Addresses of the given match indices
+     *
+     * Few indices go through matchAt; more are resolved in one pass.
+     * @return One entry per index, nullopt where it is out of range
+     */
+    [[nodiscard]] static auto resolveMatchAddresses(
+        const scan::MatchesAndOldValuesArray& matches,
+        std::span<const std::size_t> matchIndex)
+        -> std::vector<std::optional<std::uintptr_t>> {
+        std::vector<std::optional<std::uintptr_t>> out(matchIndex.size());
+        // matchAt is a rank-index lookup; a walk only pays off for many
+        if (matchIndex.size() <= RANDOM_ACCESS_LIMIT) {
+            for (std::size_t i = 0; i < matchIndex.size(); ++i) {
+                if (auto match = matches.matchAt(matchIndex[i])) {
+                    out[i] = match->address;
                 }
-                currentIndex++;
             }
+            return out;
         }
-        return std::unexpected(
-            std::format("match index {} out of range", matchIndex));
+        std::vector<std::size_t> order(matchIndex.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::ranges::sort(order, {}, [&](std::size_t i) { return matchIndex[i]; });
+
+        std::size_t next = 0;
+        std::size_t current = 0;
+        matches.forEachMatch([&](const scan::MatchView& match) {
+            while (next < order.size() && matchIndex[order[next]] == current) {
+                out[order[next++]] = match.address;
+            }
+            ++current;
+        });
+        return out;
     }
 
+   private:
     pid_t m_pid;
     utils::Endianness m_endianness{(std::endian::native == std::endian::little
                                         ? utils::Endianness::LITTLE
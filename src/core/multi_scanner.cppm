@@ -0,0 +1,263 @@
+/**
+ * @file multi_scanner.cppm
+ * @brief Scan several processes in one call (多进程扫描)
+ *
+ * One Scanner per attached pid, all on one worker pool. snapshot() and
+ * filter() drive every scanner from its own thread, and the pool runs
+ * their parallel read and match phases at the same time: a worker takes
+ * tasks from the oldest pending phase and moves to the next as soon as
+ * that one has none left. The serial parts of one target's scan (maps,
+ * merging, history) run on its driver thread meanwhile. With idle cores
+ * several small targets cost about one scan; once the pool is saturated
+ * the total is the summed parallel work over the worker count.
+ */
+
+module;
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module core.multi_scanner;
+
+import core.scanner;        // Scanner, ScannerResult
+import scan.match_storage;  // MatchView
+import scan.types;          // ScanOptions
+import utils.thread_pool;   // ThreadPool, ThreadPoolOptions
+import value.core;          // UserValue
+
+export namespace core {
+
+/** @brief Result of one attached pid */
+struct PidScanResult {
+    pid_t pid{0};
+    ScannerResult result;
+};
+
+/** @brief Results of one scan or filter over every attached pid */
+struct MultiScanResult {
+    std::vector<PidScanResult> perPid;  ///< In attach order
+    std::size_t matchCount{0};          ///< Sum over the pids that succeeded
+    std::size_t failed{0};              ///< Pids whose scan failed
+};
+
+/**
+ * @class MultiScanner
+ * @brief Scanners for several targets sharing one worker pool
+ */
+class MultiScanner {
+   public:
+    MultiScanner() = default;
+    explicit MultiScanner(utils::ThreadPoolOptions threads)
+        : m_poolOptions(std::move(threads)) {}
+
+    MultiScanner(const MultiScanner&) = delete;
+    auto operator=(const MultiScanner&) -> MultiScanner& = delete;
+
+    /** @brief Add pid; false if it is invalid or already attached */
+    auto attach(pid_t pid) -> bool {
+        if (pid <= 0 || find(pid) != nullptr) {
+            return false;
+        }
+        auto scanner = std::make_unique<Scanner>(pid, pool());
+        scanner->setIncremental(m_incremental);
+        m_scanners.push_back({.pid = pid, .scanner = std::move(scanner)});
+        return true;
+    }
+
+    /** @brief Remove pid and its matches; false if it was not attached */
+    auto detach(pid_t pid) -> bool {
+        return std::erase_if(m_scanners, [&](const Entry& entry) {
+                   return entry.pid == pid;
+               }) > 0;
+    }
+
+    [[nodiscard]] auto pids() const -> std::vector<pid_t> {
+        std::vector<pid_t> out;
+        out.reserve(m_scanners.size());
+        for (const auto& entry : m_scanners) {
+            out.push_back(entry.pid);
+        }
+        return out;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_scanners.size();
+    }
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_scanners.empty();
+    }
+
+    /** @brief Scanner of an attached pid, nullptr otherwise */
+    [[nodiscard]] auto scanner(pid_t pid) -> Scanner* { return find(pid); }
+
+    /**
+     * @brief Full scan of every attached pid at once
+     * @see Scanner::snapshot
+     */
+    [[nodiscard]] auto snapshot(
+        const ScanOptions& opts,
+        const std::optional<UserValue>& value = std::nullopt,
+        bool saveToHistory = false) -> MultiScanResult {
+        return runAll([&](Scanner& scanner) {
+            return scanner.snapshot(opts, value, saveToHistory);
+        });
+    }
+
+    /**
+     * @brief Filter the matches of every attached pid at once
+     *
+     * A pid without matches reports the usual Scanner::filter error.
+     */
+    [[nodiscard]] auto filter(
+        const ScanOptions& opts,
+        const std::optional<UserValue>& value = std::nullopt,
+        bool saveToHistory = false) -> MultiScanResult {
+        return runAll([&](Scanner& scanner) {
+            return scanner.filter(opts, value, saveToHistory);
+        });
+    }
+
+    /**
+     * @brief Filter the pids that have matches, snapshot the others
+     *
+     * What 'scan' does for one target, per pid, so a pid attached after
+     * the first scan gets its own baseline.
+     */
+    [[nodiscard]] auto scan(
+        const ScanOptions& opts,
+        const std::optional<UserValue>& value = std::nullopt,
+        bool saveToHistory = false) -> MultiScanResult {
+        return runAll([&](Scanner& scanner) {
+            return scanner.hasMatches()
+                       ? scanner.filter(opts, value, saveToHistory)
+                       : scanner.snapshot(opts, value, saveToHistory);
+        });
+    }
+
+    /** @brief Whether any attached pid has matches */
+    [[nodiscard]] auto hasMatches() const -> bool {
+        return std::ranges::any_of(m_scanners, [](const Entry& entry) {
+            return entry.scanner->hasMatches();
+        });
+    }
+
+    /** @brief Matches summed over every attached pid */
+    [[nodiscard]] auto getMatchCount() const -> std::size_t {
+        std::size_t total = 0;
+        for (const auto& entry : m_scanners) {
+            total += entry.scanner->getMatchCount();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Addresses that match in every attached pid, ascending
+     *
+     * Only forks of one parent share their layout. Processes started
+     * separately get their own ASLR bases, so for them an empty result
+     * does not mean the value is missing.
+     */
+    [[nodiscard]] auto commonAddresses() const -> std::vector<std::uintptr_t> {
+        std::vector<std::uintptr_t> common;
+        bool first = true;
+        for (const auto& entry : m_scanners) {
+            std::vector<std::uintptr_t> addresses;
+            entry.scanner->getMatches().forEachMatch(
+                [&](const scan::MatchView& match) {
+                    addresses.push_back(match.address);
+                });
+            std::ranges::sort(addresses);
+            if (first) {
+                common = std::move(addresses);
+                first = false;
+                continue;
+            }
+            std::vector<std::uintptr_t> kept;
+            std::ranges::set_intersection(common, addresses,
+                                          std::back_inserter(kept));
+            common = std::move(kept);
+            if (common.empty()) {
+                break;
+            }
+        }
+        return common;
+    }
+
+    /** @brief Clear the matches and history of every attached pid */
+    auto reset() -> void {
+        for (auto& entry : m_scanners) {
+            entry.scanner->reset();
+        }
+    }
+
+    auto setIncremental(bool enabled) -> void {
+        m_incremental = enabled;
+        for (auto& entry : m_scanners) {
+            entry.scanner->setIncremental(enabled);
+        }
+    }
+
+   private:
+    struct Entry {
+        pid_t pid{0};
+        std::unique_ptr<Scanner> scanner;
+    };
+
+    utils::ThreadPoolOptions m_poolOptions;
+    std::unique_ptr<utils::ThreadPool> m_pool;  // started by the first attach
+    std::vector<Entry> m_scanners;
+    bool m_incremental{false};
+
+    auto pool() -> utils::ThreadPool& {
+        if (!m_pool) {
+            m_pool = std::make_unique<utils::ThreadPool>(m_poolOptions);
+        }
+        return *m_pool;
+    }
+
+    [[nodiscard]] auto find(pid_t pid) const -> Scanner* {
+        for (const auto& entry : m_scanners) {
+            if (entry.pid == pid) {
+                return entry.scanner.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // One driver thread per target; their pool jobs run side by side
+    template <typename Op>
+    auto runAll(Op op) -> MultiScanResult {
+        MultiScanResult out;
+        out.perPid.resize(m_scanners.size());
+        {
+            std::vector<std::jthread> drivers;
+            drivers.reserve(m_scanners.size());
+            for (std::size_t i = 0; i < m_scanners.size(); ++i) {
+                out.perPid[i].pid = m_scanners[i].pid;
+                drivers.emplace_back([&, i]() {
+                    out.perPid[i].result = op(*m_scanners[i].scanner);
+                });
+            }
+        }
+        for (const auto& entry : out.perPid) {
+            if (entry.result.success) {
+                out.matchCount += entry.result.matchCount;
+            } else {
+                ++out.failed;
+            }
+        }
+        return out;
+    }
+};
+
+}  // namespace core
@@ -0,0 +1,130 @@
+/**
+ * @file pagemap.cppm
+ * @brief Per-page state of a target via /proc/<pid>/pagemap (页表信息)
+ *
+ * Every virtual page of the target has one 64-bit entry at offset
+ * (address / page_size) * 8. Only the flag bits are used here; the PFN
+ * field is zeroed for unprivileged readers anyway.
+ */
+
+module;
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+
+export module core.pagemap;
+
+export namespace core {
+
+/** @brief pagemap entry bits (Documentation/admin-guide/mm/pagemap.rst) */
+constexpr std::uint64_t PAGEMAP_SOFT_DIRTY = 1ULL << 55;
+constexpr std::uint64_t PAGEMAP_SWAPPED = 1ULL << 62;
+constexpr std::uint64_t PAGEMAP_PRESENT = 1ULL << 63;
+
+/** @brief Whether the page holds data of its own (in RAM or in swap) */
+[[nodiscard]] constexpr auto pageResident(std::uint64_t entry) noexcept
+    -> bool {
+    return (entry & (PAGEMAP_PRESENT | PAGEMAP_SWAPPED)) != 0;
+}
+
+/**
+ * @class PagemapReader
+ * @brief RAII wrapper for a /proc/<pid>/pagemap file descriptor
+ */
+class PagemapReader {
+   public:
+    PagemapReader() = default;
+    explicit PagemapReader(pid_t pid) : m_pid(pid) {}
+
+    ~PagemapReader() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    PagemapReader(const PagemapReader&) = delete;
+    auto operator=(const PagemapReader&) -> PagemapReader& = delete;
+    PagemapReader(PagemapReader&& other) noexcept
+        : m_pid(other.m_pid), m_fd(other.m_fd) {
+        other.m_fd = -1;
+    }
+    auto operator=(PagemapReader&& other) noexcept -> PagemapReader& {
+        if (this != &other) {
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+            m_pid = other.m_pid;
+            m_fd = other.m_fd;
+            other.m_fd = -1;
+        }
+        return *this;
+    }
+
+    [[nodiscard]] auto open() -> std::expected<void, std::string> {
+        if (m_pid <= 0) {
+            return std::unexpected{"invalid pid"};
+        }
+        const std::string PATH = std::format("/proc/{}/pagemap", m_pid);
+        const int FD = ::open(PATH.c_str(), O_RDONLY | O_CLOEXEC);
+        if (FD < 0) {
+            return std::unexpected{std::format("open {} failed: {}", PATH,
+                                               std::strerror(errno))};
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        m_fd = FD;
+        return {};
+    }
+
+    [[nodiscard]] auto isOpen() const noexcept -> bool { return m_fd >= 0; }
+
+    [[nodiscard]] static auto pageSize() noexcept -> std::size_t {
+        static const auto SIZE =
+            static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return SIZE;
+    }
+
+    /**
+     * @brief Entries of the pages starting with the one holding addr
+     * @return Entries filled; short past the end of the address space or
+     *         on a read error
+     */
+    [[nodiscard]] auto read(std::uintptr_t addr,
+                            std::span<std::uint64_t> out) const
+        -> std::size_t {
+        if (m_fd < 0) {
+            return 0;
+        }
+        const auto FIRST = static_cast<off_t>(addr / pageSize() *
+                                              sizeof(std::uint64_t));
+        std::size_t done = 0;
+        while (done < out.size()) {
+            const ssize_t GOT =
+                ::pread(m_fd, out.data() + done,
+                        (out.size() - done) * sizeof(std::uint64_t),
+                        FIRST + static_cast<off_t>(done * sizeof(std::uint64_t)));
+            if (GOT <= 0) {
+                break;
+            }
+            done += static_cast<std::size_t>(GOT) / sizeof(std::uint64_t);
+        }
+        return done;
+    }
+
+   private:
+    pid_t m_pid{-1};
+    int m_fd{-1};
+};
+
+}  // namespace core
@@ -10,6 +10,8 @@
  * - Sufficient privileges (root or CAP_SYS_PTRACE)
  * - Does NOT auto-attach/detach ptrace (caller manages debugging policy)
  * - Single fd open/reuse + one-shot convenience functions
+ * - Vectored reads of many small ranges via process_vm_readv
+ * - Vectored writes via process_vm_writev, pwrite for what it cannot reach
  */
 
 module;
@@ -19,19 +21,34 @@ module;
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <bit>
 #include <cerrno>
+#include <climits>
 #include <cstdint>
 #include <cstring>
 #include <expected>
 #include <format>
 #include <span>
 #include <string>
+#include <vector>
 
 export module core.proc_mem;
 
 export namespace core {
 
+/** @brief One remote range for ProcMemIO::readRanges */
+struct ReadRange {
+    void* addr{nullptr};
+    std::size_t len{0};
+};
+
+/** @brief One remote range for ProcMemIO::writeRanges */
+struct WriteRange {
+    void* addr{nullptr};
+    std::span<const std::uint8_t> bytes;
+};
+
 /**
  * @class ProcMemIO
  * @brief RAII wrapper for /proc/<pid>/mem file descriptor
@@ -82,7 +99,10 @@ class ProcMemIO {
     ProcMemIO(const ProcMemIO&) = delete;
     auto operator=(const ProcMemIO&) -> ProcMemIO& = delete;
     ProcMemIO(ProcMemIO&& other) noexcept
-        : m_pid(other.m_pid), m_fd(other.m_fd) {
+        : m_pid(other.m_pid),
+          m_fd(other.m_fd),
+          m_noVmReadv(other.m_noVmReadv),
+          m_noVmWritev(other.m_noVmWritev) {
         other.m_fd = -1;
     }
     auto operator=(ProcMemIO&& other) noexcept -> ProcMemIO& {
@@ -91,6 +111,8 @@ class ProcMemIO {
         }
         m_pid = other.m_pid;
         m_fd = other.m_fd;
+        m_noVmReadv = other.m_noVmReadv;
+        m_noVmWritev = other.m_noVmWritev;
         other.m_fd = -1;
         return *this;
     }
@@ -140,6 +162,93 @@ class ProcMemIO {
         return read(addr, std::span<std::uint8_t>{buf, len});
     }
 
+    /**
+     * @brief Read many remote ranges into consecutive slices of buf
+     *
+     * Ranges are fetched with process_vm_readv, IOV_MAX at a time; if the
+     * syscall is unavailable the remaining ranges fall back to pread. A
+     * range that cannot be read in full gets the readable prefix only.
+     *
+     * @param ranges Remote ranges, laid out back to back in buf
+     * @param buf Destination, at least the sum of all range lengths
+     * @param got Receives the bytes read for each range
+     * @return Expected void or error message
+     */
+    [[nodiscard]] auto readRanges(std::span<const ReadRange> ranges,
+                                  std::span<std::uint8_t> buf,
+                                  std::span<std::size_t> got) const
+        -> std::expected<void, std::string> {
+        if (m_pid <= 0) {
+            return std::unexpected{"invalid pid"};
+        }
+        if (got.size() < ranges.size()) {
+            return std::unexpected{"result span too small"};
+        }
+        std::vector<std::size_t> offsets(ranges.size());
+        std::size_t need = 0;
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            offsets[i] = need;
+            need += ranges[i].len;
+        }
+        if (buf.size() < need) {
+            return std::unexpected{"buffer too small"};
+        }
+
+        std::vector<iovec> local;
+        std::vector<iovec> remote;
+        std::size_t first = 0;
+        while (first < ranges.size()) {
+            if (m_noVmReadv) {
+                for (std::size_t i = first; i < ranges.size(); ++i) {
+                    auto readExp = read(ranges[i].addr,
+                                        buf.subspan(offsets[i], ranges[i].len));
+                    got[i] = readExp.value_or(0);
+                }
+                return {};
+            }
+
+            const std::size_t COUNT =
+                std::min<std::size_t>(ranges.size() - first, IOV_MAX);
+            local.resize(COUNT);
+            remote.resize(COUNT);
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                const auto& range = ranges[first + i];
+                local[i] = {.iov_base = buf.data() + offsets[first + i],
+                            .iov_len = range.len};
+                remote[i] = {.iov_base = range.addr, .iov_len = range.len};
+            }
+            ssize_t rval = ::process_vm_readv(m_pid, local.data(), COUNT,
+                                              remote.data(), COUNT, 0);
+            if (rval < 0) {
+                if (errno == ENOSYS || errno == EPERM) {
+                    m_noVmReadv = true;  // e.g. blocked by seccomp
+                    continue;
+                }
+                if (errno == ESRCH) {
+                    return std::unexpected{
+                        std::format("process_vm_readv error: {}",
+                                    std::strerror(errno))};
+                }
+                got[first++] = 0;  // first range unreadable, retry the rest
+                continue;
+            }
+
+            // Bytes arrive in order; a short range ends this call
+            auto remaining = static_cast<std::size_t>(rval);
+            std::size_t index = first;
+            for (; index < first + COUNT; ++index) {
+                const std::size_t TAKE = std::min(remaining, ranges[index].len);
+                got[index] = TAKE;
+                remaining -= TAKE;
+                if (TAKE < ranges[index].len) {
+                    break;
+                }
+            }
+            first = std::min(index + 1, first + COUNT);
+        }
+        return {};
+    }
+
     /**
      * @brief Write bytes to target process memory
      * @param addr Target address in remote process
@@ -170,6 +279,91 @@ class ProcMemIO {
         return total;
     }
 
+    /**
+     * @brief Write many remote ranges with as few syscalls as possible
+     *
+     * Ranges go out through process_vm_writev, IOV_MAX at a time. That
+     * syscall honours page protections, so a range it leaves short is
+     * finished with pwrite when the fd is open for writing (the kernel
+     * forces /proc/<pid>/mem writes through read-only mappings).
+     *
+     * @param ranges Remote ranges and the bytes to put there
+     * @param got Receives the bytes written for each range
+     * @return Expected void or error message
+     */
+    [[nodiscard]] auto writeRanges(std::span<const WriteRange> ranges,
+                                   std::span<std::size_t> got) const
+        -> std::expected<void, std::string> {
+        if (m_pid <= 0) {
+            return std::unexpected{"invalid pid"};
+        }
+        if (got.size() < ranges.size()) {
+            return std::unexpected{"result span too small"};
+        }
+        std::ranges::fill(got.first(ranges.size()), 0);
+
+        std::vector<iovec> local;
+        std::vector<iovec> remote;
+        std::size_t first = 0;
+        while (first < ranges.size() && !m_noVmWritev) {
+            const std::size_t COUNT =
+                std::min<std::size_t>(ranges.size() - first, IOV_MAX);
+            local.resize(COUNT);
+            remote.resize(COUNT);
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                const auto& range = ranges[first + i];
+                // process_vm_writev only reads the local buffers
+                local[i] = {.iov_base = const_cast<std::uint8_t*>(
+                                range.bytes.data()),
+                            .iov_len = range.bytes.size()};
+                remote[i] = {.iov_base = range.addr,
+                             .iov_len = range.bytes.size()};
+            }
+            ssize_t rval = ::process_vm_writev(m_pid, local.data(), COUNT,
+                                               remote.data(), COUNT, 0);
+            if (rval < 0) {
+                if (errno == ENOSYS || errno == EPERM) {
+                    m_noVmWritev = true;  // e.g. blocked by seccomp
+                    break;
+                }
+                if (errno == ESRCH) {
+                    return std::unexpected{
+                        std::format("process_vm_writev error: {}",
+                                    std::strerror(errno))};
+                }
+                ++first;  // first range unwritable, pwrite retries it below
+                continue;
+            }
+
+            auto remaining = static_cast<std::size_t>(rval);
+            std::size_t index = first;
+            for (; index < first + COUNT; ++index) {
+                const std::size_t TAKE =
+                    std::min(remaining, ranges[index].bytes.size());
+                got[index] = TAKE;
+                remaining -= TAKE;
+                if (TAKE < ranges[index].bytes.size()) {
+                    break;
+                }
+            }
+            first = std::min(index + 1, first + COUNT);
+        }
+
+        if (m_fd < 0) {
+            return {};
+        }
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            const auto& range = ranges[i];
+            if (got[i] >= range.bytes.size()) {
+                continue;
+            }
+            auto* addr = static_cast<std::uint8_t*>(range.addr) + got[i];
+            auto writeExp = write(addr, range.bytes.subspan(got[i]));
+            got[i] += writeExp.value_or(0);
+        }
+        return {};
+    }
+
     /**
      * @brief Write scalar value to target memory
      * @tparam T Trivially copyable type (int, float, etc.)
@@ -190,6 +384,72 @@ class ProcMemIO {
    private:
     pid_t m_pid{-1};
     int m_fd{-1};
+    mutable bool m_noVmReadv{false};
+    mutable bool m_noVmWritev{false};
+};
+
+/**
+ * @class ProcMemReaders
+ * @brief Per-worker ProcMemIO handles kept open across scans
+ *
+ * Slot i belongs to pool worker i and is opened on first use, so a
+ * scan/filter loop pays for open() once per worker instead of once per
+ * call. A failed open is remembered until the next reset().
+ */
+class ProcMemReaders {
+   public:
+    ProcMemReaders() = default;
+    ProcMemReaders(pid_t pid, std::size_t count) { reset(pid, count); }
+
+    /** @brief Drop every handle and prepare count lazy slots for pid */
+    void reset(pid_t pid, std::size_t count) {
+        m_pid = pid;
+        m_slots.clear();
+        m_slots.resize(count);
+    }
+
+    [[nodiscard]] auto pid() const noexcept -> pid_t { return m_pid; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_slots.size();
+    }
+
+    /** @brief Whether the cache can serve count workers of pid */
+    [[nodiscard]] auto covers(pid_t pid, std::size_t count) const noexcept
+        -> bool {
+        return m_pid == pid && m_slots.size() >= count;
+    }
+
+    /**
+     * @brief Reader of one slot, opening it on first use
+     *
+     * Different slots may be acquired from different threads concurrently;
+     * one slot must only be used by one thread at a time.
+     */
+    [[nodiscard]] auto acquire(std::size_t slot)
+        -> std::expected<ProcMemIO*, std::string> {
+        auto& entry = m_slots[slot];
+        if (!entry.tried) {
+            entry.tried = true;
+            entry.io = ProcMemIO{m_pid};
+            if (auto err = entry.io.open(); !err) {
+                entry.error = err.error();
+            }
+        }
+        if (!entry.error.empty()) {
+            return std::unexpected{entry.error};
+        }
+        return &entry.io;
+    }
+
+   private:
+    struct Slot {
+        ProcMemIO io;
+        bool tried{false};
+        std::string error;
+    };
+
+    pid_t m_pid{-1};
+    std::vector<Slot> m_slots;
 };
 
 /**
@@ -0,0 +1,203 @@
+/**
+ * @file process_pause.cppm
+ * @brief Stop a target while a snapshot is copied (暂停目标进程)
+ *
+ * SIGSTOP puts every thread of the target into a group stop without
+ * attaching to each one. The stop is only complete once every thread
+ * shows state T in /proc/<pid>/task/<tid>/stat, so stop() waits for that
+ * before returning.
+ *
+ * A traced target is refused: its tracer sees the SIGSTOP first and may
+ * let the target run on in the middle of the copy. So is this process
+ * itself, which would have no thread left to send SIGCONT.
+ */
+
+module;
+
+#include <signal.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+export module core.process_pause;
+
+export namespace core {
+
+/**
+ * @brief State letter of one thread ('\0' if it is gone)
+ *
+ * The command name in stat may hold spaces and parentheses, so the state
+ * is the field after the last ')'.
+ */
+[[nodiscard]] inline auto threadState(const std::filesystem::path& statPath)
+    -> char {
+    std::ifstream stat(statPath);
+    std::string line;
+    if (!std::getline(stat, line)) {
+        return '\0';
+    }
+    const auto CLOSE = line.rfind(')');
+    if (CLOSE == std::string::npos || CLOSE + 2 >= line.size()) {
+        return '\0';
+    }
+    return line[CLOSE + 2];
+}
+
+/** @brief Numeric field of /proc/<pid>/status ("Tgid", "TracerPid") */
+[[nodiscard]] inline auto statusField(pid_t pid, std::string_view name)
+    -> std::optional<long> {
+    std::ifstream status(std::filesystem::path("/proc") / std::to_string(pid) /
+                         "status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.size() > name.size() && line.starts_with(name) &&
+            line[name.size()] == ':') {
+            const auto BEGIN = line.find_first_not_of(" \t", name.size() + 1);
+            long number = 0;
+            if (BEGIN == std::string::npos ||
+                std::from_chars(line.data() + BEGIN,
+                                line.data() + line.size(), number)
+                        .ec != std::errc{}) {
+                return std::nullopt;
+            }
+            return number;
+        }
+    }
+    return std::nullopt;
+}
+
+/** @brief Whether no thread of pid can run (stopped, traced, dead) */
+[[nodiscard]] inline auto allThreadsStopped(pid_t pid) -> bool {
+    std::error_code error;
+    const std::filesystem::directory_iterator TASKS(
+        std::filesystem::path("/proc") / std::to_string(pid) / "task", error);
+    if (error) {
+        return false;
+    }
+    for (const auto& task : TASKS) {
+        switch (threadState(task.path() / "stat")) {
+            case 'T':
+            case 't':
+            case 'Z':
+            case 'X':
+            case '\0':
+                continue;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @class ProcessPause
+ * @brief Keeps a target stopped until resume() or destruction
+ *
+ * A target that was already stopped is left stopped, and its pause is
+ * not counted as ours.
+ */
+class ProcessPause {
+   public:
+    static constexpr std::chrono::milliseconds STOP_TIMEOUT{2000};
+
+    /** @brief Stop pid and wait until every thread has stopped */
+    [[nodiscard]] static auto stop(pid_t pid,
+                                   std::chrono::milliseconds timeout =
+                                       STOP_TIMEOUT)
+        -> std::expected<ProcessPause, std::string> {
+        if (pid <= 0) {
+            return std::unexpected(std::format("Invalid pid {}", pid));
+        }
+        if (statusField(pid, "Tgid").value_or(pid) == ::getpid()) {
+            return std::unexpected(
+                std::format("Cannot stop pid {}: it is this process", pid));
+        }
+        if (const auto TRACER = statusField(pid, "TracerPid");
+            TRACER.value_or(0) != 0) {
+            return std::unexpected(std::format(
+                "Cannot stop pid {}: traced by pid {}", pid, *TRACER));
+        }
+        if (allThreadsStopped(pid)) {
+            return ProcessPause{pid, false};
+        }
+        ProcessPause pause{pid, true};
+        if (::kill(pid, SIGSTOP) != 0) {
+            pause.m_pid = -1;
+            return std::unexpected(std::format("Cannot stop pid {}: {}", pid,
+                                               std::strerror(errno)));
+        }
+        const auto DEADLINE = std::chrono::steady_clock::now() + timeout;
+        while (!allThreadsStopped(pid)) {
+            if (std::chrono::steady_clock::now() > DEADLINE) {
+                return std::unexpected(std::format(
+                    "pid {} did not stop within {} ms", pid, timeout.count()));
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return pause;
+    }
+
+    ProcessPause(ProcessPause&& other) noexcept
+        : m_pid(std::exchange(other.m_pid, -1)),
+          m_owned(other.m_owned),
+          m_since(other.m_since),
+          m_paused(other.m_paused) {}
+    auto operator=(ProcessPause&& other) noexcept -> ProcessPause& {
+        if (this != &other) {
+            resume();
+            m_pid = std::exchange(other.m_pid, -1);
+            m_owned = other.m_owned;
+            m_since = other.m_since;
+            m_paused = other.m_paused;
+        }
+        return *this;
+    }
+    ProcessPause(const ProcessPause&) = delete;
+    auto operator=(const ProcessPause&) -> ProcessPause& = delete;
+    ~ProcessPause() { resume(); }
+
+    /**
+     * @brief Let the target run again
+     * @return How long this pause kept it stopped (0 if it was already)
+     */
+    auto resume() -> std::chrono::nanoseconds {
+        if (m_pid <= 0) {
+            return m_paused;
+        }
+        if (m_owned) {
+            ::kill(m_pid, SIGCONT);
+            m_paused = std::chrono::steady_clock::now() - m_since;
+        }
+        m_pid = -1;
+        return m_paused;
+    }
+
+    [[nodiscard]] auto stopped() const noexcept -> bool { return m_pid > 0; }
+
+   private:
+    ProcessPause(pid_t pid, bool owned)
+        : m_pid(pid),
+          m_owned(owned),
+          m_since(std::chrono::steady_clock::now()) {}
+
+    pid_t m_pid{-1};
+    bool m_owned{false};  ///< We sent SIGSTOP, so we send SIGCONT
+    std::chrono::steady_clock::time_point m_since;
+    std::chrono::nanoseconds m_paused{0};
+};
+
+}  // namespace core
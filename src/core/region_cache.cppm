@@ -0,0 +1,133 @@
+/**
+ * @file region_cache.cppm
+ * @brief Per-session cache of a target's parsed maps (区域缓存)
+ *
+ * Every scan and every listing needs the target's regions. The maps text
+ * is still read each time, since nothing else tells whether mappings
+ * changed, but it is only parsed again, and the classifier rebuilt, when
+ * the text differs from the cached copy.
+ */
+
+module;
+
+#include <sys/types.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+export module core.region_cache;
+
+import core.maps;
+import core.region_classifier;
+
+export namespace core {
+
+/**
+ * @class RegionCache
+ * @brief Parsed regions and classifier of one pid, shared across scans
+ *
+ * Results are immutable snapshots handed out by shared_ptr, so they stay
+ * valid after the cache moves on. All members are safe to call from
+ * several threads.
+ */
+class RegionCache {
+   public:
+    using Regions = std::shared_ptr<const std::vector<Region>>;
+    using Classifier = std::shared_ptr<const RegionClassifier>;
+
+    RegionCache() = default;
+    explicit RegionCache(pid_t pid) : m_pid(pid) {}
+
+    RegionCache(const RegionCache&) = delete;
+    auto operator=(const RegionCache&) -> RegionCache& = delete;
+
+    /** @brief Drop everything and follow pid from now on */
+    void reset(pid_t pid) {
+        std::lock_guard lock{m_mutex};
+        m_pid = pid;
+        m_text.clear();
+        m_valid = false;
+        m_all.clear();
+        m_levels = {};
+        m_classifier.reset();
+    }
+
+    [[nodiscard]] auto pid() const -> pid_t {
+        std::lock_guard lock{m_mutex};
+        return m_pid;
+    }
+
+    /** @brief Current regions at level (ids index the returned list) */
+    [[nodiscard]] auto regions(RegionScanLevel level)
+        -> std::expected<Regions, std::string> {
+        std::lock_guard lock{m_mutex};
+        if (auto err = refreshLocked(); !err) {
+            return std::unexpected{err.error()};
+        }
+        auto& slot = m_levels[static_cast<std::size_t>(level)];
+        if (!slot) {
+            slot = std::make_shared<const std::vector<Region>>(
+                level == RegionScanLevel::ALL
+                    ? m_all
+                    : MapsReader::selectLevel(m_all, m_exeName, level));
+        }
+        return slot;
+    }
+
+    /** @brief Classifier over every readable region */
+    [[nodiscard]] auto classifier() -> std::expected<Classifier, std::string> {
+        std::lock_guard lock{m_mutex};
+        if (auto err = refreshLocked(); !err) {
+            return std::unexpected{err.error()};
+        }
+        if (!m_classifier) {
+            m_classifier = std::make_shared<const RegionClassifier>(
+                RegionClassifier::fromRegions(m_all));
+        }
+        return m_classifier;
+    }
+
+    /** @brief Number of times the maps were parsed */
+    [[nodiscard]] auto generation() const -> std::uint64_t {
+        std::lock_guard lock{m_mutex};
+        return m_generation;
+    }
+
+   private:
+    auto refreshLocked() -> std::expected<void, std::string> {
+        auto text = MapsReader::readMapsText(m_pid);
+        if (!text) {
+            return std::unexpected{text.error().message};
+        }
+        if (m_valid && *text == m_text) {
+            return {};
+        }
+        m_text = std::move(*text);
+        m_exeName = MapsReader::exeNameOf(m_pid);
+        m_all = MapsReader::parseMaps(m_text, m_exeName, RegionScanLevel::ALL);
+        m_levels = {};
+        m_classifier.reset();
+        m_valid = true;
+        ++m_generation;
+        return {};
+    }
+
+    mutable std::mutex m_mutex;
+    pid_t m_pid{0};
+    std::string m_text;  // maps contents m_all was parsed from
+    bool m_valid{false};
+    std::string m_exeName;
+    std::vector<Region> m_all;  // RegionScanLevel::ALL
+    std::array<Regions, 4> m_levels;  // by RegionScanLevel, built lazily
+    Classifier m_classifier;
+    std::uint64_t m_generation{0};
+};
+
+}  // namespace core
@@ -7,9 +7,11 @@ module;
 
 #include <algorithm>
 #include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <format>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -29,6 +31,7 @@ struct RegionLookupEntry {
     std::uintptr_t end;  // half-open range
     RegionType type;
     std::string filename;
+    std::string label;  // classify() result, built once
 };
 
 /**
@@ -48,26 +51,26 @@ class RegionClassifier {
         if (!mapsRes) {
             return std::unexpected(mapsRes.error().message);
         }
+        return fromRegions(*mapsRes);
+    }
 
+    /** @brief Build from already parsed regions (any order) */
+    static auto fromRegions(const std::vector<Region>& maps)
+        -> RegionClassifier {
         std::vector<RegionLookupEntry> regions;
-        regions.reserve(mapsRes->size());
-
-        for (const auto& region : *mapsRes) {
-            RegionLookupEntry entry{
-                .start = std::bit_cast<std::uintptr_t>(region.start),
-                .end =
-                    std::bit_cast<std::uintptr_t>(region.start) + region.size,
-                .type = region.type,
-                .filename = region.filename};
-            regions.push_back(entry);
+        regions.reserve(maps.size());
+
+        for (const auto& region : maps) {
+            const auto START = std::bit_cast<std::uintptr_t>(region.start);
+            regions.push_back({.start = START,
+                               .end = START + region.size,
+                               .type = region.type,
+                               .filename = region.filename,
+                               .label = makeLabel(region.type, region.filename)});
         }
 
         // Sort by start address for binary search
-        std::sort(
-            regions.begin(), regions.end(),
-            [](const RegionLookupEntry& lhs, const RegionLookupEntry& rhs) {
-                return lhs.start < rhs.start;
-            });
+        std::ranges::sort(regions, {}, &RegionLookupEntry::start);
 
         return RegionClassifier{std::move(regions)};
     }
@@ -76,25 +79,31 @@ class RegionClassifier {
      * @brief Classify an address into a human-readable region description
      * @param addr Address to classify
      * @return Region description string (e.g., "heap", "stack",
-     * "code:libfoo.so")
+     * "code:libfoo.so"); valid as long as the classifier
      */
-    [[nodiscard]] auto classify(std::uintptr_t addr) const -> std::string {
-        for (const auto& entry : m_regions) {
-            if (addr >= entry.start && addr < entry.end) {
-                auto typeStr = regionTypeToString(entry.type);
-                if ((entry.type == RegionType::EXE ||
-                     entry.type == RegionType::CODE) &&
-                    !entry.filename.empty()) {
-                    std::string tail = entry.filename;
-                    if (tail.size() > 24) {
-                        tail = "..." + tail.substr(tail.size() - 21);
-                    }
-                    return std::format("{}:{}", typeStr, tail);
-                }
-                return std::string(typeStr);
-            }
-        }
-        return "unk";
+    [[nodiscard]] auto classify(std::uintptr_t addr) const
+        -> const std::string& {
+        static const std::string UNKNOWN = "unk";
+        const auto* entry = find(addr);
+        return entry != nullptr ? entry->label : UNKNOWN;
+    }
+
+    /** @brief Interned region handle; stable for the classifier's life */
+    using RegionId = std::uint32_t;
+    static constexpr RegionId NO_REGION = static_cast<RegionId>(-1);
+
+    /** @brief Region holding addr, or NO_REGION */
+    [[nodiscard]] auto regionId(std::uintptr_t addr) const -> RegionId {
+        const auto* entry = find(addr);
+        return entry != nullptr
+                   ? static_cast<RegionId>(entry - m_regions.data())
+                   : NO_REGION;
+    }
+
+    /** @brief classify() text of a region id ("unk" for NO_REGION) */
+    [[nodiscard]] auto label(RegionId id) const -> const std::string& {
+        static const std::string UNKNOWN = "unk";
+        return id < m_regions.size() ? m_regions[id].label : UNKNOWN;
     }
 
     /**
@@ -104,18 +113,47 @@ class RegionClassifier {
      */
     [[nodiscard]] auto getRegionType(std::uintptr_t addr) const
         -> std::optional<RegionType> {
-        for (const auto& entry : m_regions) {
-            if (addr >= entry.start && addr < entry.end) {
-                return entry.type;
-            }
+        const auto* entry = find(addr);
+        if (entry == nullptr) {
+            return std::nullopt;
         }
-        return std::nullopt;
+        return entry->type;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_regions.size();
     }
 
    private:
     explicit RegionClassifier(std::vector<RegionLookupEntry> regions)
         : m_regions(std::move(regions)) {}
 
+    // Entry holding addr; maps entries never overlap
+    [[nodiscard]] auto find(std::uintptr_t addr) const
+        -> const RegionLookupEntry* {
+        auto iter = std::ranges::upper_bound(m_regions, addr, {},
+                                             &RegionLookupEntry::start);
+        if (iter == m_regions.begin()) {
+            return nullptr;
+        }
+        --iter;
+        return addr < iter->end ? &*iter : nullptr;
+    }
+
+    static auto makeLabel(RegionType type, const std::string& filename)
+        -> std::string {
+        auto typeStr = regionTypeToString(type);
+        if ((type == RegionType::EXE || type == RegionType::CODE) &&
+            !filename.empty()) {
+            std::string tail = filename;
+            if (tail.size() > 24) {
+                tail = "..." + tail.substr(tail.size() - 21);
+            }
+            return std::format("{}:{}", typeStr, tail);
+        }
+        return std::string(typeStr);
+    }
+
     static auto regionTypeToString(RegionType regionType) -> std::string_view {
         switch (regionType) {
             case RegionType::HEAP:
@@ -108,7 +108,7 @@ class RegionFilter {
         }
 
         // Classify address and extract region type from classification string
-        auto classification = classifier.classify(addr);
+        const auto& classification = classifier.classify(addr);
         auto type = extractRegionTypeFromClassification(classification);
         return type && isTypeAllowed(*type);
     }
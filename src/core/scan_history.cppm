@@ -1,16 +1,37 @@
 /**
  * @file scan_history.cppm
  * @brief Management of scan result history (扫描历史管理)
+ *
+ * By default the matches of every entry spill to a snapshot file in a
+ * private temporary directory and stay reachable through an mmap view, so
+ * history costs disk space rather than copies of the baseline in RAM.
+ * Entries kept in RAM are DeltaSnapshots sharing unchanged byte chunks
+ * with the entry before them, so each step costs only what changed.
  */
 
 module;
 
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <system_error>
 #include <utility>
+#include <vector>
 
 export module core.scan_history;
 
+import scan.delta_snapshot;
+import scan.match_storage;
+import scan.snapshot_file;
 import scan.types;
 
 export namespace core {
@@ -23,53 +44,223 @@ class ScanHistory {
    public:
     ScanHistory() = default;
 
+    ~ScanHistory() {
+        clear();
+        removeSpillDir();
+    }
+
+    ScanHistory(const ScanHistory&) = delete;
+    auto operator=(const ScanHistory&) -> ScanHistory& = delete;
+
+    /**
+     * @brief Directory to create the spill directory in
+     * @param parent Parent directory; empty keeps entries in RAM
+     *
+     * Only affects entries added afterwards.
+     */
+    void setSpillParent(std::string parent) {
+        removeSpillDir();
+        m_spillParent = std::move(parent);
+    }
+
+    [[nodiscard]] auto spillParent() const -> const std::string& {
+        return m_spillParent;
+    }
+
+    /**
+     * @brief Number of results kept; the oldest are dropped beyond it
+     * @param capacity Entries to keep, at least 1
+     */
+    void setCapacity(std::size_t capacity) {
+        m_capacity = std::max<std::size_t>(capacity, 1);
+        while (m_entries.size() > m_capacity) {
+            popOldest();
+        }
+    }
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+        return m_capacity;
+    }
+
     /**
      * @brief Add a new scan result to history
      * @param result Result to add (will be moved)
      *
-     * If history exceeds MAX_HISTORY (10), the oldest result is removed.
+     * If history exceeds capacity() (DEFAULT_CAPACITY unless set), the
+     * oldest result is removed.
      */
     void add(ScanRecord result) {
-        if (m_results.size() >= MAX_HISTORY) {
-            m_results.pop_front();
+        if (m_entries.size() >= m_capacity) {
+            popOldest();
+        }
+        m_entries.push_back({.record = std::move(result)});
+    }
+
+    /**
+     * @brief Add a result whose matches are written out instead of copied
+     * @param result Everything but the matches
+     * @param matches Matches to store; kept in RAM as a delta against the
+     *        newest RAM entry if not spilled
+     */
+    void add(ScanRecord result, const scan::MatchesAndOldValuesArray& matches) {
+        auto file = spill(matches, result.opts.dataType);
+        Entry entry{.record = std::move(result), .file = std::move(file)};
+        if (!entry.file) {
+            entry.delta = scan::DeltaSnapshot::build(matches, newestDelta());
+        }
+        if (m_entries.size() >= m_capacity) {
+            popOldest();
         }
-        m_results.push_back(std::move(result));
+        m_entries.push_back(std::move(entry));
     }
 
     /**
      * @brief Get number of results in history
      * @return Result count
      */
-    [[nodiscard]] auto count() const -> std::size_t { return m_results.size(); }
+    [[nodiscard]] auto count() const -> std::size_t { return m_entries.size(); }
 
     /**
      * @brief Get a specific scan result by index
      * @param index Index from 0 (oldest) to count()-1 (newest)
-     * @return Pointer to result, or nullptr if out of range
+     * @return Pointer to result, or nullptr if out of range; the matches of
+     *         a result added with separate matches are empty (see
+     *         snapshotFile / loadMatches)
      */
     [[nodiscard]] auto get(std::size_t index) const -> const ScanRecord* {
-        if (index >= m_results.size()) {
+        if (index >= m_entries.size()) {
             return nullptr;
         }
-        return &m_results[index];
+        return &m_entries[index].record;
     }
 
-    /**
-     * @brief Get all scan results
-     * @return Reference to deque of results
-     */
-    [[nodiscard]] auto getAll() const -> const std::deque<ScanRecord>& {
-        return m_results;
+    /** @brief mmap view of a spilled result's matches, or nullptr */
+    [[nodiscard]] auto snapshotFile(std::size_t index) const
+        -> const scan::SnapshotFile* {
+        if (index >= m_entries.size() || !m_entries[index].file) {
+            return nullptr;
+        }
+        return &*m_entries[index].file;
+    }
+
+    /** @brief The matches of a result, read back from disk if spilled */
+    [[nodiscard]] auto loadMatches(std::size_t index) const
+        -> std::expected<scan::MatchesAndOldValuesArray, std::string> {
+        if (index >= m_entries.size()) {
+            return std::unexpected{
+                std::format("history index {} out of range", index)};
+        }
+        const auto& entry = m_entries[index];
+        if (entry.file) {
+            return entry.file->load();
+        }
+        if (entry.delta) {
+            return entry.delta->load();
+        }
+        return entry.record.matches;
+    }
+
+    /** @brief Bytes held by RAM entries, each shared chunk counted once */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t {
+        std::size_t total = 0;
+        for (const auto& entry : m_entries) {
+            total += entry.record.matches.memoryUsage();
+            if (entry.delta) {
+                total += entry.delta->memoryUsage();
+            }
+        }
+        return total;
     }
 
     /**
      * @brief Clear all history
      */
-    void clear() { m_results.clear(); }
+    void clear() {
+        while (!m_entries.empty()) {
+            popOldest();
+        }
+    }
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 10;
 
    private:
-    static constexpr std::size_t MAX_HISTORY = 10;
-    std::deque<ScanRecord> m_results;
+    struct Entry {
+        ScanRecord record;
+        std::optional<scan::SnapshotFile> file;
+        std::optional<scan::DeltaSnapshot> delta;  // RAM copy of the matches
+    };
+
+    [[nodiscard]] auto newestDelta() const -> const scan::DeltaSnapshot* {
+        for (auto iter = m_entries.rbegin(); iter != m_entries.rend(); ++iter) {
+            if (iter->delta) {
+                return &*iter->delta;
+            }
+        }
+        return nullptr;
+    }
+
+    void popOldest() {
+        auto& entry = m_entries.front();
+        if (entry.file) {
+            std::error_code ignored;
+            std::filesystem::remove(entry.file->path(), ignored);
+        }
+        m_entries.pop_front();
+    }
+
+    auto spill(const scan::MatchesAndOldValuesArray& matches,
+               ScanDataType dataType) -> std::optional<scan::SnapshotFile> {
+        if (!ensureSpillDir()) {
+            return std::nullopt;
+        }
+        const std::string PATH =
+            std::format("{}/history-{}.snap", m_spillDir, m_nextId++);
+        if (!scan::writeSnapshotFile(PATH, matches, dataType)) {
+            return std::nullopt;
+        }
+        auto file = scan::SnapshotFile::open(PATH);
+        if (!file) {
+            std::error_code ignored;
+            std::filesystem::remove(PATH, ignored);
+            return std::nullopt;
+        }
+        return std::move(*file);
+    }
+
+    auto ensureSpillDir() -> bool {
+        if (!m_spillDir.empty()) {
+            return true;
+        }
+        if (m_spillParent.empty()) {
+            return false;
+        }
+        std::string pattern = m_spillParent + "/scan-history-XXXXXX";
+        if (::mkdtemp(pattern.data()) == nullptr) {
+            return false;
+        }
+        m_spillDir = std::move(pattern);
+        return true;
+    }
+
+    void removeSpillDir() {
+        if (m_spillDir.empty()) {
+            return;
+        }
+        std::error_code ignored;
+        std::filesystem::remove_all(m_spillDir, ignored);
+        m_spillDir.clear();
+    }
+
+    static auto defaultSpillParent() -> std::string {
+        const char* tmp = ::getenv("TMPDIR");
+        return (tmp != nullptr && *tmp != '\0') ? tmp : "/tmp";
+    }
+
+    std::deque<Entry> m_entries;
+    std::size_t m_capacity{DEFAULT_CAPACITY};
+    std::string m_spillParent{defaultSpillParent()};
+    std::string m_spillDir;  // created on first spill
+    std::uint64_t m_nextId{0};
 };
 
 }  // namespace core
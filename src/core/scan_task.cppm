@@ -0,0 +1,98 @@
+/**
+ * @file scan_task.cppm
+ * @brief A scan or filter running on its own thread (后台扫描任务)
+ *
+ * The caller stays free to poll progress() and call cancel(); the job
+ * sees both through the ScanControl it is handed. A cancelled job still
+ * returns: scans keep the regions they finished, filters keep the
+ * matches they did not get to.
+ */
+
+module;
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+export module core.scan_task;
+
+import core.scanner;
+import scan.types;
+
+export namespace core {
+
+/**
+ * @class ScanTask
+ * @brief Runs one Scanner job on a helper thread
+ *
+ * The Scanner the job uses must not be touched by anyone else until
+ * wait() returns. Destroying a running task cancels and joins it.
+ */
+class ScanTask {
+   public:
+    using Job = std::function<ScannerResult(ScanControl&)>;
+
+    explicit ScanTask(Job job)
+        : m_job(std::move(job)),
+          m_thread([this](const std::stop_token&) { run(); }) {}
+
+    ~ScanTask() { cancel(); }
+
+    ScanTask(const ScanTask&) = delete;
+    auto operator=(const ScanTask&) -> ScanTask& = delete;
+
+    /** @brief Ask the job to stop at its next block or batch */
+    void cancel() noexcept { m_stop.request_stop(); }
+
+    [[nodiscard]] auto cancelRequested() const noexcept -> bool {
+        return m_stop.stop_requested();
+    }
+
+    [[nodiscard]] auto progress() const noexcept -> ScanProgress {
+        return m_control.progress();
+    }
+
+    [[nodiscard]] auto done() const -> bool {
+        const std::lock_guard LOCK(m_mutex);
+        return m_done;
+    }
+
+    /** @brief Wait up to timeout; true once the job has returned */
+    template <typename Rep, typename Period>
+    [[nodiscard]] auto waitFor(std::chrono::duration<Rep, Period> timeout)
+        -> bool {
+        std::unique_lock lock(m_mutex);
+        return m_cv.wait_for(lock, timeout, [this]() { return m_done; });
+    }
+
+    /** @brief Block until the job returns and take its result (once) */
+    [[nodiscard]] auto wait() -> ScannerResult {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_done; });
+        return std::move(m_result);
+    }
+
+   private:
+    void run() {
+        auto result = m_job(m_control);
+        const std::lock_guard LOCK(m_mutex);
+        m_result = std::move(result);
+        m_done = true;
+        m_cv.notify_all();
+    }
+
+    std::stop_source m_stop;
+    ScanControl m_control{m_stop.get_token()};
+    Job m_job;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    ScannerResult m_result;
+    bool m_done{false};
+    std::jthread m_thread;  // last: joins before the state above goes
+};
+
+}  // namespace core
@@ -6,6 +6,14 @@
  * - snapshot(): Full memory scan (creates baseline)
  * - filter(): Incremental scan on existing matches
  * - rescan(): Clear and perform full scan again
+ *
+ * The scanner owns its worker pool, one cached /proc/<pid>/mem reader
+ * per worker and the target's parsed maps, so repeated scan/filter/list
+ * calls reuse all three.
+ *
+ * In incremental mode each snapshot first clears the target's soft-dirty
+ * bits; later filters and the next snapshot only read pages written since
+ * then and take the rest from the stored snapshot bytes.
  */
 
 module;
@@ -14,21 +22,31 @@ module;
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <expected>
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 export module core.scanner;
 
 import scan.engine;        // runScanParallel
 import scan.types;         // ScanDataType, ScanMatchType
-import scan.filter;        // filterMatches
+import scan.filter;        // filterMatchesParallel
+import scan.job;           // scanWindowSize
 import scan.match_storage; // MatchesAndOldValuesArray
+import scan.snapshot_file; // writeSnapshotFile, SnapshotFile
 import value.core;         // UserValue, Value
 import value.flags;
 import core.maps;         // RegionScanLevel
 import core.scan_history; // ScanHistory
+import core.proc_mem;     // ProcMemReaders
+import core.region_cache; // RegionCache
+import core.soft_dirty;   // SoftDirtyMap, clearSoftDirty
+import utils.thread_pool; // ThreadPool, ThreadPoolOptions
 
 export namespace core {
 
@@ -50,7 +68,32 @@ class Scanner {
      * @brief Construct scanner for given process
      * @param pid Target process ID
      */
-    explicit Scanner(pid_t pid) : m_pid(pid) {}
+    explicit Scanner(pid_t pid) : m_pid(pid), m_regionCache(pid) {}
+
+    /**
+     * @brief Construct scanner with a worker pool configuration
+     * @param pid Target process ID
+     * @param threads Pool size and CPU placement
+     */
+    Scanner(pid_t pid, utils::ThreadPoolOptions threads)
+        : m_pid(pid),
+          m_poolOptions(std::move(threads)),
+          m_regionCache(pid) {}
+
+    /**
+     * @brief Construct scanner on a pool shared with other scanners
+     * @param pid Target process ID
+     * @param pool Workers to scan with; must outlive the scanner
+     *
+     * Scanners sharing a pool may scan from different threads at once;
+     * the pool runs their parallel phases one after another.
+     */
+    Scanner(pid_t pid, utils::ThreadPool& pool)
+        : m_pid(pid),
+          m_poolOptions(pool.options()),
+          m_readers(pid, pool.size()),
+          m_regionCache(pid),
+          m_sharedPool(&pool) {}
 
     // ====================================================================
     // Explicit Public Operations
@@ -61,14 +104,17 @@ class Scanner {
      * @param opts Scan options
      * @param value Optional target value
      * @param saveToHistory Whether to save to history
+     * @param control Optional progress and cancellation (see ScanControl);
+     *        a cancelled scan keeps the regions it finished as matches
      * @return Scan response with results
      */
     [[nodiscard]] auto snapshot(
         const ScanOptions& opts,
         const std::optional<UserValue>& value = std::nullopt,
-        bool saveToHistory = false) -> ScannerResult {
-        clearMatches();
-        return doScan(opts, value, saveToHistory);
+        bool saveToHistory = false, ScanControl* control = nullptr)
+        -> ScannerResult {
+        return doScan(opts, value, saveToHistory, std::exchange(m_matches, {}),
+                      control);
     }
 
     /**
@@ -76,12 +122,15 @@ class Scanner {
      * @param opts Scan options
      * @param value Optional target value
      * @param saveToHistory Whether to save to history
+     * @param control Optional progress and cancellation; a cancelled
+     *        filter keeps the matches it did not re-check unchanged
      * @return Scan response with results
      */
     [[nodiscard]] auto filter(
         const ScanOptions& opts,
         const std::optional<UserValue>& value = std::nullopt,
-        bool saveToHistory = false) -> ScannerResult {
+        bool saveToHistory = false, ScanControl* control = nullptr)
+        -> ScannerResult {
         if (!hasMatches()) {
             return ScannerResult{
                 .stats = {},
@@ -91,8 +140,16 @@ class Scanner {
                     "No existing matches to filter. Run snapshot() first."};
         }
 
-        auto statsExp =
-            filterMatches(m_pid, opts, value ? &*value : nullptr, m_matches);
+        // Matches keep the alignment of the scan that found them
+        ScanOptions filterOpts = opts;
+        filterOpts.alignment = m_matchAlignment;
+        auto dirty = loadDirtyMap(
+            m_matches,
+            scan::scanWindowSize(filterOpts, value ? &*value : nullptr));
+        auto statsExp = filterMatchesParallel(
+            m_pid, filterOpts, value ? &*value : nullptr, m_matches,
+            &workerPool(), &m_readers, dirty ? &*dirty : nullptr, control,
+            &m_filterWorkspace);
         if (!statsExp) {
             return ScannerResult{.stats = {},
                                  .matchCount = 0,
@@ -102,12 +159,8 @@ class Scanner {
 
         pruneEmptySwaths();
 
-        if (saveToHistory) {
-            saveResultToHistory(*statsExp, opts, value);
-        }
-
-        return ScannerResult{
-            .stats = *statsExp, .matchCount = getMatchCount(), .success = true};
+        return finishResult(std::move(*statsExp), filterOpts, value,
+                            saveToHistory);
     }
 
     /**
@@ -115,14 +168,18 @@ class Scanner {
      * @param opts Scan options
      * @param value Optional target value
      * @param saveToHistory Whether to save to history
+     * @param control See snapshot()
      * @return Scan response with results
      */
     [[nodiscard]] auto rescan(
         const ScanOptions& opts,
         const std::optional<UserValue>& value = std::nullopt,
-        bool saveToHistory = false) -> ScannerResult {
-        reset();
-        return doScan(opts, value, saveToHistory);
+        bool saveToHistory = false, ScanControl* control = nullptr)
+        -> ScannerResult {
+        m_history.clear();
+        m_filterWorkspace.clear();
+        return doScan(opts, value, saveToHistory, std::exchange(m_matches, {}),
+                      control);
     }
 
     // ====================================================================
@@ -144,10 +201,54 @@ class Scanner {
     }
 
     /**
-     * @brief Get all scan results
+     * @brief Matches of a saved scan result (read back if spilled to disk)
+     */
+    [[nodiscard]] auto getResultMatches(std::size_t index) const
+        -> std::expected<scan::MatchesAndOldValuesArray, std::string> {
+        return m_history.loadMatches(index);
+    }
+
+    /**
+     * @brief Directory history spills into; empty keeps it in RAM
+     */
+    auto setHistorySpillParent(std::string parent) -> void {
+        m_history.setSpillParent(std::move(parent));
+    }
+
+    /**
+     * @brief Number of scan results kept in history
      */
-    [[nodiscard]] auto getResults() const -> const std::deque<ScanRecord>& {
-        return m_history.getAll();
+    auto setHistoryCapacity(std::size_t capacity) -> void {
+        m_history.setCapacity(capacity);
+    }
+
+    /**
+     * @brief Write the current matches to a snapshot file
+     */
+    [[nodiscard]] auto saveSnapshot(const std::string& path) const
+        -> std::expected<void, std::string> {
+        return scan::writeSnapshotFile(path, m_matches, m_lastDataType,
+                                       m_matchAlignment);
+    }
+
+    /**
+     * @brief Replace the current matches with a saved snapshot
+     * @return Number of matches loaded
+     *
+     * The snapshot becomes the baseline for the next filter; it is only
+     * meaningful against a process with the same layout.
+     */
+    [[nodiscard]] auto loadSnapshot(const std::string& path)
+        -> std::expected<std::size_t, std::string> {
+        auto file = scan::SnapshotFile::open(path);
+        if (!file) {
+            return std::unexpected{file.error()};
+        }
+        m_matches = file->load();
+        m_lastDataType = file->dataType();
+        m_matchAlignment = file->alignment();
+        m_softDirtyArmed = false;
+        return m_matches.matchCount();
     }
 
     /**
@@ -155,6 +256,14 @@ class Scanner {
      */
     auto clearResultHistory() -> void { m_history.clear(); }
 
+    /**
+     * @brief Profile of the last scan or filter run with opts.profile
+     * @return Disabled (enabled == false) until one has run
+     */
+    [[nodiscard]] auto lastProfile() const noexcept -> const ScanProfile& {
+        return m_lastProfile;
+    }
+
     /**
      * @brief Get current/active matches from most recent scan
      */
@@ -173,43 +282,29 @@ class Scanner {
     /**
      * @brief Clear current/active matches (does not affect result history)
      */
-    auto clearMatches() -> void { m_matches.swaths.clear(); }
+    auto clearMatches() -> void { m_matches.clear(); }
 
     /**
      * @brief Reset scanner state (clears matches and result history)
      */
     auto reset() -> void {
-        m_matches.swaths.clear();
+        m_matches.clear();
         m_history.clear();
+        m_filterWorkspace.clear();
     }
 
     /**
      * @brief Get number of matches in current scan
      */
     [[nodiscard]] auto getMatchCount() const -> std::size_t {
-        std::size_t count = 0;
-        for (const auto& swath : m_matches.swaths) {
-            for (const auto& element : swath.data) {
-                if (element.matchInfo != MatchFlags::EMPTY) {
-                    ++count;
-                }
-            }
-        }
-        return count;
+        return m_matches.matchCount();
     }
 
     /**
      * @brief Check if current scan has matches
      */
     [[nodiscard]] auto hasMatches() const -> bool {
-        for (const auto& swath : m_matches.swaths) {
-            for (const auto& element : swath.data) {
-                if (element.matchInfo != MatchFlags::EMPTY) {
-                    return true;
-                }
-            }
-        }
-        return false;
+        return m_matches.hasMatches();
     }
 
     /**
@@ -224,31 +319,188 @@ class Scanner {
         return m_lastDataType;
     }
 
+    // ====================================================================
+    // Worker Pool
+    // ====================================================================
+
+    /**
+     * @brief Replace the worker pool configuration
+     *
+     * The pool is rebuilt right away so affinity problems surface here; on
+     * failure the previous configuration stays in effect.
+     */
+    [[nodiscard]] auto configureThreads(utils::ThreadPoolOptions options)
+        -> std::expected<void, std::string> {
+        if (m_sharedPool != nullptr) {
+            return std::unexpected{
+                std::string{"Worker pool is shared with other scanners"}};
+        }
+        if (m_pool && options == m_poolOptions) {
+            return {};
+        }
+        auto pool = std::make_unique<utils::ThreadPool>(options);
+        if (!pool->affinityError().empty()) {
+            return std::unexpected{pool->affinityError()};
+        }
+        m_poolOptions = std::move(options);
+        m_pool = std::move(pool);
+        m_readers.reset(m_pid, m_pool->size());
+        return {};
+    }
+
+    /**
+     * @brief Current worker pool configuration
+     */
+    [[nodiscard]] auto threadOptions() const
+        -> const utils::ThreadPoolOptions& {
+        return m_poolOptions;
+    }
+
+    /**
+     * @brief Enable soft-dirty based incremental scans
+     *
+     * Takes effect from the next snapshot, which clears the dirty bits.
+     * Kernels without soft-dirty tracking keep doing full reads.
+     */
+    auto setIncremental(bool enabled) -> void {
+        m_incremental = enabled;
+        m_softDirtyArmed = false;
+    }
+
+    [[nodiscard]] auto isIncremental() const -> bool { return m_incremental; }
+
+    /**
+     * @brief Whether the stored matches can be refreshed incrementally
+     */
+    [[nodiscard]] auto incrementalReady() const -> bool {
+        return m_softDirtyArmed;
+    }
+
+    /**
+     * @brief Worker count of the pool (starting it if needed)
+     */
+    [[nodiscard]] auto threadCount() -> std::size_t {
+        return workerPool().size();
+    }
+
+    /**
+     * @brief Classifier for the target's current mappings
+     *
+     * Rebuilt only when the maps changed since the last scan or listing.
+     */
+    [[nodiscard]] auto regionClassifier() const
+        -> std::expected<RegionCache::Classifier, std::string> {
+        return m_regionCache.classifier();
+    }
+
    private:
     pid_t m_pid;
     scan::MatchesAndOldValuesArray m_matches;
     ScanHistory m_history;
     std::optional<ScanDataType> m_lastDataType;
+    ScanAlignment m_matchAlignment{ScanAlignment::NONE};  // of m_matches
+    utils::ThreadPoolOptions m_poolOptions;
+    core::ProcMemReaders m_readers;
+    mutable core::RegionCache m_regionCache;  // internally locked
+    std::unique_ptr<utils::ThreadPool> m_pool;  // started on first use
+    utils::ThreadPool* m_sharedPool{nullptr};   // not owned; overrides m_pool
+    bool m_incremental{false};
+    bool m_softDirtyArmed{false};  // dirty bits cleared before m_matches
+    ScanProfile m_lastProfile;     // of the last profiled scan or filter
+    scan::SwathPool m_swathPool;   // only holds planes during doScan
+    FilterWorkspace m_filterWorkspace;
+
+    auto workerPool() -> utils::ThreadPool& {
+        if (m_sharedPool != nullptr) {
+            return *m_sharedPool;
+        }
+        if (!m_pool) {
+            m_pool = std::make_unique<utils::ThreadPool>(m_poolOptions);
+            m_readers.reset(m_pid, m_pool->size());
+        }
+        return *m_pool;
+    }
+
+    // Page dirty bits for the memory behind matches, if they can be trusted
+    [[nodiscard]] auto loadDirtyMap(const scan::MatchesAndOldValuesArray& from,
+                                    std::size_t window) const
+        -> std::optional<SoftDirtyMap> {
+        if (!m_incremental || !m_softDirtyArmed || !from.hasMatches()) {
+            return std::nullopt;
+        }
+        std::vector<SoftDirtyMap::Range> ranges;
+        if (from.isSparse()) {
+            from.forEachMatch([&](const scan::MatchView& match) {
+                ranges.push_back({match.address, match.address + window});
+            });
+        } else {
+            for (const auto& swath : from.swaths) {
+                const auto BEGIN =
+                    reinterpret_cast<std::uintptr_t>(swath.firstByteInChild);
+                if (BEGIN != 0 && !swath.empty()) {
+                    ranges.push_back({BEGIN, BEGIN + swath.size() + window});
+                }
+            }
+        }
+        auto map = SoftDirtyMap::load(m_pid, std::move(ranges));
+        if (!map) {
+            return std::nullopt;
+        }
+        return std::move(*map);
+    }
 
     [[nodiscard]] auto doScan(const ScanOptions& opts,
                               const std::optional<UserValue>& value,
-                              bool saveToHistory) -> ScannerResult {
+                              bool saveToHistory,
+                              scan::MatchesAndOldValuesArray previous,
+                              ScanControl* control)
+        -> ScannerResult {
         m_lastDataType = opts.dataType;
+        m_matchAlignment = opts.alignment;
+        // Dirty bits since the previous snapshot, then restart tracking
+        // before any byte of the new one is read
+        auto dirty = loadDirtyMap(previous, 1);
+        if (!dirty) {
+            // Nothing to reuse: hand the old result's planes to the new
+            // swaths instead of holding both through the scan
+            m_swathPool.recycle(std::move(previous));
+        }
+        m_softDirtyArmed = m_incremental && softDirtySupported() &&
+                           clearSoftDirty(m_pid).has_value();
+        const scan::PageReuse REUSE{.snapshot = &previous,
+                                    .dirty = dirty ? &*dirty : nullptr};
         auto result = runScanParallel(m_pid, opts, value ? &*value : nullptr,
-                                      m_matches, nullptr);
+                                      m_matches, nullptr, &workerPool(),
+                                      &m_readers, &REUSE, &m_regionCache,
+                                      control, &m_swathPool);
+        m_swathPool.clear();  // planes the new result did not take
         if (!result) {
+            m_softDirtyArmed = false;
             return ScannerResult{.stats = {},
                                  .matchCount = 0,
                                  .success = false,
                                  .error = result.error()};
         }
 
+        return finishResult(std::move(*result), opts, value, saveToHistory);
+    }
+
+    // Record the result and keep its profile for lastProfile()
+    auto finishResult(ScanStats stats, const ScanOptions& opts,
+                      const std::optional<UserValue>& value,
+                      bool saveToHistory) -> ScannerResult {
         if (saveToHistory) {
-            saveResultToHistory(*result, opts, value);
+            ProfileTimer history{opts.profile, stats.profile.historyNs};
+            saveResultToHistory(stats, opts, value);
+            history.stop();
+            stats.profile.totalNs += stats.profile.historyNs;
+        }
+        if (opts.profile) {
+            m_lastProfile = stats.profile;
         }
-
         return ScannerResult{
-            .stats = *result, .matchCount = getMatchCount(), .success = true};
+            .stats = std::move(stats), .matchCount = getMatchCount(),
+            .success = true};
     }
 
     auto saveResultToHistory(const ScanStats& stats, const ScanOptions& opts,
@@ -257,18 +509,12 @@ class Scanner {
         record.stats = stats;
         record.opts = opts;
         record.value = value;
-        record.matches = m_matches;
-        m_history.add(std::move(record));
+        // Streamed to the history's snapshot file instead of deep-copied
+        m_history.add(std::move(record), m_matches);
     }
 
     auto pruneEmptySwaths() -> void {
-        auto [eraseBegin, eraseEnd] =
-            std::ranges::remove_if(m_matches.swaths, [](const auto& swath) {
-                return std::ranges::all_of(swath.data, [](const auto& cell) {
-                    return cell.matchInfo == MatchFlags::EMPTY;
-                });
-            });
-        m_matches.swaths.erase(eraseBegin, eraseEnd);
+        m_matches.dropEmptySwaths();
     }
 };
 
@@ -0,0 +1,211 @@
+/**
+ * @file soft_dirty.cppm
+ * @brief Page soft-dirty tracking via clear_refs and pagemap (页面脏位跟踪)
+ *
+ * Writing "4" to /proc/<pid>/clear_refs resets the soft-dirty bit of every
+ * page of the target; the kernel sets it again on the next write. Reading
+ * /proc/<pid>/pagemap afterwards tells which pages may have changed, so a
+ * rescan can take the others from the previous snapshot.
+ *
+ * Requires CONFIG_MEM_SOFT_DIRTY; softDirtySupported() checks for it.
+ * Writes racing the clear itself can be missed unless the target is
+ * stopped while it runs.
+ */
+
+module;
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+export module core.soft_dirty;
+
+export import core.pagemap;
+
+export namespace core {
+
+/**
+ * @brief Whether the running kernel tracks soft-dirty pages
+ *
+ * Without CONFIG_MEM_SOFT_DIRTY the bits never get set and every page
+ * would look clean, so callers must not trust a SoftDirtyMap then. The
+ * "sd" VmFlags mnemonic only exists on kernels that track them.
+ */
+[[nodiscard]] inline auto softDirtySupported() -> bool {
+    static const bool SUPPORTED = []() {
+        std::ifstream smaps("/proc/self/smaps");
+        std::string line;
+        while (std::getline(smaps, line)) {
+            if (line.starts_with("VmFlags:") &&
+                (line + ' ').find(" sd ") != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }();
+    return SUPPORTED;
+}
+
+/**
+ * @brief Reset the soft-dirty bit of every page of pid
+ * @return Expected void or error message
+ */
+[[nodiscard]] inline auto clearSoftDirty(pid_t pid)
+    -> std::expected<void, std::string> {
+    const std::string PATH = std::format("/proc/{}/clear_refs", pid);
+    const int FD = ::open(PATH.c_str(), O_WRONLY | O_CLOEXEC);
+    if (FD < 0) {
+        return std::unexpected{
+            std::format("open {} failed: {}", PATH, std::strerror(errno))};
+    }
+    const ssize_t WRITTEN = ::write(FD, "4", 1);
+    const int ERR = errno;
+    ::close(FD);
+    if (WRITTEN != 1) {
+        return std::unexpected{
+            std::format("write {} failed: {}", PATH, std::strerror(ERR))};
+    }
+    return {};
+}
+
+/**
+ * @class SoftDirtyMap
+ * @brief Per-page "clean since the last clear" bits for some address ranges
+ *
+ * A page counts as clean only if it is present or swapped and its
+ * soft-dirty bit is off; pages outside the loaded ranges, and unmapped
+ * pages (which may have been zapped), are dirty.
+ */
+class SoftDirtyMap {
+   public:
+    struct Range {
+        std::uintptr_t begin{0};
+        std::uintptr_t end{0};
+    };
+
+    SoftDirtyMap() : m_pageSize(PagemapReader::pageSize()) {}
+
+    /**
+     * @brief Read pagemap entries of pid covering ranges
+     *
+     * Ranges are page-aligned outward, sorted and merged first.
+     */
+    [[nodiscard]] static auto load(pid_t pid, std::vector<Range> ranges)
+        -> std::expected<SoftDirtyMap, std::string> {
+        SoftDirtyMap map;
+        PagemapReader pagemap{pid};
+        if (auto err = pagemap.open(); !err) {
+            return std::unexpected{err.error()};
+        }
+
+        std::vector<std::uint64_t> entries;
+        for (const auto& range : map.normalize(std::move(ranges))) {
+            entries.resize((range.end - range.begin) / map.m_pageSize);
+            // 读不到的尾部页按脏页处理
+            const std::size_t DONE = pagemap.read(range.begin, entries);
+            map.addRange(range.begin,
+                         std::span<const std::uint64_t>(entries).first(DONE));
+        }
+        return map;
+    }
+
+    /**
+     * @brief Record raw pagemap entries for the pages starting at begin
+     *
+     * begin must be page-aligned and lie above every range added so far.
+     */
+    void addRange(std::uintptr_t begin,
+                  std::span<const std::uint64_t> entries) {
+        if (entries.empty()) {
+            return;
+        }
+        Run run{.begin = begin,
+                .end = begin + entries.size() * m_pageSize,
+                .clean = std::vector<std::uint64_t>((entries.size() + 63) / 64)};
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const std::uint64_t ENTRY = entries[i];
+            if (pageResident(ENTRY) && (ENTRY & PAGEMAP_SOFT_DIRTY) == 0) {
+                run.clean[i / 64] |= 1ULL << (i % 64);
+                ++m_cleanPages;
+            }
+        }
+        m_pages += entries.size();
+        m_runs.push_back(std::move(run));
+    }
+
+    /** @brief Whether every page overlapping [addr, addr + len) is clean */
+    [[nodiscard]] auto isClean(std::uintptr_t addr, std::size_t len) const
+        -> bool {
+        if (len == 0 || m_cleanPages == 0) {
+            return false;
+        }
+        auto iter = std::ranges::upper_bound(m_runs, addr, {}, &Run::end);
+        if (iter == m_runs.end() || iter->begin > addr ||
+            addr + len > iter->end) {
+            return false;
+        }
+        const std::size_t FIRST = (addr - iter->begin) / m_pageSize;
+        const std::size_t LAST = (addr + len - 1 - iter->begin) / m_pageSize;
+        for (std::size_t page = FIRST; page <= LAST; ++page) {
+            if ((iter->clean[page / 64] & (1ULL << (page % 64))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] auto pageSize() const noexcept -> std::size_t {
+        return m_pageSize;
+    }
+    [[nodiscard]] auto pageCount() const noexcept -> std::size_t {
+        return m_pages;
+    }
+    [[nodiscard]] auto cleanPages() const noexcept -> std::size_t {
+        return m_cleanPages;
+    }
+
+   private:
+    struct Run {
+        std::uintptr_t begin;
+        std::uintptr_t end;
+        std::vector<std::uint64_t> clean;  // one bit per page
+    };
+
+    auto normalize(std::vector<Range> ranges) const -> std::vector<Range> {
+        const std::uintptr_t MASK = ~(static_cast<std::uintptr_t>(m_pageSize) - 1);
+        for (auto& range : ranges) {
+            range.begin &= MASK;
+            range.end = (range.end + m_pageSize - 1) & MASK;
+        }
+        std::erase_if(ranges, [](const Range& r) { return r.begin >= r.end; });
+        std::ranges::sort(ranges, {}, &Range::begin);
+        std::vector<Range> merged;
+        for (const auto& range : ranges) {
+            if (!merged.empty() && range.begin <= merged.back().end) {
+                merged.back().end = std::max(merged.back().end, range.end);
+            } else {
+                merged.push_back(range);
+            }
+        }
+        return merged;
+    }
+
+    std::size_t m_pageSize;
+    std::vector<Run> m_runs;  // sorted, disjoint
+    std::size_t m_pages{0};
+    std::size_t m_cleanPages{0};
+};
+
+}  // namespace core
@@ -0,0 +1,271 @@
+/**
+ * @file watcher.cppm
+ * @brief Background change detection on many addresses (地址监视)
+ *
+ * A Watcher polls a set of addresses from one helper thread. Each tick
+ * reads every address with ProcMemIO::readRanges (one process_vm_readv
+ * per IOV_MAX addresses), compares against the previous tick and pushes
+ * a WatchEvent per changed value into a lock-free ring that the REPL
+ * drains whenever it likes.
+ */
+
+module;
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+export module core.watcher;
+
+import core.proc_mem;
+import utils.periodic_worker;
+import utils.spsc_ring;
+
+export namespace core {
+
+/** @brief One observed change of a watched value */
+struct WatchEvent {
+    std::uintptr_t address{0};
+    std::uint8_t width{0};        ///< Bytes compared, 1-8
+    std::uint64_t oldValue{0};    ///< Previous bytes, host order
+    std::uint64_t newValue{0};
+    std::chrono::steady_clock::time_point when;
+};
+
+/**
+ * @class Watcher
+ * @brief Polls watched addresses at a fixed interval
+ *
+ * add / remove / drain may be called from any thread, but drain must only
+ * be called from one thread at a time (the ring has a single consumer).
+ */
+class Watcher {
+   public:
+    static constexpr std::size_t MAX_WIDTH = sizeof(std::uint64_t);
+    static constexpr std::size_t RING_CAPACITY = 64 * 1024;
+    static constexpr std::chrono::milliseconds DEFAULT_INTERVAL{100};
+
+    using Entry = std::pair<std::uintptr_t, std::size_t>;  ///< address, width
+
+    explicit Watcher(pid_t pid,
+                     std::chrono::milliseconds interval = DEFAULT_INTERVAL)
+        : m_pid(pid),
+          m_interval(std::max(interval, std::chrono::milliseconds{1})),
+          m_events(RING_CAPACITY),
+          m_memIO(pid) {
+        // The fd is the pread fallback when process_vm_readv is refused
+        std::ignore = m_memIO.open();
+        m_worker.start({
+            .hasWork = [this]() { return !m_watched.empty(); },
+            .rebuild = [this]() { rebuild(); },
+            .period = [this]() { return m_interval; },
+            .tick = [this]() { tick(); },
+        });
+    }
+
+    Watcher(const Watcher&) = delete;
+    auto operator=(const Watcher&) -> Watcher& = delete;
+    Watcher(Watcher&&) = delete;
+    auto operator=(Watcher&&) -> Watcher& = delete;
+
+    [[nodiscard]] auto pid() const noexcept -> pid_t { return m_pid; }
+
+    /**
+     * @brief Watch width bytes at address (clamped to 1-8)
+     *
+     * The first value read is the baseline; no event is reported for it.
+     */
+    void add(std::uintptr_t address, std::size_t width = MAX_WIDTH) {
+        const Entry ENTRY{address, width};
+        add(std::span{&ENTRY, 1});
+    }
+
+    /** @brief Watch every (address, width) entry with one helper rebuild */
+    void add(std::span<const Entry> entries) {
+        if (entries.empty()) {
+            return;
+        }
+        m_worker.update([&]() {
+            for (const auto& [address, width] : entries) {
+                m_watched[address] =
+                    std::clamp<std::size_t>(width, 1, MAX_WIDTH);
+            }
+            return true;
+        });
+    }
+
+    auto remove(std::uintptr_t address) -> bool {
+        return m_worker.update(
+            [&]() { return m_watched.erase(address) != 0; });
+    }
+
+    void clear() {
+        m_worker.update([this]() {
+            m_watched.clear();
+            return true;
+        });
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t {
+        return m_worker.locked([this]() { return m_watched.size(); });
+    }
+
+    /** @brief Watched addresses and their widths, by address */
+    [[nodiscard]] auto watched() const -> std::vector<Entry> {
+        return m_worker.locked([this]() {
+            return std::vector<Entry>(m_watched.begin(), m_watched.end());
+        });
+    }
+
+    void setInterval(std::chrono::milliseconds interval) {
+        m_worker.locked([&]() {
+            m_interval = std::max(interval, std::chrono::milliseconds{1});
+        });
+        m_worker.wake();
+    }
+
+    [[nodiscard]] auto interval() const -> std::chrono::milliseconds {
+        return m_worker.locked([this]() { return m_interval; });
+    }
+
+    /**
+     * @brief Hand every queued event to fn, oldest first
+     * @return Number of events drained
+     */
+    template <typename Fn>
+    auto drain(Fn&& fn) -> std::size_t {
+        std::size_t count = 0;
+        while (auto event = m_events.pop()) {
+            fn(*event);
+            ++count;
+        }
+        return count;
+    }
+
+    /** @brief Events lost because nobody drained the ring in time */
+    [[nodiscard]] auto droppedEvents() const noexcept -> std::uint64_t {
+        return m_events.dropped();
+    }
+
+    [[nodiscard]] auto ticks() const noexcept -> std::uint64_t {
+        return m_ticks.load(std::memory_order_relaxed);
+    }
+
+   private:
+    // Helper-side copy of m_watched with read buffers
+    struct Batch {
+        std::vector<ReadRange> ranges;
+        std::vector<std::uint8_t> current;   // MAX_WIDTH per range
+        std::vector<std::uint8_t> previous;  // MAX_WIDTH per range
+        std::vector<std::size_t> got;
+        std::vector<bool> known;  // previous holds a full read
+    };
+
+    void rebuild() {
+        // Keep the baseline of addresses that stay watched
+        std::map<std::uintptr_t, std::size_t> oldSlot;
+        for (std::size_t i = 0; i < m_batch.ranges.size(); ++i) {
+            if (m_batch.known[i]) {
+                const auto* addr = m_batch.ranges[i].addr;
+                oldSlot[reinterpret_cast<std::uintptr_t>(addr)] = i;
+            }
+        }
+        std::vector<std::uint8_t> previous(m_watched.size() * MAX_WIDTH);
+        std::vector<bool> known(m_watched.size());
+        std::vector<ReadRange> ranges;
+        ranges.reserve(m_watched.size());
+        for (const auto& [address, width] : m_watched) {
+            const std::size_t SLOT = ranges.size();
+            auto iter = oldSlot.find(address);
+            if (iter != oldSlot.end() &&
+                m_batch.ranges[iter->second].len == width) {
+                std::memcpy(previous.data() + SLOT * MAX_WIDTH,
+                            m_batch.previous.data() + iter->second * MAX_WIDTH,
+                            MAX_WIDTH);
+                known[SLOT] = true;
+            }
+            ranges.push_back(
+                {.addr = reinterpret_cast<void*>(address), .len = width});
+        }
+        m_batch.ranges = std::move(ranges);
+        m_batch.previous = std::move(previous);
+        m_batch.known = std::move(known);
+        m_batch.current.assign(m_batch.ranges.size() * MAX_WIDTH, 0);
+        m_batch.got.assign(m_batch.ranges.size(), 0);
+    }
+
+    // readRanges packs the values back to back; spread them out into one
+    // MAX_WIDTH slot each so compare() can work on whole words
+    auto readAll() -> bool {
+        std::size_t total = 0;
+        for (const auto& range : m_batch.ranges) {
+            total += range.len;
+        }
+        m_packed.resize(total);
+        if (!m_memIO.readRanges(m_batch.ranges, m_packed, m_batch.got)) {
+            return false;
+        }
+        std::size_t offset = 0;
+        std::ranges::fill(m_batch.current, 0);
+        for (std::size_t i = 0; i < m_batch.ranges.size(); ++i) {
+            std::memcpy(m_batch.current.data() + i * MAX_WIDTH,
+                        m_packed.data() + offset, m_batch.ranges[i].len);
+            offset += m_batch.ranges[i].len;
+        }
+        return true;
+    }
+
+    void compare() {
+        const auto NOW = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < m_batch.ranges.size(); ++i) {
+            if (m_batch.got[i] != m_batch.ranges[i].len) {
+                m_batch.known[i] = false;  // unreadable now, rebaseline later
+                continue;
+            }
+            auto* cur = m_batch.current.data() + i * MAX_WIDTH;
+            auto* prev = m_batch.previous.data() + i * MAX_WIDTH;
+            if (m_batch.known[i] && std::memcmp(cur, prev, MAX_WIDTH) != 0) {
+                WatchEvent event{
+                    .address = reinterpret_cast<std::uintptr_t>(
+                        m_batch.ranges[i].addr),
+                    .width = static_cast<std::uint8_t>(m_batch.ranges[i].len),
+                    .when = NOW};
+                std::memcpy(&event.oldValue, prev, MAX_WIDTH);
+                std::memcpy(&event.newValue, cur, MAX_WIDTH);
+                m_events.push(event);
+            }
+            std::memcpy(prev, cur, MAX_WIDTH);
+            m_batch.known[i] = true;
+        }
+    }
+
+    void tick() {
+        if (!m_batch.ranges.empty() && readAll()) {
+            compare();
+            m_ticks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    pid_t m_pid;
+    // Guarded by m_worker
+    std::map<std::uintptr_t, std::size_t> m_watched;  // address -> width
+    std::chrono::milliseconds m_interval;
+    utils::SpscRing<WatchEvent> m_events;
+    ProcMemIO m_memIO;  // helper only, like m_batch and m_packed
+    Batch m_batch;
+    std::vector<std::uint8_t> m_packed;
+    std::atomic<std::uint64_t> m_ticks{0};
+    utils::PeriodicWorker m_worker;
+};
+
+}  // namespace core
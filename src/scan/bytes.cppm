@@ -3,15 +3,15 @@ module;
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
-#include <iterator>
 #include <optional>
-#include <ranges>
+#include <span>
 #include <vector>
 
 export module scan.bytes;
 
 import scan.types;
 import scan.routine;
+import scan.pattern_set;
 import value.flags;
 
 import value.core;
@@ -20,7 +20,8 @@ import value.core;
 // Public utilities:
 // - compareBytes / compareBytesMasked: check whether the buffer prefix at the
 //   current offset matches the supplied pattern (NOT a search).
-// - findBytePattern / findBytePatternMasked: search for the first occurrence.
+// - findBytePattern / findBytePatternMasked: search for the first occurrence
+//   (via scan::PatternSet, so no per-offset rescans).
 // - makeBytearrayScanRoutine: build a scan routine for byte array matches.
 
 export inline auto makeBytearrayScanRoutine(ScanMatchType matchType)
@@ -100,16 +101,11 @@ export inline auto findBytePattern(const Value* memoryPtr, size_t memLength,
     if (LIMIT < patternSize) {
         return std::nullopt;
     }
-    auto hayView = hayAll | std::views::take(LIMIT);
-    auto patternView = std::views::counted(
-        patternData, static_cast<std::ptrdiff_t>(patternSize));
-    auto searchResult = std::ranges::search(hayView, patternView);
-    if (searchResult.empty()) {
-        return std::nullopt;
-    }
-    auto off = static_cast<size_t>(
-        std::ranges::distance(hayView.begin(), searchResult.begin()));
-    return ByteMatch{.offset = off, .length = patternSize};
+    scan::BytePattern pattern{
+        .bytes = std::vector<std::uint8_t>(patternData, patternData + patternSize),
+        .mask = std::vector<std::uint8_t>(patternSize, 0xFF)};
+    return scan::PatternSet::compile({std::move(pattern)})
+        .findFirst(std::span<const std::uint8_t>(hayAll.data(), LIMIT));
 }
 
 // Convenience overload for vector
@@ -133,21 +129,11 @@ export inline auto findBytePatternMasked(
     if (LIMIT < patternSize) {
         return std::nullopt;
     }
-    for (size_t hayIndex = 0; hayIndex + patternSize <= LIMIT; ++hayIndex) {
-        bool matched = true;
-        for (size_t patternIndex = 0; patternIndex < patternSize;
-             ++patternIndex) {
-            if (((hayAll[hayIndex + patternIndex] ^ patternData[patternIndex]) &
-                 maskData[patternIndex]) != 0) {
-                matched = false;
-                break;
-            }
-        }
-        if (matched) {
-            return ByteMatch{.offset = hayIndex, .length = patternSize};
-        }
-    }
-    return std::nullopt;
+    scan::BytePattern pattern{
+        .bytes = std::vector<std::uint8_t>(patternData, patternData + patternSize),
+        .mask = std::vector<std::uint8_t>(maskData, maskData + maskSize)};
+    return scan::PatternSet::compile({std::move(pattern)})
+        .findFirst(std::span<const std::uint8_t>(hayAll.data(), LIMIT));
 }
 
 // Convenience overload for vectors
@@ -159,41 +145,51 @@ export inline auto findBytePatternMasked(
                                  pattern.size(), mask.data(), mask.size());
 }
 
+// Whether pattern (with its mask, if any) matches at memory[0]
+inline auto bytePatternMatchesAt(std::span<const std::uint8_t> memory,
+                                 const Value& pattern) -> bool {
+    const auto& bytes = pattern.bytes;
+    if (bytes.empty() || bytes.size() > memory.size()) {
+        return false;
+    }
+    if (pattern.mask && pattern.mask->size() == bytes.size()) {
+        const auto& mask = *pattern.mask;
+        for (size_t j = 0; j < bytes.size(); ++j) {
+            if (((memory[j] ^ bytes[j]) & mask[j]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return std::equal(bytes.begin(), bytes.end(), memory.begin());
+}
+
+/* Per-offset routine: the longest of the user value's patterns matching at
+ * the offset wins. Whole-block searches go through scan.pattern_set. */
 export inline auto makeBytearrayScanRoutine(ScanMatchType matchType)
     -> scan::ScanRoutine {
     return [matchType](const scan::ScanContext& ctx) -> scan::ScanResult {
-        MatchFlags flags = MatchFlags::EMPTY;
         if (matchType == ScanMatchType::MATCH_ANY) {
             return scan::ScanResult::match(ctx.memory.size(), MatchFlags::B8);
         }
         if (!ctx.userValue || ctx.userValue->flag() != MatchFlags::BYTE_ARRAY) {
             return scan::ScanResult::noMatch();
         }
-        const auto& patternValue = ctx.userValue->primary;
-        const auto& byteArrayRef = patternValue.bytes;
-        if (byteArrayRef.empty()) {
-            return scan::ScanResult::noMatch();
-        }
-        Value memoryValue{ctx.memory.data(), ctx.memory.size()};
-        if (patternValue.mask &&
-            patternValue.mask->size() == byteArrayRef.size()) {
-            unsigned matchedLen = compareBytesMasked(
-                &memoryValue, ctx.memory.size(), byteArrayRef.data(),
-                byteArrayRef.size(), patternValue.mask->data(),
-                patternValue.mask->size(), &flags);
-            if (matchedLen > 0) {
-                return scan::ScanResult::match(
-                    matchedLen, flags | MatchFlags::BYTE_ARRAY);
+        size_t matchedLen = 0;
+        auto consider = [&](const Value& pattern) {
+            if (pattern.size() > matchedLen &&
+                bytePatternMatchesAt(ctx.memory, pattern)) {
+                matchedLen = pattern.size();
             }
-            return scan::ScanResult::noMatch();
+        };
+        consider(ctx.userValue->primary);
+        for (const auto& alternative : ctx.userValue->alternatives) {
+            consider(alternative);
         }
-        unsigned matchedLen =
-            compareBytes(&memoryValue, ctx.memory.size(), byteArrayRef.data(),
-                         byteArrayRef.size(), &flags);
-        if (matchedLen > 0) {
-            return scan::ScanResult::match(matchedLen,
-                                           flags | MatchFlags::BYTE_ARRAY);
+        if (matchedLen == 0) {
+            return scan::ScanResult::noMatch();
         }
-        return scan::ScanResult::noMatch();
+        return scan::ScanResult::match(matchedLen,
+                                       MatchFlags::B8 | MatchFlags::BYTE_ARRAY);
     };
 }
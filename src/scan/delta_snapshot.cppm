@@ -0,0 +1,192 @@
+/**
+ * @file delta_snapshot.cppm
+ * @brief In-memory snapshot sharing unchanged bytes with its predecessor
+ *        (增量快照)
+ *
+ * Consecutive scans mostly narrow the match set while the old bytes stay
+ * the same. A DeltaSnapshot cuts every swath's bytes into fixed chunks and
+ * takes over the chunk of the previous snapshot at the same address when
+ * its contents are equal, so keeping a step of history costs the changed
+ * chunks plus the delta-coded match list (see snapshot_file.cppm) instead
+ * of a deep copy of the array.
+ *
+ * Chunks are immutable and reference counted; dropping an older snapshot
+ * never invalidates a newer one that shares its chunks.
+ */
+
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module scan.delta_snapshot;
+
+import scan.match_storage;
+import scan.snapshot_file;
+
+export namespace scan {
+
+/**
+ * @class DeltaSnapshot
+ * @brief Immutable copy of a MatchesAndOldValuesArray with shared chunks
+ */
+class DeltaSnapshot {
+   public:
+    /** @brief Granularity at which bytes are shared */
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    using Chunk = std::shared_ptr<const ByteBuffer>;
+
+    DeltaSnapshot() = default;
+
+    /**
+     * @brief Snapshot matches, reusing equal chunks of previous
+     * @param matches Array to copy; a sparse array is densified first
+     * @param previous Snapshot to share chunks with, or nullptr
+     */
+    [[nodiscard]] static auto build(const MatchesAndOldValuesArray& matches,
+                                    const DeltaSnapshot* previous)
+        -> DeltaSnapshot {
+        std::optional<MatchesAndOldValuesArray> dense;
+        if (matches.isSparse()) {
+            dense.emplace(matches);
+            dense->densify();
+        }
+        const auto LOOKUP = previous != nullptr ? previous->chunkIndex()
+                                                : std::vector<ChunkRef>{};
+
+        DeltaSnapshot snapshot;
+        for (const auto& swath : dense ? dense->swaths : matches.swaths) {
+            if (swath.firstByteInChild == nullptr || swath.empty()) {
+                continue;
+            }
+            Region region{
+                .address = reinterpret_cast<std::uintptr_t>(swath.firstByteInChild),
+                .size = swath.size()};
+            const auto BYTES = swath.bytes();
+            for (std::size_t offset = 0; offset < BYTES.size();
+                 offset += CHUNK_SIZE) {
+                const auto PIECE = BYTES.subspan(
+                    offset, std::min(CHUNK_SIZE, BYTES.size() - offset));
+                Chunk chunk = findEqual(LOOKUP, region.address + offset, PIECE);
+                if (!chunk) {
+                    chunk = std::make_shared<const ByteBuffer>(PIECE.begin(),
+                                                               PIECE.end());
+                    snapshot.m_ownedBytes += PIECE.size();
+                }
+                region.chunks.push_back(std::move(chunk));
+            }
+            region.code = detail::encodeMatches(swath, region.matches);
+            region.matches.shrink_to_fit();
+            snapshot.m_byteCount += region.size;
+            snapshot.m_matchCount += region.code.matchCount;
+            snapshot.m_regions.push_back(std::move(region));
+        }
+        return snapshot;
+    }
+
+    [[nodiscard]] auto regionCount() const noexcept -> std::size_t {
+        return m_regions.size();
+    }
+    [[nodiscard]] auto byteCount() const noexcept -> std::size_t {
+        return m_byteCount;
+    }
+    [[nodiscard]] auto matchCount() const noexcept -> std::size_t {
+        return m_matchCount;
+    }
+
+    /** @brief Bytes this snapshot allocated rather than shared */
+    [[nodiscard]] auto ownedBytes() const noexcept -> std::size_t {
+        return m_ownedBytes;
+    }
+
+    /** @brief Approximate heap bytes allocated by this snapshot itself */
+    [[nodiscard]] auto memoryUsage() const noexcept -> std::size_t {
+        std::size_t total = m_regions.capacity() * sizeof(Region) + m_ownedBytes;
+        for (const auto& region : m_regions) {
+            total += region.chunks.capacity() * sizeof(Chunk) +
+                     region.matches.capacity();
+        }
+        return total;
+    }
+
+    /** @brief Rebuild the array the snapshot was taken of */
+    [[nodiscard]] auto load() const -> MatchesAndOldValuesArray {
+        MatchesAndOldValuesArray out;
+        out.swaths.reserve(m_regions.size());
+        for (const auto& region : m_regions) {
+            ByteBuffer bytes;
+            bytes.reserve(region.size);
+            for (const auto& chunk : region.chunks) {
+                bytes.insert(bytes.end(), chunk->begin(), chunk->end());
+            }
+            MatchesAndOldValuesSwath swath{
+                reinterpret_cast<void*>(region.address), std::move(bytes)};
+            detail::decodeMatches(region.matches, region.code, region.size,
+                                  [&](std::size_t index, MatchInfo info) {
+                                      swath.setMatch(index, info.flags,
+                                                     info.length);
+                                  });
+            out.addSwath(std::move(swath));
+        }
+        return out;
+    }
+
+   private:
+    struct Region {
+        std::uintptr_t address{0};
+        std::size_t size{0};
+        std::vector<Chunk> chunks;  // CHUNK_SIZE each, the last maybe shorter
+        std::vector<std::uint8_t> matches;  // delta coded
+        detail::MatchCode code{};
+    };
+
+    struct ChunkRef {
+        std::uintptr_t address;
+        const Chunk* chunk;
+    };
+
+    // Every chunk by start address, sorted for findEqual
+    [[nodiscard]] auto chunkIndex() const -> std::vector<ChunkRef> {
+        std::vector<ChunkRef> index;
+        for (const auto& region : m_regions) {
+            for (std::size_t i = 0; i < region.chunks.size(); ++i) {
+                index.push_back({region.address + i * CHUNK_SIZE,
+                                 &region.chunks[i]});
+            }
+        }
+        std::ranges::sort(index, {}, &ChunkRef::address);
+        return index;
+    }
+
+    [[nodiscard]] static auto findEqual(const std::vector<ChunkRef>& index,
+                                        std::uintptr_t address,
+                                        std::span<const std::uint8_t> bytes)
+        -> Chunk {
+        auto iter = std::ranges::lower_bound(index, address, {},
+                                             &ChunkRef::address);
+        if (iter == index.end() || iter->address != address) {
+            return nullptr;
+        }
+        const auto& chunk = *iter->chunk;
+        if (chunk->size() != bytes.size() ||
+            std::memcmp(chunk->data(), bytes.data(), bytes.size()) != 0) {
+            return nullptr;
+        }
+        return chunk;
+    }
+
+    std::vector<Region> m_regions;
+    std::size_t m_byteCount{0};
+    std::size_t m_matchCount{0};
+    std::size_t m_ownedBytes{0};
+};
+
+}  // namespace scan
@@ -4,207 +4,957 @@ module;
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
-#include <latch>
+#include <mutex>
+#include <optional>
 #include <span>
+#include <stop_token>
 #include <thread>
+#include <utility>
 #include <vector>
 
 export module scan.engine;
 
 import scan.factory;
 import scan.job;
+import scan.kernel;
+import scan.snapshot_index;
 import scan.match_storage;
 import scan.types;
 import scan.routine;
 import value.core;
 import value.flags;
 import core.maps;
+import core.pagemap;
 import core.proc_mem;
+import core.process_pause;
+import core.region_cache;
+import core.soft_dirty;
+import utils.thread_pool;
 
 namespace scan {
 
 using core::ProcMemIO;
 using core::Region;
 
-inline void appendBytesToSwath(MatchesAndOldValuesSwath& swath,
-                               const std::uint8_t* buffer,
-                               std::size_t bytesRead, void* baseAddr) {
-    if (swath.data.empty()) {
-        swath.firstByteInChild = baseAddr;
+// Regions larger than this are split so several workers can share them
+constexpr std::size_t SCAN_CHUNK_BYTES = 16 * 1024 * 1024;
+
+/** @brief A block-aligned slice of one region, the unit of parallel work */
+struct ScanChunk {
+    std::size_t region;  ///< Index into the region list
+    std::size_t offset;  ///< Bytes from the region start
+    std::size_t size;
+    std::size_t lead{0};  ///< Bytes before offset read as look-behind only
+};
+
+/**
+ * @brief Split readable regions into chunks of at most SCAN_CHUNK_BYTES
+ *
+ * Chunk sizes are a multiple of the block size, so blocks fall on the same
+ * addresses as in an unsplit scan. Every chunk but a region's first also
+ * reads the lookBehind bytes before it without matching in them, so a
+ * string or group straddling two chunks is still found by the second;
+ * addChunkSwaths() then hands that overlap to the later chunk's swath.
+ */
+inline auto planScanChunks(std::span<const Region> regions,
+                           std::size_t blockSize, std::size_t lookBehind)
+    -> std::vector<ScanChunk> {
+    const std::size_t BLOCK = std::max<std::size_t>(1, blockSize);
+    const std::size_t CHUNK = std::max(BLOCK, SCAN_CHUNK_BYTES / BLOCK * BLOCK);
+    std::vector<ScanChunk> chunks;
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        const auto& region = regions[i];
+        if (!region.isReadable() || region.size == 0) {
+            continue;
+        }
+        for (std::size_t offset = 0; offset < region.size; offset += CHUNK) {
+            chunks.push_back({.region = i,
+                              .offset = offset,
+                              .size = std::min(CHUNK, region.size - offset),
+                              .lead = std::min(offset, lookBehind)});
+        }
+    }
+    return chunks;
+}
+
+/**
+ * @brief Append one chunk's swaths to out, in address order
+ *
+ * A chunk with a lead starts its first swaths inside the previous chunk's
+ * last ones. Swaths that end there hold only look-behind bytes and are
+ * dropped. The previous matches overlapped by the first swath left move
+ * into it (it also holds the matches straddling the boundary), and the
+ * earlier swaths are cut where it starts, so no address is kept twice.
+ *
+ * @return Matches both chunks counted, to take off the scan's total
+ */
+export inline auto addChunkSwaths(MatchesAndOldValuesArray& out,
+                                  std::vector<MatchesAndOldValuesSwath>& swaths)
+    -> std::size_t {
+    const auto BASE = [](const MatchesAndOldValuesSwath& swath) {
+        return static_cast<const std::uint8_t*>(swath.firstByteInChild);
+    };
+    std::size_t duplicates = 0;
+    if (!out.swaths.empty()) {
+        const auto& last = out.swaths.back();
+        const auto* LAST_END = BASE(last) + last.size();
+        // Matching skips the lead, so these have no matches of their own
+        const auto LEAD_ONLY = std::ranges::find_if(
+            swaths, [&](const MatchesAndOldValuesSwath& swath) {
+                return BASE(swath) + swath.size() > LAST_END;
+            });
+        swaths.erase(swaths.begin(), LEAD_ONLY);
+    }
+    if (!swaths.empty()) {
+        auto& next = swaths.front();
+        const auto* NEXT_BASE = BASE(next);
+        while (!out.swaths.empty()) {
+            auto& last = out.swaths.back();
+            const auto* LAST_BASE = BASE(last);
+            if (LAST_BASE + last.size() <= NEXT_BASE) {
+                break;
+            }
+            const std::size_t KEEP =
+                NEXT_BASE > LAST_BASE ? NEXT_BASE - LAST_BASE : 0;
+            for (auto index = last.nextMatch(KEEP);
+                 index != MatchesAndOldValuesSwath::NPOS;
+                 index = last.nextMatch(index + 1)) {
+                const auto AT =
+                    static_cast<std::size_t>(LAST_BASE + index - NEXT_BASE);
+                if (next.isMatch(AT)) {
+                    ++duplicates;  // e.g. a regex match the boundary cut
+                    continue;
+                }
+                const auto INFO = last.matchInfo(index);
+                next.setMatch(AT, INFO.flags, INFO.length);
+            }
+            out.invalidateMatchIndex();
+            if (KEEP > 0) {
+                last.resize(KEEP);
+                last.shrinkToFit();
+                break;
+            }
+            out.swaths.pop_back();  // next covers all of it
+        }
     }
-    for (std::size_t index = 0; index < bytesRead; ++index) {
-        swath.data.push_back({.oldByte = buffer[index],
-                              .matchInfo = MatchFlags::EMPTY,
-                              .matchLength = 0});
+    for (auto& swath : swaths) {
+        out.addSwath(std::move(swath));
     }
+    return duplicates;
 }
 
-inline auto fetchOldBytes(const MatchesAndOldValuesArray& previous,
-                          void* address, std::size_t length,
-                          std::vector<std::uint8_t>& out) -> bool {
-    if (address == nullptr || length == 0) {
-        return false;
+// Publish the totals of a scan over chunks (regions count by first chunk)
+inline void startProgress(ScanControl* control,
+                          std::span<const ScanChunk> chunks) {
+    if (control == nullptr) {
+        return;
     }
-    for (const auto& swath : previous.swaths) {
-        if (swath.firstByteInChild == nullptr || swath.data.empty()) {
-            continue;
+    std::size_t bytes = 0;
+    std::size_t regions = 0;
+    for (const auto& chunk : chunks) {
+        bytes += chunk.size;
+        regions += chunk.offset == 0 ? 1 : 0;
+    }
+    control->start(bytes, regions, 0);
+}
+
+// Bytes fetched per read-ahead request (rounded to whole blocks)
+constexpr std::size_t READ_AHEAD_BYTES = 1024 * 1024;
+
+/**
+ * @class ReadAhead
+ * @brief One helper thread that runs a single outstanding read
+ *
+ * The scanning thread submits the next span and matches the current one
+ * while the helper sits in pread. Only one request is in flight and only
+ * one thread submits, so a mutex and a condition variable suffice.
+ */
+export class ReadAhead {
+   public:
+    ReadAhead()
+        : m_thread([this](const std::stop_token& stop) { loop(stop); }) {}
+
+    ~ReadAhead() {
+        {
+            // Stopping outside m_mutex could land between loop()'s
+            // predicate check and its sleep
+            std::scoped_lock lock(m_mutex);
+            m_thread.request_stop();
         }
-        const auto* base =
-            static_cast<const std::uint8_t*>(swath.firstByteInChild);
-        const auto* current = static_cast<const std::uint8_t*>(address);
-        if (current < base) {
-            continue;
+        m_cv.notify_all();
+    }
+
+    ReadAhead(const ReadAhead&) = delete;
+    auto operator=(const ReadAhead&) -> ReadAhead& = delete;
+    ReadAhead(ReadAhead&&) = delete;
+    auto operator=(ReadAhead&&) -> ReadAhead& = delete;
+
+    /** @brief Start reading len bytes at addr into dst */
+    void submit(const ProcMemIO& reader, void* addr, std::uint8_t* dst,
+                std::size_t len) {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_reader = &reader;
+            m_addr = addr;
+            m_dst = dst;
+            m_len = len;
+            m_state = State::REQUESTED;
         }
-        const auto OFFSET = static_cast<std::size_t>(current - base);
-        if (OFFSET >= swath.data.size()) {
-            continue;
+        m_cv.notify_all();
+    }
+
+    /** @brief Wait for the submitted read; bytes read, 0 on error */
+    auto wait() -> std::size_t {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_state == State::DONE; });
+        m_state = State::IDLE;
+        return m_got;
+    }
+
+   private:
+    enum class State : std::uint8_t { IDLE, REQUESTED, DONE };
+
+    void loop(const std::stop_token& stop) {
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [&]() {
+                return stop.stop_requested() || m_state == State::REQUESTED;
+            });
+            if (stop.stop_requested()) {
+                return;
+            }
+            lock.unlock();
+            const std::size_t GOT =
+                m_reader->read(m_addr, m_dst, m_len).value_or(0);
+            lock.lock();
+            m_got = GOT;
+            m_state = State::DONE;
+            m_cv.notify_all();
         }
-        const std::size_t REAMINING = swath.data.size() - OFFSET;
-        if (REAMINING < length) {
-            continue;
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    State m_state{State::IDLE};
+    const ProcMemIO* m_reader{nullptr};
+    void* m_addr{nullptr};
+    std::uint8_t* m_dst{nullptr};
+    std::size_t m_len{0};
+    std::size_t m_got{0};
+    std::jthread m_thread;  // joined before the request fields go away
+};
+
+/**
+ * @brief Earlier snapshot a scan may copy clean pages from
+ *
+ * dirty must have been loaded after the soft-dirty bits were cleared
+ * right before snapshot was taken; pages it reports clean then still hold
+ * the snapshot's bytes.
+ */
+export struct PageReuse {
+    const MatchesAndOldValuesArray* snapshot{nullptr};
+    const core::SoftDirtyMap* dirty{nullptr};
+};
+
+// pagemap entries fetched per lookup
+constexpr std::size_t PAGEMAP_WINDOW = 512;
+
+/** @brief Private mappings without a backing file read as zero until written */
+inline auto isAnonymous(const Region& region) -> bool {
+    const auto& name = region.filename;
+    return region.isPrivate() &&
+           (name.empty() || name.starts_with("[heap]") ||
+            name.starts_with("[stack") || name.starts_with("[anon:"));
+}
+
+/**
+ * @class PageFiller
+ * @brief Decides per page whether a block must come from the target
+ *
+ * Untouched anonymous pages are known to be zero; clean pages covered by
+ * the reuse snapshot still hold its bytes. Only the remaining pages are
+ * read. Swapped-out pages count as resident and are read, which swaps
+ * them back in.
+ */
+class PageFiller {
+   public:
+    enum class Plan : std::uint8_t {
+        READ,  ///< Read the whole block
+        FILL,  ///< Assemble it with fill()
+        HOLE,  ///< Nothing resident; leave it out of the snapshot
+    };
+
+    PageFiller(pid_t pid, AbsentPages absent, const SnapshotIndex* reuseIndex,
+               const core::SoftDirtyMap* dirty)
+        : m_absent(absent),
+          m_cursor(reuseIndex),
+          m_dirty(dirty != nullptr && dirty->cleanPages() > 0 ? dirty
+                                                              : nullptr),
+          m_pagemap(pid) {
+        if (m_absent != AbsentPages::READ && !m_pagemap.open()) {
+            m_absent = AbsentPages::READ;  // 无法读取 pagemap, 全部照常读取
+        }
+    }
+
+    /** @brief Whether plan() can ever return anything but READ */
+    [[nodiscard]] auto active() const noexcept -> bool {
+        return m_absent != AbsentPages::READ || m_dirty != nullptr;
+    }
+
+    /**
+     * @brief Classify the pages of [addr, addr + len)
+     * @param anonymous Whether the block lies in an anonymous mapping
+     */
+    auto plan(std::uint8_t* addr, std::size_t len, bool anonymous) -> Plan {
+        m_kinds.clear();
+        m_planned = addr;
+        const bool KNOWN_ZERO = anonymous && m_absent != AbsentPages::READ;
+        if (len == 0 || (!KNOWN_ZERO && m_dirty == nullptr)) {
+            return Plan::READ;
         }
-        out.resize(length);
-        for (std::size_t index = 0; index < length; ++index) {
-            out[index] = swath.data[OFFSET + index].oldByte;
+        m_segments = m_dirty != nullptr ? m_cursor.segmentsFor(addr, len, 1)
+                                        : std::span<const OldSegment>{};
+        if (!KNOWN_ZERO && m_segments.empty()) {
+            return Plan::READ;
         }
+
+        const auto BEGIN = reinterpret_cast<std::uintptr_t>(addr);
+        const std::size_t PAGE = core::PagemapReader::pageSize();
+        std::size_t segment = 0;
+        bool resident = false;
+        bool fill = false;
+        for (std::size_t pos = 0; pos < len;) {
+            const std::size_t PAGE_END = std::min(
+                len, ((BEGIN + pos) / PAGE + 1) * PAGE - BEGIN);
+            PageKind kind = PageKind::READ;
+            if (KNOWN_ZERO && !core::pageResident(entryAt((BEGIN + pos) / PAGE))) {
+                kind = PageKind::ZERO;
+            } else {
+                resident = true;
+                while (segment < m_segments.size() &&
+                       m_segments[segment].blockOffset +
+                               m_segments[segment].bytes.size() <=
+                           pos) {
+                    ++segment;
+                }
+                if (segment < m_segments.size() &&
+                    m_segments[segment].covers(pos, PAGE_END - pos) &&
+                    m_dirty->isClean(BEGIN + pos, PAGE_END - pos)) {
+                    kind = PageKind::COPY;
+                }
+            }
+            fill = fill || kind != PageKind::READ;
+            m_kinds.push_back(kind);
+            pos = PAGE_END;
+        }
+        if (!resident && m_absent == AbsentPages::SKIP) {
+            return Plan::HOLE;
+        }
+        return fill ? Plan::FILL : Plan::READ;
+    }
+
+    /**
+     * @brief Fill dst with the len bytes at addr, as planned by plan()
+     * @return False if a read came back short; the caller then reads the
+     *         whole block as usual
+     */
+    auto fill(const ProcMemIO& reader, std::uint8_t* addr, std::uint8_t* dst,
+              std::size_t len, ScanStats& stats) -> bool {
+        if (addr != m_planned || m_kinds.empty()) {
+            return false;
+        }
+        const auto BEGIN = reinterpret_cast<std::uintptr_t>(addr);
+        const std::size_t PAGE = core::PagemapReader::pageSize();
+        constexpr std::size_t NO_RUN = static_cast<std::size_t>(-1);
+        std::size_t runStart = NO_RUN;
+        std::size_t reused = 0;
+        std::size_t zeroed = 0;
+        std::size_t segment = 0;
+
+        auto readRun = [&](std::size_t end) -> bool {
+            if (runStart == NO_RUN) {
+                return true;
+            }
+            const std::size_t LEN = end - runStart;
+            const ProfileTimer TIMER{stats.profile.enabled, stats.profile.ioNs};
+            auto got = reader.read(addr + runStart, dst + runStart, LEN);
+            if (stats.profile.enabled) {
+                stats.profile.countRead(LEN, got.value_or(0));
+            }
+            runStart = NO_RUN;
+            return got && *got == LEN;
+        };
+
+        std::size_t page = 0;
+        for (std::size_t pos = 0; pos < len; ++page) {
+            const std::size_t PAGE_END = std::min(
+                len, ((BEGIN + pos) / PAGE + 1) * PAGE - BEGIN);
+            const std::size_t BYTES = PAGE_END - pos;
+            switch (m_kinds[page]) {
+                case PageKind::READ:
+                    if (runStart == NO_RUN) {
+                        runStart = pos;
+                    }
+                    break;
+                case PageKind::COPY:
+                    if (!readRun(pos)) {
+                        return false;
+                    }
+                    while (m_segments[segment].blockOffset +
+                               m_segments[segment].bytes.size() <=
+                           pos) {
+                        ++segment;
+                    }
+                    std::memcpy(dst + pos, m_segments[segment].at(pos), BYTES);
+                    reused += BYTES;
+                    break;
+                case PageKind::ZERO:
+                    if (!readRun(pos)) {
+                        return false;
+                    }
+                    std::memset(dst + pos, 0, BYTES);
+                    zeroed += BYTES;
+                    break;
+            }
+            pos = PAGE_END;
+        }
+        if (!readRun(len)) {
+            return false;
+        }
+        stats.bytesReused += reused;
+        stats.bytesSkipped += zeroed;
         return true;
     }
-    return false;
-}
 
-inline auto makeOldValue(const MatchesAndOldValuesArray* previousSnapshot,
-                         void* address, std::size_t length)
-    -> std::optional<Value> {
-    if (previousSnapshot == nullptr || address == nullptr || length == 0) {
-        return std::nullopt;
+   private:
+    enum class PageKind : std::uint8_t { READ, COPY, ZERO };
+
+    // Entry of page number page; unreadable entries count as resident
+    auto entryAt(std::uintptr_t page) -> std::uint64_t {
+        if (page < m_windowPage || page >= m_windowPage + m_window.size()) {
+            m_window.resize(PAGEMAP_WINDOW);
+            const std::size_t GOT = m_pagemap.read(
+                page * core::PagemapReader::pageSize(), m_window);
+            std::fill(m_window.begin() + static_cast<std::ptrdiff_t>(GOT),
+                      m_window.end(), core::PAGEMAP_PRESENT);
+            m_windowPage = page;
+        }
+        return m_window[page - m_windowPage];
     }
-    std::vector<std::uint8_t> oldBytes;
-    if (!fetchOldBytes(*previousSnapshot, address, length, oldBytes)) {
-        return std::nullopt;
+
+    AbsentPages m_absent;
+    SnapshotCursor m_cursor;
+    const core::SoftDirtyMap* m_dirty;
+    core::PagemapReader m_pagemap;
+    std::vector<std::uint64_t> m_window;  // pagemap entries from m_windowPage
+    std::uintptr_t m_windowPage{0};
+    // Result of the last plan()
+    std::uint8_t* m_planned{nullptr};
+    std::vector<PageKind> m_kinds;
+    std::span<const OldSegment> m_segments;
+};
+
+// Whether opts restricts region's candidates to aligned addresses
+inline auto alignsCandidates(const ScanOptions& opts, const Region& region)
+    -> bool {
+    return opts.alignment == ScanAlignment::NATURAL &&
+           !(opts.unalignedRegions.isActive() &&
+             opts.unalignedRegions.isRegionAllowed(region));
+}
+
+/**
+ * @brief Run the kernel over length bytes already at index in the swath
+ * @return Matches marked
+ */
+inline auto matchBlock(MatchesAndOldValuesSwath& swath, std::size_t index,
+                       std::size_t length, const ScanOptions& opts,
+                       bool aligned, const ScanKernel& kernel,
+                       const UserValue* userValue, ScanStats& stats,
+                       SnapshotCursor& previous, std::size_t oldSliceLen)
+    -> std::size_t {
+    const std::size_t ALIGN = aligned ? naturalAlignment(opts.dataType) : 1;
+    auto* swathBase = static_cast<std::uint8_t*>(swath.firstByteInChild);
+    if (ALIGN > 1) {
+        // Start at the block's first aligned address, not its offset
+        const auto MISALIGN =
+            reinterpret_cast<std::uintptr_t>(swathBase + index) % ALIGN;
+        const std::size_t SKIP = MISALIGN == 0 ? 0 : ALIGN - MISALIGN;
+        if (SKIP >= length) {
+            return 0;
+        }
+        index += SKIP;
+        length -= SKIP;
     }
+    auto* baseAddr = swathBase + index;
+    const BlockScanArgs ARGS{
+        .memory = std::span<const std::uint8_t>(swath.bytes().data() + index,
+                                                length),
+        .address = baseAddr,
+        .baseIndex = index,
+        .step = ALIGN > 1 ? ALIGN : opts.step,
+        .userValue = userValue,
+        .oldSegments = previous.segmentsFor(baseAddr, length, oldSliceLen),
+        .oldSliceLen = oldSliceLen,
+        .reverseEndianness = opts.reverseEndianness,
+        .lookBehind = std::min(index, kernel.lookBehind),
+        .alignedWidthsOnly = aligned && isAggregatedAny(opts.dataType),
+    };
+    const ProfileTimer TIMER{opts.profile, stats.profile.matchNs};
+    return kernel.scanBlock(ARGS, swath);
+}
 
-    Value oldValue;
-    oldValue.bytes = std::move(oldBytes);
-    oldValue.flags =
-        MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
-    return oldValue;
+/**
+ * @brief Kernel for the copy phase of a consistent scan: matches nothing,
+ *        so reads only fill the swaths
+ */
+inline auto copyOnlyBlockKernel(const ScanKernel& /*kernel*/,
+                                const BlockScanArgs& /*args*/,
+                                MatchesAndOldValuesSwath& /*swath*/)
+    -> std::size_t {
+    return 0;
 }
 
-inline void scanBlock(std::span<const std::uint8_t> buffer,
-                      std::size_t baseIndex, std::size_t step,
-                      const ScanRoutine& routine, const UserValue* userValue,
-                      MatchesAndOldValuesSwath& swath, ScanStats& stats,
-                      void* regionBlockBase,
-                      const MatchesAndOldValuesArray* previousSnapshot,
-                      std::size_t oldSliceLen, bool reverseEndianness) {
-    const std::size_t STEP_SIZE = std::max<std::size_t>(1, step);
-    for (std::size_t offset = 0; offset < buffer.size(); offset += STEP_SIZE) {
-        auto memory = buffer.subspan(offset);
-        auto* address = static_cast<void*>(
-            static_cast<std::uint8_t*>(regionBlockBase) + offset);
-        auto oldValue = makeOldValue(previousSnapshot, address, oldSliceLen);
-        auto context = makeScanContext(
-            memory, oldValue ? &*oldValue : nullptr, userValue,
-            (userValue != nullptr) ? userValue->flag() : MatchFlags::EMPTY,
-            reverseEndianness);
-        auto result = routine(context);
-        if (!result) {
-            continue;
+// Match swaths a copy-only pass over chunk filled, block by block
+inline void matchSwaths(std::span<MatchesAndOldValuesSwath> swaths,
+                        const Region& region, const ScanChunk& chunk,
+                        const ScanOptions& opts, const ScanKernel& kernel,
+                        const UserValue* userValue, ScanStats& stats,
+                        SnapshotCursor& previous, std::size_t oldSliceLen) {
+    const bool ALIGNED = alignsCandidates(opts, region);
+    const std::size_t BLOCK = std::max<std::size_t>(1, opts.blockSize);
+    const auto* from = static_cast<const std::uint8_t*>(region.start) +
+                       chunk.offset;
+    for (auto& swath : swaths) {
+        // The chunk's lead is look-behind only
+        const auto* base =
+            static_cast<const std::uint8_t*>(swath.firstByteInChild);
+        const std::size_t FIRST =
+            from > base ? std::min(static_cast<std::size_t>(from - base),
+                                   swath.size())
+                        : 0;
+        for (std::size_t index = FIRST; index < swath.size();
+             index += BLOCK) {
+            stats.matches += matchBlock(
+                swath, index, std::min(BLOCK, swath.size() - index), opts,
+                ALIGNED, kernel, userValue, stats, previous, oldSliceLen);
         }
-        swath.markRangeByIndex(baseIndex + offset, result.matchLength,
-                               result.matchedFlag);
-        stats.matches++;
     }
 }
 
-export inline auto scanRegion(const Region& region, ProcMemIO& reader,
-                              const ScanOptions& opts,
-                              const ScanRoutine& routine,
-                              const UserValue* userValue, ScanStats& stats,
-                              const MatchesAndOldValuesArray* previousSnapshot,
-                              std::size_t oldSliceLen)
-    -> std::optional<MatchesAndOldValuesSwath> {
-    if (!region.isReadable() || region.size == 0) {
-        return std::nullopt;
+/**
+ * @brief Scan [begin, begin + length) of a region, reading each block
+ *        straight into the swath
+ *
+ * The lead bytes before begin are read into the swath first, so kernels can
+ * look behind into them, but nothing is matched or counted there.
+ *
+ * The swath's byte plane is sized to the range up front and every block is
+ * read into its final place, so the old bytes are never copied. A block
+ * that cannot be read closes the current swath and the next readable block
+ * opens a new one, keeping swath indices aligned with addresses.
+ *
+ * With readAhead, whole multi-block spans are read and the next span is
+ * fetched while the current one is matched. A span that comes back short
+ * is replayed block by block, so holes are handled exactly as without it.
+ * With filler, each block is planned first: blocks with no resident page
+ * are skipped like unreadable ones, blocks with zero or reusable pages are
+ * assembled by the filler, and only spans planned as plain reads are read
+ * ahead.
+ */
+inline auto scanRegionRange(const Region& region, std::size_t begin,
+                            std::size_t length, std::size_t lead,
+                            ProcMemIO& reader,
+                            const ScanOptions& opts, const ScanKernel& kernel,
+                            const UserValue* userValue, ScanStats& stats,
+                            SnapshotCursor& previous, std::size_t oldSliceLen,
+                            ReadAhead* readAhead = nullptr,
+                            PageFiller* filler = nullptr,
+                            ScanControl* control = nullptr,
+                            SwathPool* pool = nullptr)
+    -> std::vector<MatchesAndOldValuesSwath> {
+    std::vector<MatchesAndOldValuesSwath> swaths;
+    const std::size_t END = std::min(region.size, begin + length);
+    if (!region.isReadable() || begin >= END) {
+        return swaths;
     }
+    const bool ANONYMOUS = isAnonymous(region);
+    const bool PROFILE = opts.profile;
+    stats.profile.enabled = PROFILE;
+    const bool ALIGNED = alignsCandidates(opts, region);
 
-    stats.regionsVisited++;
+    auto* regionBase = static_cast<std::uint8_t*>(region.start);
     MatchesAndOldValuesSwath swath;
-    std::vector<std::uint8_t> buffer(opts.blockSize);
-    std::size_t regionOffset = 0;
+    bool open = false;
+    std::size_t swathStart = 0;
+    std::size_t regionOffset = begin - std::min(lead, begin);
+
+    auto closeSwath = [&]() {
+        if (!open) {
+            return;
+        }
+        open = false;
+        const std::size_t FILLED = regionOffset - swathStart;
+        if (FILLED == 0) {
+            return;
+        }
+        if (FILLED < swath.size()) {
+            swath.resize(FILLED);
+            swath.shrinkToFit();
+        }
+        swaths.push_back(std::move(swath));
+    };
 
-    while (regionOffset < region.size) {
-        const std::size_t REMAINING = region.size - regionOffset;
-        const std::size_t TO_READ = std::min(REMAINING, opts.blockSize);
-        auto* baseAddr =
-            static_cast<std::uint8_t*>(region.start) + regionOffset;
+    auto openSwath = [&]() {
+        swath = pool != nullptr
+                    ? pool->make(regionBase + regionOffset, END - regionOffset)
+                    : MatchesAndOldValuesSwath{regionBase + regionOffset,
+                                               ByteBuffer(END - regionOffset)};
+        swathStart = regionOffset;
+        open = true;
+    };
 
-        auto bytesReadExp = reader.read(baseAddr, buffer.data(), TO_READ);
-        if (!bytesReadExp) {
-            regionOffset += TO_READ;
-            continue;
+    // Match bytes already sitting at their place in the swath
+    auto scanRead = [&](std::size_t offset, std::size_t bytesRead) {
+        if (offset < begin) {
+            return;  // lead: the previous chunk matched these
         }
+        stats.bytesScanned += bytesRead;
+        stats.matches +=
+            matchBlock(swath, offset - swathStart, bytesRead, opts, ALIGNED,
+                       kernel, userValue, stats, previous, oldSliceLen);
+    };
 
-        const std::size_t BYTES_READ = *bytesReadExp;
-        if (BYTES_READ == 0) {
+    // Synchronous read and scan of the block at regionOffset
+    auto stepBlock = [&]() {
+        const std::size_t LIMIT = regionOffset < begin ? begin : END;
+        const std::size_t TO_READ =
+            std::min(LIMIT - regionOffset, opts.blockSize);
+        const auto PLAN =
+            filler != nullptr
+                ? filler->plan(regionBase + regionOffset, TO_READ, ANONYMOUS)
+                : PageFiller::Plan::READ;
+        if (PLAN == PageFiller::Plan::HOLE) {
+            closeSwath();
+            if (regionOffset >= begin) {
+                stats.bytesSkipped += TO_READ;
+            }
             regionOffset += TO_READ;
+            return;
+        }
+        if (!open) {
+            openSwath();
+        }
+        std::uint8_t* target =
+            swath.mutableBytes().data() + (regionOffset - swathStart);
+        if (PLAN == PageFiller::Plan::FILL &&
+            filler->fill(reader, regionBase + regionOffset, target, TO_READ,
+                         stats)) {
+            scanRead(regionOffset, TO_READ);
+            regionOffset += TO_READ;
+            return;
+        }
+        auto bytesReadExp = [&]() {
+            const ProfileTimer TIMER{PROFILE, stats.profile.ioNs};
+            return reader.read(regionBase + regionOffset, target, TO_READ);
+        }();
+        if (PROFILE) {
+            stats.profile.countRead(TO_READ, bytesReadExp.value_or(0));
+        }
+        if (!bytesReadExp || *bytesReadExp == 0) {
+            closeSwath();
+            regionOffset += TO_READ;
+            return;
+        }
+        scanRead(regionOffset, *bytesReadExp);
+        regionOffset += *bytesReadExp;
+    };
+
+    // Report progress and check for cancellation between blocks
+    std::size_t reported = begin;
+    auto report = [&]() {
+        if (control != nullptr && regionOffset > reported) {
+            control->addBytes(regionOffset - reported);
+            reported = regionOffset;
+        }
+    };
+    auto keepGoing = [&]() {
+        if (control == nullptr) {
+            return true;
+        }
+        report();
+        if (control->stopRequested()) {
+            stats.cancelled = true;
+            return false;
+        }
+        return true;
+    };
+
+    while (regionOffset < begin && keepGoing()) {
+        stepBlock();
+    }
+    if (readAhead == nullptr) {
+        while (regionOffset < END && keepGoing()) {
+            stepBlock();
+        }
+        report();
+        closeSwath();
+        return swaths;
+    }
+
+    const std::size_t BLOCK = std::max<std::size_t>(1, opts.blockSize);
+    const std::size_t SPAN = std::max(BLOCK, READ_AHEAD_BYTES / BLOCK * BLOCK);
+    bool inFlight = false;
+    std::size_t spanBegin = 0;
+    std::size_t spanLen = 0;
+    auto submit = [&](std::size_t offset) {
+        spanBegin = offset;
+        spanLen = std::min(SPAN, END - offset);
+        readAhead->submit(reader, regionBase + offset,
+                          swath.mutableBytes().data() + (offset - swathStart),
+                          spanLen);
+        inFlight = true;
+    };
+    // Spans needing the filler are not read ahead
+    auto plainSpan = [&](std::size_t offset) {
+        return filler == nullptr ||
+               filler->plan(regionBase + offset, std::min(SPAN, END - offset),
+                            ANONYMOUS) == PageFiller::Plan::READ;
+    };
+
+    while (regionOffset < END) {
+        if (!keepGoing()) {
+            // The swath owns the buffer the helper is writing into
+            if (inFlight) {
+                readAhead->wait();
+                inFlight = false;
+            }
+            break;
+        }
+        if (!inFlight) {
+            if (!plainSpan(regionOffset)) {
+                const std::size_t STOP = std::min(END, regionOffset + SPAN);
+                while (regionOffset < STOP) {
+                    stepBlock();
+                }
+                continue;
+            }
+            if (!open) {
+                openSwath();
+            }
+            submit(regionOffset);
+        }
+        const std::size_t GOT = [&]() {
+            // Only the stall counts; the read overlapped the last span
+            const ProfileTimer TIMER{PROFILE, stats.profile.ioNs};
+            return readAhead->wait();
+        }();
+        if (PROFILE) {
+            stats.profile.countRead(spanLen, GOT);
+        }
+        inFlight = false;
+        const std::size_t SPAN_BEGIN = spanBegin;
+        const std::size_t SPAN_END = spanBegin + spanLen;
+        if (GOT < spanLen) {
+            // Nothing is in flight now, so the replay may close the swath
+            while (regionOffset < SPAN_END) {
+                stepBlock();
+            }
             continue;
         }
+        // The next span lands past every byte the kernel reads below
+        if (SPAN_END < END && plainSpan(SPAN_END)) {
+            submit(SPAN_END);
+        }
+        for (std::size_t offset = SPAN_BEGIN; offset < SPAN_END;
+             offset += BLOCK) {
+            scanRead(offset, std::min(BLOCK, SPAN_END - offset));
+        }
+        regionOffset = SPAN_END;
+    }
+    report();
+    closeSwath();
+
+    return swaths;
+}
 
-        const std::size_t BASE_INDEX = swath.data.size();
-        appendBytesToSwath(swath, buffer.data(), BYTES_READ, baseAddr);
-        scanBlock(std::span<const std::uint8_t>(buffer.data(), BYTES_READ),
-                  BASE_INDEX, opts.step, routine, userValue, swath, stats,
-                  baseAddr, previousSnapshot, oldSliceLen,
-                  opts.reverseEndianness);
+/** @brief Scan one whole region (see scanRegionRange) */
+export inline auto scanRegion(const Region& region, ProcMemIO& reader,
+                              const ScanOptions& opts,
+                              const ScanKernel& kernel,
+                              const UserValue* userValue, ScanStats& stats,
+                              SnapshotCursor& previous,
+                              std::size_t oldSliceLen,
+                              ReadAhead* readAhead = nullptr)
+    -> std::vector<MatchesAndOldValuesSwath> {
+    if (!region.isReadable() || region.size == 0) {
+        return {};
+    }
+    stats.regionsVisited++;
+    return scanRegionRange(region, 0, region.size, 0, reader, opts, kernel,
+                           userValue, stats, previous, oldSliceLen, readAhead);
+}
 
-        stats.bytesScanned += BYTES_READ;
-        regionOffset += BYTES_READ;
+// Scan one chunk; the first chunk of a region counts the region as visited
+inline auto scanChunk(std::span<const Region> regions, const ScanChunk& chunk,
+                      ProcMemIO& reader, const ScanOptions& opts,
+                      const ScanKernel& kernel, const UserValue* userValue,
+                      ScanStats& stats, SnapshotCursor& previous,
+                      std::size_t oldSliceLen, ReadAhead* readAhead = nullptr,
+                      PageFiller* filler = nullptr,
+                      ScanControl* control = nullptr,
+                      SwathPool* pool = nullptr)
+    -> std::vector<MatchesAndOldValuesSwath> {
+    if (control != nullptr && control->stopRequested()) {
+        stats.cancelled = true;
+        return {};
+    }
+    if (chunk.offset == 0) {
+        stats.regionsVisited++;
     }
+    const ProfileTimer TIMER{opts.profile, stats.profile.scanNs};
+    auto swaths = scanRegionRange(regions[chunk.region], chunk.offset,
+                                  chunk.size, chunk.lead, reader, opts, kernel,
+                                  userValue,
+                                  stats, previous, oldSliceLen, readAhead,
+                                  filler, control, pool);
+    const auto& region = regions[chunk.region];
+    if (control != nullptr && !control->stopRequested() &&
+        chunk.offset + chunk.size >= region.size) {
+        control->finishRegion();
+    }
+    if (opts.profile) {
+        stats.profile.noteTask(
+            TIMER.elapsedNs(),
+            reinterpret_cast<std::uintptr_t>(region.start) + chunk.offset,
+            chunk.size);
+    }
+    return swaths;
+}
 
-    return swath.data.empty() ? std::nullopt : std::make_optional(swath);
+inline auto isReusable(const PageReuse* reuse) -> bool {
+    return reuse != nullptr && reuse->snapshot != nullptr &&
+           reuse->dirty != nullptr;
 }
 
-export inline auto runScanInternal(
-    pid_t pid, const ScanOptions& opts, const UserValue* userValue,
-    MatchesAndOldValuesArray& out,
-    const MatchesAndOldValuesArray* previousSnapshot)
+// Sequential scan of every chunk through one already-open reader
+inline auto scanSequential(pid_t pid, const ScanOptions& opts,
+                           const UserValue* userValue,
+                           MatchesAndOldValuesArray& out,
+                           const MatchesAndOldValuesArray* previousSnapshot,
+                           ProcMemIO& reader, const PageReuse* reuse,
+                           core::RegionCache* regionCache,
+                           ScanControl* control, SwathPool* pool)
     -> std::expected<ScanStats, std::string> {
-    out.swaths.clear();
+    out.clear();
+    ScanStats stats{};
+    stats.profile.enabled = opts.profile;
+    ProfileTimer total{opts.profile, stats.profile.totalNs};
 
-    auto regionsExp = prepareScanRegions(pid, opts);
+    auto regionsExp = [&]() {
+        const ProfileTimer TIMER{opts.profile, stats.profile.mapsNs};
+        return prepareScanRegions(pid, opts, regionCache);
+    }();
     if (!regionsExp) {
         return std::unexpected{regionsExp.error()};
     }
-    auto regions = std::move(*regionsExp);
+    const auto REGION_LIST = std::move(*regionsExp);
+    const auto& regions = *REGION_LIST;
 
-    auto routineExp = prepareScanRoutine(opts, userValue);
-    if (!routineExp) {
-        return std::unexpected{routineExp.error()};
+    auto kernelExp = prepareScanKernel(opts, userValue);
+    if (!kernelExp) {
+        return std::unexpected{kernelExp.error()};
     }
-    auto routine = *routineExp;
+    const auto& kernel = *kernelExp;
 
-    ProcMemIO reader{pid};
-    if (auto err = reader.open(); !err) {
-        return std::unexpected{err.error()};
+    const std::size_t OLD_SLICE_LEN = scanWindowSize(opts, userValue);
+    const SnapshotIndex PREVIOUS = previousSnapshot != nullptr
+                                       ? SnapshotIndex{*previousSnapshot}
+                                       : SnapshotIndex{};
+    SnapshotCursor cursor{&PREVIOUS};
+
+    // Parallel workers overlap one another's reads instead; a lone
+    // scanning thread gets a helper to keep pread off its critical path
+    std::optional<ReadAhead> readAhead;
+    if (opts.pipelineReads) {
+        readAhead.emplace();
     }
+    ReadAhead* ahead = readAhead ? &*readAhead : nullptr;
 
-    ScanStats stats{};
-    const std::size_t OLD_SLICE_LEN = scanWindowSize(opts, userValue);
+    const bool REUSE = isReusable(reuse);
+    const SnapshotIndex REUSE_INDEX =
+        REUSE ? SnapshotIndex{*reuse->snapshot} : SnapshotIndex{};
+    PageFiller filler{pid, opts.absentPages, &REUSE_INDEX,
+                      REUSE ? reuse->dirty : nullptr};
+    PageFiller* fill = filler.active() ? &filler : nullptr;
+
+    std::optional<core::ProcessPause> pause;
+    if (opts.consistent) {
+        auto stopped = core::ProcessPause::stop(pid);
+        if (!stopped) {
+            return std::unexpected{stopped.error()};
+        }
+        pause.emplace(std::move(*stopped));
+    }
+    const ScanKernel COPY_KERNEL{.block = &copyOnlyBlockKernel};
+    const ScanKernel& readKernel = pause ? COPY_KERNEL : kernel;
+
+    const auto CHUNKS =
+        planScanChunks(regions, opts.blockSize, kernel.lookBehind);
+    startProgress(control, CHUNKS);
+    std::vector<std::vector<MatchesAndOldValuesSwath>> copied;
+    for (const auto& chunk : CHUNKS) {
+        if (stats.cancelled) {
+            break;
+        }
+        auto swaths = scanChunk(regions, chunk, reader, opts, readKernel,
+                                userValue, stats, cursor, OLD_SLICE_LEN, ahead,
+                                fill, control, pool);
+        if (pause) {
+            copied.push_back(std::move(swaths));
+            continue;
+        }
+        const ProfileTimer MERGE{opts.profile, stats.profile.mergeNs};
+        stats.matches -= addChunkSwaths(out, swaths);
+    }
 
-    for (const auto& region : regions) {
-        if (auto swath = scanRegion(region, reader, opts, routine, userValue,
-                                    stats, previousSnapshot, OLD_SLICE_LEN)) {
-            out.addSwath(*swath);
+    if (pause) {
+        stats.pauseNs = static_cast<std::uint64_t>(pause->resume().count());
+        for (std::size_t i = 0; i < copied.size(); ++i) {
+            matchSwaths(copied[i], regions[CHUNKS[i].region], CHUNKS[i], opts,
+                        kernel, userValue, stats, cursor, OLD_SLICE_LEN);
+            const ProfileTimer MERGE{opts.profile, stats.profile.mergeNs};
+            stats.matches -= addChunkSwaths(out, copied[i]);
         }
     }
 
+    total.stop();
     return stats;
 }
 
+/**
+ * @brief Sequential scan
+ * @param reuse Optional clean-page source; its snapshot must not be out
+ */
+export inline auto runScanInternal(
+    pid_t pid, const ScanOptions& opts, const UserValue* userValue,
+    MatchesAndOldValuesArray& out,
+    const MatchesAndOldValuesArray* previousSnapshot,
+    const PageReuse* reuse = nullptr)
+    -> std::expected<ScanStats, std::string> {
+    ProcMemIO reader{pid};
+    if (auto err = reader.open(); !err) {
+        out.clear();
+        return std::unexpected{err.error()};
+    }
+    return scanSequential(pid, opts, userValue, out, previousSnapshot, reader,
+                          reuse, nullptr, nullptr, nullptr);
+}
+
 export [[nodiscard]] inline auto runScan(pid_t pid, const ScanOptions& opts,
                                          const UserValue* userValue,
                                          MatchesAndOldValuesArray& out)
@@ -220,143 +970,201 @@ export [[nodiscard]] inline auto runScanWithPrevious(
     return runScanInternal(pid, opts, userValue, out, &previousSnapshot);
 }
 
-// WORKER Thread: From shared queue, grab regions to scan
-static void scanRegionsWorker(
-    pid_t pid, std::span<const core::Region> regions,
-    std::atomic_size_t& nextIndex, const ScanOptions& opts,
-    const ScanRoutine& routine, const UserValue* userValue,
-    std::size_t oldSlice, const MatchesAndOldValuesArray* previousSnapshot,
-    ScanStats& localStats,
-    std::vector<std::pair<std::size_t, MatchesAndOldValuesSwath>>& localSwaths,
-    std::latch& workDone) {
-    core::ProcMemIO localReader{pid};
-    if (auto err = localReader.open(); !err) {
-        workDone.count_down();
-        return;
-    }
-
-    while (true) {
-        size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
-        if (index >= regions.size()) {
-            break;
-        }
-        const auto& region = regions[index];
-        if (auto swath =
-                scanRegion(region, localReader, opts, routine, userValue,
-                           localStats, previousSnapshot, oldSlice)) {
-            localSwaths.emplace_back(region.id, *swath);
-        }
-    }
-
-    workDone.count_down();
-}
-
-// Combine all thread scan results into output array
-static void mergeThreadResults(
-    std::vector<std::vector<std::pair<std::size_t, MatchesAndOldValuesSwath>>>&
-        threadSwaths,
-    std::span<const core::Region> regions, MatchesAndOldValuesArray& out) {
-    // Collect all (region.id, swath) from all threads
-    std::vector<std::pair<std::size_t, MatchesAndOldValuesSwath>> allSwaths;
-    size_t totalPairs = 0;
-    for (const auto& threadVec : threadSwaths) {
-        totalPairs += threadVec.size();
-    }
-    allSwaths.reserve(totalPairs);
-    for (auto& threadVec : threadSwaths) {
-        allSwaths.insert(allSwaths.end(),
-                         std::make_move_iterator(threadVec.begin()),
-                         std::make_move_iterator(threadVec.end()));
-    }
-
-    // Sort by region.id to ensure output order matches sequential scan
-    std::ranges::sort(allSwaths, [](const auto& lhs, const auto& rhs) {
-        return lhs.first < rhs.first;
-    });
-
-    // Deduplication guard: avoid merging swaths from the same region multiple
-    // times
-    std::vector<bool> seen;
-    if (!regions.empty()) {
-        std::size_t maxRegionId = 0;
-        for (const auto& regionItem : regions) {
-            maxRegionId = std::max(maxRegionId, regionItem.id);
-        }
-        seen.assign(maxRegionId + 1, false);
-    }
-    for (auto& pairItem : allSwaths) {
-        std::size_t regionId = pairItem.first;
-        if (regionId < seen.size()) {
-            if (seen[regionId]) {
-                continue;  // skip duplicate
-            }
-            seen[regionId] = true;
-        }
-        out.addSwath(pairItem.second);
-    }
-}
-
-// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+/**
+ * @brief Scan regions on a work-stealing pool
+ *
+ * Regions are split into block-aligned chunks so one huge mapping still
+ * spreads across every worker. Each chunk's swaths land in a slot indexed
+ * by chunk, and the slots are moved into out in order, giving the same
+ * result as the sequential scan.
+ *
+ * @param pool Pool to run on; nullptr uses utils::ThreadPool::shared()
+ * @param readers Per-worker readers kept open across calls; ignored
+ *        unless it was reset for pid with at least pool->size() slots
+ * @param reuse Optional clean-page source; its snapshot must not be out
+ * @param regionCache Optional session cache of the target's maps
+ * @param control Optional progress and cancellation; a cancelled scan
+ *        leaves the chunks finished so far in out
+ * @param swathPool Optional source of swath storage, e.g. the planes of the
+ *        result this scan replaces
+ */
 export auto runScanParallel(pid_t pid, const ScanOptions& opts,
                             const UserValue* userValue,
                             MatchesAndOldValuesArray& out,
-                            const MatchesAndOldValuesArray* previousSnapshot)
+                            const MatchesAndOldValuesArray* previousSnapshot,
+                            utils::ThreadPool* pool = nullptr,
+                            core::ProcMemReaders* readers = nullptr,
+                            const PageReuse* reuse = nullptr,
+                            core::RegionCache* regionCache = nullptr,
+                            ScanControl* control = nullptr,
+                            SwathPool* swathPool = nullptr)
     -> std::expected<ScanStats, std::string> {
-    out.swaths.clear();
+    out.clear();
+    ScanStats totalStats{};
+    totalStats.profile.enabled = opts.profile;
+    ProfileTimer total{opts.profile, totalStats.profile.totalNs};
 
-    auto regionsExp = prepareScanRegions(pid, opts);
+    auto regionsExp = [&]() {
+        const ProfileTimer TIMER{opts.profile, totalStats.profile.mapsNs};
+        return prepareScanRegions(pid, opts, regionCache);
+    }();
     if (!regionsExp) {
         return std::unexpected{regionsExp.error()};
     }
-    auto regions = *regionsExp;
+    const auto REGION_LIST = std::move(*regionsExp);
+    const auto& REGIONS = *REGION_LIST;
+    if (REGIONS.empty()) {
+        startProgress(control, {});
+        total.stop();
+        return totalStats;
+    }
+
+    auto& workers = pool != nullptr ? *pool : utils::ThreadPool::shared();
+    core::ProcMemReaders localReaders;
+    if (readers == nullptr || !readers->covers(pid, workers.size())) {
+        localReaders.reset(pid, workers.size());
+        readers = &localReaders;
+    }
+    // Slot 0 doubles as the caller's reader; workers are idle when it runs
+    auto probeExp = readers->acquire(0);
+    if (!probeExp) {
+        return std::unexpected{probeExp.error()};
+    }
+    auto& probe = **probeExp;
 
-    if (regions.empty()) {
-        return ScanStats{};
+    // Leads don't change the chunk count, only where chunks start reading
+    if (workers.size() <= 1 ||
+        planScanChunks(REGIONS, opts.blockSize, 0).size() <= 1) {
+        // Reads the (cached) maps again and times itself
+        return scanSequential(pid, opts, userValue, out, previousSnapshot,
+                              probe, reuse, regionCache, control,
+                              swathPool);
     }
 
-    auto routineExp = prepareScanRoutine(opts, userValue);
-    if (!routineExp) {
-        return std::unexpected{routineExp.error()};
+    auto kernelExp = prepareScanKernel(opts, userValue);
+    if (!kernelExp) {
+        return std::unexpected{kernelExp.error()};
     }
-    auto routine = *routineExp;
+    const auto& kernel = *kernelExp;
+    const auto CHUNKS =
+        planScanChunks(REGIONS, opts.blockSize, kernel.lookBehind);
+    startProgress(control, CHUNKS);
     const std::size_t OLD_SLICE = scanWindowSize(opts, userValue);
 
-    const size_t NUM_THREADS = std::min(
-        static_cast<size_t>(std::max(1U, std::thread::hardware_concurrency())),
-        regions.size());
+    const SnapshotIndex PREVIOUS = previousSnapshot != nullptr
+                                       ? SnapshotIndex{*previousSnapshot}
+                                       : SnapshotIndex{};
+    const bool REUSE = isReusable(reuse);
+    const SnapshotIndex REUSE_INDEX =
+        REUSE ? SnapshotIndex{*reuse->snapshot} : SnapshotIndex{};
+    const core::SoftDirtyMap* dirty = REUSE ? reuse->dirty : nullptr;
+
+    // Per-worker state, touched only by its own worker
+    struct WorkerState {
+        ScanStats stats{};
+        SnapshotCursor cursor;
+        PageFiller filler;
+        std::size_t tasks{0};
+    };
+    std::vector<WorkerState> states;
+    states.reserve(workers.size());
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        states.push_back(
+            {.cursor = SnapshotCursor{&PREVIOUS},
+             .filler = PageFiller{pid, opts.absentPages, &REUSE_INDEX, dirty}});
+    }
 
-    if (NUM_THREADS <= 1) {
-        return runScanInternal(pid, opts, userValue, out, previousSnapshot);
+    // A consistent scan only copies while the target is stopped; the
+    // kernel runs over the copies once it is resumed
+    std::optional<core::ProcessPause> pause;
+    if (opts.consistent) {
+        auto stopped = core::ProcessPause::stop(pid);
+        if (!stopped) {
+            return std::unexpected{stopped.error()};
+        }
+        pause.emplace(std::move(*stopped));
     }
+    const ScanKernel COPY_KERNEL{.block = &copyOnlyBlockKernel};
+    const ScanKernel& readKernel = pause ? COPY_KERNEL : kernel;
 
-    std::vector<ScanStats> results(NUM_THREADS);
-    std::vector<std::vector<std::pair<std::size_t, MatchesAndOldValuesSwath>>>
-        threadSwaths(NUM_THREADS);
-    std::latch workDone{static_cast<ptrdiff_t>(NUM_THREADS)};
+    std::vector<std::vector<MatchesAndOldValuesSwath>> slots(CHUNKS.size());
+    std::vector<char> scanned(CHUNKS.size(), 0);
+    ProfileTimer scanPhase{opts.profile, totalStats.profile.scanNs};
+    workers.parallelFor(CHUNKS.size(), [&](std::size_t task,
+                                           std::size_t worker) {
+        auto readerExp = readers->acquire(worker);
+        if (!readerExp) {
+            return;
+        }
+        auto& state = states[worker];
+        slots[task] = scanChunk(REGIONS, CHUNKS[task], **readerExp, opts,
+                                readKernel, userValue, state.stats,
+                                state.cursor, OLD_SLICE, nullptr,
+                                state.filler.active() ? &state.filler
+                                                      : nullptr,
+                                control, swathPool);
+        ++state.tasks;
+        scanned[task] = 1;
+    });
 
-    std::vector<std::jthread> threads;
-    threads.reserve(NUM_THREADS);
+    // A worker that could not open its reader leaves chunks behind
+    SnapshotCursor probeCursor{&PREVIOUS};
+    PageFiller probeFiller{pid, opts.absentPages, &REUSE_INDEX, dirty};
+    for (std::size_t i = 0; i < CHUNKS.size(); ++i) {
+        if (scanned[i] == 0) {
+            slots[i] = scanChunk(REGIONS, CHUNKS[i], probe, opts, readKernel,
+                                 userValue, totalStats, probeCursor, OLD_SLICE,
+                                 nullptr,
+                                 probeFiller.active() ? &probeFiller : nullptr,
+                                 control, swathPool);
+        }
+    }
 
-    std::atomic_size_t nextIndex{0};
-    for (size_t i = 0; i < NUM_THREADS; ++i) {
-        threads.emplace_back([&, i]() {
-            scanRegionsWorker(pid, regions, nextIndex, opts, routine, userValue,
-                              OLD_SLICE, previousSnapshot, results[i],
-                              threadSwaths[i], workDone);
+    if (pause) {
+        totalStats.pauseNs =
+            static_cast<std::uint64_t>(pause->resume().count());
+        workers.parallelFor(CHUNKS.size(), [&](std::size_t task,
+                                               std::size_t worker) {
+            auto& state = states[worker];
+            matchSwaths(slots[task], REGIONS[CHUNKS[task].region],
+                        CHUNKS[task], opts, kernel, userValue, state.stats,
+                        state.cursor, OLD_SLICE);
         });
     }
+    scanPhase.stop();
 
-    workDone.wait();
-
-    mergeThreadResults(threadSwaths, regions, out);
+    std::size_t duplicates = 0;
+    {
+        const ProfileTimer MERGE{opts.profile, totalStats.profile.mergeNs};
+        std::size_t swathCount = 0;
+        for (const auto& slot : slots) {
+            swathCount += slot.size();
+        }
+        out.swaths.reserve(swathCount);
+        for (auto& slot : slots) {
+            duplicates += addChunkSwaths(out, slot);
+        }
+    }
 
-    ScanStats totalStats{};
-    for (auto& result : results) {
-        totalStats.regionsVisited += result.regionsVisited;
-        totalStats.bytesScanned += result.bytesScanned;
-        totalStats.matches += result.matches;
+    for (const auto& state : states) {
+        totalStats.regionsVisited += state.stats.regionsVisited;
+        totalStats.bytesScanned += state.stats.bytesScanned;
+        totalStats.matches += state.stats.matches;
+        totalStats.bytesReused += state.stats.bytesReused;
+        totalStats.bytesSkipped += state.stats.bytesSkipped;
+        totalStats.cancelled = totalStats.cancelled || state.stats.cancelled;
+        if (opts.profile) {
+            totalStats.profile.merge(state.stats.profile);
+            totalStats.profile.workers.push_back(
+                {.busyNs = state.stats.profile.scanNs,
+                 .tasks = state.tasks,
+                 .bytes = state.stats.bytesScanned});
+        }
     }
 
+    totalStats.matches -= duplicates;
+
+    total.stop();
     return totalStats;
 }
 
@@ -11,9 +11,11 @@ export module scan.factory;
 
 import scan.types;
 import scan.routine;
+import scan.match_plan;
 import scan.numeric;
 import scan.bytes;
 import scan.string;
+import scan.group;
 import value.core;
 
 export namespace scan {
@@ -50,6 +52,8 @@ export namespace scan {
             return makeBytearrayScanRoutine(matchType);
         case ScanDataType::STRING:
             return makeStringScanRoutine(matchType);
+        case ScanDataType::GROUP:
+            return makeGroupScanRoutine(matchType);
         case ScanDataType::ANY_INTEGER:
             return makeAnyIntegerScanRoutine(matchType, reverseEndianness);
         case ScanDataType::ANY_FLOAT:
@@ -61,6 +65,37 @@ export namespace scan {
     }
 }
 
+/**
+ * @brief Create a scan routine whose numeric operands come from plan
+ *
+ * Numeric and ANY_* routines read the pre-converted user value; other
+ * types do not convert it and get the plain routine.
+ */
+[[nodiscard]] inline auto makeScanRoutine(const MatchPlanPtr& plan)
+    -> ScanRoutine {
+    switch (plan->dataType()) {
+        case ScanDataType::INTEGER_8:
+            return makeNumericScanRoutine<int8_t>(plan);
+        case ScanDataType::INTEGER_16:
+            return makeNumericScanRoutine<int16_t>(plan);
+        case ScanDataType::INTEGER_32:
+            return makeNumericScanRoutine<int32_t>(plan);
+        case ScanDataType::INTEGER_64:
+            return makeNumericScanRoutine<int64_t>(plan);
+        case ScanDataType::FLOAT_32:
+            return makeNumericScanRoutine<float>(plan);
+        case ScanDataType::FLOAT_64:
+            return makeNumericScanRoutine<double>(plan);
+        case ScanDataType::ANY_INTEGER:
+        case ScanDataType::ANY_FLOAT:
+        case ScanDataType::ANY_NUMBER:
+            return makeAnyWidthScanRoutine(plan);
+        default:
+            return makeScanRoutine(plan->dataType(), plan->matchType(),
+                                   plan->reverseEndianness());
+    }
+}
+
 /**
  * @brief Check if a scan routine is available for the given configuration
  */
@@ -1,9 +1,9 @@
 module;
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
-#include <optional>
 #include <span>
 #include <string>
 #include <vector>
@@ -13,86 +13,271 @@ export module scan.filter;
 import scan.types; // ScanOptions / ScanStats / bytesNeededForType / matchUsesOldValue
 import scan.job;
 import scan.match_storage;
+import scan.numeric;
 import scan.routine;
 import value.core;
 import value.flags;
 import core.proc_mem; // ProcMemIO
+import core.soft_dirty; // SoftDirtyMap
+import utils.thread_pool;
 
 using scan::MatchesAndOldValuesArray;
-using scan::MatchesAndOldValuesSwath;
-using scan::OldValueAndMatchInfo;
+
+// Reusable buffers of one filtering thread
+struct FilterScratch {
+    std::vector<core::ReadRange> ranges;
+    std::vector<std::size_t> rangeOf;     // match -> range index
+    std::vector<std::size_t> rangeStart;  // range -> offset in buffer
+    std::vector<std::size_t> got;
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::uint8_t> single;  // per-match fallback read
+    // Matches on dirty pages, when clean ones are answered from old bytes
+    std::vector<scan::MatchView> dirtyBatch;
+    std::vector<std::size_t> dirtyIndex;
+    std::vector<scan::MatchInfo> dirtyOut;
+    std::vector<scan::MatchView> batch;  // shard matches being gathered
+    Value oldValue;                      // see oldValueForMatch
+};
+
+/**
+ * @brief Filter buffers kept between calls by one owner (e.g. a Scanner)
+ *
+ * Repeated filters reuse the per-thread scratch instead of allocating it
+ * again on every pass. The shard results are not kept: they scale with
+ * the matches, and pinning them between filters would hold the largest
+ * pass's memory long after the matches shrank. Not thread-safe: one
+ * filter call at a time.
+ */
+export struct FilterWorkspace {
+    std::vector<FilterScratch> scratch;  // per worker, plus a fallback
+
+    void clear() { scratch = {}; }
+};
 
 namespace {
 
-[[nodiscard]] inline auto makeOldValueForCell(const MatchesAndOldValuesSwath& swath,
-                                              std::size_t index,
-                                              const ScanOptions& opts)
-    -> std::optional<Value> {
+// The match's old value in scratch, whose capacity assign() keeps
+[[nodiscard]] inline auto oldValueForMatch(const scan::MatchView& match,
+                                           const ScanOptions& opts,
+                                           Value& scratch) -> const Value* {
     if (!matchUsesOldValue(opts.matchType)) {
-        return std::nullopt;
+        return nullptr;
     }
     const std::size_t NEED = bytesNeededForType(opts.dataType);
-    const std::size_t REM = swath.data.size() - index;
-    if (REM < NEED) {
-        return std::nullopt;
+    if (match.oldBytes.size() < NEED) {
+        return nullptr;
     }
 
-    Value oldValue;
-    oldValue.bytes.reserve(NEED);
-    for (std::size_t k = 0; k < NEED; ++k) {
-        oldValue.bytes.push_back(swath.data[index + k].oldByte);
-    }
-    oldValue.flags =
+    const auto OLD_BYTES = match.oldBytes.first(NEED);
+    scratch.bytes.assign(OLD_BYTES.begin(), OLD_BYTES.end());
+    scratch.flags =
         MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
-    return oldValue;
+    return &scratch;
+}
+
+// Matches re-checked per vectored read
+constexpr std::size_t FILTER_BATCH = 4096;
+// Matches per shard handed to a filter worker
+constexpr std::size_t FILTER_SHARD_MATCHES = 64 * 1024;
+// Matches narrowed before their results are applied; bounds the result
+// array (4 bytes per match) however many matches a snapshot holds
+constexpr std::size_t FILTER_WAVE_MATCHES = 4 * 1024 * 1024;
+// Windows closer than this share one read range (one page)
+constexpr std::size_t COALESCE_GAP = 4096;
+// Upper bound for a single coalesced range
+constexpr std::size_t MAX_RANGE_BYTES = 64 * 1024;
+
+// Group the batch's windows into ascending, page-spanning read ranges
+void planRanges(std::span<const scan::MatchView> batch, std::size_t slice,
+                FilterScratch& scratch) {
+    scratch.ranges.clear();
+    scratch.rangeOf.clear();
+    std::uintptr_t rangeBegin = 0;
+    std::uintptr_t rangeEnd = 0;
+    for (const auto& match : batch) {
+        const std::uintptr_t BEGIN = match.address;
+        const std::uintptr_t END = BEGIN + slice;
+        const bool EXTEND = !scratch.ranges.empty() && BEGIN >= rangeBegin &&
+                            BEGIN <= rangeEnd + COALESCE_GAP &&
+                            END - rangeBegin <= MAX_RANGE_BYTES;
+        if (EXTEND) {
+            rangeEnd = std::max(rangeEnd, END);
+            scratch.ranges.back().len = rangeEnd - rangeBegin;
+        } else {
+            rangeBegin = BEGIN;
+            rangeEnd = END;
+            scratch.ranges.push_back(
+                {.addr = reinterpret_cast<void*>(BEGIN), .len = slice});
+        }
+        scratch.rangeOf.push_back(scratch.ranges.size() - 1);
+    }
+
+    scratch.rangeStart.resize(scratch.ranges.size());
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < scratch.ranges.size(); ++i) {
+        scratch.rangeStart[i] = total;
+        total += scratch.ranges[i].len;
+    }
+    scratch.buffer.resize(total);
+    scratch.got.assign(scratch.ranges.size(), 0);
 }
 
 }  // namespace
 
-// Narrow matches for a single swath using the provided routine.
-inline void narrowSwath(MatchesAndOldValuesSwath& swath, auto& routine,
-                        const UserValue* value, core::ProcMemIO& reader,
-                        std::vector<std::uint8_t>& buffer, ScanStats& stats,
-                        const ScanOptions& opts) {
-    if (swath.firstByteInChild == nullptr) {
-        return;
+// Re-check a single existing match against its current bytes.
+inline auto narrowMatch(const scan::MatchView& match,
+                        std::span<const std::uint8_t> current, auto& routine,
+                        const UserValue* value, ScanStats& stats,
+                        const ScanOptions& opts, Value& scratchOld)
+    -> scan::MatchInfo {
+    if (current.empty()) {
+        return {};
     }
-    auto* base = static_cast<std::uint8_t*>(swath.firstByteInChild);
-    for (std::size_t i = 0; i < swath.data.size(); ++i) {
-        auto& cell = swath.data[i];
-        if (cell.matchInfo == MatchFlags::EMPTY) {
-            continue;
+    const Value* oldValue = oldValueForMatch(match, opts, scratchOld);
+    auto ctx = scan::makeScanContext(
+        current, oldValue, value,
+        (value != nullptr) ? value->flag() : MatchFlags::EMPTY,
+        opts.reverseEndianness);
+    auto result = routine(ctx);
+    stats.bytesScanned += current.size();
+    if (!result) {
+        return {};
+    }
+    scan::WidthMatch widths{.flags = result.matchedFlag,
+                            .length = static_cast<unsigned int>(
+                                result.matchLength)};
+    if (opts.alignment == ScanAlignment::NATURAL &&
+        isAggregatedAny(opts.dataType)) {
+        // The scan kept only aligned widths (or all, in unaligned regions);
+        // never widen a match beyond them
+        widths = scan::AnyNumberMatcher::keepWidths(widths, match.info.flags);
+        if (widths.length == 0) {
+            return {};
         }
-        void* addr = static_cast<void*>(base + i);
-        auto readExp = reader.read(addr, buffer.data(), buffer.size());
-        if (!readExp || *readExp == 0) {
-            cell.matchInfo = MatchFlags::EMPTY;
-            cell.matchLength = 0;
-            continue;
+    }
+    stats.matches++;
+    return {.flags = widths.flags,
+            .length = static_cast<std::uint16_t>(widths.length)};
+}
+
+// Fetch a batch of windows with vectored reads, then re-check each match.
+inline void narrowRead(std::span<const scan::MatchView> batch,
+                       std::span<scan::MatchInfo> out, auto& routine,
+                       const UserValue* value, core::ProcMemIO& reader,
+                       std::size_t slice, FilterScratch& scratch,
+                       ScanStats& stats, const ScanOptions& opts) {
+    planRanges(batch, slice, scratch);
+    auto& profile = stats.profile;
+    const bool PROFILE = opts.profile;
+    profile.enabled = PROFILE;
+    {
+        const ProfileTimer TIMER{PROFILE, profile.ioNs};
+        if (!reader.readRanges(scratch.ranges, scratch.buffer, scratch.got)) {
+            std::ranges::fill(out, scan::MatchInfo{});
+            return;
+        }
+    }
+    if (PROFILE) {
+        // readRanges issues one process_vm_readv per IOV_MAX ranges; count
+        // each range so short and failed ones show up
+        for (std::size_t i = 0; i < scratch.ranges.size(); ++i) {
+            profile.countRead(scratch.ranges[i].len, scratch.got[i]);
+        }
+    }
+
+    const ProfileTimer MATCH{PROFILE, profile.matchNs};
+    for (std::size_t k = 0; k < batch.size(); ++k) {
+        const std::size_t RANGE = scratch.rangeOf[k];
+        const auto& range = scratch.ranges[RANGE];
+        const std::size_t OFFSET =
+            batch[k].address - reinterpret_cast<std::uintptr_t>(range.addr);
+        const std::size_t GOT = scratch.got[RANGE];
+        std::span<const std::uint8_t> current;
+        if (GOT >= OFFSET + slice || GOT == range.len) {
+            const std::size_t AVAILABLE =
+                GOT > OFFSET ? std::min(slice, GOT - OFFSET) : 0;
+            current = std::span<const std::uint8_t>(
+                scratch.buffer.data() + scratch.rangeStart[RANGE] + OFFSET,
+                AVAILABLE);
+        } else {
+            // The range stopped early, maybe at a hole the coalescing
+            // bridged; read this window on its own
+            auto readExp = reader.read(reinterpret_cast<void*>(batch[k].address),
+                                       scratch.single.data(), slice);
+            current = std::span<const std::uint8_t>(scratch.single.data(),
+                                                    readExp.value_or(0));
+            if (PROFILE) {
+                // Rare; its time is left in matchNs
+                profile.countRead(slice, readExp.value_or(0));
+            }
         }
-        auto oldValue = makeOldValueForCell(swath, i, opts);
-        auto ctx = scan::makeScanContext(
-            std::span<const std::uint8_t>(buffer.data(), *readExp),
-            oldValue ? &*oldValue : nullptr, value,
-            (value != nullptr) ? value->flag() : MatchFlags::EMPTY,
-            opts.reverseEndianness);
-        auto result = routine(ctx);
-        if (result) {
-            cell.matchInfo = result.matchedFlag;
-            cell.matchLength = static_cast<std::uint16_t>(result.matchLength);
-            stats.matches++;
+        out[k] = narrowMatch(batch[k], current, routine, value, stats, opts,
+                             scratch.oldValue);
+    }
+}
+
+// Re-check a batch; with dirty, windows on clean pages are unchanged since
+// the snapshot, so their old bytes stand in for a read.
+inline void narrowBatch(std::span<const scan::MatchView> batch,
+                        std::span<scan::MatchInfo> out, auto& routine,
+                        const UserValue* value, core::ProcMemIO& reader,
+                        std::size_t slice, FilterScratch& scratch,
+                        ScanStats& stats, const ScanOptions& opts,
+                        const core::SoftDirtyMap* dirty = nullptr) {
+    if (dirty == nullptr || dirty->cleanPages() == 0) {
+        narrowRead(batch, out, routine, value, reader, slice, scratch, stats,
+                   opts);
+        return;
+    }
+    scratch.dirtyBatch.clear();
+    scratch.dirtyIndex.clear();
+    for (std::size_t k = 0; k < batch.size(); ++k) {
+        const auto& match = batch[k];
+        if (match.oldBytes.size() >= slice &&
+            dirty->isClean(match.address, slice)) {
+            out[k] = narrowMatch(match, match.oldBytes.first(slice), routine,
+                                 value, stats, opts, scratch.oldValue);
+            stats.bytesReused += slice;
         } else {
-            cell.matchInfo = MatchFlags::EMPTY;
-            cell.matchLength = 0;
+            scratch.dirtyBatch.push_back(match);
+            scratch.dirtyIndex.push_back(k);
         }
-        stats.bytesScanned += *readExp;
+    }
+    if (scratch.dirtyBatch.empty()) {
+        return;
+    }
+    scratch.dirtyOut.resize(scratch.dirtyBatch.size());
+    narrowRead(scratch.dirtyBatch, scratch.dirtyOut, routine, value, reader,
+               slice, scratch, stats, opts);
+    for (std::size_t i = 0; i < scratch.dirtyIndex.size(); ++i) {
+        out[scratch.dirtyIndex[i]] = scratch.dirtyOut[i];
     }
 }
 
-// Filter existing matches in-place using current scan options/user value.
-export [[nodiscard]] inline auto filterMatches(
-    pid_t pid, const ScanOptions& opts, const UserValue* value,
-    MatchesAndOldValuesArray& matches)
+// Matches a cancelled filter did not get to are kept unchanged
+inline auto keepOnStop(std::span<const scan::MatchView> batch,
+                       std::span<scan::MatchInfo> out, ScanStats& stats,
+                       ScanControl* control) -> bool {
+    if (control == nullptr) {
+        return false;
+    }
+    if (!control->stopRequested()) {
+        control->addMatches(batch.size());
+        return false;
+    }
+    for (std::size_t k = 0; k < batch.size(); ++k) {
+        out[k] = batch[k].info;
+    }
+    stats.cancelled = true;
+    return true;
+}
+
+// Sequential filter through one already-open reader
+inline auto filterSequential(const ScanOptions& opts, const UserValue* value,
+                             MatchesAndOldValuesArray& matches,
+                             core::ProcMemIO& reader,
+                             const core::SoftDirtyMap* dirty,
+                             ScanControl* control, FilterScratch& scratch)
     -> std::expected<ScanStats, std::string> {
     auto routineExp = scan::prepareScanRoutine(opts, value);
     if (!routineExp) {
@@ -100,16 +285,250 @@ export [[nodiscard]] inline auto filterMatches(
     }
     auto routine = *routineExp;
 
+    const std::size_t SLICE_SIZE = scan::scanWindowSize(opts, value);
+    scratch.single.resize(SLICE_SIZE);
+    ScanStats stats{};
+    stats.profile.enabled = opts.profile;
+    ProfileTimer total{opts.profile, stats.profile.totalNs};
+    if (control != nullptr) {
+        control->start(0, 0, matches.matchCount());
+    }
+    {
+        // Narrowing and compaction are interleaved; this is both
+        const ProfileTimer SCAN{opts.profile, stats.profile.scanNs};
+        matches.retainMatchBatches(
+            FILTER_BATCH, [&](std::span<const scan::MatchView> batch,
+                              std::span<scan::MatchInfo> out) {
+                if (keepOnStop(batch, out, stats, control)) {
+                    return;
+                }
+                narrowBatch(batch, out, routine, value, reader, SLICE_SIZE,
+                            scratch, stats, opts, dirty);
+            });
+    }
+    {
+        const ProfileTimer MERGE{opts.profile, stats.profile.mergeNs};
+        matches.dropEmptySwaths();
+        // Few survivors: keep just their addresses and old bytes
+        matches.adaptStorage(SLICE_SIZE);
+    }
+    total.stop();
+    return stats;
+}
+
+/**
+ * @brief Filter existing matches in-place using current scan options/user value
+ * @param dirty Pages written since the matches' snapshot was taken (soft-dirty
+ *        cleared right before it); windows on other pages are not re-read
+ * @param control Optional progress and cancellation; once cancelled the
+ *        matches not yet re-checked are kept as they were
+ */
+export [[nodiscard]] inline auto filterMatches(
+    pid_t pid, const ScanOptions& opts, const UserValue* value,
+    MatchesAndOldValuesArray& matches,
+    const core::SoftDirtyMap* dirty = nullptr,
+    ScanControl* control = nullptr)
+    -> std::expected<ScanStats, std::string> {
     core::ProcMemIO reader{pid};
     if (auto err = reader.open(); !err) {
         return std::unexpected(err.error());
     }
+    FilterScratch scratch;
+    return filterSequential(opts, value, matches, reader, dirty, control,
+                            scratch);
+}
+
+/**
+ * @brief Parallel filterMatches: shards matches across the worker pool
+ *
+ * Each worker owns a ProcMemIO and writes into per-shard result slots.
+ * Shards run in waves of at most FILTER_WAVE_MATCHES matches, each
+ * applied in shard order before the next starts, so the result slots stay
+ * bounded and the outcome is identical to the sequential path.
+ *
+ * @param pool Pool to run on; nullptr uses utils::ThreadPool::shared()
+ * @param readers Per-worker readers kept open across calls; ignored
+ *        unless it was reset for pid with at least pool->size() slots
+ * @param dirty See filterMatches
+ * @param control See filterMatches
+ * @param workspace Buffers reused across calls; nullptr allocates per call
+ */
+export [[nodiscard]] inline auto filterMatchesParallel(
+    pid_t pid, const ScanOptions& opts, const UserValue* value,
+    MatchesAndOldValuesArray& matches, utils::ThreadPool* pool = nullptr,
+    core::ProcMemReaders* readers = nullptr,
+    const core::SoftDirtyMap* dirty = nullptr,
+    ScanControl* control = nullptr, FilterWorkspace* workspace = nullptr)
+    -> std::expected<ScanStats, std::string> {
+    auto& workers = pool != nullptr ? *pool : utils::ThreadPool::shared();
+    FilterWorkspace localWorkspace;
+    if (workspace == nullptr) {
+        workspace = &localWorkspace;
+    }
+    // One scratch per worker and one for the fallback below
+    if (workspace->scratch.size() < workers.size() + 1) {
+        workspace->scratch.resize(workers.size() + 1);
+    }
+    core::ProcMemReaders localReaders;
+    if (readers == nullptr || !readers->covers(pid, workers.size())) {
+        localReaders.reset(pid, workers.size());
+        readers = &localReaders;
+    }
+    // Slot 0 doubles as the caller's reader; workers are idle when it runs
+    auto probeExp = readers->acquire(0);
+    if (!probeExp) {
+        return std::unexpected(probeExp.error());
+    }
+    auto& probe = **probeExp;
+
+    const auto SHARDS = matches.shardMatches(FILTER_SHARD_MATCHES);
+    if (workers.size() <= 1 || SHARDS.size() <= 1) {
+        return filterSequential(opts, value, matches, probe, dirty, control,
+                                workspace->scratch.back());
+    }
+
+    auto routineExp = scan::prepareScanRoutine(opts, value);
+    if (!routineExp) {
+        return std::unexpected(routineExp.error());
+    }
+    auto routine = *routineExp;
 
     const std::size_t SLICE_SIZE = scan::scanWindowSize(opts, value);
-    std::vector<std::uint8_t> buffer(SLICE_SIZE);
-    ScanStats stats{};
-    for (auto& swath : matches.swaths) {
-        narrowSwath(swath, routine, value, reader, buffer, stats, opts);
+
+    // Per-worker state, touched only by its own worker
+    struct WorkerState {
+        FilterScratch* scratch{nullptr};
+        ScanStats stats{};
+        std::size_t tasks{0};
+        std::uint64_t busyNs{0};
+    };
+    std::vector<WorkerState> states(workers.size());
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        states[i].scratch = &workspace->scratch[i];
+        states[i].scratch->single.resize(SLICE_SIZE);
     }
-    return stats;
+
+    // Shards run in waves of about FILTER_WAVE_MATCHES matches; shard i's
+    // results live at offsets[i] - offsets[first shard of its wave]
+    std::vector<std::size_t> offsets(SHARDS.size() + 1, 0);
+    std::vector<std::size_t> waves{0};  // first shard of each wave
+    std::size_t waveMatches = 0;
+    std::size_t largestWave = 0;
+    for (std::size_t i = 0; i < SHARDS.size(); ++i) {
+        offsets[i + 1] = offsets[i] + SHARDS[i].matches;
+        if (waveMatches > 0 &&
+            waveMatches + SHARDS[i].matches > FILTER_WAVE_MATCHES) {
+            waves.push_back(i);
+            waveMatches = 0;
+        }
+        waveMatches += SHARDS[i].matches;
+        largestWave = std::max(largestWave, waveMatches);
+    }
+    waves.push_back(SHARDS.size());
+    std::vector<scan::MatchInfo> results(largestWave);
+    std::size_t waveBase = 0;  // offsets[] of the current wave's first shard
+    auto shardResults = [&](std::size_t index) {
+        return std::span(results).subspan(offsets[index] - waveBase,
+                                          SHARDS[index].matches);
+    };
+
+    auto narrowShard = [&](std::size_t index, WorkerState& state,
+                           core::ProcMemIO& reader) {
+        const ProfileTimer BUSY{opts.profile, state.busyNs};
+        ++state.tasks;
+        auto& scratch = *state.scratch;
+        const auto OUT_ALL = shardResults(index);
+        std::size_t done = 0;
+        auto flush = [&]() {
+            const auto OUT = OUT_ALL.subspan(done, scratch.batch.size());
+            if (!keepOnStop(scratch.batch, OUT, state.stats, control)) {
+                narrowBatch(scratch.batch, OUT, routine, value, reader,
+                            SLICE_SIZE, scratch, state.stats, opts, dirty);
+            }
+            done += scratch.batch.size();
+            scratch.batch.clear();
+        };
+        scratch.batch.clear();
+        matches.forEachMatchIn(SHARDS[index], [&](const scan::MatchView& match) {
+            scratch.batch.push_back(match);
+            if (scratch.batch.size() == FILTER_BATCH) {
+                flush();
+            }
+        });
+        if (!scratch.batch.empty()) {
+            flush();
+        }
+    };
+
+    ScanStats totalStats;
+    totalStats.profile.enabled = opts.profile;
+    ProfileTimer total{opts.profile, totalStats.profile.totalNs};
+    ProfileTimer scanPhase{opts.profile, totalStats.profile.scanNs};
+    if (control != nullptr) {
+        std::size_t shardMatches = 0;
+        for (const auto& shard : SHARDS) {
+            shardMatches += shard.matches;
+        }
+        control->start(0, 0, shardMatches);
+    }
+    std::vector<char> narrowed(SHARDS.size(), 0);
+    WorkerState fallback{.scratch = &workspace->scratch.back()};
+    fallback.scratch->single.resize(SLICE_SIZE);
+    // Shards never share a swath word, so applying one wave leaves the
+    // matches of later shards as they were
+    for (std::size_t wave = 0; wave + 1 < waves.size(); ++wave) {
+        const std::size_t FIRST = waves[wave];
+        const std::size_t LAST = waves[wave + 1];
+        waveBase = offsets[FIRST];
+        workers.parallelFor(LAST - FIRST, [&](std::size_t task,
+                                              std::size_t worker) {
+            auto readerExp = readers->acquire(worker);
+            if (!readerExp) {
+                return;
+            }
+            narrowShard(FIRST + task, states[worker], **readerExp);
+            narrowed[FIRST + task] = 1;
+        });
+
+        // A worker that could not open its reader leaves shards behind
+        for (std::size_t i = FIRST; i < LAST; ++i) {
+            if (narrowed[i] == 0) {
+                narrowShard(i, fallback, probe);
+            }
+        }
+
+        const ProfileTimer MERGE{opts.profile, totalStats.profile.mergeNs};
+        for (std::size_t i = FIRST; i < LAST; ++i) {
+            matches.applyShard(SHARDS[i], shardResults(i));
+        }
+    }
+    scanPhase.stop();
+
+    {
+        const ProfileTimer MERGE{opts.profile, totalStats.profile.mergeNs};
+        matches.finishShards();
+        matches.dropEmptySwaths();
+        matches.adaptStorage(SLICE_SIZE);
+    }
+
+    auto addStats = [&](const WorkerState& state) {
+        totalStats.regionsVisited += state.stats.regionsVisited;
+        totalStats.bytesScanned += state.stats.bytesScanned;
+        totalStats.matches += state.stats.matches;
+        totalStats.bytesReused += state.stats.bytesReused;
+        totalStats.cancelled = totalStats.cancelled || state.stats.cancelled;
+        totalStats.profile.merge(state.stats.profile);
+    };
+    addStats(fallback);
+    for (const auto& state : states) {
+        addStats(state);
+        if (opts.profile) {
+            totalStats.profile.workers.push_back(
+                {.busyNs = state.busyNs,
+                 .tasks = state.tasks,
+                 .bytes = state.stats.bytesScanned});
+        }
+    }
+    total.stop();
+    return totalStats;
 }
@@ -0,0 +1,239 @@
+/**
+ * @file group.cppm
+ * @brief Group (structure) scans: several typed values near one another
+ *
+ * A group is an anchor plus companions, each at a fixed offset after the
+ * anchor or anywhere inside the window. The block kernel in scan.kernel
+ * finds anchors with the typed compare and calls groupMatchesAt() only on
+ * the bytes behind each hit, so one pass replaces one scan per value.
+ */
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+
+export module scan.group;
+
+import scan.types;
+import scan.routine;
+import scan.numeric;
+import utils.read_helpers;
+import value.core;
+import value.flags;
+
+export namespace scan {
+
+/** @brief Fixed-width type a group member was parsed as */
+[[nodiscard]] inline auto memberDataType(const GroupMember& member) noexcept
+    -> ScanDataType {
+    switch (member.value.size()) {
+        case 1:
+            return ScanDataType::INTEGER_8;
+        case 2:
+            return ScanDataType::INTEGER_16;
+        case 4:
+            return member.isFloat ? ScanDataType::FLOAT_32
+                                  : ScanDataType::INTEGER_32;
+        default:
+            return member.isFloat ? ScanDataType::FLOAT_64
+                                  : ScanDataType::INTEGER_64;
+    }
+}
+
+/** @brief Bytes from the anchor one group match covers */
+[[nodiscard]] inline auto groupSpan(const UserValue& value) noexcept
+    -> std::size_t {
+    std::size_t span = value.groupWindow;
+    for (const auto& member : value.group) {
+        if (member.offset) {
+            span = std::max(span, *member.offset + member.value.size());
+        }
+    }
+    return span;
+}
+
+namespace detail {
+
+template <typename T>
+[[nodiscard]] inline auto memberEqualAs(const GroupMember& member,
+                                        const std::uint8_t* bytes,
+                                        bool reverseEndianness) noexcept
+    -> bool {
+    T memv;
+    T want;
+    std::memcpy(&memv, bytes, sizeof(T));
+    std::memcpy(&want, member.value.data(), sizeof(T));
+    return numericEqual<T>(swapIfReverse<T>(memv, reverseEndianness), want);
+}
+
+[[nodiscard]] inline auto memberEqualAt(const GroupMember& member,
+                                        const std::uint8_t* bytes,
+                                        bool reverseEndianness) noexcept
+    -> bool {
+    switch (memberDataType(member)) {
+        case ScanDataType::INTEGER_8:
+            return memberEqualAs<std::int8_t>(member, bytes, reverseEndianness);
+        case ScanDataType::INTEGER_16:
+            return memberEqualAs<std::int16_t>(member, bytes,
+                                               reverseEndianness);
+        case ScanDataType::INTEGER_32:
+            return memberEqualAs<std::int32_t>(member, bytes,
+                                               reverseEndianness);
+        case ScanDataType::FLOAT_32:
+            return memberEqualAs<float>(member, bytes, reverseEndianness);
+        case ScanDataType::FLOAT_64:
+            return memberEqualAs<double>(member, bytes, reverseEndianness);
+        default:
+            return memberEqualAs<std::int64_t>(member, bytes,
+                                               reverseEndianness);
+    }
+}
+
+// Interchangeable members: same width, kind and value
+[[nodiscard]] inline auto sameMember(const GroupMember& lhs,
+                                     const GroupMember& rhs) noexcept -> bool {
+    return lhs.isFloat == rhs.isFloat && lhs.value.size() == rhs.value.size() &&
+           std::memcmp(lhs.value.data(), rhs.value.data(),
+                       lhs.value.size()) == 0;
+}
+
+/**
+ * @brief Backtracking placement of the members without an offset
+ *
+ * Widest members go first, as they have the fewest places; equal members
+ * take ascending places, so their orderings are not tried again. steps
+ * bounds the positions tried per anchor on pathological input.
+ */
+struct GroupPlacement {
+    static constexpr std::size_t MAX = UserValue::GROUP_MAX_MEMBERS;
+    static constexpr std::size_t STEPS = 16 * 1024;
+
+    const UserValue& value;
+    std::span<const std::uint8_t> memory;
+    std::size_t span{0};
+    bool reverseEndianness{false};
+    std::array<std::size_t, MAX> order{};  // free members, search order
+    std::size_t count{0};
+    std::array<std::pair<std::size_t, std::size_t>, MAX> claimed{};
+    std::size_t claimedCount{0};
+    std::array<std::size_t, MAX> placedAt{};
+    std::size_t steps{STEPS};
+
+    [[nodiscard]] auto overlaps(std::size_t begin,
+                                std::size_t end) const noexcept -> bool {
+        for (std::size_t i = 0; i < claimedCount; ++i) {
+            if (begin < claimed[i].second && claimed[i].first < end) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto place(std::size_t k) noexcept -> bool {
+        if (k == count) {
+            return true;
+        }
+        const auto& member = value.group[order[k]];
+        const std::size_t WIDTH = member.value.size();
+        std::size_t at = 0;
+        if (k > 0 && sameMember(value.group[order[k - 1]], member)) {
+            at = placedAt[k - 1] + WIDTH;
+        }
+        for (; at + WIDTH <= span; ++at) {
+            if (steps == 0) {
+                return false;
+            }
+            --steps;
+            if (overlaps(at, at + WIDTH) ||
+                !memberEqualAt(member, memory.data() + at,
+                               reverseEndianness)) {
+                continue;
+            }
+            claimed[claimedCount++] = {at, at + WIDTH};
+            placedAt[k] = at;
+            if (place(k + 1)) {
+                return true;
+            }
+            --claimedCount;
+        }
+        return false;
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Whether memory (starting at an anchor) holds the whole group
+ *
+ * Members with an offset are checked there. The others need distinct
+ * places in the window that no other member uses, so two equal values
+ * (hp and maxhp) need two places; all ways of placing them are tried.
+ */
+[[nodiscard]] inline auto groupMatchesAt(const UserValue& value,
+                                         std::span<const std::uint8_t> memory,
+                                         bool reverseEndianness) noexcept
+    -> bool {
+    const std::size_t SPAN = groupSpan(value);
+    if (value.group.empty() ||
+        value.group.size() > UserValue::GROUP_MAX_MEMBERS ||
+        memory.size() < SPAN) {
+        return false;
+    }
+    detail::GroupPlacement placement{.value = value,
+                                     .memory = memory,
+                                     .span = SPAN,
+                                     .reverseEndianness = reverseEndianness};
+    for (std::size_t i = 0; i < value.group.size(); ++i) {
+        const auto& member = value.group[i];
+        if (!member.offset) {
+            placement.order[placement.count++] = i;
+            continue;
+        }
+        if (!detail::memberEqualAt(member, memory.data() + *member.offset,
+                                   reverseEndianness)) {
+            return false;
+        }
+        placement.claimed[placement.claimedCount++] = {
+            *member.offset, *member.offset + member.value.size()};
+    }
+    const auto FREE = std::span(placement.order).first(placement.count);
+    std::ranges::sort(FREE, [&](std::size_t lhs, std::size_t rhs) {
+        const auto& left = value.group[lhs].value;
+        const auto& right = value.group[rhs].value;
+        if (left.size() != right.size()) {
+            return left.size() > right.size();
+        }
+        return std::memcmp(left.data(), right.data(), left.size()) < 0;
+    });
+    return placement.place(0);
+}
+
+/**
+ * @brief Routine matching a whole group at the current offset
+ *
+ * Only MATCH_EQUAL_TO is meaningful for a group; a match covers the span
+ * and carries the anchor's width flag.
+ */
+[[nodiscard]] inline auto makeGroupScanRoutine(ScanMatchType matchType)
+    -> ScanRoutine {
+    if (matchType != ScanMatchType::MATCH_EQUAL_TO) {
+        return nullRoutine();
+    }
+    return [](const ScanContext& ctx) -> ScanResult {
+        if (ctx.userValue == nullptr || ctx.userValue->group.empty() ||
+            !groupMatchesAt(*ctx.userValue, ctx.memory,
+                            ctx.reverseEndianness)) {
+            return ScanResult::noMatch();
+        }
+        return ScanResult::match(groupSpan(*ctx.userValue),
+                                 ctx.userValue->group.front().value.flag());
+    };
+}
+
+}  // namespace scan
@@ -10,49 +10,105 @@ module;
 #include <algorithm>
 #include <expected>
 #include <format>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 export module scan.job;
 
 import scan.types;
 import scan.factory;
+import scan.group;
 import scan.routine;
+import scan.kernel;
+import scan.match_plan;
+import scan.string;
 import core.maps;
+import core.region_cache;
 import core.region_filter;
 import value.core;
 
 export namespace scan {
 
+/**
+ * @brief Regions a scan with opts visits
+ * @param cache Optional session cache; used only if it follows pid
+ */
 [[nodiscard]] inline auto prepareScanRegions(pid_t pid,
-                                             const ScanOptions& opts)
-    -> std::expected<std::vector<core::Region>, std::string> {
-    auto regionsExp = readProcessMaps(pid, opts.regionLevel);
-    if (!regionsExp) {
-        return std::unexpected{std::format("readProcessMaps failed: {}",
-                                           regionsExp.error().message)};
+                                             const ScanOptions& opts,
+                                             core::RegionCache* cache = nullptr)
+    -> std::expected<core::RegionCache::Regions, std::string> {
+    core::RegionCache::Regions regions;
+    if (cache != nullptr && cache->pid() == pid) {
+        auto cached = cache->regions(opts.regionLevel);
+        if (!cached) {
+            return std::unexpected{
+                std::format("readProcessMaps failed: {}", cached.error())};
+        }
+        regions = std::move(*cached);
+    } else {
+        auto regionsExp = readProcessMaps(pid, opts.regionLevel);
+        if (!regionsExp) {
+            return std::unexpected{std::format("readProcessMaps failed: {}",
+                                               regionsExp.error().message)};
+        }
+        regions = std::make_shared<const std::vector<core::Region>>(
+            std::move(*regionsExp));
     }
 
-    auto regions = *regionsExp;
     if (opts.regionFilter.isScanTimeFilter() &&
         opts.regionFilter.filter.isActive()) {
-        regions = opts.regionFilter.filter.filterRegions(regions);
+        regions = std::make_shared<const std::vector<core::Region>>(
+            opts.regionFilter.filter.filterRegions(*regions));
     }
 
     return regions;
 }
 
+/**
+ * @brief Routine for opts, with the user value converted once up front
+ * @param plan Plan to reuse; built from opts and userValue when null
+ */
 [[nodiscard]] inline auto prepareScanRoutine(const ScanOptions& opts,
-                                             const UserValue* userValue)
+                                             const UserValue* userValue,
+                                             MatchPlanPtr plan = nullptr)
     -> std::expected<ScanRoutine, std::string> {
-    auto routine =
-        makeScanRoutine(opts.dataType, opts.matchType, opts.reverseEndianness);
+    if (!plan) {
+        plan = makeMatchPlan(opts, userValue);
+    }
+    auto routine = makeScanRoutine(plan);
     if (!routine) {
         return std::unexpected{"no scan routine for options"};
     }
     return routine;
 }
 
+/**
+ * @brief Resolve the routine and block kernel used by snapshot scans
+ */
+[[nodiscard]] inline auto prepareScanKernel(const ScanOptions& opts,
+                                            const UserValue* userValue)
+    -> std::expected<ScanKernel, std::string> {
+    auto plan = makeMatchPlan(opts, userValue);
+    auto routineExp = prepareScanRoutine(opts, userValue, plan);
+    if (!routineExp) {
+        return std::unexpected{routineExp.error()};
+    }
+    auto kernel = makeScanKernel(opts, std::move(*routineExp), std::move(plan));
+    if (opts.dataType == ScanDataType::STRING &&
+        opts.matchType == ScanMatchType::MATCH_REGEX && userValue != nullptr &&
+        !kernel.strings) {
+        // Report why the pattern did not compile instead of matching nothing
+        auto searcher =
+            StringSearcher::create(opts.matchType, *userValue, opts.stringEncoding);
+        if (!searcher) {
+            return std::unexpected{searcher.error()};
+        }
+    }
+    return kernel;
+}
+
 [[nodiscard]] inline auto scanWindowSize(const ScanOptions& opts,
                                          const UserValue* userValue)
     -> std::size_t {
@@ -62,6 +118,11 @@ export namespace scan {
         if (userValue->secondary) {
             window = std::max(window, userValue->secondary->size());
         }
+        for (const auto& alternative : userValue->alternatives) {
+            window = std::max(window, alternative.size());
+        }
+        // A group is re-checked as a whole, anchor to end of span
+        window = std::max(window, groupSpan(*userValue));
     }
     return std::max<std::size_t>(1, window);
 }
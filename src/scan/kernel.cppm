@@ -0,0 +1,737 @@
+/**
+ * @file kernel.cppm
+ * @brief Block-level scan kernels selected once per scan
+ *
+ * A kernel consumes a whole block of freshly read bytes instead of being
+ * invoked per offset. Fixed-width numeric types get a kernel specialised at
+ * compile time on (type, match, endianness), both for user-value and for
+ * previous-snapshot matches; ANY_NUMBER / ANY_INTEGER / ANY_FLOAT share one
+ * fused kernel reporting every matching width. Byte-array equality searches a PatternSet
+ * compiled once from the user value; string equality and regexes run a
+ * StringSearcher over the block, looking back into bytes of the previous
+ * block so matches straddling the boundary are not lost. Group scans find
+ * the anchor with the typed compare and verify the companions only in the
+ * bytes right behind each hit. Every other combination falls back to
+ * driving the per-offset ScanRoutine.
+ */
+
+module;
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module scan.kernel;
+
+import scan.types;
+import scan.routine;
+import scan.group;
+import scan.numeric;
+import scan.match_plan;
+import scan.pattern_set;
+import scan.match_storage;
+import scan.simd;
+import scan.snapshot_index;
+import scan.string;
+import utils.read_helpers;
+import value.core;
+import value.flags;
+
+export namespace scan {
+
+/**
+ * @struct BlockScanArgs
+ * @brief Everything a kernel needs to scan one block
+ */
+struct BlockScanArgs {
+    std::span<const std::uint8_t> memory;  ///< Bytes read for this block
+    void* address{nullptr};                ///< Remote address of memory[0]
+    std::size_t baseIndex{0};              ///< Swath index of memory[0]
+    std::size_t step{1};                   ///< Distance between candidates
+    const UserValue* userValue{nullptr};   ///< Optional comparison value
+    std::span<const OldSegment> oldSegments;  ///< Previous bytes, by offset
+    std::size_t oldSliceLen{0};            ///< Old bytes needed per offset
+    bool reverseEndianness{false};         ///< Used by the routine fallback
+    /// Bytes before memory.data() that are valid to read (previous block)
+    std::size_t lookBehind{0};
+    /// ANY_* only: report just the widths each address is aligned for
+    bool alignedWidthsOnly{false};
+};
+
+struct ScanKernel;
+
+/**
+ * @brief Block kernel signature
+ * @return Number of matches marked in the swath
+ */
+using BlockKernelFn = std::size_t (*)(const ScanKernel& kernel,
+                                      const BlockScanArgs& args,
+                                      MatchesAndOldValuesSwath& swath);
+
+/**
+ * @struct ScanKernel
+ * @brief Selected block kernel plus the routine it may fall back to
+ */
+struct ScanKernel {
+    ScanRoutine routine;           ///< Per-offset routine (fallback path)
+    BlockKernelFn block{nullptr};  ///< Block entry point
+    bool specialized{false};       ///< True when block is a typed kernel
+    std::shared_ptr<const PatternSet> patterns;  ///< Byte-array signatures
+    std::shared_ptr<const StringSearcher> strings;  ///< String / regex search
+    std::shared_ptr<const AnyNumberMatcher> anyNumber;  ///< ANY_* widths
+    MatchPlanPtr plan;  ///< User value converted once per scan
+    std::size_t lookBehind{0};  ///< Bytes of the previous block wanted
+
+    auto scanBlock(const BlockScanArgs& args,
+                   MatchesAndOldValuesSwath& swath) const -> std::size_t {
+        return block(*this, args, swath);
+    }
+};
+
+/**
+ * @brief Advance seg to the segment covering offset, if any
+ *
+ * Offsets are visited in ascending order, so the segment index only moves
+ * forward over a block.
+ */
+inline auto findOldSegment(std::span<const OldSegment> segments,
+                           std::size_t& seg, std::size_t offset,
+                           std::size_t window) noexcept -> const OldSegment* {
+    while (seg < segments.size() &&
+           segments[seg].blockOffset + segments[seg].bytes.size() <
+               offset + window) {
+        ++seg;
+    }
+    if (seg < segments.size() && segments[seg].covers(offset, window)) {
+        return &segments[seg];
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Generic kernel: evaluate the routine at every step inside the block
+ */
+inline auto routineBlockKernel(const ScanKernel& kernel,
+                               const BlockScanArgs& args,
+                               MatchesAndOldValuesSwath& swath) -> std::size_t {
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+    const MatchFlags REQUIRED = (args.userValue != nullptr)
+                                    ? args.userValue->flag()
+                                    : MatchFlags::EMPTY;
+    const std::size_t WINDOW = std::max<std::size_t>(1, args.oldSliceLen);
+
+    // One Value reused for every offset; assign() keeps its capacity.
+    Value oldValue;
+    oldValue.flags =
+        MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
+    std::size_t seg = 0;
+
+    std::size_t matches = 0;
+    for (std::size_t offset = 0; offset < args.memory.size();
+         offset += STEP_SIZE) {
+        const Value* old = nullptr;
+        if (const auto* segment =
+                findOldSegment(args.oldSegments, seg, offset, WINDOW)) {
+            const auto* first = segment->at(offset);
+            oldValue.bytes.assign(first, first + WINDOW);
+            old = &oldValue;
+        }
+        auto context =
+            makeScanContext(args.memory.subspan(offset), old, args.userValue,
+                            REQUIRED, args.reverseEndianness);
+        auto result = kernel.routine(context);
+        if (!result) {
+            continue;
+        }
+        swath.markRangeByIndex(args.baseIndex + offset, result.matchLength,
+                               result.matchedFlag);
+        ++matches;
+    }
+    return matches;
+}
+
+/**
+ * @brief Fill a per-thread bitmask via fillMask, then mark every set offset
+ */
+template <typename FillMask>
+auto markFromMask(const BlockScanArgs& args, MatchesAndOldValuesSwath& swath,
+                  std::size_t width, MatchFlags flag, FillMask&& fillMask)
+    -> std::size_t {
+    thread_local std::vector<std::uint64_t> maskWords;
+    maskWords.assign(maskWordsFor(args.memory.size()), 0);
+    const std::size_t MATCHES = fillMask(std::span<std::uint64_t>(maskWords));
+    if (MATCHES == 0) {
+        return 0;
+    }
+    for (std::size_t word = 0; word < maskWords.size(); ++word) {
+        std::uint64_t bits = maskWords[word];
+        while (bits != 0) {
+            const auto BIT = static_cast<std::size_t>(std::countr_zero(bits));
+            swath.markRangeByIndex(args.baseIndex + word * 64 + BIT, width, flag);
+            bits &= bits - 1;
+        }
+    }
+    return MATCHES;
+}
+
+/**
+ * @brief Typed kernel for user-value comparisons
+ *
+ * The user value is decoded once per block, and the comparison, width and
+ * byte order are all fixed at compile time, so the inner loop is a plain
+ * load/compare with no type dispatch. int32/int64/float/double comparisons
+ * are handed to the SIMD bitmask kernels when the step allows it.
+ * Semantics match numericMatchCore.
+ */
+template <typename T, ScanMatchType MATCH, bool REVERSE>
+auto numericBlockKernel(const ScanKernel& kernel, const BlockScanArgs& args,
+                        MatchesAndOldValuesSwath& swath) -> std::size_t {
+    constexpr MatchFlags FLAG = flagForType<T>();
+    constexpr std::size_t WIDTH = sizeof(T);
+
+    T low{};
+    T high{};
+    if constexpr (MATCH != ScanMatchType::MATCH_ANY) {
+        if (!kernel.plan) {
+            return 0;
+        }
+        const auto& operands = kernel.plan->template operands<T>();
+        if (!operands.valid) {
+            return 0;
+        }
+        low = operands.low;
+        high = operands.high;
+    }
+
+    if (args.memory.size() < WIDTH) {
+        return 0;
+    }
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+
+    if constexpr (!REVERSE && SIMD_COMPARABLE<T> && isSimdMatch(MATCH)) {
+        if (WIDTH % STEP_SIZE == 0) {
+            return markFromMask(
+                args, swath, WIDTH, FLAG, [&](std::span<std::uint64_t> mask) {
+                    return compareBlockMask<T, MATCH>(args.memory, STEP_SIZE,
+                                                      low, high, mask);
+                });
+        }
+    }
+
+    const std::uint8_t* bytes = args.memory.data();
+    const std::size_t LAST = args.memory.size() - WIDTH;
+    std::size_t matches = 0;
+    for (std::size_t offset = 0; offset <= LAST; offset += STEP_SIZE) {
+        T memv;
+        std::memcpy(&memv, bytes + offset, WIDTH);
+        memv = swapIfReverse<T>(memv, REVERSE);
+        if (evalPredicate<T, MATCH>(memv, low, high)) {
+            swath.markRangeByIndex(args.baseIndex + offset, WIDTH, FLAG);
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Fused ANY_* kernel: all widths per offset from one load
+ *
+ * Like the routine path, offsets whose old bytes are missing never match
+ * a comparison against the previous value.
+ */
+template <ScanMatchType MATCH>
+auto anyNumberBlockKernel(const ScanKernel& kernel, const BlockScanArgs& args,
+                          MatchesAndOldValuesSwath& swath) -> std::size_t {
+    const auto& matcher = *kernel.anyNumber;
+    const auto ADDRESS = reinterpret_cast<std::uintptr_t>(args.address);
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+    const std::size_t WINDOW = std::max<std::size_t>(1, args.oldSliceLen);
+    std::size_t seg = 0;
+
+    std::size_t matches = 0;
+    for (std::size_t offset = 0; offset < args.memory.size();
+         offset += STEP_SIZE) {
+        std::span<const std::uint8_t> old;
+        if constexpr (matchUsesOldValue(MATCH)) {
+            const auto* segment =
+                findOldSegment(args.oldSegments, seg, offset, WINDOW);
+            if (segment == nullptr) {
+                continue;
+            }
+            old = {segment->at(offset), WINDOW};
+        }
+        auto result = matcher.match<MATCH>(args.memory.subspan(offset), old);
+        if (args.alignedWidthsOnly) {
+            result = AnyNumberMatcher::keepWidths(
+                result, alignedWidths(ADDRESS + offset));
+        }
+        if (result.length == 0) {
+            continue;
+        }
+        swath.markRangeByIndex(args.baseIndex + offset, result.length,
+                               result.flags);
+        ++matches;
+    }
+    return matches;
+}
+
+constexpr auto selectAnyNumberKernel(ScanMatchType matchType) -> BlockKernelFn {
+    switch (matchType) {
+        case ScanMatchType::MATCH_ANY:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_ANY>;
+        case ScanMatchType::MATCH_EQUAL_TO:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_EQUAL_TO>;
+        case ScanMatchType::MATCH_NOT_EQUAL_TO:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_NOT_EQUAL_TO>;
+        case ScanMatchType::MATCH_GREATER_THAN:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_GREATER_THAN>;
+        case ScanMatchType::MATCH_LESS_THAN:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_LESS_THAN>;
+        case ScanMatchType::MATCH_RANGE:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_RANGE>;
+        case ScanMatchType::MATCH_UPDATE:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_UPDATE>;
+        case ScanMatchType::MATCH_NOT_CHANGED:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_NOT_CHANGED>;
+        case ScanMatchType::MATCH_CHANGED:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_CHANGED>;
+        case ScanMatchType::MATCH_INCREASED:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_INCREASED>;
+        case ScanMatchType::MATCH_DECREASED:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_DECREASED>;
+        case ScanMatchType::MATCH_INCREASED_BY:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_INCREASED_BY>;
+        case ScanMatchType::MATCH_DECREASED_BY:
+            return &anyNumberBlockKernel<ScanMatchType::MATCH_DECREASED_BY>;
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * @brief Byte-array kernel: one PatternSet search over the whole block
+ *
+ * Where several patterns start at the same offset the longest one is
+ * marked, like the routine path.
+ */
+inline auto byteArrayBlockKernel(const ScanKernel& kernel,
+                                 const BlockScanArgs& args,
+                                 MatchesAndOldValuesSwath& swath)
+    -> std::size_t {
+    if (!kernel.patterns || kernel.patterns->empty()) {
+        return 0;
+    }
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+    constexpr MatchFlags FLAG = MatchFlags::B8 | MatchFlags::BYTE_ARRAY;
+    const auto& patterns = *kernel.patterns;
+
+    if (patterns.size() == 1) {
+        const std::size_t LENGTH = patterns.pattern(0).size();
+        std::size_t matches = 0;
+        patterns.search(args.memory, [&](std::size_t offset, std::size_t) {
+            if (offset % STEP_SIZE == 0) {
+                swath.markRangeByIndex(args.baseIndex + offset, LENGTH, FLAG);
+                ++matches;
+            }
+        });
+        return matches;
+    }
+
+    // Hits of different patterns interleave; order them before marking
+    thread_local std::vector<std::pair<std::size_t, std::size_t>> hits;
+    hits.clear();
+    patterns.search(args.memory, [&](std::size_t offset, std::size_t index) {
+        if (offset % STEP_SIZE == 0) {
+            hits.emplace_back(offset, patterns.pattern(index).size());
+        }
+    });
+    std::ranges::sort(hits, [](const auto& lhs, const auto& rhs) {
+        return lhs.first != rhs.first ? lhs.first < rhs.first
+                                      : lhs.second > rhs.second;
+    });
+    std::size_t matches = 0;
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+        if (i > 0 && hits[i].first == hits[i - 1].first) {
+            continue;
+        }
+        swath.markRangeByIndex(args.baseIndex + hits[i].first, hits[i].second,
+                               FLAG);
+        ++matches;
+    }
+    return matches;
+}
+
+/**
+ * @brief String kernel: one StringSearcher pass over the whole block
+ *
+ * The search starts args.lookBehind bytes early. Matches ending there were
+ * already reported by the previous block; matches starting there straddle
+ * the boundary and are marked at their (earlier) start index. A match the
+ * previous block cut short at its end is replaced, not counted twice.
+ */
+inline auto stringBlockKernel(const ScanKernel& kernel,
+                              const BlockScanArgs& args,
+                              MatchesAndOldValuesSwath& swath) -> std::size_t {
+    if (!kernel.strings || args.memory.empty()) {
+        return 0;
+    }
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+    const std::size_t BEHIND = std::min(args.lookBehind, args.baseIndex);
+    const std::span<const std::uint8_t> HAY{args.memory.data() - BEHIND,
+                                            args.memory.size() + BEHIND};
+    thread_local std::vector<ByteMatch> hits;
+    hits.clear();
+    kernel.strings->search(HAY, hits);
+
+    std::size_t matches = 0;
+    for (const auto& hit : hits) {
+        if (hit.offset + hit.length <= BEHIND) {
+            continue;
+        }
+        const std::size_t INDEX = args.baseIndex - BEHIND + hit.offset;
+        if (INDEX % STEP_SIZE != 0) {
+            continue;
+        }
+        const bool SEEN = hit.offset < BEHIND && swath.isMatch(INDEX);
+        swath.setMatch(INDEX, MatchFlags::B8, hit.length);
+        if (!SEEN) {
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Group kernel: typed anchor compare, companions checked per hit
+ *
+ * An anchor is only tested once its whole span has been read, looking
+ * args.lookBehind bytes back into the previous block; anchors whose span
+ * ended inside that block were tested there and are skipped.
+ */
+template <typename T, bool REVERSE>
+auto groupBlockKernel(const ScanKernel& kernel, const BlockScanArgs& args,
+                      MatchesAndOldValuesSwath& swath) -> std::size_t {
+    constexpr MatchFlags FLAG = flagForType<T>();
+    constexpr std::size_t WIDTH = sizeof(T);
+    if (!kernel.plan || args.userValue == nullptr) {
+        return 0;
+    }
+    const auto& operands = kernel.plan->template operands<T>();
+    const UserValue& group = *args.userValue;
+    const std::size_t SPAN = groupSpan(group);
+    const std::size_t BEHIND = std::min(args.lookBehind, args.baseIndex);
+    const std::span<const std::uint8_t> HAY{args.memory.data() - BEHIND,
+                                            args.memory.size() + BEHIND};
+    if (!operands.valid || SPAN < WIDTH || HAY.size() < SPAN) {
+        return 0;
+    }
+    const auto ANCHORS = HAY.first(HAY.size() - SPAN + WIDTH);
+    const std::size_t FIRST_INDEX = args.baseIndex - BEHIND;
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+
+    std::size_t matches = 0;
+    auto verify = [&](std::size_t offset) {
+        const std::size_t INDEX = FIRST_INDEX + offset;
+        if (offset + SPAN <= BEHIND || INDEX % STEP_SIZE != 0 ||
+            !groupMatchesAt(group, HAY.subspan(offset, SPAN), REVERSE)) {
+            return;
+        }
+        swath.markRangeByIndex(INDEX, SPAN, FLAG);
+        ++matches;
+    };
+
+    if constexpr (!REVERSE && SIMD_COMPARABLE<T>) {
+        thread_local std::vector<std::uint64_t> maskWords;
+        maskWords.assign(maskWordsFor(ANCHORS.size()), 0);
+        if (compareBlockMask<T, ScanMatchType::MATCH_EQUAL_TO>(
+                ANCHORS, 1, operands.low, operands.high,
+                std::span<std::uint64_t>(maskWords)) == 0) {
+            return 0;
+        }
+        for (std::size_t word = 0; word < maskWords.size(); ++word) {
+            std::uint64_t bits = maskWords[word];
+            while (bits != 0) {
+                verify(word * 64 + static_cast<std::size_t>(
+                                       std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+        return matches;
+    }
+
+    const std::uint8_t* bytes = ANCHORS.data();
+    for (std::size_t offset = 0; offset + WIDTH <= ANCHORS.size(); ++offset) {
+        T memv;
+        std::memcpy(&memv, bytes + offset, WIDTH);
+        memv = swapIfReverse<T>(memv, REVERSE);
+        if (evalPredicate<T, ScanMatchType::MATCH_EQUAL_TO>(memv, operands.low,
+                                                           operands.high)) {
+            verify(offset);
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Compare against the previous value (and user delta where needed)
+ */
+template <typename T, ScanMatchType MATCH>
+[[nodiscard]] constexpr auto evalDelta(T memv, T old, T delta) noexcept
+    -> bool {
+    if constexpr (MATCH == ScanMatchType::MATCH_UPDATE ||
+                  MATCH == ScanMatchType::MATCH_NOT_CHANGED) {
+        return numericEqual<T>(memv, old);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_CHANGED) {
+        return !numericEqual<T>(memv, old);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_INCREASED) {
+        return numericGreater<T>(memv, old);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_DECREASED) {
+        return numericLess<T>(memv, old);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_INCREASED_BY) {
+        return numericEqual<T>(static_cast<T>(memv - old), delta);
+    } else {
+        static_assert(MATCH == ScanMatchType::MATCH_DECREASED_BY);
+        return numericEqual<T>(static_cast<T>(old - memv), delta);
+    }
+}
+
+/**
+ * @brief Typed kernel for matches against the previous snapshot
+ *
+ * Walks the old-byte segments of the block directly instead of building a
+ * Value per offset; offsets without a full old window never match, as in
+ * the routine path.
+ */
+template <typename T, ScanMatchType MATCH, bool REVERSE>
+auto numericDeltaKernel(const ScanKernel& kernel, const BlockScanArgs& args,
+                        MatchesAndOldValuesSwath& swath) -> std::size_t {
+    constexpr MatchFlags FLAG = flagForType<T>();
+    constexpr std::size_t WIDTH = sizeof(T);
+
+    T delta{};
+    if constexpr (matchNeedsUserValue(MATCH)) {
+        if (!kernel.plan) {
+            return 0;
+        }
+        const auto& operands = kernel.plan->template operands<T>();
+        if (!operands.valid) {
+            return 0;
+        }
+        delta = operands.low;
+    }
+
+    if (args.memory.size() < WIDTH) {
+        return 0;
+    }
+    const std::uint8_t* bytes = args.memory.data();
+    const std::size_t LAST = args.memory.size() - WIDTH;
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, args.step);
+    const std::size_t WINDOW = std::max(WIDTH, args.oldSliceLen);
+
+    std::size_t matches = 0;
+    for (const auto& segment : args.oldSegments) {
+        if (segment.bytes.size() < WINDOW) {
+            continue;
+        }
+        const std::size_t FIRST =
+            (segment.blockOffset + STEP_SIZE - 1) / STEP_SIZE * STEP_SIZE;
+        const std::size_t END = std::min(
+            LAST, segment.blockOffset + segment.bytes.size() - WINDOW);
+        for (std::size_t offset = FIRST; offset <= END; offset += STEP_SIZE) {
+            T memv;
+            T old;
+            std::memcpy(&memv, bytes + offset, WIDTH);
+            std::memcpy(&old, segment.at(offset), WIDTH);
+            memv = swapIfReverse<T>(memv, REVERSE);
+            old = swapIfReverse<T>(old, REVERSE);
+            if (evalDelta<T, MATCH>(memv, old, delta)) {
+                swath.markRangeByIndex(args.baseIndex + offset, WIDTH, FLAG);
+                ++matches;
+            }
+        }
+    }
+    return matches;
+}
+
+}  // namespace scan
+
+namespace scan {
+
+template <typename T, bool REVERSE>
+constexpr auto selectNumericKernel(ScanMatchType matchType) -> BlockKernelFn {
+    switch (matchType) {
+        case ScanMatchType::MATCH_ANY:
+            return &numericBlockKernel<T, ScanMatchType::MATCH_ANY, REVERSE>;
+        case ScanMatchType::MATCH_EQUAL_TO:
+            return &numericBlockKernel<T, ScanMatchType::MATCH_EQUAL_TO,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_NOT_EQUAL_TO:
+            return &numericBlockKernel<T, ScanMatchType::MATCH_NOT_EQUAL_TO,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_GREATER_THAN:
+            return &numericBlockKernel<T, ScanMatchType::MATCH_GREATER_THAN,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_LESS_THAN:
+            return &numericBlockKernel<T, ScanMatchType::MATCH_LESS_THAN,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_RANGE:
+            return &numericBlockKernel<T, ScanMatchType::MATCH_RANGE, REVERSE>;
+        case ScanMatchType::MATCH_UPDATE:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_UPDATE, REVERSE>;
+        case ScanMatchType::MATCH_NOT_CHANGED:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_NOT_CHANGED,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_CHANGED:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_CHANGED,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_INCREASED:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_INCREASED,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_DECREASED:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_DECREASED,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_INCREASED_BY:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_INCREASED_BY,
+                                       REVERSE>;
+        case ScanMatchType::MATCH_DECREASED_BY:
+            return &numericDeltaKernel<T, ScanMatchType::MATCH_DECREASED_BY,
+                                       REVERSE>;
+        default:
+            return nullptr;
+    }
+}
+
+template <typename T>
+constexpr auto selectNumericKernel(ScanMatchType matchType, bool reverse)
+    -> BlockKernelFn {
+    return reverse ? selectNumericKernel<T, true>(matchType)
+                   : selectNumericKernel<T, false>(matchType);
+}
+
+template <typename T>
+constexpr auto selectGroupKernel(bool reverse) -> BlockKernelFn {
+    return reverse ? &groupBlockKernel<T, true> : &groupBlockKernel<T, false>;
+}
+
+/** @brief Group kernel for the anchor's type */
+constexpr auto selectGroupKernel(ScanDataType anchorType, bool reverse)
+    -> BlockKernelFn {
+    switch (anchorType) {
+        case ScanDataType::INTEGER_8:
+            return selectGroupKernel<int8_t>(reverse);
+        case ScanDataType::INTEGER_16:
+            return selectGroupKernel<int16_t>(reverse);
+        case ScanDataType::INTEGER_32:
+            return selectGroupKernel<int32_t>(reverse);
+        case ScanDataType::INTEGER_64:
+            return selectGroupKernel<int64_t>(reverse);
+        case ScanDataType::FLOAT_32:
+            return selectGroupKernel<float>(reverse);
+        case ScanDataType::FLOAT_64:
+            return selectGroupKernel<double>(reverse);
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace scan
+
+export namespace scan {
+
+/**
+ * @brief Look up a specialised block kernel
+ * @return nullptr when the combination has no typed kernel
+ */
+[[nodiscard]] constexpr auto selectBlockKernel(ScanDataType dataType,
+                                               ScanMatchType matchType,
+                                               bool reverseEndianness)
+    -> BlockKernelFn {
+    switch (dataType) {
+        case ScanDataType::INTEGER_8:
+            return selectNumericKernel<int8_t>(matchType, reverseEndianness);
+        case ScanDataType::INTEGER_16:
+            return selectNumericKernel<int16_t>(matchType, reverseEndianness);
+        case ScanDataType::INTEGER_32:
+            return selectNumericKernel<int32_t>(matchType, reverseEndianness);
+        case ScanDataType::INTEGER_64:
+            return selectNumericKernel<int64_t>(matchType, reverseEndianness);
+        case ScanDataType::FLOAT_32:
+            return selectNumericKernel<float>(matchType, reverseEndianness);
+        case ScanDataType::FLOAT_64:
+            return selectNumericKernel<double>(matchType, reverseEndianness);
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * @brief Bundle a routine with the best block kernel for the options
+ * @param plan Built from opts and the user value (which byte-array and
+ *        string patterns are compiled from; may be nullptr)
+ */
+[[nodiscard]] inline auto makeScanKernel(const ScanOptions& opts,
+                                         ScanRoutine routine, MatchPlanPtr plan)
+    -> ScanKernel {
+    const UserValue* userValue = plan->userValue();
+    ScanKernel kernel{.routine = std::move(routine), .plan = std::move(plan)};
+    kernel.block = selectBlockKernel(opts.dataType, opts.matchType,
+                                     opts.reverseEndianness);
+    if (isAggregatedAny(opts.dataType)) {
+        kernel.block = selectAnyNumberKernel(opts.matchType);
+        if (kernel.block != nullptr) {
+            kernel.anyNumber = std::make_shared<const AnyNumberMatcher>(
+                AnyNumberMatcher::create(*kernel.plan));
+        }
+    }
+    if (opts.dataType == ScanDataType::BYTE_ARRAY &&
+        opts.matchType == ScanMatchType::MATCH_EQUAL_TO &&
+        userValue != nullptr && userValue->flag() == MatchFlags::BYTE_ARRAY) {
+        kernel.patterns = std::make_shared<const PatternSet>(
+            PatternSet::fromUserValue(*userValue));
+        kernel.block = &byteArrayBlockKernel;
+    }
+    if (opts.dataType == ScanDataType::STRING &&
+        (opts.matchType == ScanMatchType::MATCH_EQUAL_TO ||
+         opts.matchType == ScanMatchType::MATCH_REGEX) &&
+        userValue != nullptr && userValue->flag() == MatchFlags::STRING) {
+        if (auto searcher = StringSearcher::create(
+                opts.matchType, *userValue, opts.stringEncoding)) {
+            kernel.lookBehind = searcher->lookBehind(
+                std::min({opts.stringOverlap, opts.blockSize,
+                          ScanOptions::MAX_STRING_OVERLAP}));
+            kernel.strings =
+                std::make_shared<const StringSearcher>(std::move(*searcher));
+            kernel.block = &stringBlockKernel;
+        }
+    }
+    if (opts.dataType == ScanDataType::GROUP &&
+        opts.matchType == ScanMatchType::MATCH_EQUAL_TO &&
+        userValue != nullptr && !userValue->group.empty()) {
+        kernel.block = selectGroupKernel(
+            memberDataType(userValue->group.front()), opts.reverseEndianness);
+        kernel.lookBehind = groupSpan(*userValue) - 1;
+    }
+    kernel.specialized = kernel.block != nullptr;
+    if (!kernel.specialized) {
+        kernel.block = &routineBlockKernel;
+    }
+    return kernel;
+}
+
+/** @brief makeScanKernel() with a plan built from opts and userValue */
+[[nodiscard]] inline auto makeScanKernel(const ScanOptions& opts,
+                                         ScanRoutine routine,
+                                         const UserValue* userValue = nullptr)
+    -> ScanKernel {
+    return makeScanKernel(opts, std::move(routine),
+                          makeMatchPlan(opts, userValue));
+}
+
+}  // namespace scan
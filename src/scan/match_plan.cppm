@@ -0,0 +1,171 @@
+/**
+ * @file match_plan.cppm
+ * @brief User value pre-converted for every numeric type (匹配计划)
+ *
+ * numericMatchCore converts the user value (and for ranges orders the
+ * bounds) on every call. A MatchPlan does that once per scan, for every
+ * fixed-width type, and routines, kernels and the ANY_* matcher read the
+ * typed operands straight from it.
+ */
+
+module;
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+export module scan.match_plan;
+
+import scan.types;
+import utils.read_helpers;
+import value.core;
+import value.flags;
+
+export namespace scan {
+
+/**
+ * @brief The user value as one type
+ *
+ * For MATCH_RANGE, low <= high; rangeLow / rangeHigh are the bounds
+ * widened by the float tolerance (equal to low / high for integers).
+ */
+template <typename T>
+struct TypedOperands {
+    using Type = T;
+
+    T low{};
+    T high{};
+    T rangeLow{};
+    T rangeHigh{};
+    T tolerance{};       ///< Absolute tolerance, 0 for integers
+    bool valid{false};   ///< The user value converts to T (and has a high
+                         ///< bound, for ranges)
+
+    [[nodiscard]] constexpr auto inRange(T memv) const noexcept -> bool {
+        return memv >= rangeLow && memv <= rangeHigh;
+    }
+};
+
+/**
+ * @brief Convert the user value to T
+ * @param range Also read and order the high bound (MATCH_RANGE)
+ */
+template <typename T>
+[[nodiscard]] inline auto toOperands(const UserValue& value, bool range) noexcept
+    -> TypedOperands<T> {
+    TypedOperands<T> operands;
+    auto low = userValueAs<T>(value);
+    if (!low) {
+        return operands;
+    }
+    operands.low = *low;
+    operands.high = *low;
+    if (range) {
+        auto high = userValueHighAs<T>(value);
+        if (!high) {
+            return operands;
+        }
+        std::tie(operands.low, operands.high) = std::minmax(*low, *high);
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        operands.tolerance = absTol<T>();
+    }
+    operands.rangeLow = static_cast<T>(operands.low - operands.tolerance);
+    operands.rangeHigh = static_cast<T>(operands.high + operands.tolerance);
+    operands.valid = true;
+    return operands;
+}
+
+/**
+ * @class MatchPlan
+ * @brief Scan options plus the user value converted for every type
+ */
+class MatchPlan {
+   public:
+    MatchPlan() = default;
+
+    /**
+     * @param userValue May be nullptr; kept by address so routines can tell
+     *        whether they are called with the value the plan was built for
+     */
+    [[nodiscard]] static auto build(const ScanOptions& opts,
+                                    const UserValue* userValue) noexcept
+        -> MatchPlan {
+        MatchPlan plan;
+        plan.m_dataType = opts.dataType;
+        plan.m_matchType = opts.matchType;
+        plan.m_reverseEndianness = opts.reverseEndianness;
+        plan.m_userValue = userValue;
+        plan.m_needsUserValue = matchNeedsUserValue(opts.matchType);
+        plan.m_usesOldValue = matchUsesOldValue(opts.matchType);
+        if (userValue != nullptr) {
+            plan.m_requiredFlags = userValue->flag();
+            const bool RANGE = opts.matchType == ScanMatchType::MATCH_RANGE;
+            std::apply(
+                [&](auto&... operands) {
+                    ((operands = toOperands<typename std::remove_cvref_t<
+                          decltype(operands)>::Type>(*userValue, RANGE)),
+                     ...);
+                },
+                plan.m_operands);
+        }
+        return plan;
+    }
+
+    [[nodiscard]] auto dataType() const noexcept -> ScanDataType {
+        return m_dataType;
+    }
+    [[nodiscard]] auto matchType() const noexcept -> ScanMatchType {
+        return m_matchType;
+    }
+    [[nodiscard]] auto reverseEndianness() const noexcept -> bool {
+        return m_reverseEndianness;
+    }
+    [[nodiscard]] auto needsUserValue() const noexcept -> bool {
+        return m_needsUserValue;
+    }
+    [[nodiscard]] auto usesOldValue() const noexcept -> bool {
+        return m_usesOldValue;
+    }
+    /** @brief Width flags of the user value (EMPTY without one) */
+    [[nodiscard]] auto requiredFlags() const noexcept -> MatchFlags {
+        return m_requiredFlags;
+    }
+    /** @brief The value the plan was built from, or nullptr */
+    [[nodiscard]] auto userValue() const noexcept -> const UserValue* {
+        return m_userValue;
+    }
+
+    template <typename T>
+    [[nodiscard]] auto operands() const noexcept -> const TypedOperands<T>& {
+        return std::get<TypedOperands<T>>(m_operands);
+    }
+
+   private:
+    ScanDataType m_dataType{ScanDataType::ANY_NUMBER};
+    ScanMatchType m_matchType{ScanMatchType::MATCH_ANY};
+    bool m_reverseEndianness{false};
+    bool m_needsUserValue{false};
+    bool m_usesOldValue{false};
+    MatchFlags m_requiredFlags{MatchFlags::EMPTY};
+    const UserValue* m_userValue{nullptr};
+    std::tuple<TypedOperands<std::int8_t>, TypedOperands<std::uint8_t>,
+               TypedOperands<std::int16_t>, TypedOperands<std::uint16_t>,
+               TypedOperands<std::int32_t>, TypedOperands<std::uint32_t>,
+               TypedOperands<std::int64_t>, TypedOperands<std::uint64_t>,
+               TypedOperands<float>, TypedOperands<double>>
+        m_operands;
+};
+
+/** @brief Shared, immutable plan handed to routines and kernels */
+using MatchPlanPtr = std::shared_ptr<const MatchPlan>;
+
+[[nodiscard]] inline auto makeMatchPlan(const ScanOptions& opts,
+                                        const UserValue* userValue)
+    -> MatchPlanPtr {
+    return std::make_shared<const MatchPlan>(MatchPlan::build(opts, userValue));
+}
+
+}  // namespace scan
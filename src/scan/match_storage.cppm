@@ -1,11 +1,22 @@
 /**
  * @file match_storage.cppm
  * @brief Types for storing scan results and historical bytes.
+ *
+ * A swath keeps its data as separate planes: the raw bytes read from the
+ * target, one match bit per byte, and a sparse side table holding the few
+ * flags/length pairs that differ from the swath's default. A snapshot
+ * therefore costs a little over one byte per byte scanned.
+ *
+ * Once narrowing leaves only a sprinkle of matches, the array can drop the
+ * swaths and keep a sparse list of (address, old bytes, flags) instead, so
+ * counting, listing and writing cost O(matches) rather than O(bytes).
  */
 
 module;
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cctype>
 #include <cstddef>
@@ -14,10 +25,15 @@ module;
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 export module scan.match_storage;
@@ -28,7 +44,7 @@ export namespace scan {
 
 // Exported types and functions
 
-/** @brief Historical byte value and its match flags */
+/** @brief Historical byte value and its match flags (one cell, by value) */
 struct OldValueAndMatchInfo {
     uint8_t oldByte;       ///< Historical byte value (single byte)
     MatchFlags matchInfo;  ///< Match flags for this byte
@@ -36,20 +52,282 @@ struct OldValueAndMatchInfo {
         matchLength;  ///< Match length (only valid at match start position)
 };
 
+/** @brief Flags and length recorded for a match start */
+struct MatchInfo {
+    MatchFlags flags{MatchFlags::EMPTY};
+    uint16_t length{0};
+
+    friend auto operator==(const MatchInfo&, const MatchInfo&) -> bool =
+                                                                   default;
+};
+
+/** @brief One match as seen through either storage mode */
+struct MatchView {
+    std::uintptr_t address{0};
+    std::span<const std::uint8_t> oldBytes;  ///< Old bytes from address on
+    MatchInfo info;
+};
+
+/**
+ * @brief A contiguous run of matches that can be re-checked independently
+ *
+ * Dense shards cover a word-aligned byte range of one swath; sparse shards
+ * cover a run of sparse entries and use swath == NO_SWATH.
+ */
+struct MatchShard {
+    static constexpr std::size_t NO_SWATH = static_cast<std::size_t>(-1);
+
+    std::size_t swath{NO_SWATH};
+    std::size_t begin{0};    ///< Byte index or sparse entry index
+    std::size_t end{0};      ///< One past the last byte / entry
+    std::size_t matches{0};  ///< Matches inside the shard
+};
+
+/**
+ * @brief Allocator that leaves trivially constructible elements
+ *        uninitialised on resize, so read buffers are not zero-filled first
+ */
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() = default;
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>& /*other*/) noexcept {}
+
+    template <typename U>
+    void construct(U* ptr) noexcept {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        std::construct_at(ptr, std::forward<Args>(args)...);
+    }
+};
+
+/** @brief Byte plane of a swath; resize() does not zero new bytes */
+using ByteBuffer = std::vector<std::uint8_t, DefaultInitAllocator<std::uint8_t>>;
+
 class MatchesAndOldValuesSwath {
    public:
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
     void* firstByteInChild = nullptr;
-    std::vector<OldValueAndMatchInfo> data;
 
     MatchesAndOldValuesSwath() = default;
 
+    /** @brief Heap planes of a swath, for reuse by another (SwathPool) */
+    struct Storage {
+        ByteBuffer bytes;
+        std::vector<std::uint64_t> matchBits;
+    };
+
+    /** @brief Take ownership of an already filled byte buffer */
+    MatchesAndOldValuesSwath(void* baseAddr, ByteBuffer bytes)
+        : firstByteInChild(baseAddr), m_bytes(std::move(bytes)) {
+        m_matchBits.assign(wordsFor(m_bytes.size()), 0);
+    }
+
+    /** @brief As above, clearing matchBits in place instead of allocating */
+    MatchesAndOldValuesSwath(void* baseAddr, ByteBuffer bytes,
+                             std::vector<std::uint64_t> matchBits)
+        : firstByteInChild(baseAddr),
+          m_bytes(std::move(bytes)),
+          m_matchBits(std::move(matchBits)) {
+        m_matchBits.assign(wordsFor(m_bytes.size()), 0);
+    }
+
+    /** @brief Move the byte and bit planes out, leaving the swath empty */
+    [[nodiscard]] auto releaseStorage() noexcept -> Storage {
+        Storage storage{std::move(m_bytes), std::move(m_matchBits)};
+        m_bytes.clear();
+        m_matchBits.clear();
+        m_overrides.clear();
+        m_hasDefault = 0;
+        return storage;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_bytes.size();
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_bytes.empty();
+    }
+
+    [[nodiscard]] auto bytes() const noexcept -> std::span<const std::uint8_t> {
+        return {m_bytes.data(), m_bytes.size()};
+    }
+
+    [[nodiscard]] auto mutableBytes() noexcept -> std::span<std::uint8_t> {
+        return {m_bytes.data(), m_bytes.size()};
+    }
+
+    [[nodiscard]] auto oldByte(std::size_t index) const noexcept
+        -> std::uint8_t {
+        return m_bytes[index];
+    }
+
+    [[nodiscard]] auto isMatch(std::size_t index) const noexcept -> bool {
+        return ((m_matchBits[index / BITS] >> (index % BITS)) & 1U) != 0;
+    }
+
+    [[nodiscard]] auto matchInfo(std::size_t index) const noexcept
+        -> MatchInfo {
+        if (!isMatch(index)) {
+            return {};
+        }
+        if (const auto* entry = findOverride(index)) {
+            return entry->info;
+        }
+        return m_defaults[phaseOf(index)];
+    }
+
+    [[nodiscard]] auto flags(std::size_t index) const noexcept -> MatchFlags {
+        return matchInfo(index).flags;
+    }
+
+    [[nodiscard]] auto matchLength(std::size_t index) const noexcept
+        -> uint16_t {
+        return matchInfo(index).length;
+    }
+
+    /** @brief Old byte plus match info at index, assembled by value */
+    [[nodiscard]] auto cell(std::size_t index) const noexcept
+        -> OldValueAndMatchInfo {
+        const auto INFO = matchInfo(index);
+        return {.oldByte = m_bytes[index],
+                .matchInfo = INFO.flags,
+                .matchLength = INFO.length};
+    }
+
+    [[nodiscard]] auto matchCount() const noexcept -> std::size_t {
+        std::size_t count = 0;
+        for (auto word : m_matchBits) {
+            count += static_cast<std::size_t>(std::popcount(word));
+        }
+        return count;
+    }
+
+    [[nodiscard]] auto hasMatches() const noexcept -> bool {
+        return std::ranges::any_of(m_matchBits,
+                                   [](std::uint64_t word) { return word != 0; });
+    }
+
+    /** @brief Match bitmap, WORD_BITS cells per word, cell 0 in bit 0 */
+    [[nodiscard]] auto matchWords() const noexcept
+        -> std::span<const std::uint64_t> {
+        return m_matchBits;
+    }
+
+    static constexpr std::size_t WORD_BITS = 64;
+
+    /** @brief First match index >= from, or NPOS */
+    [[nodiscard]] auto nextMatch(std::size_t from) const noexcept
+        -> std::size_t {
+        if (from >= m_bytes.size()) {
+            return NPOS;
+        }
+        std::size_t word = from / BITS;
+        std::uint64_t bits = m_matchBits[word] & (~std::uint64_t{0}
+                                                  << (from % BITS));
+        while (true) {
+            if (bits != 0) {
+                return word * BITS +
+                       static_cast<std::size_t>(std::countr_zero(bits));
+            }
+            if (++word >= m_matchBits.size()) {
+                return NPOS;
+            }
+            bits = m_matchBits[word];
+        }
+    }
+
+    /** @brief Call fn(index) for every match, in ascending order */
+    template <typename Fn>
+    void forEachMatch(Fn&& fn) const {
+        for (std::size_t word = 0; word < m_matchBits.size(); ++word) {
+            std::uint64_t bits = m_matchBits[word];
+            while (bits != 0) {
+                fn(word * BITS +
+                   static_cast<std::size_t>(std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Cut [0, size) into word-aligned byte ranges of about target
+     *        matches each; calls fn(begin, end, count) per non-empty range
+     */
+    template <typename Fn>
+    void forEachShard(std::size_t target, Fn&& fn) const {
+        target = std::max<std::size_t>(1, target);
+        std::size_t begin = 0;
+        std::size_t count = 0;
+        for (std::size_t word = 0; word < m_matchBits.size(); ++word) {
+            count += static_cast<std::size_t>(std::popcount(m_matchBits[word]));
+            if (count >= target) {
+                const std::size_t END = std::min((word + 1) * BITS, size());
+                fn(begin, END, count);
+                begin = END;
+                count = 0;
+            }
+        }
+        if (count > 0) {
+            fn(begin, size(), count);
+        }
+    }
+
+    /** @brief Record a match; EMPTY flags clear it */
+    void setMatch(std::size_t index, MatchFlags matchFlags,
+                  std::size_t length) {
+        if (matchFlags == MatchFlags::EMPTY) {
+            clearMatch(index);
+            return;
+        }
+        const MatchInfo INFO{.flags = matchFlags,
+                             .length = static_cast<uint16_t>(length)};
+        const std::size_t PHASE = phaseOf(index);
+        const auto PHASE_BIT = static_cast<std::uint8_t>(1U << PHASE);
+        if ((m_hasDefault & PHASE_BIT) == 0) {
+            m_defaults[PHASE] = INFO;
+            m_hasDefault |= PHASE_BIT;
+        }
+        m_matchBits[index / BITS] |= std::uint64_t{1} << (index % BITS);
+        if (INFO == m_defaults[PHASE]) {
+            eraseOverride(index);
+        } else {
+            upsertOverride(index, INFO);
+        }
+    }
+
+    void clearMatch(std::size_t index) noexcept {
+        m_matchBits[index / BITS] &= ~(std::uint64_t{1} << (index % BITS));
+        eraseOverride(index);
+    }
+
+    /** @brief Drop every match but keep the bytes */
+    void clearMatches() noexcept {
+        std::ranges::fill(m_matchBits, 0);
+        m_overrides.clear();
+        m_hasDefault = 0;
+    }
+
     /* Append a single byte and its match flags; set firstByteInChild on first
      * insert. Caller should append bytes in ascending address order. */
     void addElement(void* addr, uint8_t byte, MatchFlags matchFlags) {
-        if (data.empty()) {
+        if (m_bytes.empty()) {
             firstByteInChild = addr;
         }
-        data.push_back({byte, matchFlags});
+        m_bytes.push_back(byte);
+        m_matchBits.resize(wordsFor(m_bytes.size()), 0);
+        if (matchFlags != MatchFlags::EMPTY) {
+            setMatch(m_bytes.size() - 1, matchFlags, 0);
+        }
     }
 
     // Append multiple bytes
@@ -59,22 +337,39 @@ class MatchesAndOldValuesSwath {
             return;
         }
         assert(bytes != nullptr);
-        if (data.empty()) {
+        if (m_bytes.empty()) {
             firstByteInChild = baseAddr;
         }
-        for (std::size_t i = 0; i < length; ++i) {
-            data.push_back({bytes[i], initial});
+        const std::size_t FIRST = m_bytes.size();
+        m_bytes.insert(m_bytes.end(), bytes, bytes + length);
+        m_matchBits.resize(wordsFor(m_bytes.size()), 0);
+        if (initial != MatchFlags::EMPTY) {
+            for (std::size_t i = FIRST; i < m_bytes.size(); ++i) {
+                setMatch(i, initial, 0);
+            }
         }
     }
 
+    /** @brief Grow/shrink the byte plane; new bytes are left uninitialised */
+    void resize(std::size_t length) {
+        m_bytes.resize(length);
+        m_matchBits.resize(wordsFor(length), 0);
+        trimTail();
+    }
+
+    void shrinkToFit() {
+        m_bytes.shrink_to_fit();
+        m_matchBits.shrink_to_fit();
+        m_overrides.shrink_to_fit();
+    }
+
     // Mark only the start position with flags and length
     void markRangeByIndex(size_t startIndex, size_t length, MatchFlags flags) {
-        if (length == 0 || startIndex >= data.size()) {
+        if (length == 0 || startIndex >= m_bytes.size()) {
             return;
         }
         // Only mark the start position with the match length
-        data[startIndex].matchInfo = data[startIndex].matchInfo | flags;
-        data[startIndex].matchLength = static_cast<uint16_t>(length);
+        setMatch(startIndex, this->flags(startIndex) | flags, length);
     }
 
     // Mark a target address range with flags
@@ -91,17 +386,67 @@ class MatchesAndOldValuesSwath {
         markRangeByIndex(offset, length, flags);
     }
 
+    /** @brief Remove [start, end) and close the gap; returns matches removed */
+    auto eraseRange(std::size_t start, std::size_t end) -> std::size_t {
+        end = std::min(end, m_bytes.size());
+        if (start >= end) {
+            return 0;
+        }
+        const std::size_t SHIFT = end - start;
+        std::size_t removed = 0;
+        std::vector<std::pair<std::size_t, MatchInfo>> tail;
+        for (auto index = nextMatch(start); index != NPOS;
+             index = nextMatch(index + 1)) {
+            if (index < end) {
+                ++removed;
+            } else {
+                tail.emplace_back(index - SHIFT, matchInfo(index));
+            }
+        }
+        m_bytes.erase(m_bytes.begin() + static_cast<std::ptrdiff_t>(start),
+                      m_bytes.begin() + static_cast<std::ptrdiff_t>(end));
+        // Keep bits below start, then re-add the shifted tail
+        m_matchBits.resize(wordsFor(m_bytes.size()), 0);
+        if (start % BITS != 0) {
+            m_matchBits[start / BITS] &=
+                (std::uint64_t{1} << (start % BITS)) - 1;
+        }
+        for (std::size_t word = (start + BITS - 1) / BITS;
+             word < m_matchBits.size(); ++word) {
+            m_matchBits[word] = 0;
+        }
+        std::erase_if(m_overrides, [start](const Override& entry) {
+            return entry.index >= start;
+        });
+        // Before re-adding the tail, which is phased by address
+        if (start == 0) {
+            firstByteInChild = static_cast<char*>(firstByteInChild) +
+                               static_cast<std::ptrdiff_t>(SHIFT);
+        }
+        for (const auto& [index, info] : tail) {
+            setMatch(index, info.flags, info.length);
+        }
+        return removed;
+    }
+
+    /** @brief Approximate heap bytes held by this swath */
+    [[nodiscard]] auto memoryUsage() const noexcept -> std::size_t {
+        return m_bytes.capacity() +
+               m_matchBits.capacity() * sizeof(std::uint64_t) +
+               m_overrides.capacity() * sizeof(Override);
+    }
+
     /* Return a printable string for up to len bytes starting at idx.
      * Non-printable bytes are shown as '.'. */
     [[nodiscard]] auto toPrintableString(size_t idx, size_t len) const
         -> std::string {
         std::ostringstream oss;
-        if (idx >= data.size()) {
+        if (idx >= m_bytes.size()) {
             return {};
         }
-        size_t count = std::min(len, data.size() - idx);
+        size_t count = std::min(len, m_bytes.size() - idx);
         for (size_t i = 0; i < count; ++i) {
-            auto byteVal = data[idx + i].oldByte;
+            auto byteVal = m_bytes[idx + i];
             oss << ((std::isprint(byteVal) != 0) ? static_cast<char>(byteVal)
                                                  : '.');
         }
@@ -112,14 +457,14 @@ class MatchesAndOldValuesSwath {
     [[nodiscard]] auto toByteArrayText(size_t idx, size_t len) const
         -> std::string {
         std::ostringstream oss;
-        if (idx >= data.size()) {
+        if (idx >= m_bytes.size()) {
             return {};
         }
-        size_t count = std::min(len, data.size() - idx);
+        size_t count = std::min(len, m_bytes.size() - idx);
         oss << std::nouppercase << std::hex;
         for (size_t i = 0; i < count; ++i) {
             oss << std::setw(2) << std::setfill('0')
-                << (static_cast<int>(data[idx + i].oldByte) &
+                << (static_cast<int>(m_bytes[idx + i]) &
                     0xFF);  // NOLINT(readability-magic-numbers)
             if (i + 1 < count) {
                 oss << ' ';
@@ -127,49 +472,682 @@ class MatchesAndOldValuesSwath {
         }
         return oss.str();
     }
+
+   private:
+    static constexpr std::size_t BITS = 64;
+    // Matches inherit the first info seen at their address mod PERIOD, so
+    // naturally aligned scans (widths set by address) need no overrides
+    static constexpr std::size_t PERIOD = 8;
+
+    struct Override {
+        std::size_t index;
+        MatchInfo info;
+    };
+
+    static constexpr auto wordsFor(std::size_t length) noexcept
+        -> std::size_t {
+        return (length + BITS - 1) / BITS;
+    }
+
+    // By address rather than index, so trimming the front keeps phases
+    [[nodiscard]] auto phaseOf(std::size_t index) const noexcept
+        -> std::size_t {
+        return (reinterpret_cast<std::uintptr_t>(firstByteInChild) + index) %
+               PERIOD;
+    }
+
+    [[nodiscard]] auto findOverride(std::size_t index) const noexcept
+        -> const Override* {
+        if (m_overrides.empty()) {
+            return nullptr;
+        }
+        auto iter =
+            std::ranges::lower_bound(m_overrides, index, {}, &Override::index);
+        return (iter != m_overrides.end() && iter->index == index) ? &*iter
+                                                                   : nullptr;
+    }
+
+    void upsertOverride(std::size_t index, MatchInfo info) {
+        // Scans mark offsets in ascending order, so appending is the norm
+        if (m_overrides.empty() || m_overrides.back().index < index) {
+            m_overrides.push_back({index, info});
+            return;
+        }
+        auto iter =
+            std::ranges::lower_bound(m_overrides, index, {}, &Override::index);
+        if (iter != m_overrides.end() && iter->index == index) {
+            iter->info = info;
+        } else {
+            m_overrides.insert(iter, {index, info});
+        }
+    }
+
+    void eraseOverride(std::size_t index) noexcept {
+        if (m_overrides.empty()) {
+            return;
+        }
+        auto iter =
+            std::ranges::lower_bound(m_overrides, index, {}, &Override::index);
+        if (iter != m_overrides.end() && iter->index == index) {
+            m_overrides.erase(iter);
+        }
+    }
+
+    // Clear bits and overrides that fall beyond the byte plane
+    void trimTail() {
+        const std::size_t SIZE = m_bytes.size();
+        if (SIZE % BITS != 0 && !m_matchBits.empty()) {
+            m_matchBits.back() &= (std::uint64_t{1} << (SIZE % BITS)) - 1;
+        }
+        std::erase_if(m_overrides, [SIZE](const Override& entry) {
+            return entry.index >= SIZE;
+        });
+    }
+
+    ByteBuffer m_bytes;
+    std::vector<std::uint64_t> m_matchBits;
+    std::vector<Override> m_overrides;  // sorted by index
+    std::array<MatchInfo, PERIOD> m_defaults{};
+    std::uint8_t m_hasDefault{0};  // bit p: m_defaults[p] is set
+};
+
+/**
+ * @class MatchRankIndex
+ * @brief Prefix match counts for finding the n-th dense match quickly
+ *
+ * Holds the number of matches before every swath and before every
+ * RANK_WORDS-word block of each swath's bitmap. Finding match #n is two
+ * binary searches plus a popcount over at most RANK_WORDS words, instead
+ * of counting from the first swath.
+ */
+class MatchRankIndex {
+   public:
+    static constexpr std::size_t RANK_WORDS = 8;  ///< 512 cells per block
+
+    MatchRankIndex() = default;
+
+    /** @brief Index swaths; swaths without a base address count as empty */
+    explicit MatchRankIndex(std::span<const MatchesAndOldValuesSwath> swaths) {
+        m_swathStart.reserve(swaths.size() + 1);
+        m_firstBlock.reserve(swaths.size() + 1);
+        std::size_t total = 0;
+        for (const auto& swath : swaths) {
+            m_swathStart.push_back(total);
+            m_firstBlock.push_back(m_blockStart.size());
+            if (swath.firstByteInChild == nullptr) {
+                continue;
+            }
+            const auto WORDS = swath.matchWords();
+            for (std::size_t word = 0; word < WORDS.size(); ++word) {
+                if (word % RANK_WORDS == 0) {
+                    m_blockStart.push_back(total);
+                }
+                total += static_cast<std::size_t>(std::popcount(WORDS[word]));
+            }
+        }
+        m_swathStart.push_back(total);
+        m_firstBlock.push_back(m_blockStart.size());
+    }
+
+    [[nodiscard]] auto matchCount() const noexcept -> std::size_t {
+        return m_swathStart.empty() ? 0 : m_swathStart.back();
+    }
+
+    /**
+     * @brief Locate match #n
+     * @param swaths The swaths the index was built from
+     * @return (swath position, cell index), or nullopt past the end
+     */
+    [[nodiscard]] auto find(std::span<const MatchesAndOldValuesSwath> swaths,
+                            std::size_t n) const noexcept
+        -> std::optional<std::pair<std::size_t, std::size_t>> {
+        if (n >= matchCount()) {
+            return std::nullopt;
+        }
+        // Last swath starting at or before n (empty swaths share a start)
+        const auto SWATH_ITER =
+            std::ranges::upper_bound(m_swathStart.begin(),
+                                     m_swathStart.end() - 1, n) -
+            1;
+        const auto SWATH =
+            static_cast<std::size_t>(SWATH_ITER - m_swathStart.begin());
+        const auto FIRST = m_blockStart.begin() +
+                           static_cast<std::ptrdiff_t>(m_firstBlock[SWATH]);
+        const auto LAST = m_blockStart.begin() +
+                          static_cast<std::ptrdiff_t>(m_firstBlock[SWATH + 1]);
+        const auto BLOCK_ITER = std::ranges::upper_bound(FIRST, LAST, n) - 1;
+
+        std::size_t rank = n - *BLOCK_ITER;
+        const auto WORDS = swaths[SWATH].matchWords();
+        for (auto word = static_cast<std::size_t>(BLOCK_ITER - FIRST) *
+                         RANK_WORDS;
+             word < WORDS.size(); ++word) {
+            std::uint64_t bits = WORDS[word];
+            const auto COUNT = static_cast<std::size_t>(std::popcount(bits));
+            if (rank >= COUNT) {
+                rank -= COUNT;
+                continue;
+            }
+            for (; rank > 0; --rank) {
+                bits &= bits - 1;
+            }
+            return std::make_pair(
+                SWATH, word * MatchesAndOldValuesSwath::WORD_BITS +
+                           static_cast<std::size_t>(std::countr_zero(bits)));
+        }
+        return std::nullopt;  // stale index
+    }
+
+   private:
+    std::vector<std::size_t> m_swathStart;  // matches before swath i; + total
+    std::vector<std::size_t> m_firstBlock;  // first m_blockStart of swath i
+    std::vector<std::size_t> m_blockStart;  // matches before each block
+};
+
+/**
+ * @brief A MatchRankIndex built on first use and dropped on change
+ *
+ * Copies and moves start out empty, so the owning array stays regular.
+ */
+class LazyMatchRankIndex {
+   public:
+    LazyMatchRankIndex() = default;
+    LazyMatchRankIndex(const LazyMatchRankIndex& /*other*/) noexcept {}
+    LazyMatchRankIndex(LazyMatchRankIndex&& /*other*/) noexcept {}
+    auto operator=(const LazyMatchRankIndex& /*other*/) noexcept
+        -> LazyMatchRankIndex& {
+        reset();
+        return *this;
+    }
+    auto operator=(LazyMatchRankIndex&& /*other*/) noexcept
+        -> LazyMatchRankIndex& {
+        reset();
+        return *this;
+    }
+    ~LazyMatchRankIndex() = default;
+
+    /** @brief The index of swaths, building it if there is none */
+    [[nodiscard]] auto get(std::span<const MatchesAndOldValuesSwath> swaths)
+        const -> const MatchRankIndex& {
+        std::scoped_lock lock(m_mutex);
+        if (!m_index) {
+            m_index = std::make_unique<const MatchRankIndex>(swaths);
+        }
+        return *m_index;
+    }
+
+    void reset() noexcept {
+        std::scoped_lock lock(m_mutex);
+        m_index.reset();
+    }
+
+   private:
+    mutable std::mutex m_mutex;
+    mutable std::unique_ptr<const MatchRankIndex> m_index;
 };
 
 /* MatchesAndOldValuesArray: collection of swaths storing historical bytes
- * and match flags. */
+ * and match flags, or a sparse match list once few matches remain. */
 class MatchesAndOldValuesArray {
    public:
-    std::vector<MatchesAndOldValuesSwath> swaths;
+    /** @brief Sparse mode is used below one match per this many bytes */
+    static constexpr std::size_t SPARSE_DENSITY_DIVISOR = 64;
+    /** @brief Old bytes kept per sparse match, at least (widest number) */
+    static constexpr std::size_t MIN_SPARSE_BYTES = 8;
+    /** @brief Batch size retainMatches uses internally */
+    static constexpr std::size_t DEFAULT_RETAIN_BATCH = 256;
+
+    std::vector<MatchesAndOldValuesSwath> swaths;  ///< Empty in sparse mode
     MatchesAndOldValuesArray() = default;
 
+    [[nodiscard]] auto isSparse() const noexcept -> bool {
+        return m_sparseMode;
+    }
+
+    /** @brief Drop all swaths and sparse matches */
+    void clear() noexcept {
+        m_rankIndex.reset();
+        swaths.clear();
+        m_sparse.clear();
+        m_sparseBytes.clear();
+        m_sparseMode = false;
+    }
+
     /* Append a swath (copied). Caller may assume ordered insertion by address.
      */
     void addSwath(const MatchesAndOldValuesSwath& swath) {
+        densify();
+        m_rankIndex.reset();
         swaths.push_back(swath);
     }
 
-    /* Return pointer and index for the n-th match, or std::nullopt if not
-     * found. */
-    auto nthMatch(size_t n)
-        -> std::optional<std::pair<MatchesAndOldValuesSwath*, size_t>> {
-        size_t count = 0;
-        for (auto& swath : swaths) {
-            for (size_t i = 0; i < swath.data.size(); ++i) {
-                if (swath.data[i].matchInfo != MatchFlags::EMPTY) {
-                    if (count == n) {
-                        return std::make_pair(&swath, i);
+    void addSwath(MatchesAndOldValuesSwath&& swath) {
+        densify();
+        m_rankIndex.reset();
+        swaths.push_back(std::move(swath));
+    }
+
+    /**
+     * @brief Forget the rank index behind matchAt / nthMatch
+     *
+     * Member functions keep it current; only code that edits swaths
+     * directly (or through a nthMatch pointer) needs to call this.
+     */
+    void invalidateMatchIndex() noexcept { m_rankIndex.reset(); }
+
+    [[nodiscard]] auto matchCount() const noexcept -> std::size_t {
+        if (m_sparseMode) {
+            return m_sparse.size();
+        }
+        std::size_t count = 0;
+        for (const auto& swath : swaths) {
+            count += swath.matchCount();
+        }
+        return count;
+    }
+
+    /**
+     * @brief matchCount() through the rank index
+     *
+     * The same walk as matchCount() the first time, then O(1) until the
+     * matches change (same contract as matchAt).
+     */
+    [[nodiscard]] auto indexedMatchCount() const -> std::size_t {
+        if (m_sparseMode) {
+            return m_sparse.size();
+        }
+        return m_rankIndex.get(swaths).matchCount();
+    }
+
+    [[nodiscard]] auto hasMatches() const noexcept -> bool {
+        if (m_sparseMode) {
+            return !m_sparse.empty();
+        }
+        return std::ranges::any_of(
+            swaths, [](const auto& swath) { return swath.hasMatches(); });
+    }
+
+    /** @brief Call fn(const MatchView&) for every match, in storage order */
+    template <typename Fn>
+    void forEachMatch(Fn&& fn) const {
+        if (m_sparseMode) {
+            for (const auto& entry : m_sparse) {
+                fn(viewOf(entry));
+            }
+            return;
+        }
+        for (const auto& swath : swaths) {
+            if (swath.firstByteInChild == nullptr) {
+                continue;
+            }
+            swath.forEachMatch(
+                [&](std::size_t index) { fn(viewOf(swath, index)); });
+        }
+    }
+
+    /** @brief The n-th match, found through the rank index */
+    [[nodiscard]] auto matchAt(std::size_t n) const
+        -> std::optional<MatchView> {
+        if (m_sparseMode) {
+            if (n >= m_sparse.size()) {
+                return std::nullopt;
+            }
+            return viewOf(m_sparse[n]);
+        }
+        auto where = m_rankIndex.get(swaths).find(swaths, n);
+        if (!where) {
+            return std::nullopt;
+        }
+        return viewOf(swaths[where->first], where->second);
+    }
+
+    /**
+     * @brief Visit matches in storage order starting at match #first
+     *
+     * fn(const MatchView&) returns false to stop early.
+     */
+    template <typename Fn>
+    void forEachMatchFrom(std::size_t first, Fn&& fn) const {
+        if (m_sparseMode) {
+            for (std::size_t i = first; i < m_sparse.size(); ++i) {
+                if (!fn(viewOf(m_sparse[i]))) {
+                    return;
+                }
+            }
+            return;
+        }
+        auto where = m_rankIndex.get(swaths).find(swaths, first);
+        if (!where) {
+            return;
+        }
+        for (std::size_t pos = where->first; pos < swaths.size(); ++pos) {
+            const auto& swath = swaths[pos];
+            if (swath.firstByteInChild == nullptr) {
+                continue;
+            }
+            const std::size_t FROM = pos == where->first ? where->second : 0;
+            for (auto index = swath.nextMatch(FROM);
+                 index != MatchesAndOldValuesSwath::NPOS;
+                 index = swath.nextMatch(index + 1)) {
+                if (!fn(viewOf(swath, index))) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Re-evaluate every match in place
+     *
+     * fn(const MatchView&) returns the new MatchInfo; EMPTY flags drop the
+     * match.
+     */
+    template <typename Fn>
+    void retainMatches(Fn&& fn) {
+        retainMatchBatches(
+            DEFAULT_RETAIN_BATCH,
+            [&](std::span<const MatchView> batch, std::span<MatchInfo> out) {
+                for (std::size_t k = 0; k < batch.size(); ++k) {
+                    out[k] = fn(batch[k]);
+                }
+            });
+    }
+
+    /**
+     * @brief Re-evaluate matches a batch at a time
+     *
+     * fn(std::span<const MatchView> batch, std::span<MatchInfo> out) fills
+     * in the new MatchInfo of every match in the batch; EMPTY flags drop
+     * it. Batches follow storage order, span swaths, and hold at most
+     * maxBatch matches, so callers can fetch their memory in one go.
+     */
+    template <typename Fn>
+    void retainMatchBatches(std::size_t maxBatch, Fn&& fn) {
+        m_rankIndex.reset();
+        maxBatch = std::max<std::size_t>(1, maxBatch);
+        std::vector<MatchView> views;
+        std::vector<MatchInfo> results(maxBatch);
+        views.reserve(maxBatch);
+
+        if (m_sparseMode) {
+            std::size_t kept = 0;
+            for (std::size_t begin = 0; begin < m_sparse.size();
+                 begin += maxBatch) {
+                const std::size_t END =
+                    std::min(m_sparse.size(), begin + maxBatch);
+                views.clear();
+                for (std::size_t i = begin; i < END; ++i) {
+                    views.push_back(viewOf(m_sparse[i]));
+                }
+                fn(std::span<const MatchView>(views),
+                   std::span<MatchInfo>(results).first(views.size()));
+                for (std::size_t i = begin; i < END; ++i) {
+                    const MatchInfo& info = results[i - begin];
+                    if (info.flags == MatchFlags::EMPTY) {
+                        continue;
                     }
-                    ++count;
+                    m_sparse[kept] = m_sparse[i];
+                    m_sparse[kept++].info = info;
+                }
+            }
+            m_sparse.resize(kept);
+            repackSparseBytes();
+            return;
+        }
+
+        std::vector<std::pair<MatchesAndOldValuesSwath*, std::size_t>> where;
+        where.reserve(maxBatch);
+        auto flush = [&]() {
+            if (views.empty()) {
+                return;
+            }
+            fn(std::span<const MatchView>(views),
+               std::span<MatchInfo>(results).first(views.size()));
+            for (std::size_t k = 0; k < where.size(); ++k) {
+                where[k].first->setMatch(where[k].second, results[k].flags,
+                                         results[k].length);
+            }
+            views.clear();
+            where.clear();
+        };
+        for (auto& swath : swaths) {
+            if (swath.firstByteInChild == nullptr) {
+                continue;
+            }
+            for (auto index = swath.nextMatch(0);
+                 index != MatchesAndOldValuesSwath::NPOS;
+                 index = swath.nextMatch(index + 1)) {
+                views.push_back(viewOf(swath, index));
+                where.emplace_back(&swath, index);
+                if (views.size() == maxBatch) {
+                    flush();
                 }
             }
         }
-        return std::nullopt;
+        flush();
+    }
+
+    /**
+     * @brief Split the matches into shards of about target matches each
+     *
+     * Shards never share a swath word, so they can be evaluated on
+     * different threads; results are applied with applyShard afterwards.
+     */
+    [[nodiscard]] auto shardMatches(std::size_t target) const
+        -> std::vector<MatchShard> {
+        target = std::max<std::size_t>(1, target);
+        std::vector<MatchShard> shards;
+        if (m_sparseMode) {
+            for (std::size_t begin = 0; begin < m_sparse.size();
+                 begin += target) {
+                const std::size_t END = std::min(m_sparse.size(), begin + target);
+                shards.push_back({.begin = begin,
+                                  .end = END,
+                                  .matches = END - begin});
+            }
+            return shards;
+        }
+        for (std::size_t index = 0; index < swaths.size(); ++index) {
+            if (swaths[index].firstByteInChild == nullptr) {
+                continue;
+            }
+            swaths[index].forEachShard(
+                target, [&](std::size_t begin, std::size_t end,
+                            std::size_t count) {
+                    shards.push_back({.swath = index,
+                                      .begin = begin,
+                                      .end = end,
+                                      .matches = count});
+                });
+        }
+        return shards;
+    }
+
+    /** @brief Call fn(const MatchView&) for every match in one shard */
+    template <typename Fn>
+    void forEachMatchIn(const MatchShard& shard, Fn&& fn) const {
+        if (shard.swath == MatchShard::NO_SWATH) {
+            for (std::size_t i = shard.begin; i < shard.end; ++i) {
+                fn(viewOf(m_sparse[i]));
+            }
+            return;
+        }
+        const auto& swath = swaths[shard.swath];
+        for (auto index = swath.nextMatch(shard.begin); index < shard.end;
+             index = swath.nextMatch(index + 1)) {
+            fn(viewOf(swath, index));
+        }
+    }
+
+    /**
+     * @brief Store new MatchInfo for a shard, in match order
+     *
+     * Missing trailing results count as EMPTY. Call finishShards once all
+     * shards are applied.
+     */
+    void applyShard(const MatchShard& shard,
+                    std::span<const MatchInfo> results) {
+        m_rankIndex.reset();
+        std::size_t k = 0;
+        auto next = [&]() -> MatchInfo {
+            return k < results.size() ? results[k++] : MatchInfo{};
+        };
+        if (shard.swath == MatchShard::NO_SWATH) {
+            for (std::size_t i = shard.begin; i < shard.end; ++i) {
+                m_sparse[i].info = next();
+            }
+            return;
+        }
+        auto& swath = swaths[shard.swath];
+        for (auto index = swath.nextMatch(shard.begin); index < shard.end;
+             index = swath.nextMatch(index + 1)) {
+            const MatchInfo INFO = next();
+            swath.setMatch(index, INFO.flags, INFO.length);
+        }
+    }
+
+    /** @brief Drop sparse entries that applyShard emptied */
+    void finishShards() {
+        if (!m_sparseMode) {
+            return;
+        }
+        std::erase_if(m_sparse, [](const SparseMatch& entry) {
+            return entry.info.flags == MatchFlags::EMPTY;
+        });
+        repackSparseBytes();
+    }
+
+    /** @brief Remove swaths that no longer hold a match */
+    void dropEmptySwaths() {
+        m_rankIndex.reset();
+        std::erase_if(swaths, [](const MatchesAndOldValuesSwath& swath) {
+            return !swath.hasMatches();
+        });
+    }
+
+    /**
+     * @brief Switch to the sparse list when matches are rare enough
+     * @param window Old bytes the next filter needs per match
+     */
+    void adaptStorage(std::size_t window) {
+        if (m_sparseMode) {
+            return;
+        }
+        std::size_t totalBytes = 0;
+        for (const auto& swath : swaths) {
+            totalBytes += swath.size();
+        }
+        if (matchCount() * SPARSE_DENSITY_DIVISOR < totalBytes) {
+            sparsify(window);
+        }
+    }
+
+    /** @brief Keep only (address, old bytes, flags) for each match */
+    void sparsify(std::size_t window) {
+        if (m_sparseMode) {
+            return;
+        }
+        const std::size_t KEEP = std::max(window, MIN_SPARSE_BYTES);
+        std::vector<SparseMatch> sparse;
+        sparse.reserve(matchCount());
+        ByteBuffer pool;
+        for (const auto& swath : swaths) {
+            if (swath.firstByteInChild == nullptr) {
+                continue;
+            }
+            const auto BASE =
+                reinterpret_cast<std::uintptr_t>(swath.firstByteInChild);
+            const auto BYTES = swath.bytes();
+            swath.forEachMatch([&](std::size_t index) {
+                const MatchInfo INFO = swath.matchInfo(index);
+                const std::size_t COUNT =
+                    std::min<std::size_t>(std::max<std::size_t>(KEEP, INFO.length),
+                                          BYTES.size() - index);
+                sparse.push_back(
+                    {.address = BASE + index,
+                     .byteOffset = pool.size(),
+                     .byteCount = COUNT,
+                     .info = INFO});
+                pool.insert(pool.end(), BYTES.begin() + static_cast<std::ptrdiff_t>(index),
+                            BYTES.begin() +
+                                static_cast<std::ptrdiff_t>(index + COUNT));
+            });
+        }
+        m_rankIndex.reset();
+        swaths.clear();
+        swaths.shrink_to_fit();
+        m_sparse = std::move(sparse);
+        m_sparseBytes = std::move(pool);
+        m_sparseMode = true;
+    }
+
+    /** @brief Rebuild swaths from the sparse list, merging touching windows */
+    void densify() {
+        if (!m_sparseMode) {
+            return;
+        }
+        std::vector<MatchesAndOldValuesSwath> rebuilt;
+        std::uintptr_t base = 0;
+        for (const auto& entry : m_sparse) {
+            const auto BYTES = sparseBytes(entry);
+            const std::uintptr_t END =
+                rebuilt.empty() ? 0 : base + rebuilt.back().size();
+            if (rebuilt.empty() || entry.address < base ||
+                entry.address > END) {
+                base = entry.address;
+                rebuilt.emplace_back().appendRange(
+                    reinterpret_cast<void*>(entry.address), BYTES.data(),
+                    BYTES.size());
+            } else if (entry.address + BYTES.size() > END) {
+                const std::size_t SKIP = END - entry.address;
+                rebuilt.back().appendRange(reinterpret_cast<void*>(END),
+                                           BYTES.data() + SKIP,
+                                           BYTES.size() - SKIP);
+            }
+            rebuilt.back().setMatch(entry.address - base, entry.info.flags,
+                                    entry.info.length);
+        }
+        m_rankIndex.reset();
+        swaths = std::move(rebuilt);
+        m_sparse.clear();
+        m_sparseBytes.clear();
+        m_sparseMode = false;
+    }
+
+    /* Return pointer and index for the n-th match, or std::nullopt if not
+     * found. Needs swaths, so a sparse array is densified first. Changing
+     * matches through the pointer requires invalidateMatchIndex(). */
+    auto nthMatch(size_t n)
+        -> std::optional<std::pair<MatchesAndOldValuesSwath*, size_t>> {
+        densify();
+        auto where = m_rankIndex.get(swaths).find(swaths, n);
+        if (!where) {
+            return std::nullopt;
+        }
+        return std::make_pair(&swaths[where->first], where->second);
     }
 
     /* Remove bytes in [start, end); count deleted matches in numMatches. */
     void deleteInAddressRange(void* start, void* end,
                               unsigned long& numMatches) {
         numMatches = 0;
+        m_rankIndex.reset();
         if (start == nullptr || end == nullptr || start == end) {
             return;
         }
 
+        if (m_sparseMode) {
+            const auto FROM = reinterpret_cast<std::uintptr_t>(start);
+            const auto TO = reinterpret_cast<std::uintptr_t>(end);
+            numMatches = std::erase_if(m_sparse, [&](const SparseMatch& entry) {
+                return entry.address >= FROM && entry.address < TO;
+            });
+            repackSparseBytes();
+            return;
+        }
+
         for (auto& swath : swaths) {
-            if (swath.firstByteInChild == nullptr || swath.data.empty()) {
+            if (swath.firstByteInChild == nullptr || swath.empty()) {
                 continue;
             }
 
@@ -177,7 +1155,7 @@ class MatchesAndOldValuesArray {
             const auto* startPtr = static_cast<const char*>(start);
             const auto* endPtr = static_cast<const char*>(end);
 
-            const std::size_t SWATH_SIZE = swath.data.size();
+            const std::size_t SWATH_SIZE = swath.size();
             const auto* swathEndPtr =
                 basePtr + static_cast<std::ptrdiff_t>(SWATH_SIZE);
 
@@ -195,29 +1173,15 @@ class MatchesAndOldValuesArray {
             const std::size_t END_IDX =
                 static_cast<std::size_t>(clampedEnd - basePtr);
 
-            // Count matches in the interval
-            for (std::size_t i = START_IDX; i < END_IDX; ++i) {
-                if (swath.data[i].matchInfo != MatchFlags::EMPTY) {
-                    ++numMatches;
-                }
-            }
-
-            // Erase bytes in [startIdx, endIdx)
-            swath.data.erase(
-                swath.data.begin() + static_cast<std::ptrdiff_t>(START_IDX),
-                swath.data.begin() + static_cast<std::ptrdiff_t>(END_IDX));
-
-            // If we erased a prefix, advance the base address
-            if (START_IDX == 0) {
-                swath.firstByteInChild =
-                    basePtr + static_cast<std::ptrdiff_t>(END_IDX);
-            }
+            // Erase bytes in [startIdx, endIdx); a prefix erase advances the
+            // base address
+            numMatches += swath.eraseRange(START_IDX, END_IDX);
         }
 
         // Drop empty swaths to keep structure compact
         const auto REMOVE_EMPTY = std::ranges::remove_if(
             swaths, [](const MatchesAndOldValuesSwath& swathEntry) {
-                return swathEntry.data.empty();
+                return swathEntry.empty();
             });
         swaths.erase(REMOVE_EMPTY.begin(), REMOVE_EMPTY.end());
     }
@@ -229,8 +1193,21 @@ class MatchesAndOldValuesArray {
         if (addr == nullptr || len == 0) {
             return false;
         }
+        if (m_sparseMode) {
+            const auto ADDRESS = reinterpret_cast<std::uintptr_t>(addr);
+            for (const auto& entry : m_sparse) {
+                if (ADDRESS >= entry.address &&
+                    ADDRESS - entry.address + len <= entry.byteCount) {
+                    const auto BYTES =
+                        sparseBytes(entry).subspan(ADDRESS - entry.address, len);
+                    out.assign(BYTES.begin(), BYTES.end());
+                    return true;
+                }
+            }
+            return false;
+        }
         for (const auto& swath : swaths) {
-            if (swath.firstByteInChild == nullptr || swath.data.empty()) {
+            if (swath.firstByteInChild == nullptr || swath.empty()) {
                 continue;
             }
             const auto* base = static_cast<const char*>(swath.firstByteInChild);
@@ -239,22 +1216,159 @@ class MatchesAndOldValuesArray {
                 continue;
             }
             const auto OFFSET = static_cast<size_t>(curr - base);
-            if (OFFSET >= swath.data.size()) {
+            if (OFFSET >= swath.size()) {
                 continue;
             }
-            const size_t REMAIN = swath.data.size() - OFFSET;
+            const size_t REMAIN = swath.size() - OFFSET;
             if (REMAIN < len) {
                 continue;
             }
-            // Assemble bytes
-            out.resize(len);
-            for (size_t i = 0; i < len; ++i) {
-                out[i] = swath.data[OFFSET + i].oldByte;
-            }
+            const auto BYTES = swath.bytes().subspan(OFFSET, len);
+            out.assign(BYTES.begin(), BYTES.end());
             return true;
         }
         return false;
     }
+
+    /** @brief Approximate heap bytes held by all swaths */
+    [[nodiscard]] auto memoryUsage() const noexcept -> std::size_t {
+        std::size_t total = swaths.capacity() * sizeof(MatchesAndOldValuesSwath);
+        for (const auto& swath : swaths) {
+            total += swath.memoryUsage();
+        }
+        return total + m_sparse.capacity() * sizeof(SparseMatch) +
+               m_sparseBytes.capacity();
+    }
+
+   private:
+    struct SparseMatch {
+        std::uintptr_t address;
+        std::size_t byteOffset;  ///< Into m_sparseBytes
+        std::size_t byteCount;
+        MatchInfo info;
+    };
+
+    [[nodiscard]] auto sparseBytes(const SparseMatch& entry) const noexcept
+        -> std::span<const std::uint8_t> {
+        return {m_sparseBytes.data() + entry.byteOffset, entry.byteCount};
+    }
+
+    [[nodiscard]] auto viewOf(const SparseMatch& entry) const noexcept
+        -> MatchView {
+        return {.address = entry.address,
+                .oldBytes = sparseBytes(entry),
+                .info = entry.info};
+    }
+
+    [[nodiscard]] static auto viewOf(const MatchesAndOldValuesSwath& swath,
+                                     std::size_t index) noexcept -> MatchView {
+        return {.address =
+                    reinterpret_cast<std::uintptr_t>(swath.firstByteInChild) +
+                    index,
+                .oldBytes = swath.bytes().subspan(index),
+                .info = swath.matchInfo(index)};
+    }
+
+    // Compact the byte pool once dropped matches leave most of it unused
+    void repackSparseBytes() {
+        std::size_t used = 0;
+        for (const auto& entry : m_sparse) {
+            used += entry.byteCount;
+        }
+        if (used * 2 > m_sparseBytes.size()) {
+            return;
+        }
+        ByteBuffer pool;
+        pool.reserve(used);
+        for (auto& entry : m_sparse) {
+            const auto BYTES = sparseBytes(entry);
+            entry.byteOffset = pool.size();
+            pool.insert(pool.end(), BYTES.begin(), BYTES.end());
+        }
+        m_sparseBytes = std::move(pool);
+    }
+
+    std::vector<SparseMatch> m_sparse;  // ascending address when built
+    ByteBuffer m_sparseBytes;
+    bool m_sparseMode{false};
+    LazyMatchRankIndex m_rankIndex;  // dense mode only
+};
+
+/**
+ * @class SwathPool
+ * @brief Planes of a finished result, handed to the swaths of the next
+ *
+ * A rescan fills swaths of much the same sizes as the result it replaces;
+ * taking that result's planes spares a large allocation per swath, and
+ * the page faults of touching it for the first time. Planes below
+ * MIN_BYTES are left to malloc, and a plane is only reused when at most
+ * an eighth of its capacity would go unused. Thread-safe.
+ */
+class SwathPool {
+   public:
+    static constexpr std::size_t MIN_BYTES = 256 * 1024;
+
+    /** @brief Keep the planes of every swath in matches, then clear it */
+    void recycle(MatchesAndOldValuesArray&& matches) {
+        std::vector<MatchesAndOldValuesSwath::Storage> planes;
+        planes.reserve(matches.swaths.size());
+        for (auto& swath : matches.swaths) {
+            auto storage = swath.releaseStorage();
+            if (storage.bytes.capacity() >= MIN_BYTES) {
+                planes.push_back(std::move(storage));
+            }
+        }
+        matches.clear();
+        const std::scoped_lock LOCK(m_mutex);
+        for (auto& storage : planes) {
+            m_free.emplace(storage.bytes.capacity(), std::move(storage));
+        }
+    }
+
+    /** @brief A swath of size bytes at baseAddr; its bytes are unset */
+    [[nodiscard]] auto make(void* baseAddr, std::size_t size)
+        -> MatchesAndOldValuesSwath {
+        if (size >= MIN_BYTES) {
+            std::unique_lock lock(m_mutex);
+            auto iter = m_free.lower_bound(size);
+            if (iter != m_free.end() && iter->first - size <= iter->first / 8) {
+                auto storage = std::move(iter->second);
+                m_free.erase(iter);
+                ++m_reused;
+                lock.unlock();
+                storage.bytes.resize(size);  // within capacity, not zeroed
+                return {baseAddr, std::move(storage.bytes),
+                        std::move(storage.matchBits)};
+            }
+        }
+        return {baseAddr, ByteBuffer(size)};
+    }
+
+    /** @brief Free every plane still pooled */
+    void clear() {
+        const std::scoped_lock LOCK(m_mutex);
+        m_free.clear();
+    }
+
+    [[nodiscard]] auto pooledBytes() const -> std::size_t {
+        const std::scoped_lock LOCK(m_mutex);
+        std::size_t total = 0;
+        for (const auto& [capacity, storage] : m_free) {
+            total += capacity;
+        }
+        return total;
+    }
+
+    /** @brief Swaths made on recycled planes so far */
+    [[nodiscard]] auto reused() const -> std::size_t {
+        const std::scoped_lock LOCK(m_mutex);
+        return m_reused;
+    }
+
+   private:
+    mutable std::mutex m_mutex;
+    std::multimap<std::size_t, MatchesAndOldValuesSwath::Storage> m_free;
+    std::size_t m_reused{0};
 };
 
 }  // namespace scan
@@ -1,41 +1,96 @@
 module;
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <optional>
+#include <span>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 export module scan.numeric;
 
 import scan.types;
 import scan.routine;
+import scan.match_plan;
 import utils.read_helpers;
 import value.flags;
 import value.core;
 
 // This module implements the core numeric matching logic and canonical
-// ScanRoutine factories for numeric scan operations.
+// ScanRoutine factories for numeric scan operations. ANY_* scans go through
+// scan::AnyNumberMatcher, which evaluates every width from one load.
 
+/**
+ * @brief Tolerance-aware comparison primitives
+ *
+ * Shared by numericMatchCore and the block kernels in scan.kernel so that
+ * both paths agree on float tolerance semantics.
+ */
 export template <typename T>
-// NOLINTNEXTLINE(readability-function-cognitive-complexity)
-inline auto numericMatchCore(ScanMatchType matchType, T memv,
-                             const Value* oldValue, const UserValue* userValue,
-                             MatchFlags* saveFlags,
-                             bool reverseEndianness = false) noexcept
-    -> unsigned int {
-    const bool NEEDS_USER = matchNeedsUserValue(matchType);
+[[nodiscard]] constexpr auto numericEqual(T firstValue, T secondValue) noexcept
+    -> bool {
+    if constexpr (std::is_floating_point_v<T>) {
+        return almostEqual<T>(firstValue, secondValue);
+    } else {
+        return firstValue == secondValue;
+    }
+}
 
-    if (NEEDS_USER && userValue == nullptr) {
-        return 0;
+export template <typename T>
+[[nodiscard]] constexpr auto numericGreater(T firstValue, T secondValue) noexcept
+    -> bool {
+    if constexpr (std::is_floating_point_v<T>) {
+        return firstValue > secondValue && !almostEqual<T>(firstValue, secondValue);
+    } else {
+        return firstValue > secondValue;
     }
+}
 
-    if (NEEDS_USER && userValue != nullptr) {
-        const auto REQUIRED = flagForType<T>();
-        if ((userValue->flag() & REQUIRED) == MatchFlags::EMPTY) {
-            return 0;
-        }
+export template <typename T>
+[[nodiscard]] constexpr auto numericLess(T firstValue, T secondValue) noexcept
+    -> bool {
+    if constexpr (std::is_floating_point_v<T>) {
+        return firstValue < secondValue && !almostEqual<T>(firstValue, secondValue);
+    } else {
+        return firstValue < secondValue;
+    }
+}
+
+/** @brief Inclusive range test; bounds must already be ordered */
+export template <typename T>
+[[nodiscard]] constexpr auto numericInRange(T memv, T lowBound,
+                                            T highBound) noexcept -> bool {
+    if constexpr (std::is_floating_point_v<T>) {
+        const T ABS_TOLERANCE = absTol<T>();
+        return memv >= lowBound - ABS_TOLERANCE &&
+               memv <= highBound + ABS_TOLERANCE;
+    } else {
+        return memv >= lowBound && memv <= highBound;
+    }
+}
+
+/**
+ * @brief Match memv against user operands already converted to T
+ *
+ * Shared by numericMatchCore (converting per call) and routines built from
+ * a MatchPlan (converted once per scan).
+ */
+export template <typename T>
+inline auto numericMatchOperands(ScanMatchType matchType, T memv,
+                                 const Value* oldValue,
+                                 const scan::TypedOperands<T>& operands,
+                                 MatchFlags* saveFlags,
+                                 bool reverseEndianness = false) noexcept
+    -> unsigned int {
+    if (matchNeedsUserValue(matchType) && !operands.valid) {
+        return 0;
     }
 
     std::optional<T> oldOpt;
@@ -51,121 +106,73 @@ inline auto numericMatchCore(ScanMatchType matchType, T memv,
         return sizeof(T);
     };
 
-    auto isEqual = [&](T firstValue, T secondValue) {
-        if constexpr (std::is_floating_point_v<T>) {
-            return almostEqual<T>(firstValue, secondValue);
-        }
-        return firstValue == secondValue;
-    };
-
-    auto isNotEqual = [&](T firstValue, T secondValue) {
-        return !isEqual(firstValue, secondValue);
-    };
-
-    auto isGreaterThan = [&](T firstValue, T secondValue) {
-        if constexpr (std::is_floating_point_v<T>) {
-            return firstValue > secondValue &&
-                   !isEqual(firstValue, secondValue);
-        }
-        return firstValue > secondValue;
-    };
-    
-    auto isLessThan = [&](T firstValue, T secondValue) {
-        if constexpr (std::is_floating_point_v<T>) {
-            return firstValue < secondValue &&
-                   !isEqual(firstValue, secondValue);
-        }
-        return firstValue < secondValue;
-    };
-
-    std::optional<T> userLowOpt;
-    if (NEEDS_USER) {
-        userLowOpt = userValueAs<T>(*userValue);
-        if (!userLowOpt) {
-            return 0;
-        }
-    }
-
-    const T USERVALUEMAIN = userLowOpt.value_or(T{});
+    const T USERVALUEMAIN = operands.low;
 
     switch (matchType) {
         case ScanMatchType::MATCH_ANY:
             return markMatched();
         case ScanMatchType::MATCH_EQUAL_TO:
-            return isEqual(memv, USERVALUEMAIN) ? markMatched() : 0;
+            return numericEqual<T>(memv, USERVALUEMAIN) ? markMatched() : 0;
         case ScanMatchType::MATCH_NOT_EQUAL_TO:
-            return isNotEqual(memv, USERVALUEMAIN) ? markMatched() : 0;
+            return !numericEqual<T>(memv, USERVALUEMAIN) ? markMatched() : 0;
         case ScanMatchType::MATCH_GREATER_THAN:
-            return isGreaterThan(memv, USERVALUEMAIN) ? markMatched() : 0;
+            return numericGreater<T>(memv, USERVALUEMAIN) ? markMatched() : 0;
         case ScanMatchType::MATCH_LESS_THAN:
-            return isLessThan(memv, USERVALUEMAIN) ? markMatched() : 0;
+            return numericLess<T>(memv, USERVALUEMAIN) ? markMatched() : 0;
         case ScanMatchType::MATCH_UPDATE:
         case ScanMatchType::MATCH_NOT_CHANGED:
-            return isEqual(memv, *oldOpt) ? markMatched() : 0;
+            return numericEqual<T>(memv, *oldOpt) ? markMatched() : 0;
         case ScanMatchType::MATCH_CHANGED:
-            return isNotEqual(memv, *oldOpt) ? markMatched() : 0;
+            return !numericEqual<T>(memv, *oldOpt) ? markMatched() : 0;
         case ScanMatchType::MATCH_INCREASED:
-            return isGreaterThan(memv, *oldOpt) ? markMatched() : 0;
+            return numericGreater<T>(memv, *oldOpt) ? markMatched() : 0;
         case ScanMatchType::MATCH_DECREASED:
-            return isLessThan(memv, *oldOpt) ? markMatched() : 0;
+            return numericLess<T>(memv, *oldOpt) ? markMatched() : 0;
         case ScanMatchType::MATCH_INCREASED_BY: {
             const T DELTA = memv - *oldOpt;
-            if constexpr (std::is_floating_point_v<T>) {
-                return almostEqual<T>(DELTA, USERVALUEMAIN) ? markMatched() : 0;
-            }
-            return (DELTA == USERVALUEMAIN) ? markMatched() : 0;
+            return numericEqual<T>(DELTA, USERVALUEMAIN) ? markMatched() : 0;
         }
         case ScanMatchType::MATCH_DECREASED_BY: {
             const T DELTA = *oldOpt - memv;
-            if constexpr (std::is_floating_point_v<T>) {
-                return almostEqual<T>(DELTA, USERVALUEMAIN) ? markMatched() : 0;
-            }
-            return (DELTA == USERVALUEMAIN) ? markMatched() : 0;
-        }
-        case ScanMatchType::MATCH_RANGE: {
-            auto highOpt = userValueHighAs<T>(*userValue);
-            if (!highOpt || !userLowOpt) {
-                return 0;
-            }
-            const T HIGHVALUE = *highOpt;
-            auto [lowBound, highBound] = std::minmax(*userLowOpt, HIGHVALUE);
-            if constexpr (std::is_floating_point_v<T>) {
-                const T ABS_TOLERANCE = absTol<T>();
-                const bool IN_RANGE = (memv >= lowBound - ABS_TOLERANCE &&
-                                       memv <= highBound + ABS_TOLERANCE);
-                return IN_RANGE ? markMatched() : 0;
-            }
-            const bool IN_RANGE = (memv >= lowBound && memv <= highBound);
-            return IN_RANGE ? markMatched() : 0;
+            return numericEqual<T>(DELTA, USERVALUEMAIN) ? markMatched() : 0;
         }
+        case ScanMatchType::MATCH_RANGE:
+            return operands.inRange(memv) ? markMatched() : 0;
         default:
             return 0;
     }
 }
 
+export template <typename T>
+inline auto numericMatchCore(ScanMatchType matchType, T memv,
+                             const Value* oldValue, const UserValue* userValue,
+                             MatchFlags* saveFlags,
+                             bool reverseEndianness = false) noexcept
+    -> unsigned int {
+    scan::TypedOperands<T> operands;
+    if (matchNeedsUserValue(matchType)) {
+        if (userValue == nullptr) {
+            return 0;
+        }
+        operands = scan::toOperands<T>(
+            *userValue, matchType == ScanMatchType::MATCH_RANGE);
+    }
+    return numericMatchOperands<T>(matchType, memv, oldValue, operands,
+                                   saveFlags, reverseEndianness);
+}
+
 namespace detail {
 
 template <typename T>
 inline auto runNumericMatch(ScanMatchType matchType, const scan::ScanContext& ctx,
+                            bool reverseEndianness,
                             MatchFlags* saveFlags) noexcept -> unsigned int {
-    auto memOpt = readTyped<T>(ctx.memory, ctx.reverseEndianness);
+    auto memOpt = readTyped<T>(ctx.memory, reverseEndianness);
     if (!memOpt) {
         return 0;
     }
-    return numericMatchCore<T>(
-        matchType, *memOpt, ctx.oldValue ? &*ctx.oldValue : nullptr,
-        ctx.userValue ? &*ctx.userValue : nullptr, saveFlags,
-        ctx.reverseEndianness);
-}
-
-template <typename... Ts>
-inline auto tryNumericSequence(ScanMatchType matchType,
-                               const scan::ScanContext& ctx,
-                               MatchFlags* saveFlags) noexcept -> unsigned int {
-    unsigned int result = 0;
-    ((result != 0 ? 0 : result = runNumericMatch<Ts>(matchType, ctx, saveFlags)),
-     ...);
-    return result;
+    return numericMatchCore<T>(matchType, *memOpt, ctx.oldValue, ctx.userValue,
+                               saveFlags, reverseEndianness);
 }
 
 }  // namespace detail
@@ -173,12 +180,11 @@ inline auto tryNumericSequence(ScanMatchType matchType,
 export template <typename T>
 inline auto makeNumericScanRoutine(ScanMatchType matchType,
                                    bool reverseEndianness) -> scan::ScanRoutine {
-    return [matchType, reverseEndianness](const scan::ScanContext& baseCtx) {
-        scan::ScanContext ctx = baseCtx;
-        ctx.reverseEndianness = reverseEndianness;
+    return [matchType, reverseEndianness](const scan::ScanContext& ctx) {
         MatchFlags flags = MatchFlags::EMPTY;
         const auto matched =
-            detail::runNumericMatch<T>(matchType, ctx, &flags);
+            detail::runNumericMatch<T>(matchType, ctx, reverseEndianness,
+                                       &flags);
         if (matched == 0U) {
             return scan::ScanResult::noMatch();
         }
@@ -186,17 +192,29 @@ inline auto makeNumericScanRoutine(ScanMatchType matchType,
     };
 }
 
-export inline auto makeAnyIntegerScanRoutine(ScanMatchType matchType,
-                                             bool reverseEndianness)
+/**
+ * @brief Numeric routine reading its operands from a MatchPlan
+ *
+ * Calls with a different user value than the plan's still work; they
+ * convert it per call like the plain routine.
+ */
+export template <typename T>
+inline auto makeNumericScanRoutine(scan::MatchPlanPtr plan)
     -> scan::ScanRoutine {
-    return [matchType, reverseEndianness](const scan::ScanContext& baseCtx) {
-        scan::ScanContext ctx = baseCtx;
-        ctx.reverseEndianness = reverseEndianness;
+    return [plan = std::move(plan)](const scan::ScanContext& ctx) {
+        const bool REVERSE = plan->reverseEndianness();
         MatchFlags flags = MatchFlags::EMPTY;
-        const auto matched =
-            detail::tryNumericSequence<uint64_t, int64_t, uint32_t, int32_t,
-                                       uint16_t, int16_t, uint8_t, int8_t>(
-                matchType, ctx, &flags);
+        unsigned int matched = 0;
+        if (ctx.userValue == plan->userValue()) {
+            if (auto memOpt = readTyped<T>(ctx.memory, REVERSE)) {
+                matched = numericMatchOperands<T>(
+                    plan->matchType(), *memOpt, ctx.oldValue,
+                    plan->operands<T>(), &flags, REVERSE);
+            }
+        } else {
+            matched = detail::runNumericMatch<T>(plan->matchType(), ctx,
+                                                 REVERSE, &flags);
+        }
         if (matched == 0U) {
             return scan::ScanResult::noMatch();
         }
@@ -204,41 +222,391 @@ export inline auto makeAnyIntegerScanRoutine(ScanMatchType matchType,
     };
 }
 
-export inline auto makeAnyFloatScanRoutine(ScanMatchType matchType,
-                                           bool reverseEndianness)
-    -> scan::ScanRoutine {
-    return [matchType, reverseEndianness](const scan::ScanContext& baseCtx) {
-        scan::ScanContext ctx = baseCtx;
-        ctx.reverseEndianness = reverseEndianness;
-        MatchFlags flags = MatchFlags::EMPTY;
-        const auto matched =
-            detail::tryNumericSequence<double, float>(matchType, ctx, &flags);
-        if (matched == 0U) {
+export namespace scan {
+
+/** @brief Result of evaluating every width at one offset */
+struct WidthMatch {
+    MatchFlags flags{MatchFlags::EMPTY};  ///< Every width that matched
+    unsigned int length{0};               ///< Widest width that matched
+};
+
+/**
+ * @class AnyNumberMatcher
+ * @brief Fused ANY_NUMBER / ANY_INTEGER / ANY_FLOAT evaluation
+ *
+ * The user value is converted for every candidate type once, at creation.
+ * match() then loads up to 8 bytes (and old bytes) once per offset and
+ * evaluates all widths, reporting the complete width mask instead of the
+ * first type that matched. MATCH_ANY is a table lookup by the bytes left,
+ * and integer equality compares all four widths as masked XORs of the one
+ * 64-bit load, since signedness does not change bitwise equality.
+ */
+class AnyNumberMatcher {
+   public:
+    static constexpr std::size_t MAX_WIDTH = 8;
+
+    /**
+     * @param plan Plan of an ANY_NUMBER, ANY_INTEGER or ANY_FLOAT scan;
+     *        types the user value does not convert to stay disabled
+     */
+    [[nodiscard]] static auto create(const MatchPlan& plan) noexcept
+        -> AnyNumberMatcher {
+        AnyNumberMatcher matcher;
+        matcher.m_reverse = plan.reverseEndianness();
+        const auto DATA_TYPE = plan.dataType();
+        const auto MATCH_TYPE = plan.matchType();
+        auto prepare = [&]<typename T>(Operand<T>& operand, bool wanted) {
+            const auto& planned = plan.operands<T>();
+            if (!wanted || (plan.needsUserValue() && !planned.valid)) {
+                return;
+            }
+            operand.low = planned.low;
+            operand.high = planned.high;
+            operand.enabled = true;
+        };
+        std::apply(
+            [&](auto&... operands) {
+                (prepare(operands, DATA_TYPE != ScanDataType::ANY_FLOAT), ...);
+            },
+            matcher.m_ints);
+        std::apply(
+            [&](auto&... operands) {
+                (prepare(operands, DATA_TYPE != ScanDataType::ANY_INTEGER), ...);
+            },
+            matcher.m_floats);
+
+        if (MATCH_TYPE == ScanMatchType::MATCH_ANY) {
+            matcher.buildAnyTable();
+        }
+        if (MATCH_TYPE == ScanMatchType::MATCH_EQUAL_TO) {
+            matcher.buildEqualPatterns();
+        }
+        return matcher;
+    }
+
+    /** @brief create() for a plan built from just these settings */
+    [[nodiscard]] static auto create(ScanDataType dataType,
+                                     ScanMatchType matchType,
+                                     const UserValue* userValue,
+                                     bool reverseEndianness) noexcept
+        -> AnyNumberMatcher {
+        ScanOptions opts;
+        opts.dataType = dataType;
+        opts.matchType = matchType;
+        opts.reverseEndianness = reverseEndianness;
+        return create(MatchPlan::build(opts, userValue));
+    }
+
+    /** @brief Evaluate every enabled type at memory[0] */
+    template <ScanMatchType MATCH>
+    [[nodiscard]] auto match(std::span<const std::uint8_t> memory,
+                             std::span<const std::uint8_t> old) const noexcept
+        -> WidthMatch {
+        const std::size_t AVAIL = std::min(memory.size(), MAX_WIDTH);
+        if constexpr (MATCH == ScanMatchType::MATCH_ANY) {
+            return m_anyTable[AVAIL];
+        }
+        WidthMatch out;
+        if (AVAIL == 0) {
+            return out;
+        }
+        std::array<std::uint8_t, MAX_WIDTH> cur{};
+        std::memcpy(cur.data(), memory.data(), AVAIL);
+        std::array<std::uint8_t, MAX_WIDTH> prev{};
+        std::size_t oldAvail = 0;
+        if constexpr (matchUsesOldValue(MATCH)) {
+            oldAvail = std::min(old.size(), MAX_WIDTH);
+            std::memcpy(prev.data(), old.data(), oldAvail);
+        }
+        const Loaded LOADED{.cur = cur.data(),
+                            .avail = AVAIL,
+                            .prev = prev.data(),
+                            .prevAvail = oldAvail};
+
+        if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+            const auto BITS = std::bit_cast<std::uint64_t>(cur);
+            for (std::size_t idx = 0; idx < WIDTHS; ++idx) {
+                const std::size_t WIDTH = std::size_t{1} << idx;
+                if (WIDTH <= AVAIL && ((m_equalWidths >> idx) & 1U) != 0 &&
+                    ((BITS ^ m_equalBits[idx]) & widthMask(WIDTH)) == 0) {
+                    out.flags = out.flags | widthFlag(WIDTH);
+                    out.length = static_cast<unsigned int>(WIDTH);
+                }
+            }
+        } else {
+            std::apply(
+                [&](const auto&... operands) {
+                    (evaluate<MATCH>(operands, LOADED, out), ...);
+                },
+                m_ints);
+        }
+        std::apply(
+            [&](const auto&... operands) {
+                (evaluate<MATCH>(operands, LOADED, out), ...);
+            },
+            m_floats);
+        return out;
+    }
+
+    /** @brief match() with the match type chosen at run time */
+    [[nodiscard]] auto match(ScanMatchType matchType,
+                             std::span<const std::uint8_t> memory,
+                             std::span<const std::uint8_t> old) const noexcept
+        -> WidthMatch {
+        switch (matchType) {
+            case ScanMatchType::MATCH_ANY:
+                return match<ScanMatchType::MATCH_ANY>(memory, old);
+            case ScanMatchType::MATCH_EQUAL_TO:
+                return match<ScanMatchType::MATCH_EQUAL_TO>(memory, old);
+            case ScanMatchType::MATCH_NOT_EQUAL_TO:
+                return match<ScanMatchType::MATCH_NOT_EQUAL_TO>(memory, old);
+            case ScanMatchType::MATCH_GREATER_THAN:
+                return match<ScanMatchType::MATCH_GREATER_THAN>(memory, old);
+            case ScanMatchType::MATCH_LESS_THAN:
+                return match<ScanMatchType::MATCH_LESS_THAN>(memory, old);
+            case ScanMatchType::MATCH_RANGE:
+                return match<ScanMatchType::MATCH_RANGE>(memory, old);
+            case ScanMatchType::MATCH_UPDATE:
+                return match<ScanMatchType::MATCH_UPDATE>(memory, old);
+            case ScanMatchType::MATCH_NOT_CHANGED:
+                return match<ScanMatchType::MATCH_NOT_CHANGED>(memory, old);
+            case ScanMatchType::MATCH_CHANGED:
+                return match<ScanMatchType::MATCH_CHANGED>(memory, old);
+            case ScanMatchType::MATCH_INCREASED:
+                return match<ScanMatchType::MATCH_INCREASED>(memory, old);
+            case ScanMatchType::MATCH_DECREASED:
+                return match<ScanMatchType::MATCH_DECREASED>(memory, old);
+            case ScanMatchType::MATCH_INCREASED_BY:
+                return match<ScanMatchType::MATCH_INCREASED_BY>(memory, old);
+            case ScanMatchType::MATCH_DECREASED_BY:
+                return match<ScanMatchType::MATCH_DECREASED_BY>(memory, old);
+            default:
+                return {};
+        }
+    }
+
+    /** @brief Drop the widths not in allowed, shrinking the length to fit */
+    [[nodiscard]] static auto keepWidths(WidthMatch result,
+                                       MatchFlags allowed) noexcept
+        -> WidthMatch {
+        result.flags = result.flags & allowed;
+        result.length = 0;
+        for (std::size_t width = 1; width <= MAX_WIDTH; width *= 2) {
+            if ((result.flags & widthFlag(width)) != MatchFlags::EMPTY) {
+                result.length = static_cast<unsigned int>(width);
+            }
+        }
+        return result;
+    }
+
+   private:
+    static constexpr std::size_t WIDTHS = 4;  // 1, 2, 4 and 8 bytes
+
+    template <typename T>
+    struct Operand {
+        T low{};
+        T high{};
+        bool enabled{false};
+    };
+
+    struct Loaded {
+        const std::uint8_t* cur;
+        std::size_t avail;
+        const std::uint8_t* prev;
+        std::size_t prevAvail;
+    };
+
+    [[nodiscard]] static constexpr auto widthFlag(std::size_t width) noexcept
+        -> MatchFlags {
+        switch (width) {
+            case 1:
+                return MatchFlags::B8;
+            case 2:
+                return MatchFlags::B16;
+            case 4:
+                return MatchFlags::B32;
+            default:
+                return MatchFlags::B64;
+        }
+    }
+
+    // Selects the first width bytes of an 8-byte load, in memory order
+    [[nodiscard]] static auto widthMask(std::size_t width) noexcept
+        -> std::uint64_t {
+        std::array<std::uint8_t, MAX_WIDTH> bytes{};
+        std::fill_n(bytes.begin(), width, std::uint8_t{0xFF});
+        return std::bit_cast<std::uint64_t>(bytes);
+    }
+
+    template <ScanMatchType MATCH, typename T>
+    [[nodiscard]] static constexpr auto compare(T memv, T old,
+                                                const Operand<T>& operand) noexcept
+        -> bool {
+        if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+            return numericEqual<T>(memv, operand.low);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_NOT_EQUAL_TO) {
+            return !numericEqual<T>(memv, operand.low);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_GREATER_THAN) {
+            return numericGreater<T>(memv, operand.low);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+            return numericLess<T>(memv, operand.low);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_RANGE) {
+            return numericInRange<T>(memv, operand.low, operand.high);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_UPDATE ||
+                             MATCH == ScanMatchType::MATCH_NOT_CHANGED) {
+            return numericEqual<T>(memv, old);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_CHANGED) {
+            return !numericEqual<T>(memv, old);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_INCREASED) {
+            return numericGreater<T>(memv, old);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_DECREASED) {
+            return numericLess<T>(memv, old);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_INCREASED_BY) {
+            return numericEqual<T>(static_cast<T>(memv - old), operand.low);
+        } else if constexpr (MATCH == ScanMatchType::MATCH_DECREASED_BY) {
+            return numericEqual<T>(static_cast<T>(old - memv), operand.low);
+        } else {
+            return false;
+        }
+    }
+
+    template <ScanMatchType MATCH, typename T>
+    void evaluate(const Operand<T>& operand, const Loaded& loaded,
+                  WidthMatch& out) const noexcept {
+        constexpr MatchFlags FLAG = flagForType<T>();
+        if (!operand.enabled || loaded.avail < sizeof(T) ||
+            (out.flags & FLAG) != MatchFlags::EMPTY) {
+            return;  // signed and unsigned share a width; one hit suffices
+        }
+        T memv{};
+        std::memcpy(&memv, loaded.cur, sizeof(T));
+        memv = swapIfReverse<T>(memv, m_reverse);
+        T old{};
+        if constexpr (matchUsesOldValue(MATCH)) {
+            if (loaded.prevAvail < sizeof(T)) {
+                return;
+            }
+            std::memcpy(&old, loaded.prev, sizeof(T));
+            old = swapIfReverse<T>(old, m_reverse);
+        }
+        if (compare<MATCH, T>(memv, old, operand)) {
+            out.flags = out.flags | FLAG;
+            out.length = std::max<unsigned int>(out.length, sizeof(T));
+        }
+    }
+
+    void buildAnyTable() noexcept {
+        for (std::size_t avail = 0; avail <= MAX_WIDTH; ++avail) {
+            auto& entry = m_anyTable[avail];
+            auto add = [&]<typename T>(const Operand<T>& operand) {
+                if (operand.enabled && sizeof(T) <= avail) {
+                    entry.flags = entry.flags | flagForType<T>();
+                    entry.length = std::max<unsigned int>(entry.length, sizeof(T));
+                }
+            };
+            std::apply([&](const auto&... ops) { (add(ops), ...); }, m_ints);
+            std::apply([&](const auto&... ops) { (add(ops), ...); }, m_floats);
+        }
+    }
+
+    void buildEqualPatterns() noexcept {
+        auto add = [&]<typename T>(const Operand<T>& operand) {
+            if (!operand.enabled) {
+                return;
+            }
+            const auto IDX = static_cast<std::size_t>(std::countr_zero(sizeof(T)));
+            const T IN_MEMORY = swapIfReverse<T>(operand.low, m_reverse);
+            std::memcpy(&m_equalBits[IDX], &IN_MEMORY, sizeof(T));
+            m_equalWidths |= 1U << IDX;
+        };
+        std::apply([&](const auto&... ops) { (add(ops), ...); }, m_ints);
+    }
+
+    std::tuple<Operand<std::uint64_t>, Operand<std::int64_t>,
+               Operand<std::uint32_t>, Operand<std::int32_t>,
+               Operand<std::uint16_t>, Operand<std::int16_t>,
+               Operand<std::uint8_t>, Operand<std::int8_t>>
+        m_ints;
+    std::tuple<Operand<double>, Operand<float>> m_floats;
+    std::array<WidthMatch, MAX_WIDTH + 1> m_anyTable{};  // by bytes left
+    std::array<std::uint64_t, WIDTHS> m_equalBits{};  // integer EQUAL_TO
+    unsigned int m_equalWidths{0};                    // bit per width index
+    bool m_reverse{false};
+};
+
+}  // namespace scan
+
+namespace detail {
+
+// Routine form of AnyNumberMatcher; converts the user value on every call
+// unless it is the one plan was built from
+inline auto makeAnyWidthScanRoutine(scan::MatchPlanPtr plan) -> scan::ScanRoutine {
+    auto matcher = std::make_shared<const scan::AnyNumberMatcher>(
+        scan::AnyNumberMatcher::create(*plan));
+    return [plan = std::move(plan),
+            matcher = std::move(matcher)](const scan::ScanContext& ctx) {
+        const auto MATCH_TYPE = plan->matchType();
+        std::span<const std::uint8_t> old;
+        if (ctx.oldValue != nullptr) {
+            old = {ctx.oldValue->data(), ctx.oldValue->size()};
+        }
+        scan::WidthMatch result;
+        if (ctx.userValue == plan->userValue()) {
+            result = matcher->match(MATCH_TYPE, ctx.memory, old);
+        } else {
+            result = scan::AnyNumberMatcher::create(
+                         plan->dataType(), MATCH_TYPE, ctx.userValue,
+                         plan->reverseEndianness())
+                         .match(MATCH_TYPE, ctx.memory, old);
+        }
+        if (matchUsesOldValue(MATCH_TYPE)) {
+            // Old bytes only stand for the widths their flags allow
+            result = scan::AnyNumberMatcher::keepWidths(
+                result, ctx.oldValue != nullptr ? ctx.oldValue->flags
+                                                : MatchFlags::EMPTY);
+        }
+        if (result.length == 0U) {
             return scan::ScanResult::noMatch();
         }
-        return scan::ScanResult::match(matched, flags);
+        return scan::ScanResult::match(result.length, result.flags);
     };
 }
 
+inline auto makeAnyWidthScanRoutine(ScanDataType dataType,
+                                    ScanMatchType matchType,
+                                    bool reverseEndianness) -> scan::ScanRoutine {
+    ScanOptions opts;
+    opts.dataType = dataType;
+    opts.matchType = matchType;
+    opts.reverseEndianness = reverseEndianness;
+    return makeAnyWidthScanRoutine(scan::makeMatchPlan(opts, nullptr));
+}
+
+}  // namespace detail
+
+export inline auto makeAnyIntegerScanRoutine(ScanMatchType matchType,
+                                             bool reverseEndianness)
+    -> scan::ScanRoutine {
+    return detail::makeAnyWidthScanRoutine(ScanDataType::ANY_INTEGER,
+                                           matchType, reverseEndianness);
+}
+
+export inline auto makeAnyFloatScanRoutine(ScanMatchType matchType,
+                                           bool reverseEndianness)
+    -> scan::ScanRoutine {
+    return detail::makeAnyWidthScanRoutine(ScanDataType::ANY_FLOAT, matchType,
+                                           reverseEndianness);
+}
+
 export inline auto makeAnyNumberScanRoutine(ScanMatchType matchType,
                                             bool reverseEndianness)
     -> scan::ScanRoutine {
-    return [matchType, reverseEndianness](const scan::ScanContext& baseCtx) {
-        scan::ScanContext ctx = baseCtx;
-        ctx.reverseEndianness = reverseEndianness;
-        MatchFlags flags = MatchFlags::EMPTY;
-        if (auto matched =
-                detail::tryNumericSequence<double, float>(matchType, ctx, &flags);
-            matched != 0U) {
-            return scan::ScanResult::match(matched, flags);
-        }
-        const auto matched =
-            detail::tryNumericSequence<uint64_t, int64_t, uint32_t, int32_t,
-                                       uint16_t, int16_t, uint8_t, int8_t>(
-                matchType, ctx, &flags);
-        if (matched == 0U) {
-            return scan::ScanResult::noMatch();
-        }
-        return scan::ScanResult::match(matched, flags);
-    };
+    return detail::makeAnyWidthScanRoutine(ScanDataType::ANY_NUMBER,
+                                           matchType, reverseEndianness);
+}
+
+/** @brief ANY_* routine (by plan->dataType()) reading a MatchPlan */
+export inline auto makeAnyWidthScanRoutine(scan::MatchPlanPtr plan)
+    -> scan::ScanRoutine {
+    return detail::makeAnyWidthScanRoutine(std::move(plan));
 }
@@ -0,0 +1,421 @@
+/**
+ * @file pattern_set.cppm
+ * @brief Block-level search for one or many masked byte patterns (字节特征码)
+ *
+ * A PatternSet is compiled once per scan and then searches whole blocks:
+ *
+ *  - a single pattern uses a first/last fixed byte prefilter: two vector
+ *    compares per 16 or 32 candidate offsets, and only offsets where both
+ *    bytes agree are verified against the full pattern and mask;
+ *  - several patterns are matched in one pass: each is anchored on a pair
+ *    of adjacent fixed bytes (a single fixed byte if it has none), an 8 KiB
+ *    bitmap over all 65536 pairs rejects almost every offset with one load,
+ *    and only the patterns sharing a hit pair are verified.
+ *
+ * Masks are per byte (0xFF fixed, 0x00 wildcard, nibble masks allowed);
+ * only fully fixed bytes can serve as anchors.
+ */
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_SIMD_X86 1
+#define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+export module scan.pattern_set;
+
+import scan.types;
+import scan.simd;
+import value.core;
+
+export namespace scan {
+
+/**
+ * @struct BytePattern
+ * @brief One signature: bytes plus a mask of the bits that must match
+ */
+struct BytePattern {
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::uint8_t> mask;  ///< Same size as bytes
+
+    /** @brief Pattern of a byte-array Value; no mask means all fixed */
+    [[nodiscard]] static auto fromValue(const Value& value) -> BytePattern {
+        BytePattern pattern{.bytes = value.bytes};
+        if (value.mask && value.mask->size() == value.bytes.size()) {
+            pattern.mask = *value.mask;
+        } else {
+            pattern.mask.assign(value.bytes.size(), 0xFF);
+        }
+        return pattern;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return bytes.size();
+    }
+
+    /** @brief Whether the pattern matches at at[0 .. size()) */
+    [[nodiscard]] auto matchesAt(const std::uint8_t* at) const noexcept
+        -> bool {
+        for (std::size_t i = 0; i < bytes.size(); ++i) {
+            if (((at[i] ^ bytes[i]) & mask[i]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] auto isFixed(std::size_t index) const noexcept -> bool {
+        return mask[index] == 0xFF;
+    }
+};
+
+/**
+ * @class PatternSet
+ * @brief Compiled set of byte patterns searched in a single pass
+ */
+class PatternSet {
+   public:
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+    PatternSet() = default;
+
+    /** @brief Compile patterns; empty patterns are dropped */
+    [[nodiscard]] static auto compile(std::vector<BytePattern> patterns)
+        -> PatternSet {
+        PatternSet set;
+        std::erase_if(patterns,
+                      [](const BytePattern& pattern) { return pattern.size() == 0; });
+        set.m_patterns = std::move(patterns);
+        if (set.m_patterns.size() == 1 && set.prepareSingle()) {
+            return set;
+        }
+        set.m_pairFilter.assign(65536 / 64, 0);
+        for (std::size_t i = 0; i < set.m_patterns.size(); ++i) {
+            set.addAnchor(static_cast<std::uint32_t>(i));
+        }
+        std::ranges::sort(set.m_pairs, {}, &KeyedAnchor::key);
+        std::ranges::sort(set.m_bytes, {}, &KeyedAnchor::key);
+        return set;
+    }
+
+    /** @brief The primary pattern of value followed by its alternatives */
+    [[nodiscard]] static auto fromUserValue(const UserValue& value)
+        -> PatternSet {
+        std::vector<BytePattern> patterns;
+        patterns.reserve(1 + value.alternatives.size());
+        patterns.push_back(BytePattern::fromValue(value.primary));
+        for (const auto& alternative : value.alternatives) {
+            patterns.push_back(BytePattern::fromValue(alternative));
+        }
+        return compile(std::move(patterns));
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_patterns.empty();
+    }
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_patterns.size();
+    }
+    [[nodiscard]] auto pattern(std::size_t index) const -> const BytePattern& {
+        return m_patterns[index];
+    }
+
+    /**
+     * @brief Pattern matching at the start of memory
+     * @return Index of the longest such pattern (lowest index on ties), or
+     *         NPOS
+     */
+    [[nodiscard]] auto matchAt(std::span<const std::uint8_t> memory) const
+        noexcept -> std::size_t {
+        std::size_t best = NPOS;
+        for (std::size_t i = 0; i < m_patterns.size(); ++i) {
+            const auto& pattern = m_patterns[i];
+            if (pattern.size() <= memory.size() &&
+                (best == NPOS || pattern.size() > m_patterns[best].size()) &&
+                pattern.matchesAt(memory.data())) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Call fn(offset, patternIndex) for every occurrence in hay
+     *
+     * Only occurrences lying entirely inside hay are reported. Offsets of
+     * one pattern ascend; with several patterns they may interleave.
+     */
+    template <typename Fn>
+    void search(std::span<const std::uint8_t> hay, Fn&& fn) const {
+        searchUntil(hay, [&](std::size_t offset, std::size_t index) {
+            fn(offset, index);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Like search, but stops as soon as fn returns false
+     * @return false if fn stopped the search
+     */
+    template <typename Fn>
+    auto searchUntil(std::span<const std::uint8_t> hay, Fn&& fn) const
+        -> bool {
+        if (m_patterns.empty()) {
+            return true;
+        }
+        if (m_single) {
+            return searchSingle(hay, fn);
+        }
+        for (const std::uint32_t INDEX : m_everywhere) {
+            const auto& pattern = m_patterns[INDEX];
+            for (std::size_t offset = 0; offset + pattern.size() <= hay.size();
+                 ++offset) {
+                if (pattern.matchesAt(hay.data() + offset) &&
+                    !fn(offset, static_cast<std::size_t>(INDEX))) {
+                    return false;
+                }
+            }
+        }
+        if (!m_bytes.empty()) {
+            for (std::size_t pos = 0; pos < hay.size(); ++pos) {
+                if ((m_byteFilter[hay[pos] / 64] & (1ULL << (hay[pos] % 64))) !=
+                        0 &&
+                    !verify(m_bytes, hay[pos], hay, pos, fn)) {
+                    return false;
+                }
+            }
+        }
+        if (!m_pairs.empty()) {
+            for (std::size_t pos = 0; pos + 1 < hay.size(); ++pos) {
+                const auto KEY = static_cast<std::uint16_t>(
+                    hay[pos] | (hay[pos + 1] << 8));
+                if ((m_pairFilter[KEY / 64] & (1ULL << (KEY % 64))) != 0 &&
+                    !verify(m_pairs, KEY, hay, pos, fn)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /** @brief First occurrence of any pattern (lowest offset, then longest) */
+    [[nodiscard]] auto findFirst(std::span<const std::uint8_t> hay) const
+        -> std::optional<ByteMatch> {
+        std::optional<ByteMatch> first;
+        searchUntil(hay, [&](std::size_t offset, std::size_t index) {
+            const std::size_t LENGTH = m_patterns[index].size();
+            if (!first || offset < first->offset ||
+                (offset == first->offset && LENGTH > first->length)) {
+                first = ByteMatch{.offset = offset, .length = LENGTH};
+            }
+            // A lone pattern reports offsets in order
+            return !m_single;
+        });
+        return first;
+    }
+
+   private:
+    struct KeyedAnchor {
+        std::uint16_t key;       // anchor byte(s), little-endian pair
+        std::uint32_t pattern;   // index into m_patterns
+        std::uint32_t offset;    // anchor position inside the pattern
+    };
+
+    // Bytes that are seldom worth anchoring on: padding, fill, int3, nop
+    static constexpr auto isCommonByte(std::uint8_t byte) noexcept -> bool {
+        return byte == 0x00 || byte == 0xFF || byte == 0xCC || byte == 0x90;
+    }
+
+    void addAnchor(std::uint32_t index) {
+        const auto& pattern = m_patterns[index];
+        std::size_t pair = NPOS;
+        std::size_t single = NPOS;
+        for (std::size_t i = 0; i < pattern.size(); ++i) {
+            if (!pattern.isFixed(i)) {
+                continue;
+            }
+            if (single == NPOS || (isCommonByte(pattern.bytes[single]) &&
+                                   !isCommonByte(pattern.bytes[i]))) {
+                single = i;
+            }
+            if (i + 1 < pattern.size() && pattern.isFixed(i + 1)) {
+                const bool RARE = !isCommonByte(pattern.bytes[i]) ||
+                                  !isCommonByte(pattern.bytes[i + 1]);
+                if (pair == NPOS || (RARE && isCommonByte(pattern.bytes[pair]) &&
+                                     isCommonByte(pattern.bytes[pair + 1]))) {
+                    pair = i;
+                }
+            }
+        }
+        if (pair != NPOS) {
+            const auto KEY = static_cast<std::uint16_t>(
+                pattern.bytes[pair] | (pattern.bytes[pair + 1] << 8));
+            m_pairFilter[KEY / 64] |= 1ULL << (KEY % 64);
+            m_pairs.push_back({KEY, index, static_cast<std::uint32_t>(pair)});
+        } else if (single != NPOS) {
+            const std::uint8_t KEY = pattern.bytes[single];
+            m_byteFilter[KEY / 64] |= 1ULL << (KEY % 64);
+            m_bytes.push_back({KEY, index, static_cast<std::uint32_t>(single)});
+        } else {
+            m_everywhere.push_back(index);
+        }
+    }
+
+    // Prefilter bytes for the single-pattern path: first and last fixed
+    auto prepareSingle() -> bool {
+        const auto& pattern = m_patterns.front();
+        for (std::size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern.isFixed(i)) {
+                m_lastFixed = i;
+                if (m_firstFixed == NPOS) {
+                    m_firstFixed = i;
+                }
+            }
+        }
+        m_single = m_firstFixed != NPOS;
+        return m_single;
+    }
+
+    template <typename Fn>
+    auto verify(const std::vector<KeyedAnchor>& anchors, std::uint16_t key,
+                std::span<const std::uint8_t> hay, std::size_t pos,
+                Fn& fn) const -> bool {
+        auto [first, last] =
+            std::ranges::equal_range(anchors, key, {}, &KeyedAnchor::key);
+        for (auto iter = first; iter != last; ++iter) {
+            const auto& pattern = m_patterns[iter->pattern];
+            if (pos < iter->offset) {
+                continue;
+            }
+            const std::size_t START = pos - iter->offset;
+            if (START + pattern.size() <= hay.size() &&
+                pattern.matchesAt(hay.data() + START) &&
+                !fn(START, static_cast<std::size_t>(iter->pattern))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Fn>
+    auto searchSingle(std::span<const std::uint8_t> hay, Fn& fn) const
+        -> bool {
+        const auto& pattern = m_patterns.front();
+        if (hay.size() < pattern.size()) {
+            return true;
+        }
+        const std::size_t LAST_START = hay.size() - pattern.size();
+        std::size_t pos = 0;
+#if defined(SCAN_SIMD_X86)
+        pos = detectSimdLevel() >= SimdLevel::AVX2
+                  ? searchAvx2(hay.data(), LAST_START, fn)
+                  : searchSse2(hay.data(), LAST_START, fn);
+        if (pos == NPOS) {
+            return false;
+        }
+#endif
+        const std::uint8_t FIRST = pattern.bytes[m_firstFixed];
+        while (pos <= LAST_START) {
+            // memchr is the portable vector prefilter for the tail
+            const void* hit = std::memchr(hay.data() + pos + m_firstFixed,
+                                          FIRST, LAST_START - pos + 1);
+            if (hit == nullptr) {
+                return true;
+            }
+            pos = static_cast<std::size_t>(
+                      static_cast<const std::uint8_t*>(hit) - hay.data()) -
+                  m_firstFixed;
+            if (pattern.matchesAt(hay.data() + pos) && !fn(pos, std::size_t{0})) {
+                return false;
+            }
+            ++pos;
+        }
+        return true;
+    }
+
+#if defined(SCAN_SIMD_X86)
+    // Both return the first start offset they did not examine, or NPOS
+    // once fn stopped the search
+    template <typename Fn>
+    SCAN_TARGET_AVX2 auto searchAvx2(const std::uint8_t* hay,
+                                     std::size_t lastStart, Fn& fn) const
+        -> std::size_t {
+        const auto& pattern = m_patterns.front();
+        const __m256i FIRST = _mm256_set1_epi8(
+            static_cast<char>(pattern.bytes[m_firstFixed]));
+        const __m256i LAST = _mm256_set1_epi8(
+            static_cast<char>(pattern.bytes[m_lastFixed]));
+        std::size_t pos = 0;
+        for (; pos + 31 <= lastStart; pos += 32) {
+            const __m256i AT_FIRST = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(hay + pos + m_firstFixed));
+            const __m256i AT_LAST = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(hay + pos + m_lastFixed));
+            auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(AT_FIRST, FIRST),
+                                 _mm256_cmpeq_epi8(AT_LAST, LAST))));
+            while (bits != 0) {
+                const std::size_t START = pos + std::countr_zero(bits);
+                if (pattern.matchesAt(hay + START) && !fn(START, std::size_t{0})) {
+                    return NPOS;
+                }
+                bits &= bits - 1;
+            }
+        }
+        return pos;
+    }
+
+    template <typename Fn>
+    auto searchSse2(const std::uint8_t* hay, std::size_t lastStart,
+                    Fn& fn) const -> std::size_t {
+        const auto& pattern = m_patterns.front();
+        const __m128i FIRST =
+            _mm_set1_epi8(static_cast<char>(pattern.bytes[m_firstFixed]));
+        const __m128i LAST =
+            _mm_set1_epi8(static_cast<char>(pattern.bytes[m_lastFixed]));
+        std::size_t pos = 0;
+        for (; pos + 15 <= lastStart; pos += 16) {
+            const __m128i AT_FIRST = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(hay + pos + m_firstFixed));
+            const __m128i AT_LAST = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(hay + pos + m_lastFixed));
+            auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(AT_FIRST, FIRST),
+                              _mm_cmpeq_epi8(AT_LAST, LAST))));
+            while (bits != 0) {
+                const std::size_t START = pos + std::countr_zero(bits);
+                if (pattern.matchesAt(hay + START) && !fn(START, std::size_t{0})) {
+                    return NPOS;
+                }
+                bits &= bits - 1;
+            }
+        }
+        return pos;
+    }
+#endif
+
+    std::vector<BytePattern> m_patterns;
+    std::vector<KeyedAnchor> m_pairs;  // sorted by key
+    std::vector<KeyedAnchor> m_bytes;  // single-byte anchors, sorted by key
+    std::vector<std::uint32_t> m_everywhere;  // no fully fixed byte to anchor
+    std::vector<std::uint64_t> m_pairFilter;  // one bit per anchor pair
+    std::array<std::uint64_t, 4> m_byteFilter{};
+    bool m_single{false};
+    std::size_t m_firstFixed{NPOS};
+    std::size_t m_lastFixed{NPOS};
+};
+
+}  // namespace scan
@@ -0,0 +1,716 @@
+/**
+ * @file pointer_scan.cppm
+ * @brief Pointer index and multi-level pointer path search (指针扫描)
+ *
+ * One parallel pass over the source regions records every aligned 8-byte
+ * word whose value lies inside a readable mapping, as (target, source)
+ * pairs sorted by target. Reverse searches then walk the index, not the
+ * target's memory: the pointers into [address - maxOffset, address] are a
+ * binary search away, level after level, until a source lies in a module
+ * image (a static base).
+ *
+ * Paths are kept relative to their module's load address, so after the
+ * target restarts they are checked again with one read per level instead
+ * of a new index.
+ */
+
+module;
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+export module scan.pointer_scan;
+
+import core.maps;
+import core.proc_mem;
+import scan.types;
+import utils.thread_pool;
+
+export namespace scan {
+
+/** @brief An aligned word at source whose value is target */
+struct PointerRecord {
+    std::uint64_t target{0};
+    std::uint64_t source{0};
+
+    auto operator<=>(const PointerRecord&) const = default;
+};
+
+/** @brief A file mapped into the target, by its lowest mapping */
+struct PointerModule {
+    std::string name;  ///< Path as in /proc/<pid>/maps
+    std::uint64_t base{0};
+};
+
+/**
+ * @class StaticModules
+ * @brief Module images of a target: the static bases of pointer paths
+ *
+ * Every mapping of a file belongs to its module, as does an anonymous
+ * mapping right behind one (the image's .bss). Pseudo files such as
+ * [heap] and [vdso] are not modules.
+ */
+class StaticModules {
+   public:
+    StaticModules() = default;
+
+    explicit StaticModules(std::span<const core::Region> regions) {
+        std::vector<core::Region> sorted(regions.begin(), regions.end());
+        std::ranges::sort(sorted, {}, [](const core::Region& region) {
+            return reinterpret_cast<std::uintptr_t>(region.start);
+        });
+        std::size_t previous = NO_MODULE;
+        std::uint64_t previousEnd = 0;
+        for (const auto& region : sorted) {
+            const auto BEGIN = reinterpret_cast<std::uint64_t>(region.start);
+            const auto END = BEGIN + region.size;
+            std::size_t module = NO_MODULE;
+            if (isModuleFile(region.filename)) {
+                module = indexOf(region.filename, BEGIN);
+            } else if (region.filename.empty() && BEGIN == previousEnd) {
+                module = previous;
+            }
+            if (module != NO_MODULE) {
+                m_ranges.push_back({BEGIN, END, module});
+            }
+            previous = module;
+            previousEnd = END;
+        }
+    }
+
+    [[nodiscard]] auto modules() const noexcept
+        -> std::span<const PointerModule> {
+        return m_modules;
+    }
+
+    /** @brief The module whose image holds address, if any */
+    [[nodiscard]] auto containing(std::uint64_t address) const noexcept
+        -> const PointerModule* {
+        auto iter = std::ranges::upper_bound(m_ranges, address, {},
+                                             &Range::begin);
+        if (iter == m_ranges.begin()) {
+            return nullptr;
+        }
+        --iter;
+        return address < iter->end ? &m_modules[iter->module] : nullptr;
+    }
+
+    [[nodiscard]] auto base(std::string_view name) const noexcept
+        -> std::optional<std::uint64_t> {
+        for (const auto& module : m_modules) {
+            if (module.name == name) {
+                return module.base;
+            }
+        }
+        return std::nullopt;
+    }
+
+   private:
+    static constexpr std::size_t NO_MODULE = static_cast<std::size_t>(-1);
+
+    struct Range {
+        std::uint64_t begin;
+        std::uint64_t end;
+        std::size_t module;
+    };
+
+    static auto isModuleFile(std::string_view name) -> bool {
+        return !name.empty() && name.front() != '[';
+    }
+
+    auto indexOf(const std::string& name, std::uint64_t begin) -> std::size_t {
+        for (std::size_t i = 0; i < m_modules.size(); ++i) {
+            if (m_modules[i].name == name) {
+                return i;
+            }
+        }
+        m_modules.push_back({.name = name, .base = begin});
+        return m_modules.size() - 1;
+    }
+
+    std::vector<PointerModule> m_modules;
+    std::vector<Range> m_ranges;  // ascending, non-overlapping
+};
+
+struct PointerIndexOptions {
+    /// Index sizes from which records live in an unlinked temp file
+    static constexpr std::size_t DEFAULT_FILE_BACKED_BYTES = 256UL << 20;
+
+    /// Regions whose words are indexed; targets are any readable mapping
+    core::RegionScanLevel sourceLevel{core::RegionScanLevel::ALL_RW};
+    std::size_t fileBackedBytes{DEFAULT_FILE_BACKED_BYTES};
+    std::string tempDir;  ///< Empty: $TMPDIR, else /tmp
+};
+
+namespace detail {
+
+// Records on the heap, or in a mapping of an already unlinked file
+class RecordStorage {
+   public:
+    RecordStorage() = default;
+    ~RecordStorage() { release(); }
+
+    RecordStorage(RecordStorage&& other) noexcept { *this = std::move(other); }
+    auto operator=(RecordStorage&& other) noexcept -> RecordStorage& {
+        if (this != &other) {
+            release();
+            m_heap = std::move(other.m_heap);
+            m_map = std::exchange(other.m_map, nullptr);
+            m_count = std::exchange(other.m_count, 0);
+        }
+        return *this;
+    }
+    RecordStorage(const RecordStorage&) = delete;
+    auto operator=(const RecordStorage&) -> RecordStorage& = delete;
+
+    [[nodiscard]] static auto onHeap(std::size_t count) -> RecordStorage {
+        RecordStorage storage;
+        storage.m_heap.resize(count);
+        storage.m_count = count;
+        return storage;
+    }
+
+    [[nodiscard]] static auto inTempFile(std::size_t count,
+                                         const std::string& dir)
+        -> std::expected<RecordStorage, std::string> {
+        RecordStorage storage;
+        if (count == 0) {
+            return storage;
+        }
+        std::string path = dir + "/pointer-index-XXXXXX";
+        const int FD = ::mkstemp(path.data());
+        if (FD < 0) {
+            return std::unexpected{std::format("mkstemp in {} failed: {}", dir,
+                                               std::strerror(errno))};
+        }
+        ::unlink(path.c_str());
+        const std::size_t BYTES = count * sizeof(PointerRecord);
+        void* map = MAP_FAILED;
+        if (::ftruncate(FD, static_cast<off_t>(BYTES)) == 0) {
+            map = ::mmap(nullptr, BYTES, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         FD, 0);
+        }
+        const int ERR = errno;
+        ::close(FD);
+        if (map == MAP_FAILED) {
+            return std::unexpected{std::format(
+                "mapping a {} byte index in {} failed: {}", BYTES, dir,
+                std::strerror(ERR))};
+        }
+        storage.m_map = map;
+        storage.m_count = count;
+        return storage;
+    }
+
+    [[nodiscard]] auto records() noexcept -> std::span<PointerRecord> {
+        return {m_map != nullptr ? static_cast<PointerRecord*>(m_map)
+                                 : m_heap.data(),
+                m_count};
+    }
+    [[nodiscard]] auto records() const noexcept
+        -> std::span<const PointerRecord> {
+        return {m_map != nullptr ? static_cast<const PointerRecord*>(m_map)
+                                 : m_heap.data(),
+                m_count};
+    }
+    [[nodiscard]] auto fileBacked() const noexcept -> bool {
+        return m_map != nullptr;
+    }
+
+   private:
+    void release() noexcept {
+        if (m_map != nullptr) {
+            ::munmap(m_map, m_count * sizeof(PointerRecord));
+            m_map = nullptr;
+        }
+        m_heap = {};
+        m_count = 0;
+    }
+
+    std::vector<PointerRecord> m_heap;
+    void* m_map{nullptr};
+    std::size_t m_count{0};
+};
+
+// Readable address ranges, for telling pointers from other words
+class TargetRanges {
+   public:
+    explicit TargetRanges(std::span<const core::Region> regions) {
+        for (const auto& region : regions) {
+            if (region.isReadable() && region.size > 0) {
+                const auto BEGIN = reinterpret_cast<std::uint64_t>(region.start);
+                m_ranges.emplace_back(BEGIN, BEGIN + region.size);
+            }
+        }
+        std::ranges::sort(m_ranges);
+        if (!m_ranges.empty()) {
+            m_low = m_ranges.front().first;
+            m_high = m_ranges.back().second;
+        }
+    }
+
+    [[nodiscard]] auto contains(std::uint64_t value) const noexcept -> bool {
+        // Most words are small numbers or zero; one compare rejects them
+        if (value < m_low || value >= m_high) {
+            return false;
+        }
+        auto iter = std::ranges::upper_bound(
+            m_ranges, value, {},
+            &std::pair<std::uint64_t, std::uint64_t>::first);
+        return iter != m_ranges.begin() && value < std::prev(iter)->second;
+    }
+
+   private:
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> m_ranges;
+    std::uint64_t m_low{0};
+    std::uint64_t m_high{0};
+};
+
+struct SourceChunk {
+    std::uint64_t begin;
+    std::size_t size;
+    bool lastOfRegion;
+};
+
+// Regions are split so workers share big ones; chunks stay word aligned
+constexpr std::size_t POINTER_CHUNK_BYTES = 16UL << 20;
+// One pread per block
+constexpr std::size_t POINTER_BLOCK_BYTES = 1UL << 20;
+constexpr std::size_t POINTER_PAGE = 4096;
+
+inline auto planSourceChunks(std::span<const core::Region> regions)
+    -> std::vector<SourceChunk> {
+    std::vector<SourceChunk> chunks;
+    for (const auto& region : regions) {
+        if (!region.isReadable() || region.size == 0) {
+            continue;
+        }
+        const auto BEGIN = reinterpret_cast<std::uint64_t>(region.start);
+        for (std::size_t offset = 0; offset < region.size;
+             offset += POINTER_CHUNK_BYTES) {
+            const std::size_t SIZE =
+                std::min(POINTER_CHUNK_BYTES, region.size - offset);
+            chunks.push_back({.begin = BEGIN + offset,
+                              .size = SIZE,
+                              .lastOfRegion = offset + SIZE >= region.size});
+        }
+    }
+    return chunks;
+}
+
+// Pointers in one chunk, sorted; unreadable pages are skipped
+inline void collectPointers(const SourceChunk& chunk,
+                            const core::ProcMemIO& reader,
+                            const TargetRanges& targets,
+                            std::vector<std::uint8_t>& buffer,
+                            std::vector<PointerRecord>& out,
+                            ScanControl* control) {
+    std::size_t offset = 0;
+    while (offset < chunk.size) {
+        if (control != nullptr && control->stopRequested()) {
+            return;
+        }
+        const std::size_t LEN =
+            std::min(POINTER_BLOCK_BYTES, chunk.size - offset);
+        buffer.resize(LEN);
+        const auto ADDRESS = chunk.begin + offset;
+        const std::size_t GOT =
+            reader.read(reinterpret_cast<void*>(ADDRESS), buffer).value_or(0);
+        for (std::size_t at = 0; at + sizeof(std::uint64_t) <= GOT;
+             at += sizeof(std::uint64_t)) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, buffer.data() + at, sizeof(word));
+            if (targets.contains(word)) {
+                out.push_back({.target = word, .source = ADDRESS + at});
+            }
+        }
+        // A short read stops at an unreadable page; carry on after it
+        const std::size_t ADVANCE =
+            GOT == LEN ? LEN
+                       : std::min(LEN, (GOT / POINTER_PAGE + 1) * POINTER_PAGE);
+        if (control != nullptr) {
+            control->addBytes(ADVANCE);
+        }
+        offset += ADVANCE;
+    }
+    std::ranges::sort(out);
+}
+
+}  // namespace detail
+
+/**
+ * @class PointerIndex
+ * @brief Sorted (target, source) pairs of one target at one moment
+ */
+class PointerIndex {
+   public:
+    PointerIndex() = default;
+
+    /**
+     * @brief Index the pointers in pid's source regions
+     * @param pool Pool to run on; nullptr uses utils::ThreadPool::shared()
+     * @param readers Per-worker readers as for runScanParallel
+     * @param control Optional progress and cancellation; a cancelled build
+     *        fails rather than leave holes in the index
+     */
+    [[nodiscard]] static auto build(pid_t pid,
+                                    const PointerIndexOptions& opts = {},
+                                    utils::ThreadPool* pool = nullptr,
+                                    core::ProcMemReaders* readers = nullptr,
+                                    ScanControl* control = nullptr)
+        -> std::expected<PointerIndex, std::string> {
+        auto allExp = core::readProcessMaps(pid, core::RegionScanLevel::ALL);
+        if (!allExp) {
+            return std::unexpected{std::format("readProcessMaps failed: {}",
+                                               allExp.error().message)};
+        }
+        const auto& ALL = *allExp;
+        std::vector<core::Region> sources;
+        if (opts.sourceLevel == core::RegionScanLevel::ALL) {
+            sources = ALL;
+        } else {
+            auto sourcesExp = core::readProcessMaps(pid, opts.sourceLevel);
+            if (!sourcesExp) {
+                return std::unexpected{std::format(
+                    "readProcessMaps failed: {}", sourcesExp.error().message)};
+            }
+            sources = std::move(*sourcesExp);
+        }
+
+        PointerIndex index;
+        index.m_modules = StaticModules{ALL};
+        const detail::TargetRanges TARGETS{ALL};
+        const auto CHUNKS = detail::planSourceChunks(sources);
+        if (control != nullptr) {
+            std::size_t bytes = 0;
+            std::size_t regions = 0;
+            for (const auto& chunk : CHUNKS) {
+                bytes += chunk.size;
+                regions += chunk.lastOfRegion ? 1 : 0;
+            }
+            control->start(bytes, regions, 0);
+        }
+
+        auto& workers = pool != nullptr ? *pool : utils::ThreadPool::shared();
+        core::ProcMemReaders localReaders;
+        if (readers == nullptr || !readers->covers(pid, workers.size())) {
+            localReaders.reset(pid, workers.size());
+            readers = &localReaders;
+        }
+        if (auto probe = readers->acquire(0); !probe) {
+            return std::unexpected{probe.error()};
+        }
+
+        std::vector<std::vector<PointerRecord>> runs(CHUNKS.size());
+        std::vector<std::vector<std::uint8_t>> buffers(workers.size());
+        std::atomic<bool> readerFailed{false};
+        workers.parallelFor(CHUNKS.size(), [&](std::size_t task,
+                                               std::size_t worker) {
+            auto readerExp = readers->acquire(worker);
+            if (!readerExp) {
+                readerFailed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            detail::collectPointers(CHUNKS[task], **readerExp, TARGETS,
+                                    buffers[worker], runs[task], control);
+            if (control != nullptr && CHUNKS[task].lastOfRegion) {
+                control->finishRegion();
+            }
+        });
+        buffers = {};
+        if (control != nullptr && control->stopRequested()) {
+            return std::unexpected{"pointer scan cancelled"};
+        }
+        if (readerFailed.load(std::memory_order_relaxed)) {
+            return std::unexpected{"pointer scan: a worker could not open "
+                                   "the target's memory"};
+        }
+
+        std::vector<std::size_t> bounds{0};
+        for (const auto& run : runs) {
+            bounds.push_back(bounds.back() + run.size());
+        }
+        const std::size_t COUNT = bounds.back();
+        if (COUNT * sizeof(PointerRecord) >= opts.fileBackedBytes) {
+            auto storage = detail::RecordStorage::inTempFile(
+                COUNT, opts.tempDir.empty() ? defaultTempDir() : opts.tempDir);
+            if (!storage) {
+                return std::unexpected{storage.error()};
+            }
+            index.m_storage = std::move(*storage);
+        } else {
+            index.m_storage = detail::RecordStorage::onHeap(COUNT);
+        }
+
+        auto records = index.m_storage.records();
+        workers.parallelFor(runs.size(), [&](std::size_t task, std::size_t) {
+            std::ranges::copy(runs[task], records.begin() +
+                                              static_cast<std::ptrdiff_t>(
+                                                  bounds[task]));
+            runs[task] = {};
+        });
+        mergeRuns(records, bounds, workers);
+        index.m_sourceBytes = 0;
+        for (const auto& chunk : CHUNKS) {
+            index.m_sourceBytes += chunk.size;
+        }
+        return index;
+    }
+
+    [[nodiscard]] auto records() const noexcept
+        -> std::span<const PointerRecord> {
+        return m_storage.records();
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return records().size();
+    }
+
+    /** @brief Whether records live in a temp file mapping, not the heap */
+    [[nodiscard]] auto fileBacked() const noexcept -> bool {
+        return m_storage.fileBacked();
+    }
+
+    /** @brief Bytes of source regions the index was built from */
+    [[nodiscard]] auto sourceBytes() const noexcept -> std::size_t {
+        return m_sourceBytes;
+    }
+
+    [[nodiscard]] auto modules() const noexcept -> const StaticModules& {
+        return m_modules;
+    }
+
+    /** @brief Records whose target lies in [low, high], by target */
+    [[nodiscard]] auto pointersInto(std::uint64_t low,
+                                    std::uint64_t high) const noexcept
+        -> std::span<const PointerRecord> {
+        const auto ALL = records();
+        auto first = std::ranges::lower_bound(ALL, low, {},
+                                              &PointerRecord::target);
+        auto last = std::ranges::upper_bound(first, ALL.end(), high, {},
+                                             &PointerRecord::target);
+        return {first, last};
+    }
+
+   private:
+    static auto defaultTempDir() -> std::string {
+        const char* tmp = ::getenv("TMPDIR");
+        return (tmp != nullptr && *tmp != '\0') ? tmp : "/tmp";
+    }
+
+    // Sorted runs at bounds, merged pairwise; pairs of a round in parallel
+    static void mergeRuns(std::span<PointerRecord> records,
+                          std::vector<std::size_t> bounds,
+                          utils::ThreadPool& workers) {
+        while (bounds.size() > 2) {
+            const std::size_t PAIRS = (bounds.size() - 1) / 2;
+            workers.parallelFor(PAIRS, [&](std::size_t pair, std::size_t) {
+                const auto BEGIN = records.begin();
+                std::inplace_merge(
+                    BEGIN + static_cast<std::ptrdiff_t>(bounds[2 * pair]),
+                    BEGIN + static_cast<std::ptrdiff_t>(bounds[2 * pair + 1]),
+                    BEGIN + static_cast<std::ptrdiff_t>(bounds[2 * pair + 2]));
+            });
+            std::vector<std::size_t> next;
+            for (std::size_t i = 0; i < bounds.size(); i += 2) {
+                next.push_back(bounds[i]);
+            }
+            if (next.back() != bounds.back()) {
+                next.push_back(bounds.back());
+            }
+            bounds = std::move(next);
+        }
+    }
+
+    detail::RecordStorage m_storage;
+    StaticModules m_modules;
+    std::size_t m_sourceBytes{0};
+};
+
+/**
+ * @brief module + moduleOffset, then one dereference per offset
+ *
+ * The root word at module base + moduleOffset is read, offsets[0] added,
+ * that word read, offsets[1] added, and so on; the last sum is the
+ * address the path leads to.
+ */
+struct PointerPath {
+    std::string module;
+    std::uint64_t moduleOffset{0};
+    std::vector<std::uint64_t> offsets;  ///< Root first; one per level
+
+    auto operator==(const PointerPath&) const -> bool = default;
+
+    /** @brief e.g. "libgame.so+0x1a2b0 -> 0x18 -> 0x40" */
+    [[nodiscard]] auto toString() const -> std::string {
+        const auto SLASH = module.rfind('/');
+        std::string text = std::format(
+            "{}+0x{:x}",
+            SLASH == std::string::npos ? module : module.substr(SLASH + 1),
+            moduleOffset);
+        for (const auto OFFSET : offsets) {
+            text += std::format(" -> 0x{:x}", OFFSET);
+        }
+        return text;
+    }
+};
+
+struct PointerSearchOptions {
+    std::size_t maxDepth{5};         ///< Dereferences per path
+    std::uint64_t maxOffset{0x1000};  ///< Largest offset after one
+    std::size_t maxResults{10000};
+    /// Addresses explored at most; wide searches stop early beyond it
+    std::size_t maxVisited{4'000'000};
+};
+
+struct PointerSearchResult {
+    std::vector<PointerPath> paths;  ///< Shortest first
+    bool truncated{false};           ///< A limit stopped the search
+};
+
+/**
+ * @brief Static pointer paths leading to target, found in index
+ *
+ * Breadth first, so shorter paths come first. Each address is expanded
+ * once, at its shallowest depth: a pointer reached along two routes
+ * yields the paths through the first one only.
+ */
+[[nodiscard]] inline auto findPointerPaths(const PointerIndex& index,
+                                           std::uint64_t target,
+                                           const PointerSearchOptions& opts)
+    -> PointerSearchResult {
+    struct Node {
+        std::uint64_t address;
+        std::size_t parent;      // node this one's word points into
+        std::uint64_t offset;    // parent address - this word's value
+    };
+    constexpr std::size_t ROOT = static_cast<std::size_t>(-1);
+
+    PointerSearchResult result;
+    std::vector<Node> nodes{{.address = target, .parent = ROOT, .offset = 0}};
+    std::unordered_set<std::uint64_t> visited{target};
+    std::vector<std::size_t> frontier{0};
+
+    auto emit = [&](std::size_t leaf, const PointerModule& module) {
+        PointerPath path{.module = module.name,
+                         .moduleOffset = nodes[leaf].address - module.base};
+        for (std::size_t at = leaf; nodes[at].parent != ROOT;
+             at = nodes[at].parent) {
+            path.offsets.push_back(nodes[at].offset);
+        }
+        result.paths.push_back(std::move(path));
+    };
+
+    for (std::size_t depth = 1; depth <= opts.maxDepth && !frontier.empty();
+         ++depth) {
+        std::vector<std::size_t> next;
+        for (const auto NODE : frontier) {
+            const auto ADDRESS = nodes[NODE].address;
+            const auto LOW = ADDRESS >= opts.maxOffset ? ADDRESS - opts.maxOffset
+                                                       : 0;
+            for (const auto& record : index.pointersInto(LOW, ADDRESS)) {
+                if (!visited.insert(record.source).second) {
+                    continue;
+                }
+                if (visited.size() > opts.maxVisited) {
+                    result.truncated = true;
+                    return result;
+                }
+                nodes.push_back({.address = record.source,
+                                 .parent = NODE,
+                                 .offset = ADDRESS - record.target});
+                if (const auto* module =
+                        index.modules().containing(record.source)) {
+                    emit(nodes.size() - 1, *module);
+                    if (result.paths.size() >= opts.maxResults) {
+                        result.truncated = true;
+                        return result;
+                    }
+                } else {
+                    next.push_back(nodes.size() - 1);
+                }
+            }
+        }
+        frontier = std::move(next);
+    }
+    return result;
+}
+
+/**
+ * @brief Follow path in a live target
+ * @return The address it leads to, or nullopt if its module is not
+ *         loaded or a word on the way cannot be read
+ */
+[[nodiscard]] inline auto resolvePointerPath(const PointerPath& path,
+                                             const StaticModules& modules,
+                                             const core::ProcMemIO& reader)
+    -> std::optional<std::uint64_t> {
+    const auto BASE = modules.base(path.module);
+    if (!BASE) {
+        return std::nullopt;
+    }
+    std::uint64_t address = *BASE + path.moduleOffset;
+    for (const auto OFFSET : path.offsets) {
+        std::uint64_t word = 0;
+        auto got = reader.read(reinterpret_cast<void*>(address),
+                               reinterpret_cast<std::uint8_t*>(&word),
+                               sizeof(word));
+        if (!got || *got != sizeof(word)) {
+            return std::nullopt;
+        }
+        address = word + OFFSET;
+    }
+    return address;
+}
+
+/**
+ * @brief Keep the paths that lead to target in pid now
+ *
+ * Meant for a restarted target: module bases come from its current maps,
+ * and each path costs one read per level.
+ */
+[[nodiscard]] inline auto rescanPointerPaths(pid_t pid,
+                                             std::span<const PointerPath> paths,
+                                             std::uint64_t target)
+    -> std::expected<std::vector<PointerPath>, std::string> {
+    auto regions = core::readProcessMaps(pid, core::RegionScanLevel::ALL);
+    if (!regions) {
+        return std::unexpected{std::format("readProcessMaps failed: {}",
+                                           regions.error().message)};
+    }
+    const StaticModules MODULES{*regions};
+    core::ProcMemIO reader{pid};
+    if (auto err = reader.open(); !err) {
+        return std::unexpected{err.error()};
+    }
+    std::vector<PointerPath> kept;
+    for (const auto& path : paths) {
+        if (resolvePointerPath(path, MODULES, reader) == target) {
+            kept.push_back(path);
+        }
+    }
+    return kept;
+}
+
+}  // namespace scan
@@ -8,7 +8,6 @@ module;
 #include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <optional>
 #include <span>
 
 export module scan.routine;
@@ -24,8 +23,8 @@ export namespace scan {
  */
 struct ScanContext {
     std::span<const std::uint8_t> memory;        ///< Current memory bytes
-    std::optional<Value> oldValue;               ///< Previous value (for delta matches)
-    std::optional<UserValue> userValue;          ///< User target value (for comparison)
+    const Value* oldValue{nullptr};              ///< Previous value (for delta matches)
+    const UserValue* userValue{nullptr};         ///< User target value (for comparison)
     MatchFlags requiredFlag{MatchFlags::EMPTY};  ///< Required type flag
     bool reverseEndianness{false};               ///< Reverse byte order flag
 
@@ -34,11 +33,11 @@ struct ScanContext {
     }
 
     [[nodiscard]] auto hasUserValue() const noexcept -> bool {
-        return userValue.has_value();
+        return userValue != nullptr;
     }
 
     [[nodiscard]] auto hasOldValue() const noexcept -> bool {
-        return oldValue.has_value();
+        return oldValue != nullptr;
     }
 };
 
@@ -74,22 +73,23 @@ using ScanRoutine = std::function<ScanResult(const ScanContext& ctx)>;
     return [](const ScanContext&) -> ScanResult { return ScanResult::noMatch(); };
 }
 
+/**
+ * @brief Build a context that borrows the given values
+ *
+ * The context only stores pointers, so oldValue and userValue must outlive
+ * every routine call made with it.
+ */
 [[nodiscard]] inline auto makeScanContext(
     std::span<const std::uint8_t> memory, const Value* oldValue,
     const UserValue* userValue, MatchFlags requiredFlag,
     bool reverseEndianness) -> ScanContext {
-    ScanContext ctx{
+    return ScanContext{
         .memory = memory,
+        .oldValue = oldValue,
+        .userValue = userValue,
         .requiredFlag = requiredFlag,
         .reverseEndianness = reverseEndianness,
     };
-    if (oldValue != nullptr) {
-        ctx.oldValue = *oldValue;
-    }
-    if (userValue != nullptr) {
-        ctx.userValue = *userValue;
-    }
-    return ctx;
 }
 
 }  // namespace scan
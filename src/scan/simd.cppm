@@ -0,0 +1,698 @@
+/**
+ * @file simd.cppm
+ * @brief Vectorised numeric comparisons producing per-offset match bitmasks
+ *
+ * Each vector load covers several candidates spaced sizeof(T) apart; a load
+ * is issued for every in-element shift that is a multiple of the scan step,
+ * so a byte-step int32 scan compares 4 x lanes offsets per iteration. Bits
+ * are written at the candidate byte offset, i.e. bit k of word w marks
+ * offset 64 * w + k. The ISA is chosen at runtime; the tail and any
+ * unsupported configuration fall back to the scalar predicate, which is
+ * also the reference the vector paths must agree with.
+ */
+
+module;
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_SIMD_X86 1
+#define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#define SCAN_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define SCAN_SIMD_NEON 1
+#endif
+
+export module scan.simd;
+
+import scan.types;
+import scan.numeric;
+import utils.read_helpers;
+
+export namespace scan {
+
+/** @brief Instruction set used by the vector comparison kernels */
+enum class SimdLevel : std::uint8_t {
+    SCALAR,
+    NEON,
+    AVX2,
+    AVX512,
+};
+
+[[nodiscard]] constexpr auto simdLevelName(SimdLevel level) noexcept
+    -> const char* {
+    switch (level) {
+        case SimdLevel::NEON:
+            return "neon";
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * @brief Best instruction set supported by the running CPU (cached)
+ */
+[[nodiscard]] inline auto detectSimdLevel() noexcept -> SimdLevel {
+    static const SimdLevel LEVEL = [] {
+#if defined(SCAN_SIMD_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::SCALAR;
+#elif defined(SCAN_SIMD_NEON)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }();
+    return LEVEL;
+}
+
+/** @brief Types with vector kernels */
+template <typename T>
+inline constexpr bool SIMD_COMPARABLE =
+    std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/** @brief Match types with vector kernels */
+[[nodiscard]] constexpr auto isSimdMatch(ScanMatchType matchType) noexcept
+    -> bool {
+    switch (matchType) {
+        case ScanMatchType::MATCH_EQUAL_TO:
+        case ScanMatchType::MATCH_NOT_EQUAL_TO:
+        case ScanMatchType::MATCH_GREATER_THAN:
+        case ScanMatchType::MATCH_LESS_THAN:
+        case ScanMatchType::MATCH_RANGE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Scalar reference predicate for a user-value comparison
+ *
+ * For MATCH_RANGE, low/high must already be ordered.
+ */
+template <typename T, ScanMatchType MATCH>
+[[nodiscard]] constexpr auto evalPredicate(T memv, T low, T high) noexcept
+    -> bool {
+    if constexpr (MATCH == ScanMatchType::MATCH_ANY) {
+        return true;
+    } else if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+        return numericEqual<T>(memv, low);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_NOT_EQUAL_TO) {
+        return !numericEqual<T>(memv, low);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_GREATER_THAN) {
+        return numericGreater<T>(memv, low);
+    } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+        return numericLess<T>(memv, low);
+    } else {
+        static_assert(MATCH == ScanMatchType::MATCH_RANGE);
+        return numericInRange<T>(memv, low, high);
+    }
+}
+
+/** @brief Number of 64-bit mask words needed for a block of the given size */
+[[nodiscard]] constexpr auto maskWordsFor(std::size_t bytes) noexcept
+    -> std::size_t {
+    return (bytes + 63) / 64;
+}
+
+}  // namespace scan
+
+namespace scan::simd_detail {
+
+constexpr std::size_t BITS_PER_WORD = 64;
+
+inline void setMaskBit(std::uint64_t* mask, std::size_t offset) noexcept {
+    mask[offset / BITS_PER_WORD] |= std::uint64_t{1}
+                                    << (offset % BITS_PER_WORD);
+}
+
+/** @brief Spread lane bits (stride = element width) into the offset mask */
+inline auto scatterLaneBits(std::uint64_t* mask, std::size_t firstOffset,
+                            std::uint64_t laneBits,
+                            std::size_t width) noexcept -> std::size_t {
+    const auto COUNT = static_cast<std::size_t>(std::popcount(laneBits));
+    while (laneBits != 0) {
+        const auto LANE = static_cast<std::size_t>(std::countr_zero(laneBits));
+        setMaskBit(mask, firstOffset + LANE * width);
+        laneBits &= laneBits - 1;
+    }
+    return COUNT;
+}
+
+template <typename T, ScanMatchType MATCH>
+auto scalarRange(const std::uint8_t* data, std::size_t size, std::size_t from,
+                 std::size_t step, T low, T high,
+                 std::uint64_t* mask) noexcept -> std::size_t {
+    if (size < sizeof(T)) {
+        return 0;
+    }
+    std::size_t matches = 0;
+    for (std::size_t offset = from; offset <= size - sizeof(T);
+         offset += step) {
+        T memv;
+        std::memcpy(&memv, data + offset, sizeof(T));
+        if (evalPredicate<T, MATCH>(memv, low, high)) {
+            setMaskBit(mask, offset);
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Shared driver: walk the block one vector span at a time
+ *
+ * LaneFn(ptr) must return the lane bits for LANES elements loaded at ptr.
+ * The driver itself carries no ISA attribute; it is always inlined into the
+ * target-specific entry points below.
+ */
+template <typename T, std::size_t LANES, typename LaneFn>
+[[gnu::always_inline]] inline auto vectorDriver(
+    const std::uint8_t* data, std::size_t size, std::size_t step,
+    std::uint64_t* mask, std::size_t& matches, LaneFn&& laneFn) noexcept
+    -> std::size_t {
+    constexpr std::size_t WIDTH = sizeof(T);
+    constexpr std::size_t SPAN = WIDTH * LANES;
+    std::size_t base = 0;
+    // The load at the largest shift reads up to base + WIDTH - step + SPAN.
+    while (base + SPAN + WIDTH <= size + step) {
+        for (std::size_t shift = 0; shift < WIDTH; shift += step) {
+            matches += scatterLaneBits(mask, base + shift,
+                                       laneFn(data + base + shift), WIDTH);
+        }
+        base += SPAN;
+    }
+    return base;
+}
+
+#if defined(SCAN_SIMD_X86)
+
+template <typename T, ScanMatchType MATCH>
+SCAN_TARGET_AVX2 auto avx2Compare(const std::uint8_t* data, std::size_t size,
+                                  std::size_t step, T low, T high,
+                                  std::uint64_t* mask) noexcept
+    -> std::size_t {
+    std::size_t matches = 0;
+    std::size_t tail = 0;
+    if constexpr (std::is_integral_v<T>) {
+        constexpr std::size_t LANES = 32 / sizeof(T);
+        const __m256i VLOW = sizeof(T) == 4
+                                 ? _mm256_set1_epi32(static_cast<int>(low))
+                                 : _mm256_set1_epi64x(low);
+        const __m256i VHIGH = sizeof(T) == 4
+                                  ? _mm256_set1_epi32(static_cast<int>(high))
+                                  : _mm256_set1_epi64x(high);
+        auto movemask = [](__m256i vec) SCAN_TARGET_AVX2 -> std::uint64_t {
+            if constexpr (sizeof(T) == 4) {
+                return static_cast<std::uint32_t>(
+                    _mm256_movemask_ps(_mm256_castsi256_ps(vec)));
+            } else {
+                return static_cast<std::uint32_t>(
+                    _mm256_movemask_pd(_mm256_castsi256_pd(vec)));
+            }
+        };
+        auto cmpEq = [](__m256i lhs, __m256i rhs) SCAN_TARGET_AVX2 {
+            if constexpr (sizeof(T) == 4) {
+                return _mm256_cmpeq_epi32(lhs, rhs);
+            } else {
+                return _mm256_cmpeq_epi64(lhs, rhs);
+            }
+        };
+        auto cmpGt = [](__m256i lhs, __m256i rhs) SCAN_TARGET_AVX2 {
+            if constexpr (sizeof(T) == 4) {
+                return _mm256_cmpgt_epi32(lhs, rhs);
+            } else {
+                return _mm256_cmpgt_epi64(lhs, rhs);
+            }
+        };
+        constexpr std::uint64_t ALL = (std::uint64_t{1} << LANES) - 1;
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) SCAN_TARGET_AVX2 -> std::uint64_t {
+                const __m256i VEC = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(ptr));
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return movemask(cmpEq(VEC, VLOW));
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~movemask(cmpEq(VEC, VLOW)) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return movemask(cmpGt(VEC, VLOW));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return movemask(cmpGt(VLOW, VEC));
+                } else {
+                    const __m256i OUTSIDE =
+                        _mm256_or_si256(cmpGt(VLOW, VEC), cmpGt(VEC, VHIGH));
+                    return ~movemask(OUTSIDE) & ALL;
+                }
+            });
+    } else if constexpr (std::is_same_v<T, float>) {
+        constexpr std::size_t LANES = 8;
+        constexpr std::uint64_t ALL = 0xFF;
+        const __m256 SIGN_OFF =
+            _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 ONE = _mm256_set1_ps(1.0F);
+        const __m256 ABS_TOL = _mm256_set1_ps(absTol<float>());
+        const __m256 REL_TOL = _mm256_set1_ps(relTol<float>());
+        const __m256 VLOW = _mm256_set1_ps(low);
+        const __m256 VABS_LOW = _mm256_and_ps(VLOW, SIGN_OFF);
+        const __m256 RANGE_LOW = _mm256_set1_ps(low - absTol<float>());
+        const __m256 RANGE_HIGH = _mm256_set1_ps(high + absTol<float>());
+        auto almostEq = [&](__m256 vec) SCAN_TARGET_AVX2 {
+            const __m256 DIFF =
+                _mm256_and_ps(_mm256_sub_ps(vec, VLOW), SIGN_OFF);
+            const __m256 SCALE = _mm256_max_ps(
+                ONE, _mm256_max_ps(_mm256_and_ps(vec, SIGN_OFF), VABS_LOW));
+            const __m256 TOL =
+                _mm256_max_ps(ABS_TOL, _mm256_mul_ps(REL_TOL, SCALE));
+            return _mm256_cmp_ps(DIFF, TOL, _CMP_LE_OQ);
+        };
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) SCAN_TARGET_AVX2 -> std::uint64_t {
+                const __m256 VEC =
+                    _mm256_loadu_ps(reinterpret_cast<const float*>(ptr));
+                __m256 hit;
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    hit = almostEq(VEC);
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~static_cast<std::uint64_t>(
+                               _mm256_movemask_ps(almostEq(VEC))) &
+                           ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    hit = _mm256_andnot_ps(almostEq(VEC),
+                                           _mm256_cmp_ps(VEC, VLOW, _CMP_GT_OQ));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    hit = _mm256_andnot_ps(almostEq(VEC),
+                                           _mm256_cmp_ps(VEC, VLOW, _CMP_LT_OQ));
+                } else {
+                    hit = _mm256_and_ps(
+                        _mm256_cmp_ps(VEC, RANGE_LOW, _CMP_GE_OQ),
+                        _mm256_cmp_ps(VEC, RANGE_HIGH, _CMP_LE_OQ));
+                }
+                return static_cast<std::uint64_t>(_mm256_movemask_ps(hit));
+            });
+    } else {
+        constexpr std::size_t LANES = 4;
+        constexpr std::uint64_t ALL = 0xF;
+        const __m256d SIGN_OFF = _mm256_castsi256_pd(
+            _mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        const __m256d ONE = _mm256_set1_pd(1.0);
+        const __m256d ABS_TOL = _mm256_set1_pd(absTol<double>());
+        const __m256d REL_TOL = _mm256_set1_pd(relTol<double>());
+        const __m256d VLOW = _mm256_set1_pd(low);
+        const __m256d VABS_LOW = _mm256_and_pd(VLOW, SIGN_OFF);
+        const __m256d RANGE_LOW = _mm256_set1_pd(low - absTol<double>());
+        const __m256d RANGE_HIGH = _mm256_set1_pd(high + absTol<double>());
+        auto almostEq = [&](__m256d vec) SCAN_TARGET_AVX2 {
+            const __m256d DIFF =
+                _mm256_and_pd(_mm256_sub_pd(vec, VLOW), SIGN_OFF);
+            const __m256d SCALE = _mm256_max_pd(
+                ONE, _mm256_max_pd(_mm256_and_pd(vec, SIGN_OFF), VABS_LOW));
+            const __m256d TOL =
+                _mm256_max_pd(ABS_TOL, _mm256_mul_pd(REL_TOL, SCALE));
+            return _mm256_cmp_pd(DIFF, TOL, _CMP_LE_OQ);
+        };
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) SCAN_TARGET_AVX2 -> std::uint64_t {
+                const __m256d VEC =
+                    _mm256_loadu_pd(reinterpret_cast<const double*>(ptr));
+                __m256d hit;
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    hit = almostEq(VEC);
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~static_cast<std::uint64_t>(
+                               _mm256_movemask_pd(almostEq(VEC))) &
+                           ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    hit = _mm256_andnot_pd(almostEq(VEC),
+                                           _mm256_cmp_pd(VEC, VLOW, _CMP_GT_OQ));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    hit = _mm256_andnot_pd(almostEq(VEC),
+                                           _mm256_cmp_pd(VEC, VLOW, _CMP_LT_OQ));
+                } else {
+                    hit = _mm256_and_pd(
+                        _mm256_cmp_pd(VEC, RANGE_LOW, _CMP_GE_OQ),
+                        _mm256_cmp_pd(VEC, RANGE_HIGH, _CMP_LE_OQ));
+                }
+                return static_cast<std::uint64_t>(_mm256_movemask_pd(hit));
+            });
+    }
+    return matches +
+           scalarRange<T, MATCH>(data, size, tail, step, low, high, mask);
+}
+
+template <typename T, ScanMatchType MATCH>
+SCAN_TARGET_AVX512 auto avx512Compare(const std::uint8_t* data,
+                                      std::size_t size, std::size_t step,
+                                      T low, T high,
+                                      std::uint64_t* mask) noexcept
+    -> std::size_t {
+    std::size_t matches = 0;
+    std::size_t tail = 0;
+    if constexpr (std::is_integral_v<T>) {
+        constexpr std::size_t LANES = 64 / sizeof(T);
+        constexpr std::uint64_t ALL = (std::uint64_t{1} << LANES) - 1;
+        const __m512i VLOW = sizeof(T) == 4
+                                 ? _mm512_set1_epi32(static_cast<int>(low))
+                                 : _mm512_set1_epi64(low);
+        const __m512i VHIGH = sizeof(T) == 4
+                                  ? _mm512_set1_epi32(static_cast<int>(high))
+                                  : _mm512_set1_epi64(high);
+        auto cmp = [](__m512i lhs, __m512i rhs,
+                      auto predicate) SCAN_TARGET_AVX512 -> std::uint64_t {
+            if constexpr (sizeof(T) == 4) {
+                return _mm512_cmp_epi32_mask(lhs, rhs,
+                                             decltype(predicate)::value);
+            } else {
+                return _mm512_cmp_epi64_mask(lhs, rhs,
+                                             decltype(predicate)::value);
+            }
+        };
+        using EQ = std::integral_constant<int, _MM_CMPINT_EQ>;
+        using NE = std::integral_constant<int, _MM_CMPINT_NE>;
+        using LT = std::integral_constant<int, _MM_CMPINT_LT>;
+        using LE = std::integral_constant<int, _MM_CMPINT_LE>;
+        using NLT = std::integral_constant<int, _MM_CMPINT_NLT>;
+        using NLE = std::integral_constant<int, _MM_CMPINT_NLE>;
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) SCAN_TARGET_AVX512 -> std::uint64_t {
+                const __m512i VEC = _mm512_loadu_si512(ptr);
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return cmp(VEC, VLOW, EQ{});
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return cmp(VEC, VLOW, NE{}) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return cmp(VEC, VLOW, NLE{});
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return cmp(VEC, VLOW, LT{});
+                } else {
+                    return cmp(VEC, VLOW, NLT{}) & cmp(VEC, VHIGH, LE{});
+                }
+            });
+    } else if constexpr (std::is_same_v<T, float>) {
+        constexpr std::size_t LANES = 16;
+        constexpr std::uint64_t ALL = 0xFFFF;
+        const __m512 ONE = _mm512_set1_ps(1.0F);
+        const __m512 ABS_TOL = _mm512_set1_ps(absTol<float>());
+        const __m512 REL_TOL = _mm512_set1_ps(relTol<float>());
+        const __m512 VLOW = _mm512_set1_ps(low);
+        const __m512 VABS_LOW = _mm512_abs_ps(VLOW);
+        const __m512 RANGE_LOW = _mm512_set1_ps(low - absTol<float>());
+        const __m512 RANGE_HIGH = _mm512_set1_ps(high + absTol<float>());
+        auto almostEq = [&](__m512 vec) SCAN_TARGET_AVX512 -> std::uint64_t {
+            const __m512 DIFF = _mm512_abs_ps(_mm512_sub_ps(vec, VLOW));
+            const __m512 SCALE =
+                _mm512_max_ps(ONE, _mm512_max_ps(_mm512_abs_ps(vec), VABS_LOW));
+            const __m512 TOL =
+                _mm512_max_ps(ABS_TOL, _mm512_mul_ps(REL_TOL, SCALE));
+            return _mm512_cmp_ps_mask(DIFF, TOL, _CMP_LE_OQ);
+        };
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) SCAN_TARGET_AVX512 -> std::uint64_t {
+                const __m512 VEC = _mm512_loadu_ps(ptr);
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return almostEq(VEC);
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~almostEq(VEC) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return _mm512_cmp_ps_mask(VEC, VLOW, _CMP_GT_OQ) &
+                           ~almostEq(VEC);
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return _mm512_cmp_ps_mask(VEC, VLOW, _CMP_LT_OQ) &
+                           ~almostEq(VEC);
+                } else {
+                    return _mm512_cmp_ps_mask(VEC, RANGE_LOW, _CMP_GE_OQ) &
+                           _mm512_cmp_ps_mask(VEC, RANGE_HIGH, _CMP_LE_OQ);
+                }
+            });
+    } else {
+        constexpr std::size_t LANES = 8;
+        constexpr std::uint64_t ALL = 0xFF;
+        const __m512d ONE = _mm512_set1_pd(1.0);
+        const __m512d ABS_TOL = _mm512_set1_pd(absTol<double>());
+        const __m512d REL_TOL = _mm512_set1_pd(relTol<double>());
+        const __m512d VLOW = _mm512_set1_pd(low);
+        const __m512d VABS_LOW = _mm512_abs_pd(VLOW);
+        const __m512d RANGE_LOW = _mm512_set1_pd(low - absTol<double>());
+        const __m512d RANGE_HIGH = _mm512_set1_pd(high + absTol<double>());
+        auto almostEq = [&](__m512d vec) SCAN_TARGET_AVX512 -> std::uint64_t {
+            const __m512d DIFF = _mm512_abs_pd(_mm512_sub_pd(vec, VLOW));
+            const __m512d SCALE =
+                _mm512_max_pd(ONE, _mm512_max_pd(_mm512_abs_pd(vec), VABS_LOW));
+            const __m512d TOL =
+                _mm512_max_pd(ABS_TOL, _mm512_mul_pd(REL_TOL, SCALE));
+            return _mm512_cmp_pd_mask(DIFF, TOL, _CMP_LE_OQ);
+        };
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) SCAN_TARGET_AVX512 -> std::uint64_t {
+                const __m512d VEC = _mm512_loadu_pd(ptr);
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return almostEq(VEC);
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~almostEq(VEC) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return _mm512_cmp_pd_mask(VEC, VLOW, _CMP_GT_OQ) &
+                           ~almostEq(VEC);
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return _mm512_cmp_pd_mask(VEC, VLOW, _CMP_LT_OQ) &
+                           ~almostEq(VEC);
+                } else {
+                    return _mm512_cmp_pd_mask(VEC, RANGE_LOW, _CMP_GE_OQ) &
+                           _mm512_cmp_pd_mask(VEC, RANGE_HIGH, _CMP_LE_OQ);
+                }
+            });
+    }
+    return matches +
+           scalarRange<T, MATCH>(data, size, tail, step, low, high, mask);
+}
+
+#endif  // SCAN_SIMD_X86
+
+#if defined(SCAN_SIMD_NEON)
+
+inline auto neonMask(uint32x4_t vec) noexcept -> std::uint64_t {
+    const uint32x4_t BITS = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(vec, BITS));
+}
+
+inline auto neonMask(uint64x2_t vec) noexcept -> std::uint64_t {
+    const uint64x2_t BITS = {1, 2};
+    return vaddvq_u64(vandq_u64(vec, BITS));
+}
+
+template <typename T, ScanMatchType MATCH>
+auto neonCompare(const std::uint8_t* data, std::size_t size, std::size_t step,
+                 T low, T high, std::uint64_t* mask) noexcept -> std::size_t {
+    std::size_t matches = 0;
+    constexpr std::size_t LANES = 16 / sizeof(T);
+    constexpr std::uint64_t ALL = (std::uint64_t{1} << LANES) - 1;
+    std::size_t tail = 0;
+    if constexpr (std::is_same_v<T, std::int32_t>) {
+        const int32x4_t VLOW = vdupq_n_s32(low);
+        const int32x4_t VHIGH = vdupq_n_s32(high);
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) -> std::uint64_t {
+                const int32x4_t VEC = vreinterpretq_s32_u8(vld1q_u8(ptr));
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return neonMask(vceqq_s32(VEC, VLOW));
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~neonMask(vceqq_s32(VEC, VLOW)) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return neonMask(vcgtq_s32(VEC, VLOW));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return neonMask(vcltq_s32(VEC, VLOW));
+                } else {
+                    return neonMask(vandq_u32(vcgeq_s32(VEC, VLOW),
+                                              vcleq_s32(VEC, VHIGH)));
+                }
+            });
+    } else if constexpr (std::is_same_v<T, std::int64_t>) {
+        const int64x2_t VLOW = vdupq_n_s64(low);
+        const int64x2_t VHIGH = vdupq_n_s64(high);
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) -> std::uint64_t {
+                const int64x2_t VEC = vreinterpretq_s64_u8(vld1q_u8(ptr));
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return neonMask(vceqq_s64(VEC, VLOW));
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~neonMask(vceqq_s64(VEC, VLOW)) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return neonMask(vcgtq_s64(VEC, VLOW));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return neonMask(vcltq_s64(VEC, VLOW));
+                } else {
+                    return neonMask(vandq_u64(vcgeq_s64(VEC, VLOW),
+                                              vcleq_s64(VEC, VHIGH)));
+                }
+            });
+    } else if constexpr (std::is_same_v<T, float>) {
+        const float32x4_t ONE = vdupq_n_f32(1.0F);
+        const float32x4_t ABS_TOL = vdupq_n_f32(absTol<float>());
+        const float32x4_t REL_TOL = vdupq_n_f32(relTol<float>());
+        const float32x4_t VLOW = vdupq_n_f32(low);
+        const float32x4_t VABS_LOW = vabsq_f32(VLOW);
+        const float32x4_t RANGE_LOW = vdupq_n_f32(low - absTol<float>());
+        const float32x4_t RANGE_HIGH = vdupq_n_f32(high + absTol<float>());
+        auto almostEq = [&](float32x4_t vec) {
+            const float32x4_t SCALE =
+                vmaxq_f32(ONE, vmaxq_f32(vabsq_f32(vec), VABS_LOW));
+            const float32x4_t TOL = vmaxq_f32(ABS_TOL, vmulq_f32(REL_TOL, SCALE));
+            return vcleq_f32(vabdq_f32(vec, VLOW), TOL);
+        };
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) -> std::uint64_t {
+                const float32x4_t VEC = vreinterpretq_f32_u8(vld1q_u8(ptr));
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return neonMask(almostEq(VEC));
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~neonMask(almostEq(VEC)) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return neonMask(vbicq_u32(vcgtq_f32(VEC, VLOW),
+                                              almostEq(VEC)));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return neonMask(vbicq_u32(vcltq_f32(VEC, VLOW),
+                                              almostEq(VEC)));
+                } else {
+                    return neonMask(vandq_u32(vcgeq_f32(VEC, RANGE_LOW),
+                                              vcleq_f32(VEC, RANGE_HIGH)));
+                }
+            });
+    } else {
+        const float64x2_t ONE = vdupq_n_f64(1.0);
+        const float64x2_t ABS_TOL = vdupq_n_f64(absTol<double>());
+        const float64x2_t REL_TOL = vdupq_n_f64(relTol<double>());
+        const float64x2_t VLOW = vdupq_n_f64(low);
+        const float64x2_t VABS_LOW = vabsq_f64(VLOW);
+        const float64x2_t RANGE_LOW = vdupq_n_f64(low - absTol<double>());
+        const float64x2_t RANGE_HIGH = vdupq_n_f64(high + absTol<double>());
+        auto almostEq = [&](float64x2_t vec) {
+            const float64x2_t SCALE =
+                vmaxq_f64(ONE, vmaxq_f64(vabsq_f64(vec), VABS_LOW));
+            const float64x2_t TOL = vmaxq_f64(ABS_TOL, vmulq_f64(REL_TOL, SCALE));
+            return vcleq_f64(vabdq_f64(vec, VLOW), TOL);
+        };
+        tail = vectorDriver<T, LANES>(
+            data, size, step, mask, matches,
+            [&](const std::uint8_t* ptr) -> std::uint64_t {
+                const float64x2_t VEC = vreinterpretq_f64_u8(vld1q_u8(ptr));
+                if constexpr (MATCH == ScanMatchType::MATCH_EQUAL_TO) {
+                    return neonMask(almostEq(VEC));
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_NOT_EQUAL_TO) {
+                    return ~neonMask(almostEq(VEC)) & ALL;
+                } else if constexpr (MATCH ==
+                                     ScanMatchType::MATCH_GREATER_THAN) {
+                    return neonMask(vbicq_u64(vcgtq_f64(VEC, VLOW),
+                                              almostEq(VEC)));
+                } else if constexpr (MATCH == ScanMatchType::MATCH_LESS_THAN) {
+                    return neonMask(vbicq_u64(vcltq_f64(VEC, VLOW),
+                                              almostEq(VEC)));
+                } else {
+                    return neonMask(vandq_u64(vcgeq_f64(VEC, RANGE_LOW),
+                                              vcleq_f64(VEC, RANGE_HIGH)));
+                }
+            });
+    }
+    return matches +
+           scalarRange<T, MATCH>(data, size, tail, step, low, high, mask);
+}
+
+#endif  // SCAN_SIMD_NEON
+
+}  // namespace scan::simd_detail
+
+export namespace scan {
+
+/**
+ * @brief Compare every step-th candidate of a block and set mask bits
+ *
+ * @param memory Block bytes, little-endian host order
+ * @param step   Candidate stride; vector paths need sizeof(T) % step == 0
+ * @param low    Comparison value (lower bound for MATCH_RANGE)
+ * @param high   Upper bound for MATCH_RANGE, ignored otherwise
+ * @param mask   At least maskWordsFor(memory.size()) words, zeroed by caller
+ * @param level  Requested ISA; clamped to what the CPU supports
+ * @return Number of bits set
+ */
+template <typename T, ScanMatchType MATCH>
+auto compareBlockMask(std::span<const std::uint8_t> memory, std::size_t step,
+                      T low, T high, std::span<std::uint64_t> mask,
+                      SimdLevel level = detectSimdLevel()) noexcept
+    -> std::size_t {
+    static_assert(SIMD_COMPARABLE<T> && isSimdMatch(MATCH));
+    const std::size_t STEP_SIZE = std::max<std::size_t>(1, step);
+    const bool VECTOR_OK =
+        sizeof(T) % STEP_SIZE == 0 && mask.size() >= maskWordsFor(memory.size());
+    if (!VECTOR_OK) {
+        level = SimdLevel::SCALAR;
+    }
+    level = std::min(level, detectSimdLevel());
+
+    const std::uint8_t* data = memory.data();
+    const std::size_t SIZE = memory.size();
+    switch (level) {
+#if defined(SCAN_SIMD_X86)
+        case SimdLevel::AVX512:
+            return simd_detail::avx512Compare<T, MATCH>(data, SIZE, STEP_SIZE,
+                                                        low, high, mask.data());
+        case SimdLevel::AVX2:
+            return simd_detail::avx2Compare<T, MATCH>(data, SIZE, STEP_SIZE,
+                                                      low, high, mask.data());
+#endif
+#if defined(SCAN_SIMD_NEON)
+        case SimdLevel::NEON:
+            return simd_detail::neonCompare<T, MATCH>(data, SIZE, STEP_SIZE,
+                                                      low, high, mask.data());
+#endif
+        default:
+            return simd_detail::scalarRange<T, MATCH>(data, SIZE, 0, STEP_SIZE,
+                                                      low, high, mask.data());
+    }
+}
+
+}  // namespace scan
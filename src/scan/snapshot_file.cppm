@@ -0,0 +1,557 @@
+/**
+ * @file snapshot_file.cppm
+ * @brief Versioned on-disk snapshot format (快照文件)
+ *
+ * Layout, host byte order, offsets absolute:
+ *   FileHeader
+ *   per region: raw bytes, then its match section (8-byte aligned)
+ *   region table, RegionRecord[regionCount]
+ *
+ * A match section is the region's match bitmap, delta coded: one varint
+ * (gap << 1 | custom) per match, gap being the distance from the previous
+ * match. If custom is set, flags and length follow as varints; otherwise
+ * the region's default info applies. A dense snapshot therefore costs
+ * about one byte per match on top of its raw bytes.
+ *
+ * The writer streams regions straight from the swaths and puts the table
+ * last, so nothing is buffered but one region's match section. Readers
+ * mmap the file and can walk matches without loading it.
+ */
+
+module;
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+export module scan.snapshot_file;
+
+import scan.match_storage;
+import scan.types;
+import value.flags;
+
+export namespace scan {
+
+constexpr std::array<char, 8> SNAPSHOT_MAGIC = {'S', 'C', 'A', 'N',
+                                                'S', 'N', 'A', 'P'};
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+/** @brief Fixed header at offset 0 */
+struct SnapshotFileHeader {
+    std::array<char, 8> magic{SNAPSHOT_MAGIC};
+    std::uint32_t version{SNAPSHOT_VERSION};
+    std::uint32_t headerSize{sizeof(SnapshotFileHeader)};
+    std::uint64_t regionCount{0};
+    std::uint64_t byteCount{0};
+    std::uint64_t matchCount{0};
+    std::uint64_t tableOffset{0};
+    std::uint8_t hasDataType{0};
+    std::uint8_t dataType{0};  ///< ScanDataType when hasDataType
+    std::uint8_t alignment{0};  ///< ScanAlignment of the matches (0: NONE)
+    std::array<std::uint8_t, 5> reserved{};
+};
+
+/** @brief One entry of the region table */
+struct SnapshotRegionRecord {
+    std::uint64_t address{0};
+    std::uint64_t size{0};
+    std::uint64_t bytesOffset{0};
+    std::uint64_t matchesOffset{0};
+    std::uint64_t matchesBytes{0};
+    std::uint64_t matchCount{0};
+    std::uint16_t defaultFlags{0};
+    std::uint16_t defaultLength{0};
+    std::uint32_t reserved{0};
+};
+
+namespace detail {
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// False on a truncated or overlong varint
+inline auto getVarint(std::span<const std::uint8_t> in, std::size_t& pos,
+                      std::uint64_t& value) -> bool {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        const std::uint8_t BYTE = in[pos++];
+        value |= static_cast<std::uint64_t>(BYTE & 0x7F) << shift;
+        if ((BYTE & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline auto writeAll(int fd, const void* data, std::size_t len)
+    -> std::expected<void, std::string> {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t DONE = ::write(fd, bytes, len);
+        if (DONE < 0 && errno == EINTR) {
+            continue;
+        }
+        if (DONE <= 0) {
+            return std::unexpected{
+                std::format("write failed: {}", std::strerror(errno))};
+        }
+        bytes += DONE;
+        len -= static_cast<std::size_t>(DONE);
+    }
+    return {};
+}
+
+/** @brief Summary of one swath's coded match section */
+struct MatchCode {
+    std::size_t matchCount{0};
+    MatchInfo defaultInfo{};
+};
+
+/** @brief Append the delta code of swath's matches to out */
+inline auto encodeMatches(const MatchesAndOldValuesSwath& swath,
+                          std::vector<std::uint8_t>& out) -> MatchCode {
+    MatchCode code;
+    std::size_t previous = 0;
+    swath.forEachMatch([&](std::size_t index) {
+        const MatchInfo INFO = swath.matchInfo(index);
+        if (code.matchCount == 0) {
+            code.defaultInfo = INFO;
+        }
+        const std::uint64_t GAP =
+            code.matchCount == 0 ? index : index - previous;
+        const bool CUSTOM = !(INFO == code.defaultInfo);
+        putVarint(out, GAP << 1 | (CUSTOM ? 1U : 0U));
+        if (CUSTOM) {
+            putVarint(out, std::to_underlying(INFO.flags));
+            putVarint(out, INFO.length);
+        }
+        previous = index;
+        ++code.matchCount;
+    });
+    return code;
+}
+
+/**
+ * @brief Call fn(index, info) for each match of a coded section
+ *
+ * Stops early at corrupt input or an index at or past size.
+ */
+template <typename Fn>
+void decodeMatches(std::span<const std::uint8_t> in, const MatchCode& code,
+                   std::size_t size, Fn&& fn) {
+    std::size_t pos = 0;
+    std::uint64_t index = 0;
+    for (std::size_t n = 0; n < code.matchCount; ++n) {
+        std::uint64_t word = 0;
+        if (!getVarint(in, pos, word)) {
+            return;
+        }
+        index = (n == 0 ? 0 : index) + (word >> 1);
+        MatchInfo info = code.defaultInfo;
+        if ((word & 1U) != 0) {
+            std::uint64_t flags = 0;
+            std::uint64_t length = 0;
+            if (!getVarint(in, pos, flags) || !getVarint(in, pos, length)) {
+                return;
+            }
+            info = {.flags = static_cast<MatchFlags>(flags),
+                    .length = static_cast<std::uint16_t>(length)};
+        }
+        if (index >= size) {
+            return;
+        }
+        fn(static_cast<std::size_t>(index), info);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @class SnapshotWriter
+ * @brief Streams swaths into a snapshot file
+ *
+ * The file only becomes valid once finish() succeeds; an abandoned writer
+ * removes it.
+ */
+class SnapshotWriter {
+   public:
+    [[nodiscard]] static auto create(std::string path)
+        -> std::expected<SnapshotWriter, std::string> {
+        const int FD =
+            ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (FD < 0) {
+            return std::unexpected{std::format("open {} failed: {}", path,
+                                               std::strerror(errno))};
+        }
+        SnapshotWriter writer{FD, std::move(path)};
+        const SnapshotFileHeader PLACEHOLDER{};
+        if (auto err = writer.append(&PLACEHOLDER, sizeof(PLACEHOLDER)); !err) {
+            return std::unexpected{err.error()};
+        }
+        return writer;
+    }
+
+    ~SnapshotWriter() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            ::unlink(m_path.c_str());
+        }
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    auto operator=(const SnapshotWriter&) -> SnapshotWriter& = delete;
+    SnapshotWriter(SnapshotWriter&& other) noexcept
+        : m_fd(std::exchange(other.m_fd, -1)),
+          m_path(std::move(other.m_path)),
+          m_offset(other.m_offset),
+          m_header(other.m_header),
+          m_regions(std::move(other.m_regions)) {}
+    auto operator=(SnapshotWriter&&) -> SnapshotWriter& = delete;
+
+    /** @brief Append one swath; swaths should come in address order */
+    auto add(const MatchesAndOldValuesSwath& swath)
+        -> std::expected<void, std::string> {
+        if (swath.firstByteInChild == nullptr || swath.empty()) {
+            return {};
+        }
+        SnapshotRegionRecord record{
+            .address = reinterpret_cast<std::uintptr_t>(swath.firstByteInChild),
+            .size = swath.size(),
+            .bytesOffset = m_offset};
+        const auto BYTES = swath.bytes();
+        if (auto err = append(BYTES.data(), BYTES.size()); !err) {
+            return err;
+        }
+        if (auto err = pad(); !err) {
+            return err;
+        }
+
+        m_code.clear();
+        const auto CODE = detail::encodeMatches(swath, m_code);
+        record.matchCount = CODE.matchCount;
+        record.defaultFlags = std::to_underlying(CODE.defaultInfo.flags);
+        record.defaultLength = CODE.defaultInfo.length;
+        record.matchesOffset = m_offset;
+        record.matchesBytes = m_code.size();
+        if (auto err = append(m_code.data(), m_code.size()); !err) {
+            return err;
+        }
+        if (auto err = pad(); !err) {
+            return err;
+        }
+
+        m_header.byteCount += record.size;
+        m_header.matchCount += record.matchCount;
+        m_regions.push_back(record);
+        return {};
+    }
+
+    /** @brief Write the region table and header, then close the file */
+    auto finish(std::optional<ScanDataType> dataType,
+                ScanAlignment alignment = ScanAlignment::NONE)
+        -> std::expected<void, std::string> {
+        m_header.regionCount = m_regions.size();
+        m_header.tableOffset = m_offset;
+        m_header.hasDataType = dataType ? 1 : 0;
+        m_header.dataType =
+            dataType ? static_cast<std::uint8_t>(*dataType) : 0;
+        m_header.alignment = static_cast<std::uint8_t>(alignment);
+        if (auto err = append(m_regions.data(),
+                              m_regions.size() * sizeof(SnapshotRegionRecord));
+            !err) {
+            return err;
+        }
+        if (::pwrite(m_fd, &m_header, sizeof(m_header), 0) !=
+            static_cast<ssize_t>(sizeof(m_header))) {
+            return std::unexpected{std::format("write {} failed: {}", m_path,
+                                               std::strerror(errno))};
+        }
+        const int FD = std::exchange(m_fd, -1);
+        if (::close(FD) != 0) {
+            ::unlink(m_path.c_str());
+            return std::unexpected{std::format("close {} failed: {}", m_path,
+                                               std::strerror(errno))};
+        }
+        return {};
+    }
+
+   private:
+    SnapshotWriter(int fd, std::string path)
+        : m_fd(fd), m_path(std::move(path)) {}
+
+    auto append(const void* data, std::size_t len)
+        -> std::expected<void, std::string> {
+        if (auto err = detail::writeAll(m_fd, data, len); !err) {
+            return std::unexpected{std::format("{}: {}", m_path, err.error())};
+        }
+        m_offset += len;
+        return {};
+    }
+
+    auto pad() -> std::expected<void, std::string> {
+        constexpr std::array<std::uint8_t, 8> ZEROS{};
+        return append(ZEROS.data(), (8 - m_offset % 8) % 8);
+    }
+
+    int m_fd{-1};
+    std::string m_path;
+    std::uint64_t m_offset{0};
+    SnapshotFileHeader m_header{};
+    std::vector<SnapshotRegionRecord> m_regions;
+    std::vector<std::uint8_t> m_code;  // current region's match section
+};
+
+/**
+ * @brief Write matches to path (replaced atomically)
+ *
+ * A sparse array is written as the swaths densify() would rebuild.
+ */
+[[nodiscard]] inline auto writeSnapshotFile(
+    const std::string& path, const MatchesAndOldValuesArray& matches,
+    std::optional<ScanDataType> dataType,
+    ScanAlignment alignment = ScanAlignment::NONE)
+    -> std::expected<void, std::string> {
+    const std::string TMP = path + ".tmp";
+    auto writer = SnapshotWriter::create(TMP);
+    if (!writer) {
+        return std::unexpected{writer.error()};
+    }
+    std::optional<MatchesAndOldValuesArray> dense;
+    if (matches.isSparse()) {
+        dense.emplace(matches);
+        dense->densify();
+    }
+    for (const auto& swath : dense ? dense->swaths : matches.swaths) {
+        if (auto err = writer->add(swath); !err) {
+            return err;
+        }
+    }
+    if (auto err = writer->finish(dataType, alignment); !err) {
+        return err;
+    }
+    if (::rename(TMP.c_str(), path.c_str()) != 0) {
+        ::unlink(TMP.c_str());
+        return std::unexpected{std::format("rename to {} failed: {}", path,
+                                           std::strerror(errno))};
+    }
+    return {};
+}
+
+/**
+ * @class SnapshotFile
+ * @brief Read-only mmap view of a snapshot file
+ */
+class SnapshotFile {
+   public:
+    /** @brief A region's raw bytes, straight from the mapping */
+    struct RegionView {
+        std::uintptr_t address{0};
+        std::span<const std::uint8_t> bytes;
+        std::size_t matchCount{0};
+    };
+
+    [[nodiscard]] static auto open(const std::string& path)
+        -> std::expected<SnapshotFile, std::string> {
+        const int FD = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (FD < 0) {
+            return std::unexpected{std::format("open {} failed: {}", path,
+                                               std::strerror(errno))};
+        }
+        struct stat info{};
+        if (::fstat(FD, &info) != 0) {
+            const int ERR = errno;
+            ::close(FD);
+            return std::unexpected{
+                std::format("stat {} failed: {}", path, std::strerror(ERR))};
+        }
+        const auto SIZE = static_cast<std::size_t>(info.st_size);
+        if (SIZE < sizeof(SnapshotFileHeader)) {
+            ::close(FD);
+            return std::unexpected{std::format("{}: not a snapshot file", path)};
+        }
+        void* map = ::mmap(nullptr, SIZE, PROT_READ, MAP_PRIVATE, FD, 0);
+        const int ERR = errno;
+        ::close(FD);
+        if (map == MAP_FAILED) {
+            return std::unexpected{
+                std::format("mmap {} failed: {}", path, std::strerror(ERR))};
+        }
+        SnapshotFile file{path, static_cast<const std::uint8_t*>(map), SIZE};
+        if (auto err = file.validate(); !err) {
+            return std::unexpected{std::format("{}: {}", path, err.error())};
+        }
+        return file;
+    }
+
+    ~SnapshotFile() {
+        if (m_data != nullptr) {
+            ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+        }
+    }
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    auto operator=(const SnapshotFile&) -> SnapshotFile& = delete;
+    SnapshotFile(SnapshotFile&& other) noexcept
+        : m_path(std::move(other.m_path)),
+          m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)),
+          m_header(other.m_header),
+          m_regions(std::move(other.m_regions)) {}
+    auto operator=(SnapshotFile&& other) noexcept -> SnapshotFile& {
+        if (this != &other) {
+            if (m_data != nullptr) {
+                ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+            }
+            m_path = std::move(other.m_path);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_header = other.m_header;
+            m_regions = std::move(other.m_regions);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] auto path() const noexcept -> const std::string& {
+        return m_path;
+    }
+    [[nodiscard]] auto fileSize() const noexcept -> std::size_t {
+        return m_size;
+    }
+    [[nodiscard]] auto regionCount() const noexcept -> std::size_t {
+        return m_regions.size();
+    }
+    [[nodiscard]] auto byteCount() const noexcept -> std::size_t {
+        return m_header.byteCount;
+    }
+    [[nodiscard]] auto matchCount() const noexcept -> std::size_t {
+        return m_header.matchCount;
+    }
+    [[nodiscard]] auto dataType() const noexcept -> std::optional<ScanDataType> {
+        if (m_header.hasDataType == 0) {
+            return std::nullopt;
+        }
+        return static_cast<ScanDataType>(m_header.dataType);
+    }
+    /** @brief Alignment of the scan that found the matches */
+    [[nodiscard]] auto alignment() const noexcept -> ScanAlignment {
+        return m_header.alignment ==
+                       static_cast<std::uint8_t>(ScanAlignment::NATURAL)
+                   ? ScanAlignment::NATURAL
+                   : ScanAlignment::NONE;
+    }
+
+    [[nodiscard]] auto region(std::size_t index) const -> RegionView {
+        const auto& record = m_regions[index];
+        return {.address = record.address,
+                .bytes = {m_data + record.bytesOffset, record.size},
+                .matchCount = record.matchCount};
+    }
+
+    /** @brief Call fn(const MatchView&) for every match, in address order */
+    template <typename Fn>
+    void forEachMatch(Fn&& fn) const {
+        for (std::size_t i = 0; i < m_regions.size(); ++i) {
+            const auto VIEW = region(i);
+            decodeMatches(i, [&](std::size_t index, MatchInfo info) {
+                fn(MatchView{.address = VIEW.address + index,
+                             .oldBytes = VIEW.bytes.subspan(index),
+                             .info = info});
+            });
+        }
+    }
+
+    /** @brief Copy the snapshot back into memory */
+    [[nodiscard]] auto load() const -> MatchesAndOldValuesArray {
+        MatchesAndOldValuesArray out;
+        out.swaths.reserve(m_regions.size());
+        for (std::size_t i = 0; i < m_regions.size(); ++i) {
+            const auto VIEW = region(i);
+            MatchesAndOldValuesSwath swath{
+                reinterpret_cast<void*>(VIEW.address),
+                ByteBuffer(VIEW.bytes.begin(), VIEW.bytes.end())};
+            decodeMatches(i, [&](std::size_t index, MatchInfo info) {
+                swath.setMatch(index, info.flags, info.length);
+            });
+            out.addSwath(std::move(swath));
+        }
+        return out;
+    }
+
+   private:
+    SnapshotFile(std::string path, const std::uint8_t* data, std::size_t size)
+        : m_path(std::move(path)), m_data(data), m_size(size) {}
+
+    [[nodiscard]] auto within(std::uint64_t offset, std::uint64_t len) const
+        -> bool {
+        return offset <= m_size && len <= m_size - offset;
+    }
+
+    auto validate() -> std::expected<void, std::string> {
+        std::memcpy(&m_header, m_data, sizeof(m_header));
+        if (m_header.magic != SNAPSHOT_MAGIC) {
+            return std::unexpected{"not a snapshot file"};
+        }
+        if (m_header.version != SNAPSHOT_VERSION ||
+            m_header.headerSize != sizeof(SnapshotFileHeader)) {
+            return std::unexpected{std::format(
+                "unsupported snapshot version {}", m_header.version)};
+        }
+        if (m_header.regionCount > m_size / sizeof(SnapshotRegionRecord) ||
+            !within(m_header.tableOffset,
+                    m_header.regionCount * sizeof(SnapshotRegionRecord))) {
+            return std::unexpected{"truncated region table"};
+        }
+        m_regions.resize(m_header.regionCount);
+        std::memcpy(m_regions.data(), m_data + m_header.tableOffset,
+                    m_regions.size() * sizeof(SnapshotRegionRecord));
+        for (const auto& record : m_regions) {
+            if (!within(record.bytesOffset, record.size) ||
+                !within(record.matchesOffset, record.matchesBytes)) {
+                return std::unexpected{"region outside the file"};
+            }
+        }
+        return {};
+    }
+
+    // Calls fn(index, info) per match of region; stops at corrupt input
+    template <typename Fn>
+    void decodeMatches(std::size_t regionIndex, Fn&& fn) const {
+        const auto& record = m_regions[regionIndex];
+        const detail::MatchCode CODE{
+            .matchCount = record.matchCount,
+            .defaultInfo = {.flags = static_cast<MatchFlags>(record.defaultFlags),
+                            .length = record.defaultLength}};
+        detail::decodeMatches({m_data + record.matchesOffset, record.matchesBytes},
+                              CODE, record.size, std::forward<Fn>(fn));
+    }
+
+    std::string m_path;
+    const std::uint8_t* m_data{nullptr};
+    std::size_t m_size{0};
+    SnapshotFileHeader m_header{};
+    std::vector<SnapshotRegionRecord> m_regions;
+};
+
+}  // namespace scan
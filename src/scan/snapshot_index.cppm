@@ -0,0 +1,169 @@
+/**
+ * @file snapshot_index.cppm
+ * @brief Address index over a previous snapshot for delta scans
+ *
+ * Delta scans need, for every candidate offset, the bytes the previous
+ * snapshot recorded at the same address. The index sorts the previous
+ * swaths by base address once per scan; each worker then walks it with a
+ * cursor that only moves forward while regions are scanned in ascending
+ * order, falling back to a binary search when it has to jump back.
+ */
+
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+export module scan.snapshot_index;
+
+import scan.match_storage;
+
+export namespace scan {
+
+/**
+ * @struct OldSegment
+ * @brief Previous-snapshot bytes overlapping one block
+ *
+ * bytes[0] is the old byte at block offset blockOffset. The span runs to
+ * the end of the previous swath or to blockLen + window - 1, whichever
+ * comes first, so a candidate at offset o has a full window of old bytes
+ * iff o >= blockOffset and o - blockOffset + window <= bytes.size().
+ */
+struct OldSegment {
+    std::size_t blockOffset{0};
+    std::span<const std::uint8_t> bytes;
+
+    [[nodiscard]] auto covers(std::size_t offset,
+                              std::size_t window) const noexcept -> bool {
+        return offset >= blockOffset &&
+               offset - blockOffset + window <= bytes.size();
+    }
+
+    [[nodiscard]] auto at(std::size_t offset) const noexcept
+        -> const std::uint8_t* {
+        return bytes.data() + (offset - blockOffset);
+    }
+};
+
+/**
+ * @class SnapshotIndex
+ * @brief Previous swaths sorted by address (built once, shared read-only)
+ */
+class SnapshotIndex {
+   public:
+    struct Entry {
+        std::uintptr_t begin;
+        std::uintptr_t end;
+        const MatchesAndOldValuesSwath* swath;
+    };
+
+    SnapshotIndex() = default;
+
+    explicit SnapshotIndex(const MatchesAndOldValuesArray& snapshot) {
+        const auto* source = &snapshot;
+        if (snapshot.isSparse()) {
+            // Sparse snapshots are small; index a dense copy of them
+            m_dense = snapshot;
+            m_dense.densify();
+            source = &m_dense;
+        }
+        m_entries.reserve(source->swaths.size());
+        for (const auto& swath : source->swaths) {
+            if (swath.firstByteInChild == nullptr || swath.empty()) {
+                continue;
+            }
+            const auto BEGIN =
+                reinterpret_cast<std::uintptr_t>(swath.firstByteInChild);
+            m_entries.push_back({BEGIN, BEGIN + swath.size(), &swath});
+        }
+        std::ranges::sort(m_entries, {}, &Entry::begin);
+    }
+
+    [[nodiscard]] auto entries() const noexcept -> std::span<const Entry> {
+        return m_entries;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_entries.empty();
+    }
+
+    SnapshotIndex(const SnapshotIndex&) = delete;
+    auto operator=(const SnapshotIndex&) -> SnapshotIndex& = delete;
+
+   private:
+    std::vector<Entry> m_entries;
+    MatchesAndOldValuesArray m_dense;  // only used for sparse snapshots
+};
+
+/**
+ * @class SnapshotCursor
+ * @brief Per-worker forward cursor yielding old-byte segments per block
+ */
+class SnapshotCursor {
+   public:
+    explicit SnapshotCursor(const SnapshotIndex* index) : m_index(index) {}
+
+    /**
+     * @brief Old bytes that overlap [address, address + blockLen)
+     *
+     * The segment list is reused by the next call; the byte spans point
+     * straight into the indexed snapshot and live as long as it does.
+     */
+    auto segmentsFor(void* address, std::size_t blockLen, std::size_t window)
+        -> std::span<const OldSegment> {
+        m_segments.clear();
+        if (m_index == nullptr || m_index->empty() || blockLen == 0) {
+            return {};
+        }
+        const auto ENTRIES = m_index->entries();
+        const auto BLOCK_BEGIN = reinterpret_cast<std::uintptr_t>(address);
+        const auto BLOCK_END = BLOCK_BEGIN + blockLen;
+        const std::size_t WINDOW = std::max<std::size_t>(1, window);
+
+        seek(BLOCK_BEGIN);
+        for (std::size_t pos = m_position;
+             pos < ENTRIES.size() && ENTRIES[pos].begin < BLOCK_END; ++pos) {
+            const auto& entry = ENTRIES[pos];
+            const auto FROM = std::max(entry.begin, BLOCK_BEGIN);
+            const auto TO = std::min(entry.end, BLOCK_END + WINDOW - 1);
+            if (FROM >= TO) {
+                continue;
+            }
+            m_segments.push_back(
+                {.blockOffset = FROM - BLOCK_BEGIN,
+                 .bytes = entry.swath->bytes().subspan(FROM - entry.begin,
+                                                       TO - FROM)});
+        }
+        return m_segments;
+    }
+
+   private:
+    // Position on the first entry whose end lies beyond address
+    void seek(std::uintptr_t address) {
+        const auto ENTRIES = m_index->entries();
+        if (m_position < ENTRIES.size() &&
+            ENTRIES[m_position].begin <= address) {
+            while (m_position < ENTRIES.size() &&
+                   ENTRIES[m_position].end <= address) {
+                ++m_position;
+            }
+            return;
+        }
+        if (m_position > 0 && m_position <= ENTRIES.size() &&
+            ENTRIES[m_position - 1].end <= address) {
+            return;  // already past everything before address
+        }
+        auto iter = std::ranges::upper_bound(ENTRIES, address, {},
+                                             &SnapshotIndex::Entry::end);
+        m_position = static_cast<std::size_t>(iter - ENTRIES.begin());
+    }
+
+    const SnapshotIndex* m_index{nullptr};
+    std::size_t m_position{0};
+    std::vector<OldSegment> m_segments;
+};
+
+}  // namespace scan
@@ -2,9 +2,12 @@ module;
 #include <algorithm>
 #include <bit>
 #include <boost/regex.hpp>
+#include <cstddef>
 #include <cstdint>
+#include <expected>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -13,13 +16,16 @@ export module scan.string;
 
 import scan.types;
 import scan.routine;
+import scan.pattern_set;
 import value.flags;
 import scan.bytes;
 import value.core;
 
 // This module implements string and regex-related routines and a
 // thread-local regex cache.
-// Exports: makeStringScanRoutine, getCachedRegex, findRegexPattern
+// Exports: makeStringScanRoutine, getCachedRegex, findRegexPattern, and
+// scan::StringSearcher, which searches whole blocks (literal strings via
+// PatternSet, regexes with one regex_iterator pass, optionally UTF-16LE).
 
 export inline auto makeStringScanRoutine(ScanMatchType matchType)
     -> scan::ScanRoutine;
@@ -48,21 +54,236 @@ export inline auto findRegexPattern(const Value* memoryPtr, size_t memLength,
     }
     const auto& hayAll = memoryPtr->bytes;
     size_t limitSize = std::min(hayAll.size(), memLength);
-    std::string hay(hayAll.begin(),
-                    hayAll.begin() + static_cast<std::ptrdiff_t>(limitSize));
+    const auto* first = std::bit_cast<const char*>(hayAll.data());
     if (const auto* rxVal = getCachedRegex(pattern)) {
-        boost::smatch matchResult;
-        if (boost::regex_search(hay, matchResult, *rxVal)) {
+        boost::cmatch matchResult;
+        if (boost::regex_search(first, first + limitSize, matchResult,
+                                *rxVal)) {
             return ByteMatch{
                 .offset = static_cast<size_t>(matchResult.position()),
                 .length = static_cast<size_t>(matchResult.length())};
         }
-    } else {
-        return std::nullopt;
     }
     return std::nullopt;
 }
 
+export namespace scan {
+
+/**
+ * @brief Decode UTF-8 into code points; invalid sequences map byte-wise
+ *        (as Latin-1) so any pattern can be re-encoded
+ */
+[[nodiscard]] inline auto decodeUtf8(std::string_view text)
+    -> std::vector<char32_t> {
+    std::vector<char32_t> out;
+    out.reserve(text.size());
+    for (std::size_t i = 0; i < text.size();) {
+        const auto LEAD = static_cast<std::uint8_t>(text[i]);
+        const std::size_t LEN = LEAD < 0x80           ? 1
+                                : (LEAD >> 5) == 0x6  ? 2
+                                : (LEAD >> 4) == 0xE  ? 3
+                                : (LEAD >> 3) == 0x1E ? 4
+                                                      : 0;
+        char32_t code = LEN == 1 ? LEAD : LEAD & (0x7F >> LEN);
+        bool valid = LEN != 0 && i + LEN <= text.size();
+        for (std::size_t k = 1; valid && k < LEN; ++k) {
+            const auto NEXT = static_cast<std::uint8_t>(text[i + k]);
+            valid = (NEXT & 0xC0) == 0x80;
+            code = (code << 6) | (NEXT & 0x3F);
+        }
+        if (!valid) {
+            out.push_back(LEAD);
+            ++i;
+            continue;
+        }
+        out.push_back(code);
+        i += LEN;
+    }
+    return out;
+}
+
+/** @brief Re-encode UTF-8 text as UTF-16LE bytes */
+[[nodiscard]] inline auto utf8ToUtf16le(std::string_view text)
+    -> std::vector<std::uint8_t> {
+    std::vector<std::uint8_t> out;
+    auto unit = [&out](std::uint32_t value) {
+        out.push_back(static_cast<std::uint8_t>(value & 0xFF));
+        out.push_back(static_cast<std::uint8_t>(value >> 8));
+    };
+    for (const char32_t CODE : decodeUtf8(text)) {
+        if (CODE >= 0x10000) {
+            const std::uint32_t REST = CODE - 0x10000;
+            unit(0xD800 | (REST >> 10));
+            unit(0xDC00 | (REST & 0x3FF));
+        } else {
+            unit(CODE);
+        }
+    }
+    return out;
+}
+
+/**
+ * @class StringSearcher
+ * @brief Whole-block string search, compiled once per scan
+ *
+ * Literal patterns (MATCH_EQUAL_TO) go through a PatternSet holding the
+ * requested encodings. Regexes (MATCH_REGEX) run one regex_iterator pass
+ * over the block; for UTF-16LE the block is widened once per byte
+ * alignment and searched with a wide regex, whose matches map back to
+ * byte offsets (code units, so characters outside the BMP only match as
+ * surrogate pairs written out in the pattern).
+ */
+class StringSearcher {
+   public:
+    [[nodiscard]] static auto create(ScanMatchType matchType,
+                                     const UserValue& value,
+                                     StringEncoding encoding)
+        -> std::expected<StringSearcher, std::string> {
+        const auto TEXT = value.stringValue();
+        if (!TEXT || TEXT->empty()) {
+            return std::unexpected{"string scan needs a non-empty string"};
+        }
+        StringSearcher searcher;
+        const bool NARROW = encoding != StringEncoding::UTF16LE;
+        const bool WIDE = encoding != StringEncoding::UTF8;
+        if (matchType == ScanMatchType::MATCH_REGEX) {
+            try {
+                if (NARROW) {
+                    searcher.m_regex = std::make_shared<const boost::regex>(
+                        *TEXT, boost::regex::perl);
+                }
+                if (WIDE) {
+                    const auto CODES = decodeUtf8(*TEXT);
+                    searcher.m_wideRegex = std::make_shared<const boost::wregex>(
+                        std::wstring(CODES.begin(), CODES.end()),
+                        boost::wregex::perl);
+                }
+            } catch (const boost::regex_error& err) {
+                return std::unexpected{std::string("invalid regex: ") +
+                                       err.what()};
+            }
+            return searcher;
+        }
+        if (matchType != ScanMatchType::MATCH_EQUAL_TO) {
+            return std::unexpected{"no block search for this match type"};
+        }
+        std::vector<BytePattern> literals;
+        auto addLiteral = [&literals](std::vector<std::uint8_t> bytes) {
+            const std::size_t SIZE = bytes.size();
+            literals.push_back({.bytes = std::move(bytes),
+                                .mask = std::vector<std::uint8_t>(SIZE, 0xFF)});
+        };
+        if (NARROW) {
+            addLiteral(std::vector<std::uint8_t>(TEXT->begin(), TEXT->end()));
+        }
+        if (WIDE) {
+            addLiteral(utf8ToUtf16le(*TEXT));
+        }
+        for (const auto& literal : literals) {
+            searcher.m_longestLiteral =
+                std::max(searcher.m_longestLiteral, literal.size());
+        }
+        searcher.m_literals = std::make_shared<const PatternSet>(
+            PatternSet::compile(std::move(literals)));
+        return searcher;
+    }
+
+    [[nodiscard]] auto isRegex() const noexcept -> bool {
+        return m_regex || m_wideRegex;
+    }
+
+    /**
+     * @brief Bytes before a block worth searching again
+     * @param regexOverlap Used for regexes, whose match length is unbounded
+     */
+    [[nodiscard]] auto lookBehind(std::size_t regexOverlap) const noexcept
+        -> std::size_t {
+        if (isRegex()) {
+            return regexOverlap;
+        }
+        return m_longestLiteral > 0 ? m_longestLiteral - 1 : 0;
+    }
+
+    /**
+     * @brief Append every non-empty match in hay to out, by offset
+     *
+     * Where both encodings match at one offset, the longer match is kept.
+     */
+    void search(std::span<const std::uint8_t> hay,
+                std::vector<ByteMatch>& out) const {
+        const std::size_t FIRST = out.size();
+        if (m_literals) {
+            m_literals->search(hay, [&](std::size_t offset, std::size_t index) {
+                out.push_back({.offset = offset,
+                               .length = m_literals->pattern(index).size()});
+            });
+        }
+        if (m_regex) {
+            const auto* begin = std::bit_cast<const char*>(hay.data());
+            for (boost::cregex_iterator iter{begin, begin + hay.size(), *m_regex},
+                 end;
+                 iter != end; ++iter) {
+                if ((*iter).length() > 0) {
+                    out.push_back(
+                        {.offset = static_cast<std::size_t>((*iter).position()),
+                         .length = static_cast<std::size_t>((*iter).length())});
+                }
+            }
+        }
+        if (m_wideRegex) {
+            searchWide(hay, out);
+        }
+        auto added = std::span(out).subspan(FIRST);
+        if (m_literals && m_literals->size() == 1 && !m_wideRegex) {
+            return;  // a single source reports in order
+        }
+        std::ranges::sort(added, [](const ByteMatch& lhs, const ByteMatch& rhs) {
+            return lhs.offset != rhs.offset ? lhs.offset < rhs.offset
+                                            : lhs.length > rhs.length;
+        });
+        auto dup = std::ranges::unique(added, {}, &ByteMatch::offset);
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(FIRST) +
+                      (dup.begin() - added.begin()),
+                  out.end());
+    }
+
+   private:
+    void searchWide(std::span<const std::uint8_t> hay,
+                    std::vector<ByteMatch>& out) const {
+        thread_local std::wstring units;
+        for (std::size_t align = 0; align < 2; ++align) {
+            if (hay.size() < align + 2) {
+                break;
+            }
+            units.resize((hay.size() - align) / 2);
+            for (std::size_t k = 0; k < units.size(); ++k) {
+                units[k] = static_cast<wchar_t>(hay[align + 2 * k] |
+                                                (hay[align + 2 * k + 1] << 8));
+            }
+            const wchar_t* begin = units.data();
+            for (boost::wcregex_iterator iter{begin, begin + units.size(),
+                                              *m_wideRegex},
+                 end;
+                 iter != end; ++iter) {
+                if ((*iter).length() > 0) {
+                    out.push_back(
+                        {.offset = align + 2 * static_cast<std::size_t>(
+                                               (*iter).position()),
+                         .length = 2 * static_cast<std::size_t>(
+                                           (*iter).length())});
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<const PatternSet> m_literals;
+    std::size_t m_longestLiteral{0};
+    std::shared_ptr<const boost::regex> m_regex;
+    std::shared_ptr<const boost::wregex> m_wideRegex;
+};
+
+}  // namespace scan
+
 namespace {
 
 [[nodiscard]] inline auto handleMATCHANY(size_t memLength,
@@ -72,20 +293,14 @@ namespace {
     return static_cast<unsigned int>(memLength);
 }
 
-[[nodiscard]] inline auto runRegexMatch(const Value* memoryPtr,
-                                        size_t memLength,
+[[nodiscard]] inline auto runRegexMatch(std::span<const std::uint8_t> memory,
                                         const std::string& pattern,
                                         MatchFlags* saveFlags) -> unsigned int {
-    if (memoryPtr == nullptr) {
-        return 0;
-    }
-    const auto& hayAll = memoryPtr->bytes;
-    size_t limitSize = std::min(hayAll.size(), memLength);
-    std::string hay(hayAll.begin(),
-                    hayAll.begin() + static_cast<std::ptrdiff_t>(limitSize));
+    const auto* first = std::bit_cast<const char*>(memory.data());
     if (const auto* rxVal = getCachedRegex(pattern)) {
-        boost::smatch matchResult;
-        if (boost::regex_search(hay, matchResult, *rxVal)) {
+        boost::cmatch matchResult;
+        if (boost::regex_search(first, first + memory.size(), matchResult,
+                                *rxVal)) {
             setFlagsIfNotNull(saveFlags, MatchFlags::B8);
             return static_cast<unsigned int>(matchResult.length());
         }
@@ -114,39 +329,33 @@ export inline auto makeStringScanRoutine(ScanMatchType matchType)
         if (pattern.empty()) {
             return scan::ScanResult::noMatch();
         }
-        Value memoryValue{ctx.memory.data(), ctx.memory.size()};
         MatchFlags flags = MatchFlags::EMPTY;
         if (matchType == ScanMatchType::MATCH_REGEX) {
             const auto MATCHED =
-                runRegexMatch(&memoryValue, ctx.memory.size(),
-                              std::string(pattern), &flags);
+                runRegexMatch(ctx.memory, std::string(pattern), &flags);
             if (MATCHED == 0U) {
                 return scan::ScanResult::noMatch();
             }
             return scan::ScanResult::match(MATCHED, flags);
         }
-        const auto* const MASK_PTR =
-            (patternValue.mask &&
-             patternValue.mask->size() == pattern.size())
-                ? &*patternValue.mask
-                : nullptr;
+        if (ctx.memory.size() < pattern.size()) {
+            return scan::ScanResult::noMatch();
+        }
         const auto* bytePtr = std::bit_cast<const uint8_t*>(pattern.data());
-        if (MASK_PTR) {
-            const auto MATCHED =
-                compareBytesMasked(&memoryValue, ctx.memory.size(), bytePtr,
-                                   pattern.size(), MASK_PTR->data(),
-                                   MASK_PTR->size(), &flags);
-            if (MATCHED == 0U) {
-                return scan::ScanResult::noMatch();
+        if (patternValue.mask && patternValue.mask->size() == pattern.size()) {
+            const auto& mask = *patternValue.mask;
+            for (std::size_t j = 0; j < pattern.size(); ++j) {
+                if (((ctx.memory[j] ^ bytePtr[j]) & mask[j]) != 0) {
+                    return scan::ScanResult::noMatch();
+                }
             }
-            return scan::ScanResult::match(MATCHED, flags);
+            return scan::ScanResult::match(
+                pattern.size(), MatchFlags::B8 | MatchFlags::BYTE_ARRAY);
         }
-        const auto MATCHED =
-            compareBytes(&memoryValue, ctx.memory.size(), bytePtr,
-                         pattern.size(), &flags);
-        if (MATCHED == 0U) {
+        if (!std::equal(bytePtr, bytePtr + pattern.size(),
+                        ctx.memory.begin())) {
             return scan::ScanResult::noMatch();
         }
-        return scan::ScanResult::match(MATCHED, flags);
+        return scan::ScanResult::match(pattern.size(), MatchFlags::B8);
     };
 }
@@ -1,8 +1,13 @@
 module;
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <stop_token>
+#include <utility>
+#include <vector>
 
 export module scan.types;
 
@@ -10,6 +15,7 @@ import core.maps;
 import core.region_filter;
 import scan.match_storage;
 import value.core;
+import value.flags;
 
 // Classification of scan data types
 export enum class ScanDataType : std::uint8_t {
@@ -23,7 +29,8 @@ export enum class ScanDataType : std::uint8_t {
     FLOAT_32,     // 32-bit float
     FLOAT_64,     // 64-bit float
     BYTE_ARRAY,   // byte array
-    STRING        // string
+    STRING,       // string
+    GROUP         // several typed values near one another (UserValue::group)
 };
 
 // Classification of match types
@@ -47,6 +54,28 @@ export enum class ScanMatchType : std::uint8_t {
     MATCH_REGEX          // regular expression (STRING only)
 };
 
+// What a scan does with anonymous pages the target never touched; they
+// read as zero but are not resident (per /proc/<pid>/pagemap)
+export enum class AbsentPages : std::uint8_t {
+    READ,  // read them like any other page (faults them in)
+    ZERO,  // fill them with zeros without reading
+    SKIP   // leave blocks without a resident page out of the snapshot
+};
+
+// Which addresses a scan considers as candidates
+export enum class ScanAlignment : std::uint8_t {
+    NONE,     // every step-th byte from the region start (ScanOptions::step)
+    NATURAL   // addresses aligned to the type's width, absolutely; ANY_*
+              // scans keep every address but only the widths aligned there
+};
+
+// Text encodings a STRING scan looks for
+export enum class StringEncoding : std::uint8_t {
+    UTF8,     // the pattern's own bytes (ASCII / UTF-8)
+    UTF16LE,  // the pattern re-encoded as UTF-16LE
+    BOTH      // either of the above, in one pass
+};
+
 // Byte pattern search result (with offset and length), useful when marking
 // target memory or ranges.
 export struct ByteMatch {
@@ -71,6 +100,7 @@ export constexpr auto isNumericType(ScanDataType scanDataType) noexcept
             return true;
         case ScanDataType::BYTE_ARRAY:
         case ScanDataType::STRING:
+        case ScanDataType::GROUP:
             return false;
     }
     return false;
@@ -133,6 +163,7 @@ export [[nodiscard]] constexpr auto bytesNeededForType(ScanDataType dataType)
             return 8;  // NOLINT(readability-magic-numbers)
         case ScanDataType::STRING:
         case ScanDataType::BYTE_ARRAY:
+        case ScanDataType::GROUP:
             return 1;
         case ScanDataType::ANY_INTEGER:
         case ScanDataType::ANY_FLOAT:
@@ -142,21 +173,283 @@ export [[nodiscard]] constexpr auto bytesNeededForType(ScanDataType dataType)
     return 8;  // NOLINT(readability-magic-numbers)
 }
 
+// Candidate alignment of a fixed-width numeric type under
+// ScanAlignment::NATURAL; 1 for every other type
+export [[nodiscard]] constexpr auto naturalAlignment(ScanDataType dataType)
+    -> std::size_t {
+    return isNumericType(dataType) && !isAggregatedAny(dataType)
+               ? bytesNeededForType(dataType)
+               : 1;
+}
+
+// Width flags whose natural alignment address satisfies
+export [[nodiscard]] constexpr auto alignedWidths(std::uintptr_t address)
+    -> MatchFlags {
+    if (address % 8 == 0) {  // NOLINT(readability-magic-numbers)
+        return MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 |
+               MatchFlags::B64;
+    }
+    if (address % 4 == 0) {
+        return MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32;
+    }
+    if (address % 2 == 0) {
+        return MatchFlags::B8 | MatchFlags::B16;
+    }
+    return MatchFlags::B8;
+}
+
 export struct ScanOptions {
     ScanDataType dataType{ScanDataType::ANY_NUMBER};
     ScanMatchType matchType{ScanMatchType::MATCH_ANY};
     bool reverseEndianness{false};
     std::size_t step{1};
+    /// NATURAL replaces step with the type's width, from address 0
+    ScanAlignment alignment{ScanAlignment::NONE};
+    /// Regions still scanned unaligned under NATURAL (none while inactive)
+    core::RegionFilter unalignedRegions;
     static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
     std::size_t blockSize{BLOCK_SIZE};
+    bool pipelineReads{true};  ///< Read ahead while matching (sequential scan)
+    AbsentPages absentPages{AbsentPages::SKIP};
+    StringEncoding stringEncoding{StringEncoding::UTF8};
+    static constexpr std::size_t STRING_OVERLAP = 256;
+    /// Bytes of the previous block a regex scan looks back into, so a
+    /// match straddling a block boundary is still found
+    std::size_t stringOverlap{STRING_OVERLAP};
+    /// Scans look back at most one block (of the default size)
+    static constexpr std::size_t MAX_STRING_OVERLAP = BLOCK_SIZE;
     core::RegionScanLevel regionLevel{core::RegionScanLevel::ALL_RW};
     core::RegionFilterConfig regionFilter;
+    /// Fill ScanStats::profile (a clock read per block and per read)
+    bool profile{false};
+    /// Keep the target stopped while its memory is copied and match after
+    /// resuming it, so the snapshot is one instant (ScanStats::pauseNs)
+    bool consistent{false};
+};
+
+/**
+ * @brief Where a scan or filter spent its time (ScanOptions::profile)
+ *
+ * Times not marked wall are summed over threads, so on a parallel scan
+ * ioNs + matchNs can exceed totalNs. A busy worker has a utilization
+ * (busyNs / scanNs) near 1; one slow task with idle workers points at a
+ * single huge region.
+ */
+export struct ScanProfile {
+    struct Worker {
+        std::uint64_t busyNs{0};  ///< Inside tasks
+        std::size_t tasks{0};
+        std::size_t bytes{0};
+    };
+
+    bool enabled{false};
+    std::uint64_t totalNs{0};    ///< Wall, the whole operation
+    std::uint64_t mapsNs{0};     ///< Wall, reading /proc/<pid>/maps
+    std::uint64_t scanNs{0};     ///< Wall, the read and match phase
+    std::uint64_t ioNs{0};       ///< Blocked in reads
+    std::uint64_t matchNs{0};    ///< In the kernel or filter routine
+    std::uint64_t mergeNs{0};    ///< Wall, assembling the result
+    std::uint64_t historyNs{0};  ///< Wall, recording it in the history
+    std::size_t reads{0};        ///< Read calls (each one syscall)
+    std::size_t bytesRead{0};
+    std::size_t shortReads{0};   ///< Returned fewer bytes than asked
+    std::size_t failedReads{0};  ///< Returned nothing (EIO, unmapped)
+    std::uint64_t slowestTaskNs{0};
+    std::uintptr_t slowestTaskAddress{0};  ///< Where that task started
+    std::size_t slowestTaskBytes{0};
+    std::vector<Worker> workers;  ///< Parallel runs only
+
+    void countRead(std::size_t asked, std::size_t got) noexcept {
+        ++reads;
+        bytesRead += got;
+        if (got == 0) {
+            ++failedReads;
+        } else if (got < asked) {
+            ++shortReads;
+        }
+    }
+
+    void noteTask(std::uint64_t nanos, std::uintptr_t address,
+                  std::size_t bytes) noexcept {
+        if (nanos > slowestTaskNs) {
+            slowestTaskNs = nanos;
+            slowestTaskAddress = address;
+            slowestTaskBytes = bytes;
+        }
+    }
+
+    /** @brief Fold in a worker's per-thread counters */
+    void merge(const ScanProfile& other) noexcept {
+        ioNs += other.ioNs;
+        matchNs += other.matchNs;
+        reads += other.reads;
+        bytesRead += other.bytesRead;
+        shortReads += other.shortReads;
+        failedReads += other.failedReads;
+        noteTask(other.slowestTaskNs, other.slowestTaskAddress,
+                 other.slowestTaskBytes);
+    }
+};
+
+/**
+ * @brief Adds the lifetime of the scope to a ScanProfile field
+ *
+ * A disabled timer never reads the clock.
+ */
+export class ProfileTimer {
+   public:
+    ProfileTimer(bool enabled, std::uint64_t& sink) noexcept
+        : m_sink(enabled ? &sink : nullptr),
+          m_start(enabled ? std::chrono::steady_clock::now()
+                          : std::chrono::steady_clock::time_point{}) {}
+    ~ProfileTimer() {
+        if (m_sink != nullptr) {
+            *m_sink += elapsedNs();
+        }
+    }
+    ProfileTimer(const ProfileTimer&) = delete;
+    auto operator=(const ProfileTimer&) -> ProfileTimer& = delete;
+
+    /** @brief Add the time so far now; the destructor then adds nothing */
+    void stop() noexcept {
+        if (m_sink != nullptr) {
+            *m_sink += elapsedNs();
+            m_sink = nullptr;
+        }
+    }
+
+    [[nodiscard]] auto elapsedNs() const noexcept -> std::uint64_t {
+        if (m_sink == nullptr) {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start)
+                .count());
+    }
+
+   private:
+    std::uint64_t* m_sink;
+    std::chrono::steady_clock::time_point m_start;
 };
 
 export struct ScanStats {
     std::size_t regionsVisited{0};
     std::size_t bytesScanned{0};
     std::size_t matches{0};
+    std::size_t bytesReused{0};  ///< Taken from a snapshot instead of read
+    std::size_t bytesSkipped{0};  ///< Non-resident, never read (see AbsentPages)
+    bool cancelled{false};  ///< Stopped early through ScanControl; partial
+    std::uint64_t pauseNs{0};  ///< Target stopped (ScanOptions::consistent)
+    ScanProfile profile;  ///< Empty unless ScanOptions::profile
+};
+
+/** @brief Point-in-time progress of a scan or filter (ScanControl) */
+export struct ScanProgress {
+    std::size_t bytesDone{0};
+    std::size_t bytesTotal{0};    ///< Readable bytes of the scanned regions
+    std::size_t regionsDone{0};
+    std::size_t regionsTotal{0};
+    std::size_t matchesDone{0};   ///< Filters: matches re-checked
+    std::size_t matchesTotal{0};
+    std::chrono::nanoseconds elapsed{0};
+
+    /** @brief Share of the work done, 0 before the totals are known */
+    [[nodiscard]] auto fraction() const noexcept -> double {
+        if (bytesTotal > 0) {
+            return static_cast<double>(bytesDone) /
+                   static_cast<double>(bytesTotal);
+        }
+        if (matchesTotal > 0) {
+            return static_cast<double>(matchesDone) /
+                   static_cast<double>(matchesTotal);
+        }
+        return 0.0;
+    }
+
+    /** @brief Time left at the rate so far; nullopt until there is one */
+    [[nodiscard]] auto eta() const noexcept
+        -> std::optional<std::chrono::nanoseconds> {
+        const double DONE = fraction();
+        if (DONE <= 0.0) {
+            return std::nullopt;
+        }
+        return std::chrono::nanoseconds{static_cast<std::int64_t>(
+            static_cast<double>(elapsed.count()) * (1.0 - DONE) / DONE)};
+    }
+};
+
+/**
+ * @brief Cancellation and progress shared with a running scan or filter
+ *
+ * The scan publishes its totals once the regions are known and bumps the
+ * counters as blocks finish; any thread may call progress() meanwhile.
+ * Scans check stopRequested() between blocks, filters between batches,
+ * and return what they have with ScanStats::cancelled set.
+ */
+export class ScanControl {
+   public:
+    ScanControl() = default;
+    explicit ScanControl(std::stop_token stop) noexcept
+        : m_stop(std::move(stop)) {}
+    ScanControl(const ScanControl&) = delete;
+    auto operator=(const ScanControl&) -> ScanControl& = delete;
+
+    [[nodiscard]] auto stopRequested() const noexcept -> bool {
+        return m_stop.stop_requested();
+    }
+
+    /** @brief Reset the counters and publish the totals of a new run */
+    void start(std::size_t bytesTotal, std::size_t regionsTotal,
+               std::size_t matchesTotal) noexcept {
+        m_bytesDone.store(0, std::memory_order_relaxed);
+        m_regionsDone.store(0, std::memory_order_relaxed);
+        m_matchesDone.store(0, std::memory_order_relaxed);
+        m_bytesTotal.store(bytesTotal, std::memory_order_relaxed);
+        m_regionsTotal.store(regionsTotal, std::memory_order_relaxed);
+        m_matchesTotal.store(matchesTotal, std::memory_order_relaxed);
+        m_startNs.store(nowNs(), std::memory_order_relaxed);
+    }
+
+    void addBytes(std::size_t bytes) noexcept {
+        m_bytesDone.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void finishRegion() noexcept {
+        m_regionsDone.fetch_add(1, std::memory_order_relaxed);
+    }
+    void addMatches(std::size_t matches) noexcept {
+        m_matchesDone.fetch_add(matches, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto progress() const noexcept -> ScanProgress {
+        const auto START = m_startNs.load(std::memory_order_relaxed);
+        return {
+            .bytesDone = m_bytesDone.load(std::memory_order_relaxed),
+            .bytesTotal = m_bytesTotal.load(std::memory_order_relaxed),
+            .regionsDone = m_regionsDone.load(std::memory_order_relaxed),
+            .regionsTotal = m_regionsTotal.load(std::memory_order_relaxed),
+            .matchesDone = m_matchesDone.load(std::memory_order_relaxed),
+            .matchesTotal = m_matchesTotal.load(std::memory_order_relaxed),
+            .elapsed = std::chrono::nanoseconds{START == 0 ? 0
+                                                           : nowNs() - START},
+        };
+    }
+
+   private:
+    static auto nowNs() noexcept -> std::int64_t {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    std::stop_token m_stop;
+    std::atomic<std::size_t> m_bytesDone{0};
+    std::atomic<std::size_t> m_bytesTotal{0};
+    std::atomic<std::size_t> m_regionsDone{0};
+    std::atomic<std::size_t> m_regionsTotal{0};
+    std::atomic<std::size_t> m_matchesDone{0};
+    std::atomic<std::size_t> m_matchesTotal{0};
+    std::atomic<std::int64_t> m_startNs{0};
 };
 
 export struct ScanRecord {
@@ -0,0 +1,136 @@
+/**
+ * @file periodic_worker.cppm
+ * @brief Helper thread that ticks at a fixed rate over a shared set
+ *
+ * Freezer and Watcher both keep a set under a mutex, let any thread edit
+ * it, and have one helper copy it into a batch whenever it changed and
+ * then work through the batch once per period. PeriodicWorker owns that
+ * skeleton: the lock, the change generation and the helper thread.
+ */
+
+module;
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+export module utils.periodic_worker;
+
+export namespace utils {
+
+/** @brief What the helper runs; all but tick() hold the worker's lock */
+struct PeriodicTask {
+    std::function<bool()> hasWork;  ///< false idles the helper
+    std::function<void()> rebuild;  ///< after update() changed the set
+    std::function<std::chrono::nanoseconds()> period;
+    std::function<void()> tick;  ///< the work itself, unlocked
+};
+
+/**
+ * @class PeriodicWorker
+ * @brief Runs a PeriodicTask on its own thread until destroyed
+ *
+ * The owner guards its set with locked() / update() and declares the
+ * worker as its last member, so the helper is joined before anything the
+ * task touches is destroyed.
+ */
+class PeriodicWorker {
+   public:
+    PeriodicWorker() = default;
+
+    ~PeriodicWorker() {
+        {
+            // Under the lock, so the helper cannot miss the wakeup
+            std::scoped_lock lock(m_mutex);
+            m_thread.request_stop();
+        }
+        m_cv.notify_all();
+    }
+
+    PeriodicWorker(const PeriodicWorker&) = delete;
+    auto operator=(const PeriodicWorker&) -> PeriodicWorker& = delete;
+    PeriodicWorker(PeriodicWorker&&) = delete;
+    auto operator=(PeriodicWorker&&) -> PeriodicWorker& = delete;
+
+    /** @brief Start the helper; call once, after the owner is set up */
+    void start(PeriodicTask task) {
+        m_task = std::move(task);
+        m_thread = std::jthread(
+            [this](const std::stop_token& stop) { loop(stop); });
+    }
+
+    /** @brief Run fn under the lock and return its result */
+    template <typename Fn>
+    auto locked(Fn&& fn) const -> decltype(fn()) {
+        std::scoped_lock lock(m_mutex);
+        return std::forward<Fn>(fn)();
+    }
+
+    /**
+     * @brief Run edit under the lock; if it returns true the set changed
+     *
+     * A change makes the helper rebuild before its next tick, which it
+     * starts right away.
+     */
+    template <typename Fn>
+    auto update(Fn&& edit) -> bool {
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!std::forward<Fn>(edit)()) {
+                return false;
+            }
+            ++m_generation;
+        }
+        m_cv.notify_all();
+        return true;
+    }
+
+    /** @brief Wake the helper to pick up a new period */
+    void wake() { m_cv.notify_all(); }
+
+   private:
+    void loop(const std::stop_token& stop) {
+        std::uint64_t seen = 0;
+        auto next = std::chrono::steady_clock::now();
+
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [&]() {
+                return stop.stop_requested() || m_task.hasWork();
+            });
+            if (stop.stop_requested()) {
+                return;
+            }
+            if (seen != m_generation) {
+                seen = m_generation;
+                m_task.rebuild();
+            }
+            const auto PERIOD = m_task.period();
+            lock.unlock();
+
+            m_task.tick();
+
+            // Fixed rate; ticks missed while working are dropped, not bunched
+            const auto NOW = std::chrono::steady_clock::now();
+            next = std::max(next + PERIOD, NOW);
+            lock.lock();
+            m_cv.wait_until(lock, next, [&]() {
+                return stop.stop_requested() || seen != m_generation;
+            });
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::uint64_t m_generation{0};
+    PeriodicTask m_task;
+    std::jthread m_thread;
+};
+
+}  // namespace utils
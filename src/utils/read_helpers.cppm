@@ -22,7 +22,7 @@ import value.core;
 
 // Conditional endianness swap (safe for integral/floating/other trivially
 // copyable types)
-template <typename T>
+export template <typename T>
 constexpr auto swapIfReverse(T value, bool reverse) noexcept -> T {
     if (!reverse) {
         return value;
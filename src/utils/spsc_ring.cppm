@@ -0,0 +1,92 @@
+/**
+ * @file spsc_ring.cppm
+ * @brief Bounded lock-free single-producer / single-consumer queue
+ *
+ * Used to hand events from a background thread to the REPL without a
+ * lock on either side. A full ring drops new items and counts them rather
+ * than blocking the producer.
+ */
+
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module utils.spsc_ring;
+
+export namespace utils {
+
+/**
+ * @class SpscRing
+ * @brief Fixed-capacity ring; push from one thread, pop from one other
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_nothrow_move_assignable_v<T>);
+
+   public:
+    /** @param capacity Rounded up to a power of two, at least 2 */
+    explicit SpscRing(std::size_t capacity)
+        : m_slots(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+          m_mask(m_slots.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    auto operator=(const SpscRing&) -> SpscRing& = delete;
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+        return m_slots.size();
+    }
+
+    /** @brief Producer side; false (and counted) when the ring is full */
+    auto push(T item) noexcept -> bool {
+        const auto TAIL = m_tail.load(std::memory_order_relaxed);
+        if (TAIL - m_head.load(std::memory_order_acquire) == m_slots.size()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_slots[TAIL & m_mask] = std::move(item);
+        m_tail.store(TAIL + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Consumer side; nullopt when empty */
+    auto pop() noexcept -> std::optional<T> {
+        const auto HEAD = m_head.load(std::memory_order_relaxed);
+        if (HEAD == m_tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        std::optional<T> item{std::move(m_slots[HEAD & m_mask])};
+        m_head.store(HEAD + 1, std::memory_order_release);
+        return item;
+    }
+
+    /** @brief Items currently queued (exact only on the consumer side) */
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_tail.load(std::memory_order_acquire) -
+               m_head.load(std::memory_order_acquire);
+    }
+
+    /** @brief Items rejected because the ring was full */
+    [[nodiscard]] auto dropped() const noexcept -> std::uint64_t {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::vector<T> m_slots;
+    std::size_t m_mask;
+    // Producer and consumer indices on separate cache lines
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_head{0};
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_tail{0};
+    alignas(CACHE_LINE) std::atomic<std::uint64_t> m_dropped{0};
+};
+
+}  // namespace utils
@@ -0,0 +1,291 @@
+/**
+ * @file thread_pool.cppm
+ * @brief Persistent work-stealing pool for index-parallel loops
+ *
+ * Workers are started once and reused by every parallelFor call. Each call
+ * splits [0, count) into one contiguous range per worker; a worker that
+ * runs dry steals the back half of another worker's range, so one slow
+ * task range never leaves the rest of the pool idle.
+ *
+ * Several threads may call parallelFor at once. Each call is a job with
+ * its own ranges; a worker takes tasks from the oldest job that still has
+ * some, so as soon as one job's last tasks are handed out its idle
+ * workers move on to the next job instead of waiting for its tail.
+ *
+ * Workers can be confined to a CPU list (e.g. to stay off the cores the
+ * target process runs on) and optionally pinned one per CPU.
+ */
+
+module;
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+export module utils.thread_pool;
+
+export namespace utils {
+
+/** @brief Size and placement of a ThreadPool's workers */
+struct ThreadPoolOptions {
+    std::size_t threads{0};  ///< 0: one per allowed CPU
+    std::vector<int> cpus;   ///< Allowed CPUs; empty: no restriction
+    bool pin{false};         ///< Pin worker i to cpus[i % cpus.size()]
+
+    auto operator==(const ThreadPoolOptions&) const -> bool = default;
+};
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads running parallelFor jobs
+ *
+ * Concurrent callers share the workers (see the file comment). Tasks
+ * must not throw and must not call back into the same pool.
+ */
+class ThreadPool {
+   public:
+    /**
+     * @brief Start the workers
+     * @param threads Worker count; 0 means std::thread::hardware_concurrency
+     */
+    explicit ThreadPool(std::size_t threads = 0)
+        : ThreadPool(ThreadPoolOptions{.threads = threads}) {}
+
+    /**
+     * @brief Start the workers with a CPU placement
+     *
+     * Affinity failures (offline or out-of-range CPUs) leave the worker
+     * unrestricted and are reported by affinityError().
+     */
+    explicit ThreadPool(const ThreadPoolOptions& options)
+        : m_options(options) {
+        std::size_t threads = m_options.threads;
+        if (threads == 0) {
+            threads = m_options.cpus.empty()
+                          ? std::max(1U, std::thread::hardware_concurrency())
+                          : m_options.cpus.size();
+        }
+        m_workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            m_workers.emplace_back([this, i]() { workerLoop(i); });
+            applyAffinity(i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        // jthread joins on destruction
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_workers.size();
+    }
+
+    [[nodiscard]] auto options() const noexcept -> const ThreadPoolOptions& {
+        return m_options;
+    }
+
+    /** @brief First affinity error hit while starting; empty if none */
+    [[nodiscard]] auto affinityError() const noexcept -> const std::string& {
+        return m_affinityError;
+    }
+
+    /**
+     * @brief Run fn(task, worker) for every task in [0, count) and wait
+     *
+     * worker is in [0, size()) and identifies the calling thread, so
+     * callers can keep per-worker state (readers, stats) without locks.
+     * A worker runs one task at a time, whichever job it belongs to.
+     */
+    template <typename Fn>
+    void parallelFor(std::size_t count, Fn&& fn) {
+        if (count == 0) {
+            return;
+        }
+        using FnType = std::remove_reference_t<Fn>;
+        run(count, static_cast<void*>(std::addressof(fn)),
+            [](void* ctx, std::size_t task, std::size_t worker) {
+                (*static_cast<FnType*>(ctx))(task, worker);
+            });
+    }
+
+    /** @brief Process-wide pool sized to the hardware */
+    static auto shared() -> ThreadPool& {
+        static ThreadPool pool;
+        return pool;
+    }
+
+   private:
+    using Invoke = void (*)(void*, std::size_t, std::size_t);
+
+    // Remaining task range of one worker
+    struct Queue {
+        std::mutex mutex;
+        std::size_t begin{0};
+        std::size_t end{0};
+    };
+
+    // One parallelFor call; lives on the caller's stack until it returns
+    struct Job {
+        void* ctx{nullptr};
+        Invoke invoke{nullptr};
+        std::vector<Queue> queues;  // one per worker
+        // Guarded by m_mutex:
+        std::size_t users{0};  // workers taking tasks from it
+        bool drained{false};   // every task handed out; off m_jobs
+    };
+
+    void applyAffinity(std::size_t index) {
+        const auto& cpus = m_options.cpus;
+        if (cpus.empty()) {
+            return;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        auto add = [&](int cpu) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                if (m_affinityError.empty()) {
+                    m_affinityError =
+                        "cpu " + std::to_string(cpu) + " out of range";
+                }
+                return;
+            }
+            CPU_SET(cpu, &set);
+        };
+        if (m_options.pin) {
+            add(cpus[index % cpus.size()]);
+        } else {
+            for (int cpu : cpus) {
+                add(cpu);
+            }
+        }
+        if (CPU_COUNT(&set) == 0) {
+            return;
+        }
+        const int RC = pthread_setaffinity_np(m_workers[index].native_handle(),
+                                              sizeof(set), &set);
+        if (RC != 0 && m_affinityError.empty()) {
+            m_affinityError = "pthread_setaffinity_np failed for worker " +
+                              std::to_string(index) + ": " +
+                              std::to_string(RC);
+        }
+    }
+
+    void run(std::size_t count, void* ctx, Invoke invoke) {
+        const std::size_t WORKERS = m_workers.size();
+        Job job{.ctx = ctx,
+                .invoke = invoke,
+                .queues = std::vector<Queue>(WORKERS)};
+        for (std::size_t i = 0; i < WORKERS; ++i) {
+            job.queues[i].begin = count * i / WORKERS;
+            job.queues[i].end = count * (i + 1) / WORKERS;
+        }
+        {
+            std::scoped_lock lock(m_mutex);
+            m_jobs.push_back(&job);
+        }
+        m_wake.notify_all();
+
+        // Workers may still be looking at the ranges after the last task
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [&]() { return job.drained && job.users == 0; });
+    }
+
+    void workerLoop(std::size_t index) {
+        while (true) {
+            Job* job = nullptr;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock,
+                            [&]() { return m_stop || !m_jobs.empty(); });
+                if (m_stop) {
+                    return;
+                }
+                job = m_jobs.front();
+                ++job->users;
+            }
+
+            std::size_t task = 0;
+            while (popOwn(*job, index, task) || steal(*job, index, task)) {
+                job->invoke(job->ctx, task, index);
+            }
+
+            std::scoped_lock lock(m_mutex);
+            if (!job->drained) {
+                job->drained = true;
+                std::erase(m_jobs, job);
+            }
+            if (--job->users == 0) {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    static auto popOwn(Job& job, std::size_t index, std::size_t& task)
+        -> bool {
+        auto& queue = job.queues[index];
+        std::scoped_lock lock(queue.mutex);
+        if (queue.begin >= queue.end) {
+            return false;
+        }
+        task = queue.begin++;
+        return true;
+    }
+
+    // Take the back half of the first non-empty victim range
+    static auto steal(Job& job, std::size_t thief, std::size_t& task)
+        -> bool {
+        const std::size_t WORKERS = job.queues.size();
+        for (std::size_t offset = 1; offset < WORKERS; ++offset) {
+            auto& victim = job.queues[(thief + offset) % WORKERS];
+            std::size_t stolenBegin = 0;
+            std::size_t stolenEnd = 0;
+            {
+                std::scoped_lock lock(victim.mutex);
+                if (victim.begin >= victim.end) {
+                    continue;
+                }
+                const std::size_t REMAINING = victim.end - victim.begin;
+                stolenEnd = victim.end;
+                stolenBegin = victim.end - (REMAINING + 1) / 2;
+                victim.end = stolenBegin;
+            }
+            task = stolenBegin;
+            auto& own = job.queues[thief];
+            std::scoped_lock lock(own.mutex);
+            own.begin = stolenBegin + 1;
+            own.end = stolenEnd;
+            return true;
+        }
+        return false;
+    }
+
+    ThreadPoolOptions m_options;
+    std::string m_affinityError;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<Job*> m_jobs;  // jobs with tasks left, oldest first
+    bool m_stop{false};
+    std::vector<std::jthread> m_workers;  // last: joins before the rest dies
+};
+
+}  // namespace utils
@@ -175,12 +175,32 @@ export struct Value {
     [[nodiscard]] auto hasMask() const -> bool { return mask.has_value(); }
 };
 
+// ============================================================================
+// GroupMember: one value of a group (structure) scan
+// ============================================================================
+export struct GroupMember {
+    Value value;           ///< Exact-width bytes of the member's type
+    bool isFloat{false};   ///< Compared as float / double, with tolerance
+    /// Bytes after the anchor; nullopt lets it sit anywhere in the window
+    std::optional<std::size_t> offset;
+};
+
 // ============================================================================
 // UserValue: scan-facing wrapper around one or two Values
 // ============================================================================
 export struct UserValue {
+    static constexpr std::size_t GROUP_WINDOW = 64;
+    static constexpr std::size_t GROUP_MAX_WINDOW = 4096;
+    static constexpr std::size_t GROUP_MAX_MEMBERS = 16;
+
     Value primary;
     std::optional<Value> secondary;
+    /// Further byte patterns matched alongside primary ("AA BB | CC DD")
+    std::vector<Value> alternatives;
+    /// Group scans: group[0] is the anchor (at offset 0, also in primary)
+    std::vector<GroupMember> group;
+    /// Bytes from the anchor that members without an offset may occupy
+    std::size_t groupWindow{0};
 
     UserValue() = default;
 
@@ -297,11 +317,25 @@ struct formatter<UserValue> {
     }
 
     static auto format(const UserValue& value, format_context& ctx) {
+        if (!value.group.empty()) {
+            for (std::size_t i = 0; i < value.group.size(); ++i) {
+                const auto& member = value.group[i];
+                format_to(ctx.out(), "{}{}", i == 0 ? "" : " ", member.value);
+                if (member.offset) {
+                    format_to(ctx.out(), "@{}", *member.offset);
+                }
+            }
+            return format_to(ctx.out(), " window:{}", value.groupWindow);
+        }
         if (value.secondary) {
             return format_to(ctx.out(), "{}..{}", value.primary,
                              *value.secondary);
         }
-        return format_to(ctx.out(), "{}", value.primary);
+        format_to(ctx.out(), "{}", value.primary);
+        for (const auto& alternative : value.alternatives) {
+            format_to(ctx.out(), " | {}", alternative);
+        }
+        return ctx.out();
     }
 };
 
@@ -3,13 +3,16 @@
  * @brief Value parsing utilities for scan operations
  */
 module;
+#include <algorithm>
 #include <cctype>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <ranges>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -44,13 +47,8 @@ namespace detail {
     return UserValue::fromString(args[startIndex]);
 }
 
-[[nodiscard]] inline auto parseByteArrayValue(
-    const std::vector<std::string>& args, size_t startIndex)
-    -> std::optional<UserValue> {
-    if (startIndex >= args.size()) {
-        return std::nullopt;
-    }
-    std::string byteStr = args[startIndex];
+[[nodiscard]] inline auto parseBytePattern(std::string byteStr)
+    -> std::optional<Value> {
 
     // Strip 0x/0X prefix.
     if (byteStr.starts_with("0x") || byteStr.starts_with("0X")) {
@@ -108,7 +106,45 @@ namespace detail {
         mask.push_back(static_cast<std::uint8_t>((hiMask << 4) | loMask));
     }
 
-    return UserValue::fromByteArray(std::move(bytes), std::move(mask));
+    if (bytes.empty()) {
+        return std::nullopt;
+    }
+    return Value::fromByteArray(std::move(bytes), std::move(mask));
+}
+
+/**
+ * @brief Parse one or more '|'-separated byte patterns
+ *
+ * The remaining arguments are joined first, so "AA BB ?? | CC DD" works
+ * quoted or not. The first pattern becomes primary, the rest alternatives.
+ */
+[[nodiscard]] inline auto parseByteArrayValue(
+    const std::vector<std::string>& args, size_t startIndex)
+    -> std::optional<UserValue> {
+    if (startIndex >= args.size()) {
+        return std::nullopt;
+    }
+    std::string text;
+    for (size_t i = startIndex; i < args.size(); ++i) {
+        text += args[i];
+        text += ' ';
+    }
+
+    UserValue value;
+    bool first = true;
+    for (auto part : std::views::split(text, '|')) {
+        auto pattern = parseBytePattern(std::string(part.begin(), part.end()));
+        if (!pattern) {
+            return std::nullopt;
+        }
+        if (first) {
+            value.primary = std::move(*pattern);
+            first = false;
+        } else {
+            value.alternatives.push_back(std::move(*pattern));
+        }
+    }
+    return value;
 }
 
 [[nodiscard]] inline auto parseAnyNumberValue(
@@ -162,6 +198,8 @@ inline auto getDataTypeMap() -> const auto& {
         mapType.emplace("str", ScanDataType::STRING);
         mapType.emplace("bytearray", ScanDataType::BYTE_ARRAY);
         mapType.emplace("bytes", ScanDataType::BYTE_ARRAY);
+        mapType.emplace("group", ScanDataType::GROUP);
+        mapType.emplace("struct", ScanDataType::GROUP);
         return mapType;
     }();
     return MAP;
@@ -230,6 +268,140 @@ inline auto getMatchTypeMap() -> const auto& {
     return std::nullopt;
 }
 
+namespace detail {
+
+/**
+ * @brief Parse one group member value ("100", "1.5") as the given type
+ */
+[[nodiscard]] inline auto parseGroupMemberValue(ScanDataType dataType,
+                                                std::string_view text)
+    -> std::optional<GroupMember> {
+    auto scalar = [&]<typename T>() -> std::optional<GroupMember> {
+        std::optional<T> parsed;
+        if constexpr (std::is_floating_point_v<T>) {
+            if (auto number = utils::parseDouble(text)) {
+                parsed = static_cast<T>(*number);
+            }
+        } else {
+            parsed = utils::parseInteger<T>(text);
+        }
+        if (!parsed) {
+            return std::nullopt;
+        }
+        return GroupMember{.value = Value::of<T>(*parsed),
+                           .isFloat = std::is_floating_point_v<T>};
+    };
+    switch (dataType) {
+        case ScanDataType::INTEGER_8:
+            return scalar.template operator()<int8_t>();
+        case ScanDataType::INTEGER_16:
+            return scalar.template operator()<int16_t>();
+        case ScanDataType::INTEGER_32:
+            return scalar.template operator()<int32_t>();
+        case ScanDataType::INTEGER_64:
+            return scalar.template operator()<int64_t>();
+        case ScanDataType::FLOAT_32:
+            return scalar.template operator()<float>();
+        case ScanDataType::FLOAT_64:
+            return scalar.template operator()<double>();
+        default:
+            return std::nullopt;
+    }
+}
+
+/**
+ * @brief Parse a group: "type:value[@offset]" members plus "window:N"
+ *
+ * The first member is the anchor, at offset 0; other offsets count bytes
+ * after it. Members without one may sit anywhere in the window (default
+ * UserValue::GROUP_WINDOW bytes from the anchor).
+ */
+[[nodiscard]] inline auto parseGroupValue(const std::vector<std::string>& args,
+                                          size_t startIndex)
+    -> std::optional<UserValue> {
+    UserValue value;
+    bool windowGiven = false;
+    for (size_t i = startIndex; i < args.size(); ++i) {
+        const std::string_view TOKEN = args[i];
+        const auto COLON = TOKEN.find(':');
+        if (COLON == std::string_view::npos) {
+            return std::nullopt;
+        }
+        const auto KEY = utils::StringUtils::toLower(TOKEN.substr(0, COLON));
+        auto rest = TOKEN.substr(COLON + 1);
+        if (KEY == "window" || KEY == "w") {
+            auto window = utils::parseInteger<std::size_t>(rest);
+            if (!window || *window == 0 ||
+                *window > UserValue::GROUP_MAX_WINDOW) {
+                return std::nullopt;
+            }
+            value.groupWindow = *window;
+            windowGiven = true;
+            continue;
+        }
+
+        std::optional<std::size_t> offset;
+        if (const auto AT = rest.find('@'); AT != std::string_view::npos) {
+            offset = utils::parseInteger<std::size_t>(rest.substr(AT + 1));
+            if (!offset || *offset >= UserValue::GROUP_MAX_WINDOW) {
+                return std::nullopt;
+            }
+            rest = rest.substr(0, AT);
+        }
+        auto dataType = parseDataType(KEY);
+        if (!dataType || !isNumericType(*dataType) ||
+            isAggregatedAny(*dataType) ||
+            value.group.size() == UserValue::GROUP_MAX_MEMBERS) {
+            return std::nullopt;
+        }
+        auto member = parseGroupMemberValue(*dataType, rest);
+        if (!member) {
+            return std::nullopt;
+        }
+        if (value.group.empty()) {
+            if (offset.value_or(0) != 0) {
+                return std::nullopt;
+            }
+            offset = 0;
+        }
+        member->offset = offset;
+        value.group.push_back(std::move(*member));
+    }
+    if (value.group.empty()) {
+        return std::nullopt;
+    }
+
+    const bool FLOATING = std::ranges::any_of(
+        value.group, [](const GroupMember& member) { return !member.offset; });
+    if (FLOATING && !windowGiven) {
+        value.groupWindow = UserValue::GROUP_WINDOW;
+    }
+    for (const auto& member : value.group) {
+        const std::size_t END = member.offset.value_or(0) + member.value.size();
+        if (END > UserValue::GROUP_MAX_WINDOW ||
+            (!member.offset && END > value.groupWindow)) {
+            return std::nullopt;
+        }
+    }
+    // Overlapping pinned members (the anchor included) only match where
+    // their shared bytes agree, which is never what was meant
+    for (std::size_t i = 0; i < value.group.size(); ++i) {
+        const auto& lhs = value.group[i];
+        for (std::size_t j = i + 1; lhs.offset && j < value.group.size();
+             ++j) {
+            const auto& rhs = value.group[j];
+            if (rhs.offset && *lhs.offset < *rhs.offset + rhs.value.size() &&
+                *rhs.offset < *lhs.offset + lhs.value.size()) {
+                return std::nullopt;
+            }
+        }
+    }
+    value.primary = value.group.front().value;
+    return value;
+}
+
+}  // namespace detail
+
 /**
  * @brief Helper: build UserValue for scalar of type T
  * @tparam T Scalar type (int8_t, int16_t, int32_t, int64_t, float, double)
@@ -337,6 +509,12 @@ template <typename T, typename Parser>
         case ScanDataType::BYTE_ARRAY:
             return detail::parseByteArrayValue(args, startIndex);
 
+        case ScanDataType::GROUP:
+            if (matchType != ScanMatchType::MATCH_EQUAL_TO) {
+                return std::nullopt;
+            }
+            return detail::parseGroupValue(args, startIndex);
+
         default:
             return std::nullopt;
     }
@@ -0,0 +1,83 @@
+// Unit tests for core::Freezer
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+import core.freezer;
+
+namespace {
+
+template <typename T>
+auto bytesOf(T value) -> std::vector<std::uint8_t> {
+    std::vector<std::uint8_t> bytes(sizeof(T));
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    return bytes;
+}
+
+// Poll until pred holds or about two seconds passed
+template <typename Pred>
+auto eventually(Pred pred) -> bool {
+    for (int i = 0; i < 200; ++i) {
+        if (pred()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+}
+
+}  // namespace
+
+TEST(FreezerTest, RewritesFrozenValues) {
+    std::array<volatile std::int32_t, 4> values{1, 2, 3, 4};
+    core::Freezer freezer(getpid(), 200);
+    // Two adjacent addresses share a range, the third stands alone
+    freezer.set(reinterpret_cast<std::uintptr_t>(&values[0]), bytesOf(100));
+    freezer.set(reinterpret_cast<std::uintptr_t>(&values[1]), bytesOf(200));
+    freezer.set(reinterpret_cast<std::uintptr_t>(&values[3]), bytesOf(400));
+    EXPECT_EQ(freezer.size(), 3U);
+
+    ASSERT_TRUE(eventually([&]() {
+        return values[0] == 100 && values[1] == 200 && values[3] == 400;
+    }));
+    EXPECT_EQ(values[2], 3);
+
+    values[1] = -1;
+    EXPECT_TRUE(eventually([&]() { return values[1] == 200; }));
+    EXPECT_GT(freezer.ticks(), 0U);
+    EXPECT_EQ(freezer.failedWrites(), 0U);
+}
+
+TEST(FreezerTest, RemoveAndReplace) {
+    volatile std::int32_t value = 0;
+    const auto ADDRESS = reinterpret_cast<std::uintptr_t>(&value);
+    core::Freezer freezer(getpid(), 500);
+    freezer.set(ADDRESS, bytesOf(7));
+    ASSERT_TRUE(eventually([&]() { return value == 7; }));
+
+    freezer.set(ADDRESS, bytesOf(8));
+    ASSERT_TRUE(eventually([&]() { return value == 8; }));
+    EXPECT_EQ(freezer.size(), 1U);
+    EXPECT_EQ(freezer.entries().front().bytes, bytesOf(8));
+
+    EXPECT_TRUE(freezer.remove(ADDRESS));
+    EXPECT_FALSE(freezer.remove(ADDRESS));
+    // Let an in-flight tick finish before checking the value stays put
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    value = 1;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(value, 1);
+}
+
+TEST(FreezerTest, RateIsClamped) {
+    core::Freezer freezer(getpid(), 0);
+    EXPECT_EQ(freezer.rate(), 1U);
+    freezer.setRate(1'000'000);
+    EXPECT_EQ(freezer.rate(), core::Freezer::MAX_RATE_HZ);
+}
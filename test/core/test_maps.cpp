@@ -77,4 +77,64 @@ TEST(MapsParserTest, ParseProcSelfMaps) {
                    reg.contains(mainAddr);
         });
     EXPECT_NE(CONST_ITER, std::ranges::end(*regions));
-}
\ No newline at end of file
+}
+
+TEST(MapsParserTest, ParsesAnonymousAndSpacedNames) {
+    const std::string SAMPLE =
+        "00400000-00401000 r-xp 00000000 08:02 123 /usr/bin/my prog\n"
+        "00401000-00402000 rw-p 00001000 08:02 123 /usr/bin/my prog\n"
+        "00402000-00404000 rw-p 00000000 00:00 0 \n"
+        "7f0000000000-7f0000010000 rw-p 00000000 00:00 0\n"
+        "7f0000010000-7f0000011000 rw-s 00000000 00:05 4294967299 "
+        "/dev/shm/x (deleted)\n"
+        "7f0000011000-7f0000012000 ---p 00000000 00:00 0\n";
+    auto regions = MapsReader::parseMaps(SAMPLE, "/usr/bin/my prog",
+                                         RegionScanLevel::ALL);
+    // The unreadable guard page is dropped
+    ASSERT_EQ(regions.size(), 5U);
+    EXPECT_EQ(regions[0].filename, "/usr/bin/my prog");
+    EXPECT_EQ(regions[0].type, RegionType::EXE);
+    // Anonymous mapping right after the image belongs to it (bss)
+    EXPECT_TRUE(regions[2].filename.empty());
+    EXPECT_EQ(regions[2].type, RegionType::EXE);
+    EXPECT_TRUE(regions[3].filename.empty());
+    EXPECT_EQ(regions[3].type, RegionType::UNKNOW);
+    EXPECT_TRUE(regions[3].isPrivate());
+    EXPECT_EQ(regions[3].size, 0x10000U);
+    EXPECT_EQ(regions[4].filename, "/dev/shm/x (deleted)");
+    EXPECT_TRUE(regions[4].isShared());
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        EXPECT_EQ(regions[i].id, i);
+    }
+}
+
+TEST(MapsParserTest, SelectLevelMatchesParsingAtLevel) {
+    const std::string SAMPLE =
+        "00400000-0040c000 r-xp 00000000 08:02 123 /usr/bin/myprog\n"
+        "0060c000-0060d000 rw-p 0000c000 08:02 123 /usr/bin/myprog\n"
+        "00e0c000-00e2d000 rw-p 00000000 00:00 0 [heap]\n"
+        "7f7a3c000000-7f7a3c001000 rw-p 00000000 00:00 0\n"
+        "7f7a3c001000-7f7a3c002000 rw-p 00000000 08:02 9 /lib/libz.so\n";
+    const auto ALL =
+        MapsReader::parseMaps(SAMPLE, "/usr/bin/myprog", RegionScanLevel::ALL);
+    for (auto level : {RegionScanLevel::ALL_RW,
+                       RegionScanLevel::HEAP_STACK_EXECUTABLE,
+                       RegionScanLevel::HEAP_STACK_EXECUTABLE_BSS}) {
+        const auto DIRECT = MapsReader::parseMaps(SAMPLE, "/usr/bin/myprog", level);
+        const auto SELECTED = MapsReader::selectLevel(ALL, "/usr/bin/myprog", level);
+        ASSERT_EQ(DIRECT.size(), SELECTED.size());
+        for (std::size_t i = 0; i < DIRECT.size(); ++i) {
+            EXPECT_EQ(DIRECT[i].start, SELECTED[i].start);
+            EXPECT_EQ(DIRECT[i].id, SELECTED[i].id);
+        }
+    }
+    // The BSS level keeps the anonymous mapping, the plain one does not
+    EXPECT_EQ(MapsReader::selectLevel(ALL, "/usr/bin/myprog",
+                                      RegionScanLevel::HEAP_STACK_EXECUTABLE)
+                  .size(),
+              2U);
+    EXPECT_EQ(MapsReader::selectLevel(ALL, "/usr/bin/myprog",
+                                      RegionScanLevel::HEAP_STACK_EXECUTABLE_BSS)
+                  .size(),
+              3U);
+}
@@ -105,3 +105,92 @@ TEST(MatchCollectorTest, ExportTimeFilterHeapOnlyDropsStack) {
     EXPECT_EQ(total, 0U);
     EXPECT_TRUE(entries.empty());
 }
+
+TEST(MatchCollectorTest, CursorPagesResumeWhereTheyStopped) {
+    MatchesAndOldValuesArray matches;
+    std::array<uint8_t, 16> buf{};
+    MatchesAndOldValuesSwath swath;
+    swath.firstByteInChild = static_cast<void*>(buf.data());
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = static_cast<uint8_t>(i);
+        swath.addElement(static_cast<void*>(buf.data() + i), buf[i],
+                         (i % 3 == 0) ? MatchFlags::EMPTY : MatchFlags::B8);
+    }
+    matches.swaths.push_back(swath);
+    const size_t TOTAL = matches.matchCount();
+    ASSERT_EQ(TOTAL, 10U);
+
+    core::MatchCursor cursor{{.matches = &matches}, nullptr};
+    std::vector<core::MatchRow> rows;
+    while (true) {
+        auto page = cursor.next(3);
+        if (page.empty()) {
+            break;
+        }
+        EXPECT_LE(page.size(), 3U);
+        rows.insert(rows.end(), page.begin(), page.end());
+    }
+    ASSERT_EQ(rows.size(), TOTAL);
+    EXPECT_EQ(cursor.position(), TOTAL);
+    EXPECT_EQ(cursor.total(), TOTAL);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(rows[i].index, i);
+        ASSERT_EQ(rows[i].value.size(), 1U);
+        EXPECT_EQ(rows[i].value[0],
+                  *reinterpret_cast<const uint8_t*>(rows[i].address));
+        EXPECT_EQ(cursor.regionLabel(rows[i]), "unk");
+    }
+
+    // collect() with an offset lands on the same rows
+    MatchCollector collector;
+    MatchCollectionOptions opts;
+    opts.limit = 4;
+    opts.offset = 7;
+    auto [entries, total] = collector.collect({.matches = &matches}, opts);
+    EXPECT_EQ(total, TOTAL);
+    ASSERT_EQ(entries.size(), 3U);
+    EXPECT_EQ(entries[0].index, 7U);
+    EXPECT_EQ(entries[0].address, rows[7].address);
+}
+
+TEST(MatchCollectorTest, OffsetCountsFilteredMatches) {
+    Scanner scanner(::getpid());
+    auto& matches = scanner.getMatches();
+
+    std::array<uint8_t, 8> buf = {1, 2, 3, 4, 5, 6, 7, 8};
+    MatchesAndOldValuesSwath swath;
+    swath.firstByteInChild = static_cast<void*>(buf.data());
+    for (size_t i = 0; i < buf.size(); ++i) {
+        swath.addElement(static_cast<void*>(buf.data() + i), buf[i],
+                         MatchFlags::B8);
+    }
+    matches.swaths.push_back(swath);
+
+    auto classifierExp = RegionClassifier::create(::getpid());
+    ASSERT_TRUE(classifierExp.has_value());
+    MatchCollector collector(std::move(classifierExp.value()));
+
+    MatchCollectionOptions opts;
+    opts.limit = 2;
+    opts.offset = 5;
+    opts.regionFilter.mode = RegionFilterMode::EXPORT_TIME;
+    opts.regionFilter.filter = RegionFilter::fromTypeNames({"stack"});
+
+    auto [entries, total] = collector.collect(
+        {.matches = &scanner.getMatches(),
+         .dataType = scanner.getLastDataType()},
+        opts);
+    EXPECT_EQ(total, 8U);
+    ASSERT_EQ(entries.size(), 2U);
+    EXPECT_EQ(entries[0].index, 5U);
+    EXPECT_EQ(entries[1].index, 6U);
+    EXPECT_NE(entries[0].region.find("stack"), std::string::npos);
+
+    // Past the end is empty, not an error
+    opts.offset = 8;
+    EXPECT_TRUE(collector
+                    .collect({.matches = &scanner.getMatches(),
+                              .dataType = scanner.getLastDataType()},
+                             opts)
+                    .first.empty());
+}
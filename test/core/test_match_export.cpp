@@ -0,0 +1,181 @@
+// Tests for core::MatchExporter (CSV and binary streaming export)
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+import core.maps;               // Region, RegionType
+import core.match;              // MatchSource
+import core.match_export;       // MatchExporter, ExportFormat
+import core.region_classifier;  // RegionClassifier
+import scan.match_storage;      // MatchesAndOldValuesArray
+import scan.types;              // ScanDataType
+import value.flags;             // MatchFlags
+
+using core::ExportFormat;
+using core::MatchExporter;
+using core::RegionClassifier;
+using scan::MatchesAndOldValuesArray;
+using scan::MatchesAndOldValuesSwath;
+
+namespace {
+
+class TempDir {
+   public:
+    TempDir() {
+        std::string pattern =
+            (std::filesystem::temp_directory_path() / "export-XXXXXX").string();
+        if (::mkdtemp(pattern.data()) != nullptr) {
+            m_path = pattern;
+        }
+    }
+    ~TempDir() {
+        std::error_code ignored;
+        std::filesystem::remove_all(m_path, ignored);
+    }
+    [[nodiscard]] auto file(const std::string& name) const -> std::string {
+        return m_path + "/" + name;
+    }
+
+   private:
+    std::string m_path;
+};
+
+auto makeSwath(std::uintptr_t base, std::size_t size) -> MatchesAndOldValuesSwath {
+    scan::ByteBuffer bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    return MatchesAndOldValuesSwath{reinterpret_cast<void*>(base),
+                                    std::move(bytes)};
+}
+
+auto classifier() -> std::shared_ptr<const RegionClassifier> {
+    core::Region heap;
+    heap.start = reinterpret_cast<void*>(0x10000);
+    heap.size = 0x1000;
+    heap.type = core::RegionType::HEAP;
+    heap.filename = "[heap]";
+    return std::make_shared<const RegionClassifier>(
+        RegionClassifier::fromRegions({heap}));
+}
+
+auto readFile(const std::string& path) -> std::string {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), {}};
+}
+
+template <typename T>
+auto take(const std::string& data, std::size_t& pos) -> T {
+    T value{};
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+}  // namespace
+
+TEST(MatchExportTest, CsvHasOneLinePerMatch) {
+    TempDir dir;
+    MatchesAndOldValuesArray matches;
+    auto swath = makeSwath(0x10000, 16);
+    swath.setMatch(0, MatchFlags::B32, 0);
+    swath.setMatch(14, MatchFlags::B32, 0);  // only two bytes left
+    matches.addSwath(std::move(swath));
+    matches.addSwath([] {
+        auto other = makeSwath(0x90000, 8);  // outside every region
+        other.setMatch(4, MatchFlags::B32, 0);
+        return other;
+    }());
+
+    const MatchExporter EXPORTER{
+        {.matches = &matches, .dataType = ScanDataType::INTEGER_32},
+        classifier()};
+    const auto PATH = dir.file("m.csv");
+    auto stats = EXPORTER.writeFile(PATH, ExportFormat::CSV);
+    ASSERT_TRUE(stats.has_value()) << stats.error();
+    EXPECT_EQ(stats->rows, 3U);
+
+    const auto TEXT = readFile(PATH);
+    EXPECT_EQ(stats->bytes, TEXT.size());
+    EXPECT_EQ(TEXT,
+              "index,address,region,value\n"
+              "0,0x0000000000010000,heap,00070e15\n"
+              "1,0x000000000001000e,heap,6269\n"
+              "2,0x0000000000090004,unk,1c232a31\n");
+}
+
+TEST(MatchExportTest, BinaryColumnsRoundTripOverManyBlocks) {
+    TempDir dir;
+    MatchesAndOldValuesArray matches;
+    constexpr std::size_t COUNT = MatchExporter::BLOCK_ROWS * 2 + 100;
+    auto swath = makeSwath(0x10000, COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        swath.setMatch(i, MatchFlags::B8, 0);
+    }
+    matches.addSwath(std::move(swath));
+
+    const auto CLASSIFIER = classifier();
+    const MatchExporter EXPORTER{
+        {.matches = &matches, .dataType = ScanDataType::INTEGER_8}, CLASSIFIER};
+    const auto PATH = dir.file("m.bin");
+    auto stats = EXPORTER.writeFile(PATH, ExportFormat::BINARY);
+    ASSERT_TRUE(stats.has_value()) << stats.error();
+    EXPECT_EQ(stats->rows, COUNT);
+
+    const auto DATA = readFile(PATH);
+    ASSERT_EQ(DATA.size(), stats->bytes);
+    std::size_t pos = 0;
+    const auto HEADER = take<core::ExportFileHeader>(DATA, pos);
+    EXPECT_EQ(HEADER.magic, core::EXPORT_MAGIC);
+    EXPECT_EQ(HEADER.version, core::EXPORT_VERSION);
+    EXPECT_EQ(HEADER.hasDataType, 1U);
+    EXPECT_EQ(HEADER.dataType,
+              static_cast<std::uint8_t>(ScanDataType::INTEGER_8));
+    ASSERT_EQ(HEADER.regionCount, 1U);
+    const auto LENGTH = take<std::uint32_t>(DATA, pos);
+    EXPECT_EQ(DATA.substr(pos, LENGTH), "heap");
+    pos += LENGTH;
+
+    std::size_t rows = 0;
+    std::size_t blocks = 0;
+    while (true) {
+        const auto BLOCK = take<core::ExportBlockHeader>(DATA, pos);
+        if (BLOCK.rows == 0) {
+            break;
+        }
+        ++blocks;
+        EXPECT_LE(BLOCK.rows, MatchExporter::BLOCK_ROWS);
+        const std::size_t INDICES = pos;
+        const std::size_t ADDRESSES = INDICES + BLOCK.rows * 8;
+        const std::size_t REGIONS = ADDRESSES + BLOCK.rows * 8;
+        const std::size_t LENGTHS = REGIONS + BLOCK.rows * 4;
+        const std::size_t VALUES = LENGTHS + BLOCK.rows * 4;
+        EXPECT_EQ(BLOCK.valueBytes, BLOCK.rows);
+        for (std::size_t i = 0; i < BLOCK.rows; i += 997) {
+            std::size_t at = INDICES + i * 8;
+            EXPECT_EQ(take<std::uint64_t>(DATA, at), rows + i);
+            at = ADDRESSES + i * 8;
+            const auto ADDRESS = take<std::uint64_t>(DATA, at);
+            EXPECT_EQ(ADDRESS, 0x10000 + rows + i);
+            at = REGIONS + i * 4;
+            EXPECT_EQ(take<std::uint32_t>(DATA, at),
+                      CLASSIFIER->regionId(ADDRESS));
+            EXPECT_EQ(static_cast<std::uint8_t>(DATA[VALUES + i]),
+                      static_cast<std::uint8_t>((rows + i) * 7));
+        }
+        rows += BLOCK.rows;
+        pos = VALUES + BLOCK.valueBytes;
+    }
+    EXPECT_EQ(rows, COUNT);
+    EXPECT_EQ(blocks, 3U);
+    EXPECT_EQ(pos, DATA.size());
+}
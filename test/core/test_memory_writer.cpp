@@ -7,14 +7,17 @@ import value.flags;
 #include <gtest/gtest.h>
 #include <unistd.h>
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 TEST(MemoryWriterMatchesTest, WritesToResolvedMatchAddress) {
     auto targetValue = int32_t{42};
     core::Scanner scanner(getpid());
 
     scan::MatchesAndOldValuesSwath swath;
-    swath.firstByteInChild = &targetValue;
-    swath.data.push_back(
-        {.oldByte = 0x2A, .matchInfo = MatchFlags::B32, .matchLength = 4});
+    swath.addElement(&targetValue, 0x2A, MatchFlags::B32);
+    swath.setMatch(0, MatchFlags::B32, 4);
     scanner.getMatches().addSwath(swath);
 
     core::MemoryWriter writer(getpid());
@@ -34,3 +37,58 @@ TEST(MemoryWriterMatchesTest, InvalidPidFails) {
     auto result = writer.writeToMatch(scanner, value, {0});
     ASSERT_FALSE(result.has_value());
 }
+
+TEST(MemoryWriterMatchesTest, WritesManyMatchesInOneBatch) {
+    std::array<int32_t, 8> targets{};
+    core::Scanner scanner(getpid());
+
+    scan::MatchesAndOldValuesSwath swath;
+    swath.appendRange(targets.data(),
+                      reinterpret_cast<const uint8_t*>(targets.data()),
+                      sizeof(targets));
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        swath.setMatch(i * sizeof(int32_t), MatchFlags::B32, 4);
+    }
+    scanner.getMatches().addSwath(swath);
+
+    core::MemoryWriter writer(getpid());
+    UserValue value = UserValue::fromScalar<int32_t>(-5);
+
+    // Out of order, one index out of range
+    auto result = writer.writeToMatch(scanner, value, {6, 1, 3, 99, 0});
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->successCount, 4U);
+    EXPECT_EQ(result->failedCount, 1U);
+    ASSERT_EQ(result->results.size(), 4U);
+    EXPECT_EQ(result->results[0].address,
+              reinterpret_cast<std::uintptr_t>(&targets[6]));
+    EXPECT_EQ(targets, (std::array<int32_t, 8>{-5, -5, 0, -5, 0, 0, -5, 0}));
+}
+
+TEST(MemoryWriterMatchesTest, ResolvesLargeIndexBatchInOnePass) {
+    std::vector<uint8_t> bytes(10000, 0);
+    scan::MatchesAndOldValuesSwath swath;
+    swath.appendRange(reinterpret_cast<void*>(0x10000), bytes.data(),
+                      bytes.size());
+    for (std::size_t i = 0; i < bytes.size(); i += 2) {
+        swath.setMatch(i, MatchFlags::B16, 2);
+    }
+    scan::MatchesAndOldValuesArray matches;
+    matches.addSwath(std::move(swath));
+
+    std::vector<std::size_t> indices;
+    for (std::size_t n = core::MemoryWriter::RANDOM_ACCESS_LIMIT + 10; n > 0;
+         --n) {
+        indices.push_back(n);  // descending, 5000+ out of range
+    }
+    const auto ADDRESSES =
+        core::MemoryWriter::resolveMatchAddresses(matches, indices);
+    ASSERT_EQ(ADDRESSES.size(), indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] < 5000) {
+            ASSERT_EQ(ADDRESSES[i], 0x10000U + indices[i] * 2) << i;
+        } else {
+            ASSERT_FALSE(ADDRESSES[i].has_value()) << i;
+        }
+    }
+}
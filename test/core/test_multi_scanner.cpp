@@ -0,0 +1,105 @@
+// Tests for scanning several processes through one MultiScanner
+
+import core.multi_scanner;  // MultiScanner, MultiScanResult
+import scan.types;          // ScanOptions
+import value.core;          // UserValue
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "child_process.h"
+
+using test_support::ChildProcess;
+
+namespace {
+
+// Same address in every fork of this process
+volatile std::int32_t g_shared = 0x13572468;
+
+auto valueOptions(ScanMatchType match) -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = match;
+    return opts;
+}
+
+}  // namespace
+
+TEST(MultiScanner, AttachAndDetach) {
+    core::MultiScanner procs;
+    EXPECT_TRUE(procs.empty());
+    EXPECT_FALSE(procs.attach(0));
+    EXPECT_TRUE(procs.attach(::getpid()));
+    EXPECT_FALSE(procs.attach(::getpid()));
+    EXPECT_EQ(procs.pids(), std::vector<pid_t>{::getpid()});
+    EXPECT_NE(procs.scanner(::getpid()), nullptr);
+    EXPECT_EQ(procs.scanner(::getpid() + 1), nullptr);
+    EXPECT_TRUE(procs.detach(::getpid()));
+    EXPECT_FALSE(procs.detach(::getpid()));
+    EXPECT_TRUE(procs.empty());
+}
+
+TEST(MultiScanner, ScansEveryPidAndFindsCommonAddress) {
+    // Each fork sees its own value at the shared address; only the first
+    // two keep the one searched for
+    std::vector<std::unique_ptr<ChildProcess>> forks;
+    for (const std::int32_t VALUE : {0x13572468, 0x13572468, 0x0badf00d}) {
+        g_shared = VALUE;
+        forks.push_back(std::make_unique<ChildProcess>());
+        ASSERT_GT(forks.back()->pid(), 0);
+    }
+    g_shared = 0;
+
+    core::MultiScanner procs({.threads = 2});
+    for (const auto& fork : forks) {
+        ASSERT_TRUE(procs.attach(fork->pid()));
+    }
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(0x13572468);
+    const auto SCANNED =
+        procs.snapshot(valueOptions(ScanMatchType::MATCH_EQUAL_TO), VALUE);
+    ASSERT_EQ(SCANNED.perPid.size(), forks.size());
+    EXPECT_EQ(SCANNED.failed, 0U);
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < forks.size(); ++i) {
+        EXPECT_EQ(SCANNED.perPid[i].pid, forks[i]->pid());
+        ASSERT_TRUE(SCANNED.perPid[i].result.success)
+            << SCANNED.perPid[i].result.error.value_or("");
+        sum += SCANNED.perPid[i].result.matchCount;
+    }
+    EXPECT_EQ(SCANNED.matchCount, sum);
+    EXPECT_EQ(procs.getMatchCount(), sum);
+
+    const auto ADDRESS = reinterpret_cast<std::uintptr_t>(&g_shared);
+    ASSERT_TRUE(procs.detach(forks.back()->pid()));
+    EXPECT_TRUE(std::ranges::binary_search(procs.commonAddresses(), ADDRESS));
+    ASSERT_TRUE(procs.attach(forks.back()->pid()));
+    EXPECT_FALSE(procs.scanner(forks.back()->pid())->hasMatches());
+    EXPECT_TRUE(procs.commonAddresses().empty());
+
+    // The newly attached pid has nothing to filter; the others narrow
+    const auto FILTERED =
+        procs.filter(valueOptions(ScanMatchType::MATCH_NOT_CHANGED));
+    EXPECT_EQ(FILTERED.failed, 1U);
+    EXPECT_TRUE(FILTERED.perPid[0].result.success);
+    EXPECT_FALSE(FILTERED.perPid[2].result.success);
+    EXPECT_EQ(FILTERED.matchCount, SCANNED.perPid[0].result.matchCount +
+                                       SCANNED.perPid[1].result.matchCount);
+
+    // scan() gives the newly attached pid its baseline instead
+    const auto RESCANNED =
+        procs.scan(valueOptions(ScanMatchType::MATCH_EQUAL_TO), VALUE);
+    EXPECT_EQ(RESCANNED.failed, 0U);
+    EXPECT_EQ(RESCANNED.perPid[0].result.matchCount,
+              FILTERED.perPid[0].result.matchCount);
+    EXPECT_TRUE(RESCANNED.perPid[2].result.success)
+        << RESCANNED.perPid[2].result.error.value_or("");
+
+    procs.reset();
+    EXPECT_FALSE(procs.hasMatches());
+}
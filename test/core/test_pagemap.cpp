@@ -0,0 +1,42 @@
+// Unit tests for core::PagemapReader
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+import core.pagemap;
+
+using core::PagemapReader;
+
+TEST(PagemapReaderTest, ReportsTouchedPagesResident) {
+    const std::size_t PAGE = PagemapReader::pageSize();
+    void* mem = ::mmap(nullptr, 4 * PAGE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mem, MAP_FAILED);
+    auto* bytes = static_cast<volatile std::uint8_t*>(mem);
+    bytes[PAGE + 1] = 7;
+    bytes[3 * PAGE] = 9;
+
+    PagemapReader reader{::getpid()};
+    if (auto opened = reader.open(); !opened) {
+        ::munmap(mem, 4 * PAGE);
+        GTEST_SKIP() << opened.error();
+    }
+    std::vector<std::uint64_t> entries(4);
+    ASSERT_EQ(reader.read(reinterpret_cast<std::uintptr_t>(mem), entries), 4U);
+    EXPECT_FALSE(core::pageResident(entries[0]));
+    EXPECT_TRUE(core::pageResident(entries[1]));
+    EXPECT_FALSE(core::pageResident(entries[2]));
+    EXPECT_TRUE(core::pageResident(entries[3]));
+    ::munmap(mem, 4 * PAGE);
+}
+
+TEST(PagemapReaderTest, UnopenedReaderReadsNothing) {
+    PagemapReader reader;
+    EXPECT_FALSE(reader.isOpen());
+    EXPECT_FALSE(reader.open().has_value());
+    std::vector<std::uint64_t> entries(2);
+    EXPECT_EQ(reader.read(0x1000, entries), 0U);
+}
@@ -1,8 +1,12 @@
 // Unit tests for core::proc_mem
 #include <gtest/gtest.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+#include <array>
+#include <cstdint>
 #include <span>
+#include <vector>
 
 import core.proc_mem;
 
@@ -46,3 +50,104 @@ TEST(ProcMemIOTest, ReadFromSelf) {
         // Result may be success or error, both are valid
     }
 }
+
+TEST(ProcMemIOTest, ReadRangesFromSelf) {
+    ProcMemIO io(getpid());
+    std::array<std::uint8_t, 64> source{};
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<std::uint8_t>(i);
+    }
+
+    // A PROT_NONE page in the middle must only fail its own range
+    void* hole = ::mmap(nullptr, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    ASSERT_NE(hole, MAP_FAILED);
+    const std::array<ReadRange, 3> ranges{{
+        {.addr = source.data(), .len = 8},
+        {.addr = hole, .len = 16},
+        {.addr = source.data() + 40, .len = 4},
+    }};
+    std::vector<std::uint8_t> buffer(28, 0xEE);
+    std::array<std::size_t, 3> got{};
+
+    auto result = io.readRanges(ranges, buffer, got);
+    ::munmap(hole, 4096);
+    if (!result) {
+        GTEST_SKIP() << result.error();
+    }
+    EXPECT_EQ(got[0], 8U);
+    EXPECT_EQ(got[1], 0U);
+    EXPECT_EQ(got[2], 4U);
+    EXPECT_EQ(buffer[7], 7U);
+    EXPECT_EQ(buffer[24], 40U);
+    EXPECT_EQ(buffer[27], 43U);
+}
+
+TEST(ProcMemIOTest, WriteRangesToSelf) {
+    ProcMemIO io(getpid());
+    std::array<std::uint8_t, 32> target{};
+    const std::array<std::uint8_t, 4> ONES{1, 1, 1, 1};
+    const std::array<std::uint8_t, 2> TWOS{2, 2};
+    const std::array<WriteRange, 2> RANGES{{
+        {.addr = target.data() + 4, .bytes = ONES},
+        {.addr = target.data() + 20, .bytes = TWOS},
+    }};
+    std::array<std::size_t, 2> got{};
+    ASSERT_TRUE(io.writeRanges(RANGES, got).has_value());
+    EXPECT_EQ(got[0], 4U);
+    EXPECT_EQ(got[1], 2U);
+    EXPECT_EQ(target[3], 0U);
+    EXPECT_EQ(target[4], 1U);
+    EXPECT_EQ(target[7], 1U);
+    EXPECT_EQ(target[8], 0U);
+    EXPECT_EQ(target[21], 2U);
+}
+
+TEST(ProcMemIOTest, WriteRangesFallsBackForReadOnlyPages) {
+    ProcMemIO io(getpid());
+    if (!io.open(true)) {
+        GTEST_SKIP() << "/proc/self/mem not writable";
+    }
+    const auto PAGE = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    void* page = ::mmap(nullptr, PAGE, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    ASSERT_NE(page, MAP_FAILED);
+    const std::array<std::uint8_t, 4> VALUE{9, 8, 7, 6};
+    const std::array<WriteRange, 1> RANGES{{{.addr = page, .bytes = VALUE}}};
+    std::array<std::size_t, 1> got{};
+    ASSERT_TRUE(io.writeRanges(RANGES, got).has_value());
+    EXPECT_EQ(got[0], VALUE.size());
+    EXPECT_EQ(static_cast<const std::uint8_t*>(page)[3], 6U);
+    ::munmap(page, PAGE);
+}
+
+TEST(ProcMemReadersTest, KeepsOneOpenHandlePerSlot) {
+    ProcMemReaders readers(getpid(), 2);
+    EXPECT_TRUE(readers.covers(getpid(), 2));
+    EXPECT_FALSE(readers.covers(getpid(), 3));
+    EXPECT_FALSE(readers.covers(getpid() + 1, 1));
+
+    auto first = readers.acquire(0);
+    if (!first) {
+        GTEST_SKIP() << first.error();
+    }
+    auto again = readers.acquire(0);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(*first, *again);
+    auto other = readers.acquire(1);
+    ASSERT_TRUE(other.has_value());
+    EXPECT_NE(*first, *other);
+
+    int value = 0x1234;
+    int readBack = 0;
+    auto got = (*other)->read(&value, reinterpret_cast<std::uint8_t*>(&readBack),
+                             sizeof(readBack));
+    ASSERT_TRUE(got.has_value());
+    EXPECT_EQ(readBack, value);
+}
+
+TEST(ProcMemReadersTest, RemembersOpenFailure) {
+    ProcMemReaders readers(-1, 1);
+    EXPECT_FALSE(readers.acquire(0).has_value());
+    EXPECT_FALSE(readers.acquire(0).has_value());
+}
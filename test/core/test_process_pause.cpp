@@ -0,0 +1,111 @@
+// Tests for stopping a target around consistent snapshots
+
+import core.process_pause;  // ProcessPause, allThreadsStopped
+import scan.engine;         // runScan, runScanParallel
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.types;          // ScanOptions
+import value.core;          // UserValue
+
+#include <gtest/gtest.h>
+#include <sys/ptrace.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "child_process.h"
+
+using test_support::ChildProcess;
+
+namespace {
+
+// Found once per copy of this process
+volatile std::int32_t g_marker = 0x5eed1e55;
+
+auto markerOptions(bool consistent) -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    opts.consistent = consistent;
+    return opts;
+}
+
+}  // namespace
+
+TEST(ProcessPause, StopsAndResumesEveryThread) {
+    const ChildProcess CHILD{ChildProcess::Idle::SPIN};
+    ASSERT_GT(CHILD.pid(), 0);
+    EXPECT_FALSE(core::allThreadsStopped(CHILD.pid()));
+
+    auto pause = core::ProcessPause::stop(CHILD.pid());
+    ASSERT_TRUE(pause.has_value()) << pause.error();
+    EXPECT_TRUE(pause->stopped());
+    EXPECT_TRUE(core::allThreadsStopped(CHILD.pid()));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_GE(pause->resume(), std::chrono::milliseconds(2));
+    EXPECT_FALSE(pause->stopped());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(core::allThreadsStopped(CHILD.pid()));
+}
+
+TEST(ProcessPause, LeavesAnAlreadyStoppedTargetStopped) {
+    const ChildProcess CHILD{ChildProcess::Idle::SPIN};
+    ASSERT_GT(CHILD.pid(), 0);
+    auto outer = core::ProcessPause::stop(CHILD.pid());
+    ASSERT_TRUE(outer.has_value()) << outer.error();
+    {
+        auto inner = core::ProcessPause::stop(CHILD.pid());
+        ASSERT_TRUE(inner.has_value()) << inner.error();
+        EXPECT_EQ(inner->resume(), std::chrono::nanoseconds{0});
+    }
+    EXPECT_TRUE(core::allThreadsStopped(CHILD.pid()));
+    EXPECT_FALSE(core::ProcessPause::stop(-1).has_value());
+}
+
+TEST(ProcessPause, RefusesThisProcessAndTracedTargets) {
+    EXPECT_FALSE(core::ProcessPause::stop(::getpid()).has_value());
+
+    const ChildProcess TRACED{[]() {
+        ::ptrace(PTRACE_TRACEME, 0, nullptr, nullptr);
+        return std::uintptr_t{0};
+    }};
+    ASSERT_GT(TRACED.pid(), 0);
+    if (core::statusField(TRACED.pid(), "TracerPid").value_or(0) == 0) {
+        GTEST_SKIP() << "ptrace is not permitted here";
+    }
+    EXPECT_FALSE(core::ProcessPause::stop(TRACED.pid()).has_value());
+}
+
+TEST(ProcessPause, ConsistentScansMatchNormalScansAndResume) {
+    const ChildProcess CHILD{ChildProcess::Idle::SPIN};
+    ASSERT_GT(CHILD.pid(), 0);
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(g_marker);
+
+    scan::MatchesAndOldValuesArray normal;
+    auto normalStats =
+        runScan(CHILD.pid(), markerOptions(false), &VALUE, normal);
+    ASSERT_TRUE(normalStats.has_value()) << normalStats.error();
+    EXPECT_EQ(normalStats->pauseNs, 0U);
+    ASSERT_GT(normalStats->matches, 0U);
+
+    scan::MatchesAndOldValuesArray sequential;
+    auto sequentialStats =
+        runScan(CHILD.pid(), markerOptions(true), &VALUE, sequential);
+    ASSERT_TRUE(sequentialStats.has_value()) << sequentialStats.error();
+    EXPECT_GT(sequentialStats->pauseNs, 0U);
+    EXPECT_EQ(sequentialStats->matches, normalStats->matches);
+    EXPECT_EQ(sequential.matchCount(), normal.matchCount());
+
+    scan::MatchesAndOldValuesArray parallel;
+    auto parallelStats = runScanParallel(CHILD.pid(), markerOptions(true),
+                                         &VALUE, parallel, nullptr);
+    ASSERT_TRUE(parallelStats.has_value()) << parallelStats.error();
+    EXPECT_GT(parallelStats->pauseNs, 0U);
+    EXPECT_EQ(parallelStats->matches, normalStats->matches);
+    EXPECT_EQ(parallel.matchCount(), normal.matchCount());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(core::allThreadsStopped(CHILD.pid()));
+}
@@ -0,0 +1,47 @@
+// Unit tests for core::RegionCache
+#include <gtest/gtest.h>
+
+#include "child_process.h"
+
+import core.maps;          // RegionScanLevel
+import core.region_cache;  // RegionCache
+
+using core::RegionCache;
+using core::RegionScanLevel;
+using test_support::ChildProcess;
+
+TEST(RegionCacheTest, ReparsesOnlyWhenMapsChange) {
+    ChildProcess child;
+    ASSERT_GT(child.pid(), 0);
+    RegionCache cache{child.pid()};
+
+    auto first = cache.regions(RegionScanLevel::ALL_RW);
+    ASSERT_TRUE(first.has_value()) << first.error();
+    EXPECT_FALSE((*first)->empty());
+    auto classifier = cache.classifier();
+    ASSERT_TRUE(classifier.has_value());
+    EXPECT_EQ(cache.generation(), 1U);
+
+    // Same maps: same parsed lists and classifier
+    auto again = cache.regions(RegionScanLevel::ALL_RW);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(first->get(), again->get());
+    EXPECT_EQ(classifier->get(), cache.classifier()->get());
+    EXPECT_EQ(cache.generation(), 1U);
+
+    // Levels are derived from the single parse
+    auto all = cache.regions(RegionScanLevel::ALL);
+    ASSERT_TRUE(all.has_value());
+    EXPECT_GE((*all)->size(), (*first)->size());
+    EXPECT_EQ(cache.generation(), 1U);
+
+    cache.reset(child.pid());
+    ASSERT_TRUE(cache.regions(RegionScanLevel::ALL_RW).has_value());
+    EXPECT_EQ(cache.generation(), 2U);
+}
+
+TEST(RegionCacheTest, FailsForMissingProcess) {
+    RegionCache cache{-1};
+    EXPECT_FALSE(cache.regions(RegionScanLevel::ALL).has_value());
+    EXPECT_FALSE(cache.classifier().has_value());
+}
@@ -1,9 +1,12 @@
 // Unit tests for core::RegionClassifier
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
+import core.maps;
 import core.region_classifier;
 
 using core::RegionClassifier;
@@ -33,3 +36,40 @@ TEST(RegionClassifierTest, ClassifyStackAndHeap) {
     EXPECT_NE(heapStr, std::string("unk"));
     std::free(heapPtr);
 }
+
+TEST(RegionClassifierTest, BinarySearchHonoursBoundsAndGaps) {
+    auto region = [](std::uintptr_t start, std::size_t size,
+                     core::RegionType type, std::string name) {
+        core::Region out;
+        out.start = reinterpret_cast<void*>(start);
+        out.size = size;
+        out.type = type;
+        out.filename = std::move(name);
+        return out;
+    };
+    // Deliberately unsorted
+    const std::vector<core::Region> REGIONS = {
+        region(0x5000, 0x1000, core::RegionType::STACK, "[stack]"),
+        region(0x1000, 0x1000, core::RegionType::EXE, "/usr/bin/prog"),
+        region(0x2000, 0x2000, core::RegionType::HEAP, "[heap]"),
+    };
+    const auto CLASSIFIER = RegionClassifier::fromRegions(REGIONS);
+    EXPECT_EQ(CLASSIFIER.size(), 3U);
+    EXPECT_EQ(CLASSIFIER.classify(0x0fff), "unk");
+    EXPECT_EQ(CLASSIFIER.classify(0x1000), "exe:/usr/bin/prog");
+    EXPECT_EQ(CLASSIFIER.classify(0x1fff), "exe:/usr/bin/prog");
+    EXPECT_EQ(CLASSIFIER.classify(0x2000), "heap");
+    EXPECT_EQ(CLASSIFIER.classify(0x3fff), "heap");
+    EXPECT_EQ(CLASSIFIER.classify(0x4000), "unk");
+    EXPECT_EQ(CLASSIFIER.classify(0x5800), "stack");
+    EXPECT_EQ(CLASSIFIER.classify(0x6000), "unk");
+    EXPECT_EQ(CLASSIFIER.getRegionType(0x2800), core::RegionType::HEAP);
+    EXPECT_FALSE(CLASSIFIER.getRegionType(0x4800).has_value());
+
+    // Region ids are one per region and label like classify()
+    EXPECT_EQ(CLASSIFIER.regionId(0x2000), CLASSIFIER.regionId(0x3fff));
+    EXPECT_NE(CLASSIFIER.regionId(0x1000), CLASSIFIER.regionId(0x2000));
+    EXPECT_EQ(CLASSIFIER.regionId(0x4000), RegionClassifier::NO_REGION);
+    EXPECT_EQ(CLASSIFIER.label(CLASSIFIER.regionId(0x5800)), "stack");
+    EXPECT_EQ(CLASSIFIER.label(RegionClassifier::NO_REGION), "unk");
+}
@@ -0,0 +1,89 @@
+// Unit tests for core::ScanHistory
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+import core.scan_history;   // ScanHistory
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.types;          // ScanRecord
+import value.flags;         // MatchFlags
+
+using core::ScanHistory;
+
+namespace {
+
+auto matchesAt(std::uintptr_t base, std::size_t size = 64)
+    -> scan::MatchesAndOldValuesArray {
+    scan::MatchesAndOldValuesArray arr;
+    scan::MatchesAndOldValuesSwath swath{reinterpret_cast<void*>(base),
+                                         scan::ByteBuffer(size, 5)};
+    swath.setMatch(8, MatchFlags::B32, 0);
+    arr.addSwath(std::move(swath));
+    return arr;
+}
+
+auto fileCount(const std::string& dir) -> std::size_t {
+    std::size_t count = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        count += entry.is_regular_file() ? 1 : 0;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(ScanHistoryTest, SpillsMatchesToDisk) {
+    std::string parent =
+        (std::filesystem::temp_directory_path() / "history-XXXXXX").string();
+    ASSERT_NE(::mkdtemp(parent.data()), nullptr);
+    {
+        ScanHistory history;
+        history.setSpillParent(parent);
+        for (std::uintptr_t i = 0; i < 12; ++i) {
+            history.add(ScanRecord{}, matchesAt(0x1000 * (i + 1)));
+        }
+        // Only the newest ten stay, each on disk
+        ASSERT_EQ(history.count(), 10U);
+        EXPECT_EQ(fileCount(parent), 10U);
+        ASSERT_NE(history.snapshotFile(0), nullptr);
+        EXPECT_EQ(history.get(0)->matches.matchCount(), 0U);
+        auto oldest = history.loadMatches(0);
+        ASSERT_TRUE(oldest.has_value()) << oldest.error();
+        ASSERT_EQ(oldest->matchCount(), 1U);
+        EXPECT_EQ(oldest->matchAt(0)->address, 0x3000U + 8);
+    }
+    // Spill files go away with the history
+    EXPECT_EQ(fileCount(parent), 0U);
+    std::filesystem::remove_all(parent);
+}
+
+TEST(ScanHistoryTest, KeepsMatchesInMemoryWithoutSpillDirectory) {
+    ScanHistory history;
+    history.setSpillParent("");
+    history.add(ScanRecord{}, matchesAt(0x1000));
+    EXPECT_EQ(history.snapshotFile(0), nullptr);
+    ASSERT_NE(history.get(0), nullptr);
+    EXPECT_EQ(history.loadMatches(0)->matchCount(), 1U);
+    EXPECT_FALSE(history.loadMatches(1).has_value());
+}
+
+TEST(ScanHistoryTest, RamEntriesShareBytesAndHonourCapacity) {
+    ScanHistory history;
+    history.setSpillParent("");
+    history.setCapacity(30);
+    constexpr std::size_t SIZE = 256 * 1024;
+    const auto MATCHES = matchesAt(0x1000, SIZE);
+    for (int i = 0; i < 40; ++i) {
+        history.add(ScanRecord{}, MATCHES);
+    }
+    ASSERT_EQ(history.count(), 30U);
+    // The swath's bytes are stored once, not thirty times
+    EXPECT_LT(history.memoryUsage(), 2 * SIZE);
+    EXPECT_EQ(history.loadMatches(29)->matchAt(0)->address, 0x1000U + 8);
+
+    history.setCapacity(5);
+    EXPECT_EQ(history.count(), 5U);
+}
@@ -0,0 +1,114 @@
+// Tests for background scans: progress, cancellation and partial results
+
+import core.scan_task;  // ScanTask
+import core.scanner;    // Scanner, ScannerResult
+import scan.types;      // ScanControl, ScanOptions
+import value.core;      // UserValue
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+
+#include "child_process.h"
+
+using test_support::ChildProcess;
+
+namespace {
+
+auto anyInt32() -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    return opts;
+}
+
+}  // namespace
+
+TEST(ScanTask, SnapshotRunsToCompletionWithProgress) {
+    ChildProcess child;
+    ASSERT_GT(child.pid(), 0);
+    core::Scanner scanner(child.pid());
+    const auto OPTS = anyInt32();
+
+    core::ScanTask task([&](ScanControl& control) {
+        return scanner.snapshot(OPTS, std::nullopt, false, &control);
+    });
+    auto result = task.wait();
+    ASSERT_TRUE(result.success) << result.error.value_or("");
+    EXPECT_FALSE(result.stats.cancelled);
+    EXPECT_GT(result.matchCount, 0U);
+
+    const auto PROGRESS = task.progress();
+    EXPECT_GT(PROGRESS.bytesTotal, 0U);
+    EXPECT_EQ(PROGRESS.bytesDone, PROGRESS.bytesTotal);
+    EXPECT_GT(PROGRESS.regionsTotal, 0U);
+    EXPECT_EQ(PROGRESS.regionsDone, PROGRESS.regionsTotal);
+    EXPECT_DOUBLE_EQ(PROGRESS.fraction(), 1.0);
+    EXPECT_TRUE(task.done());
+}
+
+TEST(ScanTask, CancelReachesTheJob) {
+    std::atomic<bool> started{false};
+    core::ScanTask task([&](ScanControl& control) {
+        started = true;
+        while (!control.stopRequested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return core::ScannerResult{.success = true};
+    });
+    EXPECT_FALSE(task.waitFor(std::chrono::milliseconds(20)));
+    task.cancel();
+    EXPECT_TRUE(task.cancelRequested());
+    EXPECT_TRUE(task.wait().success);
+    EXPECT_TRUE(started);
+}
+
+TEST(ScanTask, DestroyingARunningTaskCancelsIt) {
+    std::atomic<bool> stopped{false};
+    {
+        core::ScanTask task([&](ScanControl& control) {
+            while (!control.stopRequested()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            stopped = true;
+            return core::ScannerResult{};
+        });
+    }
+    EXPECT_TRUE(stopped);
+}
+
+// 取消后的扫描成功返回部分结果；取消的过滤保留未检查的匹配
+TEST(ScanTask, CancelledScanAndFilterKeepPartialResults) {
+    ChildProcess child;
+    ASSERT_GT(child.pid(), 0);
+    core::Scanner scanner(child.pid());
+    const auto OPTS = anyInt32();
+    std::stop_source stop;
+    stop.request_stop();
+
+    ScanControl stopped{stop.get_token()};
+    auto early = scanner.snapshot(OPTS, std::nullopt, false, &stopped);
+    ASSERT_TRUE(early.success) << early.error.value_or("");
+    EXPECT_TRUE(early.stats.cancelled);
+    EXPECT_EQ(early.matchCount, 0U);
+    EXPECT_EQ(stopped.progress().bytesDone, 0U);
+
+    auto full = scanner.snapshot(OPTS);
+    ASSERT_TRUE(full.success) << full.error.value_or("");
+    ASSERT_GT(full.matchCount, 0U);
+
+    auto narrowOpts = OPTS;
+    narrowOpts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    const auto VALUE = UserValue::fromScalar<std::int32_t>(0x7eadbeef);
+    ScanControl filterStop{stop.get_token()};
+    auto kept = scanner.filter(narrowOpts, VALUE, false, &filterStop);
+    ASSERT_TRUE(kept.success) << kept.error.value_or("");
+    EXPECT_TRUE(kept.stats.cancelled);
+    EXPECT_EQ(kept.matchCount, full.matchCount);
+    EXPECT_EQ(filterStop.progress().matchesDone, 0U);
+    EXPECT_GT(filterStop.progress().matchesTotal, 0U);
+}
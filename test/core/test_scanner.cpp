@@ -143,3 +143,54 @@ TEST_F(ScannerTest, FullThenFilteredAndReset) {
     EXPECT_GE(fullAgainCount, narrowedCount)
         << "Full scan should reset/widen matches";
 }
+
+// Test: a configured pool is kept across repeated scan/filter rounds
+TEST_F(ScannerTest, ConfiguredPoolIsReused) {
+    ASSERT_GT(childPid(), 0);
+    Scanner scanner(childPid());
+    ASSERT_TRUE(scanner.configureThreads({.threads = 3}).has_value());
+    EXPECT_EQ(scanner.threadCount(), 3U);
+    EXPECT_EQ(scanner.threadOptions().threads, 3U);
+
+    UserValue val = UserValue::of<int8_t>(42);
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_8;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    for (int round = 0; round < 3; ++round) {
+        auto full = scanner.snapshot(opts, val);
+        ASSERT_TRUE(full.success) << full.error.value_or("");
+        EXPECT_GT(full.matchCount, 0U);
+        auto narrowed = scanner.filter(opts, val);
+        ASSERT_TRUE(narrowed.success) << narrowed.error.value_or("");
+        EXPECT_LE(narrowed.matchCount, full.matchCount);
+    }
+    EXPECT_EQ(scanner.threadCount(), 3U);
+
+    // Same options again keep the running pool
+    ASSERT_TRUE(scanner.configureThreads({.threads = 3}).has_value());
+    EXPECT_EQ(scanner.threadCount(), 3U);
+}
+
+// Test: one group scan finds every copy of the repeating 8-byte pattern and
+// a filter with the same group keeps them
+TEST_F(ScannerTest, GroupScanFindsPatternInOnePass) {
+    ASSERT_GT(childPid(), 0);
+    Scanner scanner(childPid());
+
+    UserValue group;
+    group.group.push_back({.value = Value::of<int8_t>(42), .offset = 0});
+    group.group.push_back({.value = Value::of<int8_t>(9), .offset = 3});
+    group.group.push_back({.value = Value::of<int8_t>(13)});
+    group.groupWindow = 8;
+    group.primary = group.group.front().value;
+    ScanOptions opts;
+    opts.dataType = ScanDataType::GROUP;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+
+    auto full = scanner.snapshot(opts, group);
+    ASSERT_TRUE(full.success) << full.error.value_or("");
+    EXPECT_GE(full.matchCount, 256U / 8 - 1);
+    auto narrowed = scanner.filter(opts, group);
+    ASSERT_TRUE(narrowed.success) << narrowed.error.value_or("");
+    EXPECT_EQ(narrowed.matchCount, full.matchCount);
+}
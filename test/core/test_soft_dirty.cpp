@@ -0,0 +1,66 @@
+// Unit tests for core::SoftDirtyMap
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+import core.soft_dirty;
+
+using core::SoftDirtyMap;
+
+namespace {
+constexpr std::uint64_t CLEAN = core::PAGEMAP_PRESENT;
+constexpr std::uint64_t DIRTY = core::PAGEMAP_PRESENT | core::PAGEMAP_SOFT_DIRTY;
+constexpr std::uint64_t SWAPPED_CLEAN = core::PAGEMAP_SWAPPED;
+constexpr std::uint64_t UNMAPPED = 0;
+}  // namespace
+
+TEST(SoftDirtyMapTest, ClassifiesPagemapEntries) {
+    SoftDirtyMap map;
+    const std::size_t PAGE = map.pageSize();
+    const std::uintptr_t BASE = 0x10000 * PAGE;
+    const std::vector<std::uint64_t> ENTRIES = {CLEAN, DIRTY, SWAPPED_CLEAN,
+                                                UNMAPPED, CLEAN};
+    map.addRange(BASE, ENTRIES);
+
+    EXPECT_EQ(map.pageCount(), 5U);
+    EXPECT_EQ(map.cleanPages(), 3U);
+    EXPECT_TRUE(map.isClean(BASE, PAGE));
+    EXPECT_TRUE(map.isClean(BASE + 8, 16));
+    EXPECT_FALSE(map.isClean(BASE + PAGE, 4));
+    EXPECT_TRUE(map.isClean(BASE + 2 * PAGE, PAGE));
+    // Unmapped pages may have been zapped; never trust them
+    EXPECT_FALSE(map.isClean(BASE + 3 * PAGE, 4));
+    // A window straddling into a dirty page is dirty
+    EXPECT_FALSE(map.isClean(BASE + PAGE - 2, 4));
+    // Outside every loaded range
+    EXPECT_FALSE(map.isClean(BASE - PAGE, 4));
+    EXPECT_FALSE(map.isClean(BASE + 4 * PAGE + PAGE - 2, 4));
+}
+
+TEST(SoftDirtyMapTest, LoadsOwnPagemap) {
+    std::vector<std::uint8_t> buffer(64 * 1024, 1);
+    const auto BEGIN = reinterpret_cast<std::uintptr_t>(buffer.data());
+    auto map = SoftDirtyMap::load(
+        ::getpid(), {{BEGIN, BEGIN + buffer.size()}, {BEGIN + 100, BEGIN + 200}});
+    if (!map) {
+        GTEST_SKIP() << map.error();
+    }
+    // Ranges are page-aligned outward and merged
+    EXPECT_GE(map->pageCount(), buffer.size() / map->pageSize());
+    EXPECT_LE(map->pageCount(), buffer.size() / map->pageSize() + 1);
+}
+
+TEST(SoftDirtyMapTest, ClearedPageTurnsDirtyOnWrite) {
+    if (!core::softDirtySupported()) {
+        GTEST_SKIP() << "kernel without CONFIG_MEM_SOFT_DIRTY";
+    }
+    std::vector<std::uint8_t> buffer(4 * 4096, 1);
+    const auto BEGIN = reinterpret_cast<std::uintptr_t>(buffer.data());
+    ASSERT_TRUE(core::clearSoftDirty(::getpid()).has_value());
+    buffer[0] = 2;
+    auto map = SoftDirtyMap::load(::getpid(), {{BEGIN, BEGIN + buffer.size()}});
+    ASSERT_TRUE(map.has_value()) << map.error();
+    EXPECT_FALSE(map->isClean(BEGIN, 1));
+}
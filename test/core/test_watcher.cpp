@@ -0,0 +1,97 @@
+// Unit tests for core::Watcher
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+import core.watcher;
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Drain until count events arrived or about two seconds passed
+auto collect(core::Watcher& watcher, std::size_t count)
+    -> std::vector<core::WatchEvent> {
+    std::vector<core::WatchEvent> events;
+    for (int i = 0; i < 200 && events.size() < count; ++i) {
+        watcher.drain(
+            [&](const core::WatchEvent& event) { events.push_back(event); });
+        std::this_thread::sleep_for(10ms);
+    }
+    return events;
+}
+
+// Wait until the watcher has made ticks more passes
+void waitTicks(const core::Watcher& watcher, std::uint64_t ticks) {
+    const auto TARGET = watcher.ticks() + ticks;
+    for (int i = 0; i < 200 && watcher.ticks() < TARGET; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+}
+
+}  // namespace
+
+TEST(WatcherTest, ReportsChangesOfWatchedValues) {
+    std::array<volatile std::uint32_t, 64> values{};
+    core::Watcher watcher(getpid(), 2ms);
+    for (auto& value : values) {
+        watcher.add(reinterpret_cast<std::uintptr_t>(&value), sizeof(value));
+    }
+    EXPECT_EQ(watcher.size(), values.size());
+    waitTicks(watcher, 2);  // baseline read
+
+    values[3] = 7;
+    values[40] = 0xdeadbeef;
+    auto events = collect(watcher, 2);
+    ASSERT_EQ(events.size(), 2U);
+    EXPECT_EQ(events[0].address, reinterpret_cast<std::uintptr_t>(&values[3]));
+    EXPECT_EQ(events[0].width, 4U);
+    EXPECT_EQ(events[0].oldValue, 0U);
+    EXPECT_EQ(events[0].newValue, 7U);
+    EXPECT_EQ(events[1].newValue, 0xdeadbeefU);
+    EXPECT_EQ(watcher.droppedEvents(), 0U);
+}
+
+TEST(WatcherTest, AddedAddressesStartFromTheirCurrentValue) {
+    volatile std::uint64_t first = 1;
+    volatile std::uint64_t second = 2;
+    core::Watcher watcher(getpid(), 2ms);
+    watcher.add(reinterpret_cast<std::uintptr_t>(&first));
+    waitTicks(watcher, 2);
+    watcher.add(reinterpret_cast<std::uintptr_t>(&second));
+    waitTicks(watcher, 2);
+    EXPECT_TRUE(collect(watcher, 1).empty());
+
+    first = 10;
+    EXPECT_TRUE(watcher.remove(reinterpret_cast<std::uintptr_t>(&second)));
+    auto events = collect(watcher, 1);
+    ASSERT_EQ(events.size(), 1U);
+    EXPECT_EQ(events[0].oldValue, 1U);
+    EXPECT_EQ(events[0].newValue, 10U);
+}
+
+TEST(WatcherTest, AddsManyEntriesAtOnce) {
+    std::array<volatile std::uint16_t, 16> values{};
+    std::vector<core::Watcher::Entry> entries;
+    for (auto& value : values) {
+        entries.emplace_back(reinterpret_cast<std::uintptr_t>(&value),
+                             sizeof(value));
+    }
+    core::Watcher watcher(getpid(), 2ms);
+    watcher.add(entries);
+    EXPECT_EQ(watcher.watched(),
+              std::vector<core::Watcher::Entry>(entries.begin(), entries.end()));
+    waitTicks(watcher, 2);
+
+    values[9] = 0x1234;
+    auto events = collect(watcher, 1);
+    ASSERT_EQ(events.size(), 1U);
+    EXPECT_EQ(events[0].address, entries[9].first);
+    EXPECT_EQ(events[0].width, 2U);
+    EXPECT_EQ(events[0].newValue, 0x1234U);
+}
@@ -0,0 +1,115 @@
+// Tests for skipping and zero-filling non-resident pages in scans
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "child_process.h"
+
+import scan.engine;         // runScanInternal, runScanParallel
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.types;          // ScanOptions, AbsentPages
+import value.core;          // UserValue
+import core.maps;           // RegionScanLevel
+import core.pagemap;        // PagemapReader
+
+using test_support::ChildProcess;
+
+namespace {
+
+constexpr std::size_t HEAP_BYTES = 8 * 1024 * 1024;
+constexpr std::int32_t MARKER = 0x5EED1E55;
+
+// Child setup: grow [heap] but touch only its first and middle page
+auto touchSparseHeap() -> std::uintptr_t {
+    void* block = sbrk(static_cast<intptr_t>(HEAP_BYTES));
+    if (block == reinterpret_cast<void*>(-1)) {
+        _exit(1);
+    }
+    auto* heap = static_cast<volatile std::int32_t*>(block);
+    heap[0] = MARKER;
+    heap[HEAP_BYTES / 2 / sizeof(std::int32_t)] = MARKER;
+    return reinterpret_cast<std::uintptr_t>(block);
+}
+
+auto int32Options(AbsentPages absent) -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    opts.step = 4;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    opts.absentPages = absent;
+    return opts;
+}
+
+// Matches inside the child's sparse heap block
+auto heapMatches(const scan::MatchesAndOldValuesArray& arr,
+                 std::uintptr_t base) -> std::size_t {
+    std::size_t count = 0;
+    arr.forEachMatch([&](const scan::MatchView& match) {
+        if (match.address >= base && match.address < base + HEAP_BYTES) {
+            ++count;
+        }
+    });
+    return count;
+}
+
+auto pagemapReadable(pid_t pid) -> bool {
+    core::PagemapReader reader{pid};
+    return reader.open().has_value();
+}
+
+}  // namespace
+
+TEST(AbsentPagesTest, SkipLeavesUntouchedBlocksOut) {
+    ChildProcess child{touchSparseHeap};
+    ASSERT_GT(child.pid(), 0);
+    ASSERT_NE(child.base(), 0U);
+    if (!pagemapReadable(child.pid())) {
+        GTEST_SKIP() << "pagemap not readable";
+    }
+    const UserValue VAL = UserValue::fromScalar<std::int32_t>(MARKER);
+
+    scan::MatchesAndOldValuesArray skipped;
+    auto stats = runScanInternal(child.pid(), int32Options(AbsentPages::SKIP),
+                                 &VAL, skipped, nullptr);
+    ASSERT_TRUE(stats.has_value()) << stats.error();
+    EXPECT_EQ(heapMatches(skipped, child.base()), 2U);
+    EXPECT_GT(stats->bytesSkipped, 0U);
+
+    // The parallel path plans blocks the same way
+    scan::MatchesAndOldValuesArray parallel;
+    auto parallelStats =
+        runScanParallel(child.pid(), int32Options(AbsentPages::SKIP), &VAL,
+                        parallel, nullptr);
+    ASSERT_TRUE(parallelStats.has_value()) << parallelStats.error();
+    EXPECT_EQ(heapMatches(parallel, child.base()), 2U);
+    EXPECT_GT(parallelStats->bytesSkipped, 0U);
+}
+
+TEST(AbsentPagesTest, ZeroFillMatchesReadingEveryPage) {
+    ChildProcess child{touchSparseHeap};
+    ASSERT_GT(child.pid(), 0);
+    ASSERT_NE(child.base(), 0U);
+    if (!pagemapReadable(child.pid())) {
+        GTEST_SKIP() << "pagemap not readable";
+    }
+    const UserValue ZERO = UserValue::fromScalar<std::int32_t>(0);
+
+    // Reading faults untouched pages in, so zero-fill has to go first
+    scan::MatchesAndOldValuesArray zeroed;
+    auto zeroStats = runScanInternal(
+        child.pid(), int32Options(AbsentPages::ZERO), &ZERO, zeroed, nullptr);
+    ASSERT_TRUE(zeroStats.has_value()) << zeroStats.error();
+    EXPECT_GT(zeroStats->bytesSkipped, 0U);
+
+    scan::MatchesAndOldValuesArray read;
+    auto readStats = runScanInternal(
+        child.pid(), int32Options(AbsentPages::READ), &ZERO, read, nullptr);
+    ASSERT_TRUE(readStats.has_value()) << readStats.error();
+    EXPECT_EQ(readStats->bytesSkipped, 0U);
+
+    const std::size_t EXPECTED = HEAP_BYTES / sizeof(std::int32_t) - 2;
+    EXPECT_EQ(heapMatches(zeroed, child.base()), EXPECTED);
+    EXPECT_EQ(heapMatches(read, child.base()), EXPECTED);
+}
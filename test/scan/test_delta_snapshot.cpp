@@ -0,0 +1,81 @@
+// Tests for scan::DeltaSnapshot chunk sharing
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+import scan.delta_snapshot;  // DeltaSnapshot
+import scan.match_storage;   // MatchesAndOldValuesArray
+import value.flags;          // MatchFlags
+
+using scan::DeltaSnapshot;
+using scan::MatchesAndOldValuesArray;
+
+namespace {
+
+constexpr std::size_t SIZE = 3 * DeltaSnapshot::CHUNK_SIZE + 100;
+
+auto makeArray() -> MatchesAndOldValuesArray {
+    scan::ByteBuffer bytes(SIZE);
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 13);
+    }
+    MatchesAndOldValuesArray arr;
+    scan::MatchesAndOldValuesSwath swath{reinterpret_cast<void*>(0x100000),
+                                         std::move(bytes)};
+    for (std::size_t i = 0; i < SIZE; i += 16) {
+        swath.setMatch(i, MatchFlags::B32, 0);
+    }
+    swath.setMatch(SIZE - 1, MatchFlags::B8, 0);
+    arr.addSwath(std::move(swath));
+    return arr;
+}
+
+auto addresses(const MatchesAndOldValuesArray& arr)
+    -> std::vector<std::uintptr_t> {
+    std::vector<std::uintptr_t> out;
+    arr.forEachMatch(
+        [&](const scan::MatchView& match) { out.push_back(match.address); });
+    return out;
+}
+
+}  // namespace
+
+TEST(DeltaSnapshotTest, SharesUnchangedChunks) {
+    auto arr = makeArray();
+    const auto FIRST = DeltaSnapshot::build(arr, nullptr);
+    EXPECT_EQ(FIRST.ownedBytes(), SIZE);
+    EXPECT_EQ(FIRST.matchCount(), arr.matchCount());
+
+    // Narrowing alone keeps every byte shared
+    arr.retainMatches([](const scan::MatchView& match) {
+        return match.address % 64 == 0 ? match.info : scan::MatchInfo{};
+    });
+    const auto SECOND = DeltaSnapshot::build(arr, &FIRST);
+    EXPECT_EQ(SECOND.ownedBytes(), 0U);
+    EXPECT_EQ(addresses(SECOND.load()), addresses(arr));
+
+    // One changed byte costs one chunk
+    arr.swaths[0].mutableBytes()[DeltaSnapshot::CHUNK_SIZE + 5] ^= 0xFF;
+    const auto THIRD = DeltaSnapshot::build(arr, &SECOND);
+    EXPECT_EQ(THIRD.ownedBytes(), DeltaSnapshot::CHUNK_SIZE);
+    const auto LOADED = THIRD.load();
+    ASSERT_EQ(LOADED.swaths.size(), 1U);
+    EXPECT_TRUE(std::ranges::equal(LOADED.swaths[0].bytes(),
+                                   arr.swaths[0].bytes()));
+    EXPECT_EQ(addresses(LOADED), addresses(arr));
+}
+
+TEST(DeltaSnapshotTest, OutlivesThePreviousSnapshot) {
+    const auto ARR = makeArray();
+    std::optional<DeltaSnapshot> first = DeltaSnapshot::build(ARR, nullptr);
+    const auto SECOND = DeltaSnapshot::build(ARR, &*first);
+    first.reset();
+    const auto LOADED = SECOND.load();
+    ASSERT_EQ(LOADED.swaths.size(), 1U);
+    EXPECT_TRUE(
+        std::ranges::equal(LOADED.swaths[0].bytes(), ARR.swaths[0].bytes()));
+    EXPECT_EQ(addresses(LOADED), addresses(ARR));
+}
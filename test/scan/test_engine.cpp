@@ -1,8 +1,17 @@
 // Unit tests for scan::engine
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 import scan.engine;
+import scan.match_storage;
 import scan.types;
+import value.flags;
+
+using namespace scan;
 
 TEST(ScanEngineTest, ScanOptionsDefaults) {
     ScanOptions opts;
@@ -33,3 +42,71 @@ TEST(ScanEngineTest, CustomStepSize) {
 
     EXPECT_EQ(opts.step, 4);
 }
+
+namespace {
+
+// Swath over buffer[begin, end) with single-byte matches at the given offsets
+auto makeSwath(std::array<std::uint8_t, 256>& buffer, std::size_t begin,
+               std::size_t end, std::vector<std::size_t> matches)
+    -> MatchesAndOldValuesSwath {
+    MatchesAndOldValuesSwath swath;
+    swath.appendRange(buffer.data() + begin, buffer.data() + begin,
+                      end - begin);
+    for (const auto OFFSET : matches) {
+        swath.setMatch(OFFSET - begin, MatchFlags::B8, 1);
+    }
+    return swath;
+}
+
+// Buffer offsets of every match in out, in order
+auto matchOffsets(const MatchesAndOldValuesArray& out,
+                  const std::array<std::uint8_t, 256>& buffer)
+    -> std::vector<std::size_t> {
+    std::vector<std::size_t> offsets;
+    for (const auto& swath : out.swaths) {
+        const auto BASE = static_cast<std::size_t>(
+            static_cast<const std::uint8_t*>(swath.firstByteInChild) -
+            buffer.data());
+        for (auto index = swath.nextMatch(0);
+             index != MatchesAndOldValuesSwath::NPOS;
+             index = swath.nextMatch(index + 1)) {
+            offsets.push_back(BASE + index);
+        }
+    }
+    return offsets;
+}
+
+}  // namespace
+
+TEST(ScanEngineTest, AddChunkSwathsDropsLeadOnlySwaths) {
+    std::array<std::uint8_t, 256> buffer{};
+    MatchesAndOldValuesArray out;
+    out.addSwath(makeSwath(buffer, 0, 128, {10, 100}));
+    // A hole split the lead: [40, 60) and [70, 128) hold only lead bytes
+    std::vector<MatchesAndOldValuesSwath> swaths;
+    swaths.push_back(makeSwath(buffer, 40, 60, {}));
+    swaths.push_back(makeSwath(buffer, 70, 128, {}));
+    swaths.push_back(makeSwath(buffer, 90, 200, {100, 150}));
+
+    EXPECT_EQ(addChunkSwaths(out, swaths), 1U);  // 100 counted twice
+    ASSERT_EQ(out.swaths.size(), 2U);
+    EXPECT_EQ(out.swaths[0].size(), 90U);
+    EXPECT_EQ(matchOffsets(out, buffer),
+              (std::vector<std::size_t>{10, 100, 150}));
+}
+
+TEST(ScanEngineTest, AddChunkSwathsAbsorbsSwathsTheLeadCovers) {
+    std::array<std::uint8_t, 256> buffer{};
+    MatchesAndOldValuesArray out;
+    out.addSwath(makeSwath(buffer, 0, 40, {5}));
+    out.addSwath(makeSwath(buffer, 60, 128, {64, 120}));
+    // The lead starts before the last swath and cuts into the one before
+    std::vector<MatchesAndOldValuesSwath> swaths;
+    swaths.push_back(makeSwath(buffer, 20, 200, {130}));
+
+    EXPECT_EQ(addChunkSwaths(out, swaths), 0U);
+    ASSERT_EQ(out.swaths.size(), 2U);
+    EXPECT_EQ(out.swaths[0].size(), 20U);
+    EXPECT_EQ(matchOffsets(out, buffer),
+              (std::vector<std::size_t>{5, 64, 120, 130}));
+}
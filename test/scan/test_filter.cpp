@@ -11,10 +11,10 @@ using namespace scan;
 TEST(ScanFilterTest, NarrowSwathBasic) {
     // Test basic swath narrowing functionality
     MatchesAndOldValuesSwath swath;
-    swath.data.resize(10);
+    swath.resize(10);
 
     // Initially all entries should be processable
-    EXPECT_EQ(swath.data.size(), 10);
+    EXPECT_EQ(swath.size(), 10);
 }
 
 TEST(ScanFilterTest, EmptySwath) {
@@ -0,0 +1,490 @@
+// Unit tests for scan.kernel - typed kernels must agree with the routine path
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+import scan.kernel;
+import scan.factory;
+import scan.group;
+import scan.match_storage;
+import scan.snapshot_index;
+import scan.types;
+import value.core;
+import value.flags;
+
+namespace {
+
+auto makeSwath(const std::vector<uint8_t>& bytes)
+    -> scan::MatchesAndOldValuesSwath {
+    scan::MatchesAndOldValuesSwath swath;
+    swath.appendRange(reinterpret_cast<void*>(0x1000), bytes.data(),
+                      bytes.size());
+    return swath;
+}
+
+// Run the same block through the specialised kernel and the routine fallback
+void expectSameAsRoutine(const ScanOptions& opts,
+                         const std::vector<uint8_t>& bytes,
+                         const UserValue* userValue,
+                         std::span<const scan::OldSegment> oldSegments = {},
+                         std::size_t oldSliceLen = 0) {
+    auto routine =
+        scan::makeScanRoutine(opts.dataType, opts.matchType,
+                              opts.reverseEndianness);
+    auto typed = scan::makeScanKernel(opts, routine, userValue);
+    ASSERT_TRUE(typed.specialized);
+    scan::ScanKernel generic{.routine = routine,
+                             .block = &scan::routineBlockKernel};
+
+    const scan::BlockScanArgs ARGS{
+        .memory = std::span<const uint8_t>(bytes.data(), bytes.size()),
+        .address = reinterpret_cast<void*>(0x1000),
+        .step = opts.step,
+        .userValue = userValue,
+        .oldSegments = oldSegments,
+        .oldSliceLen = oldSliceLen,
+        .reverseEndianness = opts.reverseEndianness,
+    };
+
+    auto typedSwath = makeSwath(bytes);
+    auto genericSwath = makeSwath(bytes);
+    EXPECT_EQ(typed.scanBlock(ARGS, typedSwath),
+              generic.scanBlock(ARGS, genericSwath));
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        EXPECT_EQ(typedSwath.flags(i), genericSwath.flags(i)) << "offset " << i;
+        EXPECT_EQ(typedSwath.matchLength(i), genericSwath.matchLength(i))
+            << "offset " << i;
+    }
+}
+
+template <typename T>
+auto packValues(const std::vector<T>& values) -> std::vector<uint8_t> {
+    std::vector<uint8_t> bytes(values.size() * sizeof(T));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+}
+
+}  // namespace
+
+TEST(ScanKernelTest, SelectsTypedKernelOnlyForFixedWidthNumbers) {
+    EXPECT_NE(scan::selectBlockKernel(ScanDataType::INTEGER_32,
+                                      ScanMatchType::MATCH_EQUAL_TO, false),
+              nullptr);
+    EXPECT_NE(scan::selectBlockKernel(ScanDataType::FLOAT_64,
+                                      ScanMatchType::MATCH_RANGE, true),
+              nullptr);
+    EXPECT_NE(scan::selectBlockKernel(ScanDataType::INTEGER_32,
+                                      ScanMatchType::MATCH_CHANGED, false),
+              nullptr);
+    EXPECT_EQ(scan::selectBlockKernel(ScanDataType::ANY_NUMBER,
+                                      ScanMatchType::MATCH_EQUAL_TO, false),
+              nullptr);
+    EXPECT_EQ(scan::selectBlockKernel(ScanDataType::STRING,
+                                      ScanMatchType::MATCH_EQUAL_TO, false),
+              nullptr);
+}
+
+TEST(ScanKernelTest, FallbackKernelUsesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::STRING;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    auto kernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false));
+    EXPECT_FALSE(kernel.specialized);
+    EXPECT_EQ(kernel.block, &scan::routineBlockKernel);
+}
+
+TEST(ScanKernelTest, Int32EqualMatchesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    auto bytes = packValues<int32_t>({1, 42, -7, 42, 0, 42});
+    bytes.push_back(42);  // tail shorter than the type never matches
+    UserValue userValue = UserValue::fromScalar<int32_t>(42);
+    expectSameAsRoutine(opts, bytes, &userValue);
+}
+
+TEST(ScanKernelTest, Int16GreaterReverseMatchesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_16;
+    opts.matchType = ScanMatchType::MATCH_GREATER_THAN;
+    opts.reverseEndianness = true;
+    auto bytes = packValues<int16_t>({0x0100, 0x0200, 0x7F00, -1, 5});
+    UserValue userValue = UserValue::fromScalar<int16_t>(1);
+    expectSameAsRoutine(opts, bytes, &userValue);
+}
+
+TEST(ScanKernelTest, FloatRangeWithStepMatchesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::FLOAT_32;
+    opts.matchType = ScanMatchType::MATCH_RANGE;
+    opts.step = 4;
+    auto bytes = packValues<float>({0.5F, 1.0F, 2.5F, 3.0F, 10.0F, -1.0F});
+    UserValue userValue = UserValue::fromScalar<float>(3.0F);
+    userValue.secondary = Value::fromScalar<float>(1.0F);
+    expectSameAsRoutine(opts, bytes, &userValue);
+}
+
+TEST(ScanKernelTest, DoubleAnyMatchesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::FLOAT_64;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    auto bytes = packValues<double>({1.0, 2.0, 3.0});
+    expectSameAsRoutine(opts, bytes, nullptr);
+}
+
+TEST(ScanKernelTest, AnyNumberFusedKernelMatchesRoutine) {
+    std::vector<uint8_t> bytes = packValues<int32_t>({7, -7, 0x70000, 7});
+    const auto DOUBLES = packValues<double>({7.0, 1e300});
+    bytes.insert(bytes.end(), DOUBLES.begin(), DOUBLES.end());
+    bytes.push_back(7);
+
+    UserValue seven = UserValue::fromScalar<int64_t>(7);
+    UserValue narrow = seven;
+    narrow.primary.flags =
+        MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
+    UserValue range = UserValue::fromScalar<double>(8.0);
+    range.secondary = Value::fromScalar<double>(-8.0);
+    for (auto dataType : {ScanDataType::ANY_NUMBER, ScanDataType::ANY_INTEGER,
+                          ScanDataType::ANY_FLOAT}) {
+        ScanOptions opts;
+        opts.dataType = dataType;
+        expectSameAsRoutine(opts, bytes, nullptr);
+        opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+        expectSameAsRoutine(opts, bytes, &seven);
+        expectSameAsRoutine(opts, bytes, &narrow);
+        opts.matchType = ScanMatchType::MATCH_GREATER_THAN;
+        opts.reverseEndianness = true;
+        expectSameAsRoutine(opts, bytes, &narrow);
+        opts.matchType = ScanMatchType::MATCH_RANGE;
+        expectSameAsRoutine(opts, bytes, &range);
+    }
+}
+
+TEST(ScanKernelTest, AnyNumberDeltaKernelMatchesRoutine) {
+    auto current = packValues<int32_t>({5, 10, 20, 7, 7, 100, 3, 9});
+    auto previous = packValues<int32_t>({5, 8, 25, 7, 6, 90, 3, 9});
+    scan::MatchesAndOldValuesArray snapshot;
+    scan::MatchesAndOldValuesSwath swath;
+    swath.appendRange(reinterpret_cast<void*>(0x1000), previous.data(),
+                      previous.size());
+    snapshot.addSwath(swath);
+    const scan::SnapshotIndex INDEX{snapshot};
+    scan::SnapshotCursor cursor{&INDEX};
+    const auto SEGMENTS = cursor.segmentsFor(reinterpret_cast<void*>(0x1000),
+                                             current.size(), 8);
+
+    UserValue delta = UserValue::fromScalar<int64_t>(2);
+    delta.primary.flags =
+        MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
+    for (auto match : {ScanMatchType::MATCH_NOT_CHANGED,
+                       ScanMatchType::MATCH_CHANGED,
+                       ScanMatchType::MATCH_INCREASED,
+                       ScanMatchType::MATCH_INCREASED_BY}) {
+        ScanOptions opts;
+        opts.dataType = ScanDataType::ANY_NUMBER;
+        opts.matchType = match;
+        expectSameAsRoutine(opts, current, &delta, SEGMENTS, 8);
+    }
+}
+
+TEST(ScanKernelTest, AlignedWidthsOnlyDropsMisalignedWidths) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::ANY_INTEGER;
+    auto kernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false));
+    ASSERT_TRUE(kernel.specialized);
+
+    const std::vector<uint8_t> BYTES(16, 0);
+    auto swath = makeSwath(BYTES);
+    const scan::BlockScanArgs ARGS{
+        .memory = std::span<const uint8_t>(BYTES.data(), BYTES.size()),
+        .address = reinterpret_cast<void*>(0x1000),
+        .alignedWidthsOnly = true,
+    };
+    EXPECT_EQ(kernel.scanBlock(ARGS, swath), BYTES.size());
+
+    const auto ALL =
+        MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
+    EXPECT_EQ(swath.flags(0), ALL);
+    EXPECT_EQ(swath.matchLength(0), 8U);
+    EXPECT_EQ(swath.flags(1), MatchFlags::B8);
+    EXPECT_EQ(swath.matchLength(1), 1U);
+    EXPECT_EQ(swath.flags(2), MatchFlags::B8 | MatchFlags::B16);
+    EXPECT_EQ(swath.flags(4),
+              MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32);
+    EXPECT_EQ(swath.flags(8), ALL);
+    EXPECT_EQ(swath.flags(12),
+              MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32);
+}
+
+// Widths repeat with the address, so they must not cost storage per offset
+TEST(ScanKernelTest, AlignedWidthsOnlyKeepsSwathCompact) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::ANY_INTEGER;
+    auto kernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false));
+    const std::vector<uint8_t> BYTES(1 << 20, 0);
+    auto swath = makeSwath(BYTES);
+    const scan::BlockScanArgs ARGS{
+        .memory = std::span<const uint8_t>(BYTES.data(), BYTES.size()),
+        .address = reinterpret_cast<void*>(0x1000),
+        .alignedWidthsOnly = true,
+    };
+    EXPECT_EQ(kernel.scanBlock(ARGS, swath), BYTES.size());
+    // Byte plane plus one match bit per byte, and a little slack
+    EXPECT_LT(swath.memoryUsage(), BYTES.size() + BYTES.size() / 8 + 4096);
+    EXPECT_EQ(swath.flags(0x1000 - 8), MatchFlags::B8 | MatchFlags::B16 |
+                                           MatchFlags::B32 | MatchFlags::B64);
+    EXPECT_EQ(swath.flags(0x1006), MatchFlags::B8 | MatchFlags::B16);
+    EXPECT_EQ(swath.matchLength(0x1006), 2U);
+
+    // Trimming the front keeps every offset's widths
+    swath.eraseRange(0, 3);
+    EXPECT_EQ(swath.flags(0x1006 - 3), MatchFlags::B8 | MatchFlags::B16);
+    EXPECT_EQ(swath.flags(5), MatchFlags::B8 | MatchFlags::B16 |
+                                  MatchFlags::B32 | MatchFlags::B64);
+}
+
+TEST(ScanKernelTest, MissingUserValueMatchesNothing) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_64;
+    opts.matchType = ScanMatchType::MATCH_LESS_THAN;
+    auto bytes = packValues<int64_t>({1, 2, 3});
+    expectSameAsRoutine(opts, bytes, nullptr);
+}
+
+TEST(ScanKernelTest, Int32DeltaKernelsMatchRoutine) {
+    auto current = packValues<int32_t>({5, 10, 20, 7, 7, 100, 3, 9});
+    auto previous = packValues<int32_t>({5, 8, 25, 7, 6, 90, 3, 9});
+
+    // Previous snapshot covers everything but a hole at bytes [12, 18)
+    scan::MatchesAndOldValuesArray snapshot;
+    scan::MatchesAndOldValuesSwath first;
+    first.appendRange(reinterpret_cast<void*>(0x1000), previous.data(), 12);
+    scan::MatchesAndOldValuesSwath second;
+    second.appendRange(reinterpret_cast<void*>(0x1000 + 18),
+                       previous.data() + 18, previous.size() - 18);
+    snapshot.addSwath(first);
+    snapshot.addSwath(second);
+    const scan::SnapshotIndex INDEX{snapshot};
+    scan::SnapshotCursor cursor{&INDEX};
+    const auto SEGMENTS = cursor.segmentsFor(reinterpret_cast<void*>(0x1000),
+                                             current.size(), 4);
+    ASSERT_EQ(SEGMENTS.size(), 2U);
+
+    UserValue delta = UserValue::fromScalar<int32_t>(10);
+    for (auto match : {ScanMatchType::MATCH_NOT_CHANGED,
+                       ScanMatchType::MATCH_CHANGED,
+                       ScanMatchType::MATCH_INCREASED,
+                       ScanMatchType::MATCH_DECREASED,
+                       ScanMatchType::MATCH_INCREASED_BY}) {
+        ScanOptions opts;
+        opts.dataType = ScanDataType::INTEGER_32;
+        opts.matchType = match;
+        expectSameAsRoutine(opts, current, &delta, SEGMENTS, 4);
+    }
+}
+
+TEST(ScanKernelTest, ByteArrayPatternsMatchRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::BYTE_ARRAY;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    std::vector<uint8_t> bytes(300, 0x90);
+    for (size_t i = 0; i + 4 < bytes.size(); i += 37) {
+        bytes[i] = 0x48;
+        bytes[i + 1] = 0x8B;
+        bytes[i + 2] = static_cast<uint8_t>(i);
+        bytes[i + 3] = 0xE8;
+    }
+    UserValue single = UserValue::fromByteArray(
+        std::vector<uint8_t>{0x48, 0x8B, 0x00}, std::vector<uint8_t>{0xFF, 0xFF, 0x00});
+    expectSameAsRoutine(opts, bytes, &single);
+
+    // Overlapping alternatives: the longest wins where two start together
+    UserValue several = single;
+    several.alternatives.push_back(Value::fromByteArray(
+        std::vector<uint8_t>{0x48, 0x8B, 0x00, 0xE8},
+        std::vector<uint8_t>{0xFF, 0xFF, 0x00, 0xFF}));
+    several.alternatives.push_back(
+        Value::fromByteArray(std::vector<uint8_t>{0xE8, 0x90}));
+    expectSameAsRoutine(opts, bytes, &several);
+}
+
+TEST(ScanKernelTest, StringLiteralMatchesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::STRING;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    const std::string TEXT = "xxhello, hello world hellhello";
+    const std::vector<uint8_t> BYTES(TEXT.begin(), TEXT.end());
+    UserValue value = UserValue::fromString("hello");
+    expectSameAsRoutine(opts, BYTES, &value);
+}
+
+TEST(ScanKernelTest, StringKernelLooksBehindAcrossBlocks) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::STRING;
+    opts.matchType = ScanMatchType::MATCH_REGEX;
+    UserValue value = UserValue::fromString("a[0-9]+");
+    auto kernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false),
+        &value);
+    ASSERT_TRUE(kernel.strings);
+    EXPECT_EQ(kernel.lookBehind, ScanOptions::STRING_OVERLAP);
+
+    // The first block ends inside "a1234" and only sees "a12"
+    const std::string TEXT = "xxa12" "34ya5";
+    const std::vector<uint8_t> BYTES(TEXT.begin(), TEXT.end());
+    auto swath = makeSwath(BYTES);
+    auto scanAt = [&](std::size_t begin, std::size_t size) {
+        const scan::BlockScanArgs ARGS{
+            .memory = std::span<const uint8_t>(BYTES.data() + begin, size),
+            .baseIndex = begin,
+            .lookBehind = std::min(begin, kernel.lookBehind),
+        };
+        return kernel.scanBlock(ARGS, swath);
+    };
+    EXPECT_EQ(scanAt(0, 5), 1U);
+    EXPECT_EQ(swath.matchLength(2), 3U);
+    EXPECT_EQ(scanAt(5, 5), 1U);  // a5; a1234 replaces a12 uncounted
+    EXPECT_EQ(swath.matchLength(2), 5U);
+    EXPECT_EQ(swath.matchLength(8), 2U);
+
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    UserValue literal = UserValue::fromString("34ya");
+    auto literalKernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false),
+        &literal);
+    EXPECT_EQ(literalKernel.lookBehind, 3U);
+    auto literalSwath = makeSwath(BYTES);
+    const scan::BlockScanArgs SECOND{
+        .memory = std::span<const uint8_t>(BYTES.data() + 7, 2),
+        .baseIndex = 7,
+        .lookBehind = literalKernel.lookBehind,
+    };
+    EXPECT_EQ(literalKernel.scanBlock(SECOND, literalSwath), 1U);
+    EXPECT_EQ(literalSwath.matchLength(5), 4U);
+}
+
+namespace {
+
+// hp, maxhp (fixed at +4) and ammo (anywhere in 16 bytes) as one group
+auto playerGroup() -> UserValue {
+    UserValue value;
+    value.group.push_back({.value = Value::of<int32_t>(100), .offset = 0});
+    value.group.push_back({.value = Value::of<int32_t>(100), .offset = 4});
+    value.group.push_back({.value = Value::of<int16_t>(30)});
+    value.groupWindow = 16;
+    value.primary = value.group.front().value;
+    return value;
+}
+
+}  // namespace
+
+TEST(ScanKernelTest, GroupKernelMatchesRoutine) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::GROUP;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    const UserValue VALUE = playerGroup();
+
+    // Groups at 0 and 48 (ammo unaligned there); the pair at 32 lacks ammo
+    std::vector<int32_t> words(24, 0);
+    words[0] = 100;
+    words[1] = 100;
+    words[3] = 30;
+    words[8] = 100;
+    words[9] = 100;
+    words[12] = 100;
+    words[13] = 100;
+    words[14] = 30 << 16;  // ammo at 58
+    const auto BYTES = packValues(words);
+    expectSameAsRoutine(opts, BYTES, &VALUE);
+
+    auto kernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false),
+        &VALUE);
+    EXPECT_EQ(kernel.lookBehind, 15U);
+    auto swath = makeSwath(BYTES);
+    const scan::BlockScanArgs ARGS{
+        .memory = std::span<const uint8_t>(BYTES.data(), BYTES.size()),
+        .userValue = &VALUE,
+    };
+    EXPECT_EQ(kernel.scanBlock(ARGS, swath), 2U);
+    EXPECT_TRUE(swath.isMatch(0));
+    EXPECT_TRUE(swath.isMatch(48));
+    EXPECT_EQ(swath.matchLength(0), 16U);
+    EXPECT_EQ(swath.flags(0), MatchFlags::B32);
+
+    // Two equal members cannot both claim the anchor's bytes
+    UserValue twins;
+    twins.group.push_back({.value = Value::of<int32_t>(100), .offset = 0});
+    twins.group.push_back({.value = Value::of<int32_t>(100)});
+    twins.groupWindow = 8;
+    twins.primary = twins.group.front().value;
+    const std::vector<uint8_t> LONE = packValues(std::vector<int32_t>{100, 0});
+    EXPECT_FALSE(scan::groupMatchesAt(twins, LONE, false));
+    const std::vector<uint8_t> PAIR =
+        packValues(std::vector<int32_t>{100, 100});
+    EXPECT_TRUE(scan::groupMatchesAt(twins, PAIR, false));
+}
+
+TEST(ScanKernelTest, GroupKernelLooksBehindAcrossBlocks) {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::GROUP;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    const UserValue VALUE = playerGroup();
+    auto kernel = scan::makeScanKernel(
+        opts, scan::makeScanRoutine(opts.dataType, opts.matchType, false),
+        &VALUE);
+
+    // The group at 24 spans the block boundary at 32
+    std::vector<int32_t> words(16, 0);
+    words[6] = 100;
+    words[7] = 100;
+    words[9] = 30;
+    words[0] = 100;
+    words[1] = 100;
+    words[2] = 30;
+    const auto BYTES = packValues(words);
+    auto swath = makeSwath(BYTES);
+    auto scanAt = [&](std::size_t begin, std::size_t size) {
+        const scan::BlockScanArgs ARGS{
+            .memory = std::span<const uint8_t>(BYTES.data() + begin, size),
+            .baseIndex = begin,
+            .userValue = &VALUE,
+            .lookBehind = std::min(begin, kernel.lookBehind),
+        };
+        return kernel.scanBlock(ARGS, swath);
+    };
+    EXPECT_EQ(scanAt(0, 32), 1U);
+    EXPECT_TRUE(swath.isMatch(0));
+    EXPECT_FALSE(swath.isMatch(24));
+    EXPECT_EQ(scanAt(32, 32), 1U);  // 24 now complete; 0 not counted again
+    EXPECT_TRUE(swath.isMatch(24));
+    EXPECT_EQ(swath.matchLength(24), 16U);
+}
+
+// Taking the first free place in argument order would put the i8 on the
+// i16's only place; each placement must be tried
+TEST(ScanKernelTest, GroupPlacesFreeMembersByBacktracking) {
+    UserValue value;
+    value.group.push_back({.value = Value::of<int32_t>(1), .offset = 0});
+    value.group.push_back({.value = Value::of<int8_t>(7)});
+    value.group.push_back({.value = Value::of<int16_t>(0x0707)});
+    value.groupWindow = 8;
+    value.primary = value.group.front().value;
+
+    const std::vector<uint8_t> BYTES = {1, 0, 0, 0, 7, 7, 0, 7};
+    EXPECT_TRUE(scan::groupMatchesAt(value, BYTES, false));
+
+    // Two equal members still need two places
+    value.group.push_back({.value = Value::of<int8_t>(7)});
+    EXPECT_FALSE(scan::groupMatchesAt(value, BYTES, false));
+    auto more = BYTES;
+    more[6] = 7;
+    EXPECT_TRUE(scan::groupMatchesAt(value, more, false));
+}
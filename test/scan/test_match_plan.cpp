@@ -0,0 +1,81 @@
+// Unit tests for scan.match_plan - operands converted once per scan
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+import scan.match_plan;
+import scan.numeric;
+import scan.routine;
+import scan.types;
+import value.core;
+import value.flags;
+
+namespace {
+
+auto optionsFor(ScanDataType dataType, ScanMatchType matchType) -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = dataType;
+    opts.matchType = matchType;
+    return opts;
+}
+
+}  // namespace
+
+TEST(MatchPlanTest, OrdersRangeBoundsAndWidensFloats) {
+    UserValue value = UserValue::fromScalar<double>(10.0);
+    value.secondary = Value::fromScalar<double>(2.0);
+    const auto PLAN = scan::MatchPlan::build(
+        optionsFor(ScanDataType::FLOAT_64, ScanMatchType::MATCH_RANGE), &value);
+
+    const auto& operands = PLAN.operands<double>();
+    ASSERT_TRUE(operands.valid);
+    EXPECT_EQ(operands.low, 2.0);
+    EXPECT_EQ(operands.high, 10.0);
+    EXPECT_GT(operands.tolerance, 0.0);
+    EXPECT_TRUE(operands.inRange(2.0 - operands.tolerance / 2));
+    EXPECT_FALSE(operands.inRange(10.5));
+    EXPECT_EQ(PLAN.userValue(), &value);
+    EXPECT_TRUE(PLAN.needsUserValue());
+    EXPECT_FALSE(PLAN.usesOldValue());
+}
+
+TEST(MatchPlanTest, TypesTheValueDoesNotFitStayInvalid) {
+    UserValue value = UserValue::fromScalar<int16_t>(300);
+    const auto PLAN = scan::MatchPlan::build(
+        optionsFor(ScanDataType::INTEGER_16, ScanMatchType::MATCH_EQUAL_TO),
+        &value);
+    EXPECT_TRUE(PLAN.operands<int16_t>().valid);
+    EXPECT_EQ(PLAN.operands<int16_t>().low, 300);
+    EXPECT_FALSE(PLAN.operands<int8_t>().valid);
+    EXPECT_FALSE(PLAN.operands<int64_t>().valid);
+
+    // A missing high bound invalidates every type of a range scan
+    const auto RANGE = scan::MatchPlan::build(
+        optionsFor(ScanDataType::INTEGER_16, ScanMatchType::MATCH_RANGE),
+        &value);
+    EXPECT_FALSE(RANGE.operands<int16_t>().valid);
+}
+
+TEST(MatchPlanTest, PlannedRoutineAgreesWithPerCallConversion) {
+    UserValue value = UserValue::fromScalar<int32_t>(42);
+    const auto OPTS =
+        optionsFor(ScanDataType::INTEGER_32, ScanMatchType::MATCH_EQUAL_TO);
+    auto planned =
+        makeNumericScanRoutine<int32_t>(scan::makeMatchPlan(OPTS, &value));
+    auto plain = makeNumericScanRoutine<int32_t>(OPTS.matchType, false);
+
+    UserValue other = UserValue::fromScalar<int32_t>(7);
+    for (int32_t memv : {42, 7, -1}) {
+        const std::vector<uint8_t> BYTES(reinterpret_cast<uint8_t*>(&memv),
+                                         reinterpret_cast<uint8_t*>(&memv) + 4);
+        for (const UserValue* user : {&value, &other}) {
+            auto ctx = scan::makeScanContext(BYTES, nullptr, user,
+                                             user->flag(), false);
+            EXPECT_EQ(planned(ctx).matchLength, plain(ctx).matchLength)
+                << memv;
+        }
+    }
+}
@@ -1,6 +1,12 @@
 // Unit tests for scan::match_storage
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 import scan.match_storage;
 import value.flags;
 
@@ -13,9 +19,9 @@ TEST(MatchStorageTest, SwathAddElement) {
 
     swath.addElement(addr, 0xFF, MatchFlags::B8);
 
-    EXPECT_EQ(swath.data.size(), 1);
-    EXPECT_EQ(swath.data[0].oldByte, 0xFF);
-    EXPECT_EQ(swath.data[0].matchInfo, MatchFlags::B8);
+    EXPECT_EQ(swath.size(), 1);
+    EXPECT_EQ(swath.oldByte(0), 0xFF);
+    EXPECT_EQ(swath.flags(0), MatchFlags::B8);
     EXPECT_EQ(swath.firstByteInChild, addr);
 }
 
@@ -26,16 +32,16 @@ TEST(MatchStorageTest, SwathAppendRange) {
 
     swath.appendRange(addr, buffer.data(), buffer.size(), MatchFlags::B32);
 
-    EXPECT_EQ(swath.data.size(), 4);
-    EXPECT_EQ(swath.data[0].oldByte, 0x01);
-    EXPECT_EQ(swath.data[3].oldByte, 0x04);
+    EXPECT_EQ(swath.size(), 4);
+    EXPECT_EQ(swath.oldByte(0), 0x01);
+    EXPECT_EQ(swath.oldByte(3), 0x04);
     EXPECT_EQ(swath.firstByteInChild, addr);
 }
 
 TEST(MatchStorageTest, SwathEmptyByDefault) {
     MatchesAndOldValuesSwath swath;
 
-    EXPECT_EQ(swath.data.size(), 0);
+    EXPECT_EQ(swath.size(), 0);
     EXPECT_EQ(swath.firstByteInChild, nullptr);
 }
 
@@ -54,16 +60,227 @@ TEST(MatchStorageTest, AppendRangeDifferentFlagsAndBounds) {
     void* addr = static_cast<void*>(buffer.data());
 
     swath.appendRange(addr, buffer.data(), buffer.size(), MatchFlags::B8);
-    ASSERT_EQ(swath.data.size(), 3);
-    EXPECT_EQ(swath.data[0].oldByte, 0xAA);
-    EXPECT_EQ(swath.data[1].oldByte, 0xBB);
-    EXPECT_EQ(swath.data[2].oldByte, 0xCC);
+    ASSERT_EQ(swath.size(), 3);
+    EXPECT_EQ(swath.oldByte(0), 0xAA);
+    EXPECT_EQ(swath.oldByte(1), 0xBB);
+    EXPECT_EQ(swath.oldByte(2), 0xCC);
 
     // Ensure match flags recorded
-    EXPECT_EQ(swath.data[0].matchInfo, MatchFlags::B8);
+    EXPECT_EQ(swath.flags(0), MatchFlags::B8);
     // Add single element after range
     uint8_t testVal = 0x11;
     void* addr2 = static_cast<void*>(&testVal);
     swath.addElement(addr2, testVal, MatchFlags::B64);
-    EXPECT_EQ(swath.data.back().matchInfo, MatchFlags::B64);
+    EXPECT_EQ(swath.flags(swath.size() - 1), MatchFlags::B64);
+}
+
+TEST(MatchStorageTest, MatchBitsTrackFlagsAndLengths) {
+    MatchesAndOldValuesSwath swath;
+    std::array<uint8_t, 130> buffer{};
+    swath.appendRange(buffer.data(), buffer.data(), buffer.size());
+    EXPECT_FALSE(swath.hasMatches());
+
+    swath.setMatch(3, MatchFlags::B32, 4);
+    swath.setMatch(70, MatchFlags::B32, 4);
+    swath.setMatch(129, MatchFlags::STRING, 9);  // differs from the default
+
+    EXPECT_EQ(swath.matchCount(), 3U);
+    EXPECT_EQ(swath.nextMatch(0), 3U);
+    EXPECT_EQ(swath.nextMatch(4), 70U);
+    EXPECT_EQ(swath.nextMatch(71), 129U);
+    EXPECT_EQ(swath.nextMatch(130), MatchesAndOldValuesSwath::NPOS);
+    EXPECT_EQ(swath.matchLength(70), 4U);
+    EXPECT_EQ(swath.flags(129), MatchFlags::STRING);
+    EXPECT_EQ(swath.matchLength(129), 9U);
+    EXPECT_EQ(swath.flags(4), MatchFlags::EMPTY);
+
+    swath.clearMatch(70);
+    EXPECT_EQ(swath.matchCount(), 2U);
+    EXPECT_EQ(swath.nextMatch(4), 129U);
+}
+
+TEST(MatchStorageTest, EraseRangeShiftsMatchesAndBase) {
+    MatchesAndOldValuesSwath swath;
+    std::array<uint8_t, 100> buffer{};
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<uint8_t>(i);
+    }
+    swath.appendRange(buffer.data(), buffer.data(), buffer.size());
+    swath.setMatch(5, MatchFlags::B8, 1);
+    swath.setMatch(80, MatchFlags::B16, 2);
+
+    EXPECT_EQ(swath.eraseRange(0, 10), 1U);
+    EXPECT_EQ(swath.size(), 90U);
+    EXPECT_EQ(swath.firstByteInChild, static_cast<void*>(buffer.data() + 10));
+    EXPECT_EQ(swath.oldByte(0), 10U);
+    EXPECT_EQ(swath.nextMatch(0), 70U);
+    EXPECT_EQ(swath.flags(70), MatchFlags::B16);
+    EXPECT_EQ(swath.matchLength(70), 2U);
+}
+
+namespace {
+
+auto makeSparseCandidate(std::array<uint8_t, 256>& buffer)
+    -> MatchesAndOldValuesArray {
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<uint8_t>(i);
+    }
+    MatchesAndOldValuesSwath swath;
+    swath.appendRange(buffer.data(), buffer.data(), buffer.size());
+    swath.setMatch(16, MatchFlags::B32, 4);
+    swath.setMatch(18, MatchFlags::B16, 2);  // window overlaps the previous
+    swath.setMatch(200, MatchFlags::B32, 4);
+    MatchesAndOldValuesArray array;
+    array.addSwath(std::move(swath));
+    return array;
+}
+
+}  // namespace
+
+TEST(MatchStorageTest, AdaptStorageSwitchesToSparseWhenRare) {
+    std::array<uint8_t, 256> buffer{};
+    auto array = makeSparseCandidate(buffer);
+    array.adaptStorage(4);
+
+    ASSERT_TRUE(array.isSparse());
+    EXPECT_TRUE(array.swaths.empty());
+    EXPECT_EQ(array.matchCount(), 3U);
+    auto second = array.matchAt(1);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->address,
+              reinterpret_cast<std::uintptr_t>(buffer.data() + 18));
+    EXPECT_EQ(second->oldBytes[0], 18U);
+    EXPECT_EQ(second->info.flags, MatchFlags::B16);
+
+    std::vector<uint8_t> raw;
+    ASSERT_TRUE(array.getRawBytesAt(buffer.data() + 200, 4, raw));
+    EXPECT_EQ(raw, (std::vector<uint8_t>{200, 201, 202, 203}));
+}
+
+TEST(MatchStorageTest, RetainMatchesWorksInBothModes) {
+    std::array<uint8_t, 256> buffer{};
+    for (bool sparse : {false, true}) {
+        auto array = makeSparseCandidate(buffer);
+        if (sparse) {
+            array.sparsify(4);
+        }
+        array.retainMatches([](const MatchView& match) -> MatchInfo {
+            if (match.oldBytes[0] == 200) {
+                return {};
+            }
+            return {.flags = MatchFlags::B8, .length = 1};
+        });
+        EXPECT_EQ(array.matchCount(), 2U) << "sparse " << sparse;
+        std::vector<uint8_t> firstBytes;
+        array.forEachMatch([&](const MatchView& match) {
+            EXPECT_EQ(match.info.flags, MatchFlags::B8);
+            firstBytes.push_back(match.oldBytes[0]);
+        });
+        EXPECT_EQ(firstBytes, (std::vector<uint8_t>{16, 18}));
+    }
+}
+
+TEST(MatchStorageTest, DensifyMergesOverlappingWindows) {
+    std::array<uint8_t, 256> buffer{};
+    auto array = makeSparseCandidate(buffer);
+    array.sparsify(4);
+    array.densify();
+
+    ASSERT_FALSE(array.isSparse());
+    ASSERT_EQ(array.swaths.size(), 2U);
+    const auto& merged = array.swaths[0];
+    EXPECT_EQ(merged.firstByteInChild, static_cast<void*>(buffer.data() + 16));
+    EXPECT_EQ(merged.oldByte(0), 16U);
+    EXPECT_EQ(merged.flags(0), MatchFlags::B32);
+    EXPECT_EQ(merged.matchLength(0), 4U);
+    EXPECT_EQ(merged.flags(2), MatchFlags::B16);
+    EXPECT_EQ(array.matchCount(), 3U);
+}
+
+TEST(MatchStorageTest, MatchAtAgreesWithForEachMatch) {
+    // Several swaths, one empty, matches spread over many rank blocks
+    std::vector<uint8_t> bytes(5000, 0);
+    MatchesAndOldValuesArray array;
+    for (std::uintptr_t s = 0; s < 4; ++s) {
+        MatchesAndOldValuesSwath swath;
+        swath.appendRange(reinterpret_cast<void*>(0x100000 * (s + 1)),
+                          bytes.data(), bytes.size());
+        if (s != 1) {
+            for (std::size_t i = s; i < bytes.size(); i += 7 + s * 13) {
+                swath.setMatch(i, MatchFlags::B8, 1);
+            }
+        }
+        array.addSwath(std::move(swath));
+    }
+    std::vector<std::uintptr_t> expected;
+    array.forEachMatch(
+        [&](const MatchView& match) { expected.push_back(match.address); });
+    ASSERT_EQ(expected.size(), array.matchCount());
+    for (std::size_t n = 0; n < expected.size(); ++n) {
+        auto match = array.matchAt(n);
+        ASSERT_TRUE(match.has_value()) << n;
+        ASSERT_EQ(match->address, expected[n]) << n;
+    }
+    EXPECT_FALSE(array.matchAt(expected.size()).has_value());
+
+    std::vector<std::uintptr_t> tail;
+    array.forEachMatchFrom(expected.size() - 5, [&](const MatchView& match) {
+        tail.push_back(match.address);
+        return tail.size() < 3;
+    });
+    EXPECT_EQ(tail, std::vector<std::uintptr_t>(expected.end() - 5,
+                                                expected.end() - 2));
+}
+
+TEST(MatchStorageTest, MatchAtFollowsFilterAndDelete) {
+    std::array<uint8_t, 256> buffer{};
+    auto array = makeSparseCandidate(buffer);
+    ASSERT_EQ(array.matchAt(2)->oldBytes[0], 200U);  // builds the index
+    EXPECT_EQ(array.indexedMatchCount(), array.matchCount());
+
+    array.retainMatches([](const MatchView& match) -> MatchInfo {
+        return match.oldBytes[0] == 16 ? MatchInfo{} : match.info;
+    });
+    EXPECT_EQ(array.matchAt(0)->oldBytes[0], 18U);
+    EXPECT_FALSE(array.matchAt(2).has_value());
+    EXPECT_EQ(array.indexedMatchCount(), 2U);
+
+    unsigned long removed = 0;
+    array.deleteInAddressRange(buffer.data(), buffer.data() + 100, removed);
+    EXPECT_EQ(removed, 1U);
+    EXPECT_EQ(array.matchAt(0)->oldBytes[0], 200U);
+    EXPECT_FALSE(array.matchAt(1).has_value());
+    EXPECT_EQ(array.indexedMatchCount(), 1U);
+}
+
+TEST(MatchStorageTest, SwathPoolReusesPlanesThatFit) {
+    constexpr std::size_t SIZE = SwathPool::MIN_BYTES * 2;
+    std::array<uint8_t, 1> base{};
+    SwathPool pool;
+
+    MatchesAndOldValuesArray old;
+    auto first = pool.make(base.data(), SIZE);
+    first.setMatch(0, MatchFlags::B8, 1);
+    const auto* plane = first.bytes().data();
+    old.addSwath(std::move(first));
+    pool.recycle(std::move(old));
+    EXPECT_GE(pool.pooledBytes(), SIZE);
+
+    // Slightly smaller fits the recycled plane; its match bits start clear
+    auto reused = pool.make(base.data(), SIZE - 64);
+    EXPECT_EQ(reused.bytes().data(), plane);
+    EXPECT_EQ(reused.size(), SIZE - 64);
+    EXPECT_EQ(reused.matchCount(), 0U);
+    EXPECT_EQ(pool.reused(), 1U);
+    EXPECT_EQ(pool.pooledBytes(), 0U);
+
+    // Far smaller would waste most of a plane: freshly allocated instead
+    MatchesAndOldValuesArray again;
+    again.addSwath(std::move(reused));
+    pool.recycle(std::move(again));
+    auto small = pool.make(base.data(), SwathPool::MIN_BYTES);
+    EXPECT_NE(small.bytes().data(), plane);
+    EXPECT_EQ(pool.reused(), 1U);
+    pool.clear();
+    EXPECT_EQ(pool.pooledBytes(), 0U);
 }
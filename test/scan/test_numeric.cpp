@@ -101,3 +101,35 @@ TEST_F(ScanNumericTest, NumericRoutineSetsFlags) {
     EXPECT_EQ(result.matchLength, sizeof(uint16_t));
     EXPECT_EQ(result.matchedFlag, MatchFlags::B16);
 }
+
+// The fused matcher reports every width, not just the first type that fits
+TEST_F(ScanNumericTest, AnyNumberMatcherReportsAllWidths) {
+    const std::vector<uint8_t> DATA = {7, 0, 0, 0, 0, 0, 0, 0};
+    UserValue seven = UserValue::fromScalar<int64_t>(7);
+    seven.primary.flags =
+        MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32 | MatchFlags::B64;
+    const auto MATCHER = scan::AnyNumberMatcher::create(
+        ScanDataType::ANY_INTEGER, ScanMatchType::MATCH_EQUAL_TO, &seven,
+        false);
+
+    auto result = MATCHER.match(ScanMatchType::MATCH_EQUAL_TO, DATA, {});
+    EXPECT_EQ(result.flags, MatchFlags::B8 | MatchFlags::B16 |
+                                MatchFlags::B32 | MatchFlags::B64);
+    EXPECT_EQ(result.length, 8U);
+
+    // Only three bytes left: the narrow widths still match
+    result = MATCHER.match(ScanMatchType::MATCH_EQUAL_TO,
+                           std::span(DATA).first(3), {});
+    EXPECT_EQ(result.flags, MatchFlags::B8 | MatchFlags::B16);
+    EXPECT_EQ(result.length, 2U);
+
+    const std::vector<uint8_t> WIDE = {7, 1, 0, 0};
+    result = MATCHER.match(ScanMatchType::MATCH_EQUAL_TO, WIDE, {});
+    EXPECT_EQ(result.flags, MatchFlags::B8);
+
+    const auto ANY = scan::AnyNumberMatcher::create(
+        ScanDataType::ANY_NUMBER, ScanMatchType::MATCH_ANY, nullptr, false);
+    result = ANY.match(ScanMatchType::MATCH_ANY, WIDE, {});
+    EXPECT_EQ(result.flags, MatchFlags::B8 | MatchFlags::B16 | MatchFlags::B32);
+    EXPECT_EQ(result.length, 4U);
+}
@@ -0,0 +1,142 @@
+// Tests for soft-dirty page reuse in scans and filters
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "child_process.h"
+
+import scan.engine;         // runScanInternal, PageReuse
+import scan.filter;         // filterMatches
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.types;          // ScanOptions
+import value.core;          // UserValue
+import core.maps;           // RegionScanLevel
+import core.proc_mem;       // writeValue
+import core.soft_dirty;     // SoftDirtyMap
+
+using test_support::ChildProcess;
+
+namespace {
+
+constexpr std::size_t HEAP_BYTES = 256 * 1024;
+constexpr std::int32_t MARKER = 0x600DCAFE;
+constexpr std::size_t STRIDE = 977;
+
+// Child setup: grow [heap] to hold MARKER every STRIDE ints
+auto fillMarkerHeap() -> std::uintptr_t {
+    void* block = sbrk(static_cast<intptr_t>(HEAP_BYTES));
+    if (block == reinterpret_cast<void*>(-1)) {
+        _exit(1);
+    }
+    auto* heap = static_cast<volatile std::int32_t*>(block);
+    for (std::size_t i = 0; i < HEAP_BYTES / sizeof(std::int32_t); ++i) {
+        heap[i] = (i % STRIDE == 0) ? MARKER : 3;
+    }
+    return reinterpret_cast<std::uintptr_t>(block);
+}
+
+auto markerOptions() -> ScanOptions {
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    opts.step = 4;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    return opts;
+}
+
+auto isMatch(const scan::MatchesAndOldValuesArray& arr, std::uintptr_t addr)
+    -> bool {
+    bool found = false;
+    arr.forEachMatch([&](const scan::MatchView& match) {
+        found = found || match.address == addr;
+    });
+    return found;
+}
+
+// Every page of heap clean except the one holding dirtyAddr
+auto heapDirtyMap(std::uintptr_t base, std::uintptr_t dirtyAddr)
+    -> core::SoftDirtyMap {
+    core::SoftDirtyMap map;
+    const std::size_t PAGE = map.pageSize();
+    std::vector<std::uint64_t> entries(HEAP_BYTES / PAGE,
+                                       core::PAGEMAP_PRESENT);
+    entries[(dirtyAddr - base) / PAGE] |= core::PAGEMAP_SOFT_DIRTY;
+    map.addRange(base, entries);
+    return map;
+}
+
+}  // namespace
+
+TEST(PageReuseTest, ScanCopiesCleanPagesAndReadsDirtyOnes) {
+    ChildProcess child{fillMarkerHeap};
+    ASSERT_GT(child.pid(), 0);
+    ASSERT_NE(child.base(), 0U);
+    const auto OPTS = markerOptions();
+    const UserValue VAL = UserValue::fromScalar<std::int32_t>(MARKER);
+
+    scan::MatchesAndOldValuesArray previous;
+    ASSERT_TRUE(runScan(child.pid(), OPTS, &VAL, previous).has_value());
+
+    // Plant a fake marker on a clean page and one on the dirty page of the
+    // stored snapshot; only the clean one may surface in the rescan
+    const std::size_t PAGE = core::SoftDirtyMap{}.pageSize();
+    const std::uintptr_t FAKE_CLEAN = child.base() + 3 * PAGE + 8;
+    const std::uintptr_t FAKE_DIRTY = child.base() + 5 * PAGE + 8;
+    for (auto& swath : previous.swaths) {
+        const auto BEGIN = reinterpret_cast<std::uintptr_t>(swath.firstByteInChild);
+        for (auto addr : {FAKE_CLEAN, FAKE_DIRTY}) {
+            if (addr >= BEGIN && addr + 4 <= BEGIN + swath.size()) {
+                std::memcpy(swath.mutableBytes().data() + (addr - BEGIN),
+                            &MARKER, sizeof(MARKER));
+            }
+        }
+    }
+    const auto DIRTY = heapDirtyMap(child.base(), FAKE_DIRTY);
+    const scan::PageReuse REUSE{.snapshot = &previous, .dirty = &DIRTY};
+
+    scan::MatchesAndOldValuesArray rescanned;
+    auto statsExp =
+        runScanInternal(child.pid(), OPTS, &VAL, rescanned, nullptr, &REUSE);
+    ASSERT_TRUE(statsExp.has_value()) << statsExp.error();
+
+    EXPECT_GE(statsExp->bytesReused, HEAP_BYTES - 2 * PAGE);
+    EXPECT_TRUE(isMatch(rescanned, FAKE_CLEAN));
+    EXPECT_FALSE(isMatch(rescanned, FAKE_DIRTY));
+    EXPECT_TRUE(isMatch(rescanned, child.base()));
+}
+
+TEST(PageReuseTest, FilterSkipsReadsOnCleanPages) {
+    ChildProcess child{fillMarkerHeap};
+    ASSERT_GT(child.pid(), 0);
+    ASSERT_NE(child.base(), 0U);
+    const auto OPTS = markerOptions();
+    const UserValue VAL = UserValue::fromScalar<std::int32_t>(MARKER);
+
+    scan::MatchesAndOldValuesArray matches;
+    ASSERT_TRUE(runScan(child.pid(), OPTS, &VAL, matches).has_value());
+
+    // Overwrite two live markers behind the tracker's back: one on a page
+    // the map calls clean, one on the dirty page
+    const std::size_t PAGE = core::SoftDirtyMap{}.pageSize();
+    const std::uintptr_t CLEAN_HIT = child.base() + STRIDE * 4 * 2;
+    const std::uintptr_t DIRTY_HIT = child.base() + STRIDE * 4 * 5;
+    ASSERT_NE(CLEAN_HIT / PAGE, DIRTY_HIT / PAGE);
+    for (auto addr : {CLEAN_HIT, DIRTY_HIT}) {
+        ASSERT_TRUE(isMatch(matches, addr));
+        auto written = core::writeValue<std::int32_t>(
+            child.pid(), reinterpret_cast<void*>(addr), 7);
+        ASSERT_TRUE(written.has_value()) << written.error();
+    }
+
+    const auto DIRTY = heapDirtyMap(child.base(), DIRTY_HIT);
+    auto statsExp = filterMatches(child.pid(), OPTS, &VAL, matches, &DIRTY);
+    ASSERT_TRUE(statsExp.has_value()) << statsExp.error();
+
+    EXPECT_GT(statsExp->bytesReused, 0U);
+    EXPECT_TRUE(isMatch(matches, CLEAN_HIT));  // answered from old bytes
+    EXPECT_FALSE(isMatch(matches, DIRTY_HIT));
+}
@@ -1,11 +1,14 @@
 // Tests for parallel scan consistency vs sequential
 
 import scan.engine;        // runScan, runScanParallel, ScanOptions, ScanStats
+import scan.filter;        // filterMatches, filterMatchesParallel
 import scan.match_storage; // MatchesAndOldValuesArray
 import scan.types;         // ScanDataType, ScanMatchType
 import value.core;  // UserValue
 import value.flags;        // MatchFlags
 import core.maps;          // RegionScanLevel
+import core.region_filter; // RegionFilter
+import utils.thread_pool;  // ThreadPool
 
 #include <gtest/gtest.h>
 #include <signal.h>
@@ -14,8 +17,11 @@ import core.maps;          // RegionScanLevel
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 // RAII helper to spawn and cleanup an external target process
 class ExternalProcess {
@@ -47,15 +53,7 @@ class ExternalProcess {
 
 static auto countMatches(const scan::MatchesAndOldValuesArray& arr)
     -> std::size_t {
-    std::size_t total = 0;
-    for (const auto& swath : arr.swaths) {
-        for (const auto& cell : swath.data) {
-            if (cell.matchInfo != MatchFlags::EMPTY) {
-                ++total;
-            }
-        }
-    }
-    return total;
+    return arr.matchCount();
 }
 
 TEST(ScanParallel, ConsistencyWithSequentialAnyNumber) {
@@ -197,14 +195,382 @@ TEST(ScanParallel, StrictEqualityDeepCompare) {
 
         EXPECT_EQ(seqSwath.firstByteInChild, parSwath.firstByteInChild)
             << "Swath " << i << " base address mismatch";
-        EXPECT_EQ(seqSwath.data.size(), parSwath.data.size())
+        EXPECT_EQ(seqSwath.size(), parSwath.size())
             << "Swath " << i << " data size mismatch";
 
         // 比较每个 cell 的 matchInfo
         for (std::size_t j = 0;
-             j < std::min(seqSwath.data.size(), parSwath.data.size()); ++j) {
-            EXPECT_EQ(seqSwath.data[j].matchInfo, parSwath.data[j].matchInfo)
+             j < std::min(seqSwath.size(), parSwath.size()); ++j) {
+            EXPECT_EQ(seqSwath.flags(j), parSwath.flags(j))
                 << "Swath " << i << " cell " << j << " matchInfo mismatch";
         }
     }
 }
+
+// 过滤：并发与顺序结果必须完全一致
+TEST(ScanParallel, FilterMatchesSequentialResult) {
+    ExternalProcess target;
+    ASSERT_TRUE(target.valid()) << "Failed to spawn target process";
+    pid_t pid = target.pid();
+
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    opts.step = 4;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+
+    scan::MatchesAndOldValuesArray seqOut;
+    auto scanExp = runScan(pid, opts, nullptr, seqOut);
+    ASSERT_TRUE(scanExp.has_value()) << scanExp.error();
+    auto parOut = seqOut;
+
+    UserValue zero = UserValue::fromScalar<int32_t>(0);
+    ScanOptions filterOpts = opts;
+    filterOpts.matchType = ScanMatchType::MATCH_NOT_EQUAL_TO;
+    auto seqStatsExp = filterMatches(pid, filterOpts, &zero, seqOut);
+    ASSERT_TRUE(seqStatsExp.has_value()) << seqStatsExp.error();
+    auto parStatsExp = filterMatchesParallel(pid, filterOpts, &zero, parOut);
+    ASSERT_TRUE(parStatsExp.has_value()) << parStatsExp.error();
+
+    EXPECT_EQ(seqStatsExp->bytesScanned, parStatsExp->bytesScanned);
+    EXPECT_EQ(seqStatsExp->matches, parStatsExp->matches);
+    ASSERT_EQ(seqOut.isSparse(), parOut.isSparse());
+    ASSERT_EQ(seqOut.matchCount(), parOut.matchCount());
+
+    std::vector<std::uintptr_t> seqAddrs;
+    std::vector<std::uintptr_t> parAddrs;
+    seqOut.forEachMatch(
+        [&](const scan::MatchView& match) { seqAddrs.push_back(match.address); });
+    parOut.forEachMatch(
+        [&](const scan::MatchView& match) { parAddrs.push_back(match.address); });
+    EXPECT_EQ(seqAddrs, parAddrs);
+}
+
+// 匹配数超过一批 (wave) 时分批过滤, 结果仍须与顺序过滤一致
+TEST(ScanParallel, FilterInWavesMatchesSequential) {
+    constexpr std::size_t HEAP_BYTES = 24 * 1024 * 1024;
+    pid_t pid = fork();
+    if (pid == 0) {
+        void* block = sbrk(static_cast<intptr_t>(HEAP_BYTES));
+        if (block == reinterpret_cast<void*>(-1)) {
+            _exit(1);
+        }
+        auto* heap = static_cast<volatile std::uint8_t*>(block);
+        for (std::size_t i = 0; i < HEAP_BYTES; ++i) {
+            heap[i] = (i % 4099 == 0) ? 7 : 1;
+        }
+        pause();
+        _exit(0);
+    }
+    ASSERT_GT(pid, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_8;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    scan::MatchesAndOldValuesArray seqOut;
+    auto scanExp = runScan(pid, opts, nullptr, seqOut);
+    ASSERT_TRUE(scanExp.has_value()) << scanExp.error();
+    ASSERT_GT(seqOut.matchCount(), HEAP_BYTES);  // several waves
+    auto parOut = seqOut;
+
+    const UserValue ONE = UserValue::fromScalar<std::int8_t>(1);
+    ScanOptions filterOpts = opts;
+    filterOpts.matchType = ScanMatchType::MATCH_NOT_EQUAL_TO;
+    utils::ThreadPool pool(4);
+    auto seqStats = filterMatches(pid, filterOpts, &ONE, seqOut);
+    auto parStats = filterMatchesParallel(pid, filterOpts, &ONE, parOut, &pool);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    ASSERT_TRUE(seqStats.has_value()) << seqStats.error();
+    ASSERT_TRUE(parStats.has_value()) << parStats.error();
+
+    EXPECT_EQ(seqStats->matches, parStats->matches);
+    ASSERT_EQ(seqOut.matchCount(), parOut.matchCount());
+    EXPECT_GE(parOut.matchCount(), HEAP_BYTES / 4099);
+    std::vector<std::uintptr_t> seqAddrs;
+    std::vector<std::uintptr_t> parAddrs;
+    seqOut.forEachMatch(
+        [&](const scan::MatchView& match) { seqAddrs.push_back(match.address); });
+    parOut.forEachMatch(
+        [&](const scan::MatchView& match) { parAddrs.push_back(match.address); });
+    EXPECT_EQ(seqAddrs, parAddrs);
+}
+
+// 大区域被切分为多个块并行扫描，结果仍须与顺序扫描一致
+TEST(ScanParallel, LargeRegionIsChunkedConsistently) {
+    constexpr std::size_t HEAP_BYTES = 48 * 1024 * 1024;
+    constexpr std::int32_t MARKER = 0x5A17C0DE;
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Grow [heap] itself so the block is a single named region
+        void* block = sbrk(static_cast<intptr_t>(HEAP_BYTES));
+        if (block == reinterpret_cast<void*>(-1)) {
+            _exit(1);
+        }
+        auto* heap = static_cast<volatile std::int32_t*>(block);
+        for (std::size_t i = 0; i < HEAP_BYTES / sizeof(std::int32_t); ++i) {
+            heap[i] = (i % 1021 == 0) ? MARKER : 1;
+        }
+        pause();
+        _exit(0);
+    }
+    ASSERT_GT(pid, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    opts.step = 4;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    UserValue val = UserValue::fromScalar<std::int32_t>(MARKER);
+
+    scan::MatchesAndOldValuesArray seqOut;
+    auto seqStatsExp = runScan(pid, opts, &val, seqOut);
+    scan::MatchesAndOldValuesArray parOut;
+    auto parStatsExp = runScanParallel(pid, opts, &val, parOut, nullptr);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    ASSERT_TRUE(seqStatsExp.has_value()) << seqStatsExp.error();
+    ASSERT_TRUE(parStatsExp.has_value()) << parStatsExp.error();
+
+    EXPECT_GE(seqStatsExp->matches, HEAP_BYTES / sizeof(std::int32_t) / 1021);
+    EXPECT_EQ(seqStatsExp->regionsVisited, parStatsExp->regionsVisited);
+    EXPECT_EQ(seqStatsExp->bytesScanned, parStatsExp->bytesScanned);
+    EXPECT_EQ(seqStatsExp->matches, parStatsExp->matches);
+    ASSERT_EQ(seqOut.swaths.size(), parOut.swaths.size());
+    for (std::size_t i = 0; i < seqOut.swaths.size(); ++i) {
+        EXPECT_EQ(seqOut.swaths[i].firstByteInChild,
+                  parOut.swaths[i].firstByteInChild);
+        EXPECT_EQ(seqOut.swaths[i].matchCount(), parOut.swaths[i].matchCount());
+    }
+}
+
+// 跨越 16 MiB 切块边界的字符串与组合值也必须被找到
+TEST(ScanParallel, StringsAndGroupsCrossChunkBoundaries) {
+    constexpr std::size_t HEAP_BYTES = 40 * 1024 * 1024;
+    constexpr std::size_t CHUNK = 16 * 1024 * 1024;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    pid_t pid = fork();
+    if (pid == 0) {
+        void* block = sbrk(static_cast<intptr_t>(HEAP_BYTES));
+        if (block == reinterpret_cast<void*>(-1)) {
+            _exit(1);
+        }
+        std::memset(block, 0, HEAP_BYTES);
+        // Chunks are cut from the start of [heap], not of this block
+        std::uintptr_t start = 0;
+        std::uintptr_t end = 0;
+        char line[512];
+        FILE* maps = std::fopen("/proc/self/maps", "r");
+        while (maps != nullptr && std::fgets(line, sizeof(line), maps)) {
+            if (std::strstr(line, "[heap]") != nullptr) {
+                std::sscanf(line, "%lx-%lx", &start, &end);
+            }
+        }
+        auto* heap = reinterpret_cast<std::uint8_t*>(start);
+        std::memcpy(heap + CHUNK - 3, "edgeword", 8);
+        const std::int32_t HP = 100;
+        const std::int16_t AMMO = 30;
+        std::memcpy(heap + 2 * CHUNK - 6, &HP, sizeof(HP));
+        std::memcpy(heap + 2 * CHUNK - 2, &HP, sizeof(HP));
+        std::memcpy(heap + 2 * CHUNK + 4, &AMMO, sizeof(AMMO));
+        (void)write(fds[1], &start, sizeof(start));
+        pause();
+        _exit(0);
+    }
+    ASSERT_GT(pid, 0);
+    close(fds[1]);
+    std::uintptr_t heapStart = 0;
+    ASSERT_EQ(read(fds[0], &heapStart, sizeof(heapStart)),
+              static_cast<ssize_t>(sizeof(heapStart)));
+    close(fds[0]);
+    ASSERT_NE(heapStart, 0U);
+
+    auto matchesAt = [](const scan::MatchesAndOldValuesArray& out,
+                        std::uintptr_t address) {
+        bool found = false;
+        out.forEachMatch([&](const scan::MatchView& match) {
+            found = found || match.address == address;
+        });
+        return found;
+    };
+    utils::ThreadPool pool(4);
+    auto expectFound = [&](const ScanOptions& opts, const UserValue& value,
+                           std::uintptr_t address) {
+        scan::MatchesAndOldValuesArray seqOut;
+        auto seqStats = runScan(pid, opts, &value, seqOut);
+        scan::MatchesAndOldValuesArray parOut;
+        auto parStats =
+            runScanParallel(pid, opts, &value, parOut, nullptr, &pool);
+        ASSERT_TRUE(seqStats.has_value()) << seqStats.error();
+        ASSERT_TRUE(parStats.has_value()) << parStats.error();
+        EXPECT_TRUE(matchesAt(seqOut, address));
+        EXPECT_TRUE(matchesAt(parOut, address));
+        EXPECT_EQ(seqStats->matches, seqOut.matchCount());
+        EXPECT_EQ(parStats->matches, parOut.matchCount());
+        EXPECT_EQ(seqOut.matchCount(), parOut.matchCount());
+        // The overlap is kept once
+        for (std::size_t i = 1; i < parOut.swaths.size(); ++i) {
+            const auto& prev = parOut.swaths[i - 1];
+            EXPECT_LE(static_cast<const std::uint8_t*>(prev.firstByteInChild) +
+                          prev.size(),
+                      parOut.swaths[i].firstByteInChild);
+        }
+    };
+
+    ScanOptions stringOpts;
+    stringOpts.dataType = ScanDataType::STRING;
+    stringOpts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    stringOpts.regionLevel = core::RegionScanLevel::ALL_RW;
+    expectFound(stringOpts, UserValue::fromString("edgeword"),
+                heapStart + CHUNK - 3);
+
+    UserValue group;
+    group.group.push_back({.value = Value::of<std::int32_t>(100), .offset = 0});
+    group.group.push_back({.value = Value::of<std::int32_t>(100), .offset = 4});
+    group.group.push_back({.value = Value::of<std::int16_t>(30)});
+    group.groupWindow = 16;
+    group.primary = group.group.front().value;
+    ScanOptions groupOpts = stringOpts;
+    groupOpts.dataType = ScanDataType::GROUP;
+    expectFound(groupOpts, group, heapStart + 2 * CHUNK - 6);
+
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+}
+
+// 预读流水线与逐块同步读取的结果必须完全一致
+TEST(ScanParallel, PipelinedReadsMatchSynchronous) {
+    constexpr std::size_t HEAP_BYTES = 6 * 1024 * 1024 + 12345;
+    constexpr std::int32_t MARKER = 0x0BADF00D;
+    pid_t pid = fork();
+    if (pid == 0) {
+        void* block = sbrk(static_cast<intptr_t>(HEAP_BYTES));
+        if (block == reinterpret_cast<void*>(-1)) {
+            _exit(1);
+        }
+        auto* heap = static_cast<volatile std::int32_t*>(block);
+        for (std::size_t i = 0; i < HEAP_BYTES / sizeof(std::int32_t); ++i) {
+            heap[i] = (i % 977 == 0) ? MARKER : 3;
+        }
+        pause();
+        _exit(0);
+    }
+    ASSERT_GT(pid, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_EQUAL_TO;
+    opts.blockSize = 48 * 1024;  // spans are not a power-of-two multiple
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    UserValue val = UserValue::fromScalar<std::int32_t>(MARKER);
+
+    opts.pipelineReads = true;
+    scan::MatchesAndOldValuesArray pipelined;
+    auto pipelinedExp = runScan(pid, opts, &val, pipelined);
+    opts.pipelineReads = false;
+    scan::MatchesAndOldValuesArray blockwise;
+    auto blockwiseExp = runScan(pid, opts, &val, blockwise);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    ASSERT_TRUE(pipelinedExp.has_value()) << pipelinedExp.error();
+    ASSERT_TRUE(blockwiseExp.has_value()) << blockwiseExp.error();
+
+    EXPECT_GE(pipelinedExp->matches, HEAP_BYTES / sizeof(std::int32_t) / 977);
+    EXPECT_EQ(pipelinedExp->bytesScanned, blockwiseExp->bytesScanned);
+    EXPECT_EQ(pipelinedExp->matches, blockwiseExp->matches);
+    ASSERT_EQ(pipelined.swaths.size(), blockwise.swaths.size());
+    for (std::size_t i = 0; i < pipelined.swaths.size(); ++i) {
+        const auto& lhs = pipelined.swaths[i];
+        const auto& rhs = blockwise.swaths[i];
+        EXPECT_EQ(lhs.firstByteInChild, rhs.firstByteInChild);
+        ASSERT_EQ(lhs.size(), rhs.size());
+        EXPECT_TRUE(std::ranges::equal(lhs.bytes(), rhs.bytes()));
+        EXPECT_EQ(lhs.matchCount(), rhs.matchCount());
+    }
+}
+
+// NATURAL 对齐：只在绝对对齐的地址匹配；豁免区域回到逐字节扫描
+TEST(ScanParallel, NaturalAlignmentKeepsAlignedAddresses) {
+    ExternalProcess target;
+    ASSERT_TRUE(target.valid()) << "Failed to spawn target process";
+    pid_t pid = target.pid();
+
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    opts.alignment = ScanAlignment::NATURAL;
+
+    scan::MatchesAndOldValuesArray aligned;
+    auto alignedExp = runScanParallel(pid, opts, nullptr, aligned, nullptr);
+    ASSERT_TRUE(alignedExp.has_value()) << alignedExp.error();
+    ASSERT_GT(aligned.matchCount(), 0U);
+    aligned.forEachMatch([](const scan::MatchView& match) {
+        EXPECT_EQ(match.address % 4, 0U) << std::hex << match.address;
+    });
+
+    // Every region exempt: the same as an unaligned step-1 scan
+    opts.unalignedRegions = core::RegionFilter::fromTypeNames(
+        {"exe", "code", "heap", "stack", "unknow"});
+    scan::MatchesAndOldValuesArray exempt;
+    auto exemptExp = runScanParallel(pid, opts, nullptr, exempt, nullptr);
+    ASSERT_TRUE(exemptExp.has_value()) << exemptExp.error();
+
+    ScanOptions plain = opts;
+    plain.alignment = ScanAlignment::NONE;
+    plain.unalignedRegions = {};
+    scan::MatchesAndOldValuesArray unaligned;
+    auto plainExp = runScanParallel(pid, plain, nullptr, unaligned, nullptr);
+    ASSERT_TRUE(plainExp.has_value()) << plainExp.error();
+    EXPECT_EQ(exempt.matchCount(), unaligned.matchCount());
+    EXPECT_GT(unaligned.matchCount(), aligned.matchCount());
+}
+
+// 计时默认关闭；开启后各阶段与每个工作线程都有记录
+TEST(ScanParallel, ProfileIsOptInAndCoversPhases) {
+    ExternalProcess target;
+    ASSERT_TRUE(target.valid()) << "Failed to spawn target process";
+
+    ScanOptions opts;
+    opts.dataType = ScanDataType::INTEGER_32;
+    opts.matchType = ScanMatchType::MATCH_ANY;
+    opts.regionLevel = core::RegionScanLevel::ALL_RW;
+    utils::ThreadPool pool(2);
+
+    scan::MatchesAndOldValuesArray out;
+    auto plain = runScanParallel(target.pid(), opts, nullptr, out, nullptr, &pool);
+    ASSERT_TRUE(plain.has_value()) << plain.error();
+    EXPECT_FALSE(plain->profile.enabled);
+    EXPECT_EQ(plain->profile.reads, 0U);
+    EXPECT_EQ(plain->profile.totalNs, 0U);
+
+    opts.profile = true;
+    auto timed = runScanParallel(target.pid(), opts, nullptr, out, nullptr, &pool);
+    ASSERT_TRUE(timed.has_value()) << timed.error();
+    const auto& profile = timed->profile;
+    EXPECT_TRUE(profile.enabled);
+    EXPECT_GT(profile.totalNs, 0U);
+    EXPECT_GE(profile.totalNs, profile.scanNs);
+    EXPECT_GT(profile.reads, 0U);
+    EXPECT_GT(profile.bytesRead, 0U);
+    EXPECT_GT(profile.slowestTaskNs, 0U);
+    ASSERT_EQ(profile.workers.size(), pool.size());
+    std::size_t bytes = 0;
+    for (const auto& worker : profile.workers) {
+        bytes += worker.bytes;
+    }
+    EXPECT_EQ(bytes, timed->bytesScanned);
+
+    UserValue zero = UserValue::fromScalar<int32_t>(0);
+    opts.matchType = ScanMatchType::MATCH_NOT_EQUAL_TO;
+    auto filtered = filterMatchesParallel(target.pid(), opts, &zero, out, &pool);
+    ASSERT_TRUE(filtered.has_value()) << filtered.error();
+    EXPECT_TRUE(filtered->profile.enabled);
+    EXPECT_GT(filtered->profile.totalNs, 0U);
+    EXPECT_GT(filtered->profile.reads, 0U);
+}
@@ -0,0 +1,113 @@
+// Unit tests for scan.pattern_set - block searches must agree with a naive scan
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+import scan.pattern_set;
+
+using scan::BytePattern;
+using scan::PatternSet;
+
+namespace {
+
+using Hit = std::pair<std::size_t, std::size_t>;  // offset, pattern
+
+auto naive(const std::vector<BytePattern>& patterns,
+           std::span<const std::uint8_t> hay) -> std::set<Hit> {
+    std::set<Hit> hits;
+    for (std::size_t p = 0; p < patterns.size(); ++p) {
+        const auto& pattern = patterns[p];
+        for (std::size_t offset = 0; offset + pattern.size() <= hay.size();
+             ++offset) {
+            if (pattern.matchesAt(hay.data() + offset)) {
+                hits.emplace(offset, p);
+            }
+        }
+    }
+    return hits;
+}
+
+auto searched(const PatternSet& set, std::span<const std::uint8_t> hay)
+    -> std::set<Hit> {
+    std::set<Hit> hits;
+    set.search(hay, [&](std::size_t offset, std::size_t index) {
+        EXPECT_TRUE(hits.emplace(offset, index).second) << "duplicate hit";
+    });
+    return hits;
+}
+
+auto fixed(std::vector<std::uint8_t> bytes) -> BytePattern {
+    const std::size_t SIZE = bytes.size();
+    return {.bytes = std::move(bytes), .mask = std::vector<std::uint8_t>(SIZE, 0xFF)};
+}
+
+// Random bytes from a small alphabet so patterns actually occur
+auto randomHay(std::size_t size, unsigned seed) -> std::vector<std::uint8_t> {
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> dist{0, 3};
+    std::vector<std::uint8_t> hay(size);
+    for (auto& byte : hay) {
+        byte = static_cast<std::uint8_t>(0x40 + dist(rng));
+    }
+    return hay;
+}
+
+}  // namespace
+
+TEST(PatternSetTest, SinglePatternMatchesNaiveScan) {
+    const auto HAY = randomHay(1000, 1);
+    const std::vector<std::vector<BytePattern>> CASES = {
+        {fixed({0x41})},
+        {fixed({0x40, 0x41, 0x42})},
+        {{.bytes = {0x41, 0x00, 0x43, 0x40}, .mask = {0xFF, 0x00, 0xFF, 0xF0}}},
+    };
+    for (const auto& patterns : CASES) {
+        const auto SET = PatternSet::compile(patterns);
+        // Odd sizes exercise the vector loop and the scalar tail
+        for (const std::size_t SIZE : {0UL, 3UL, 31UL, 64UL, 999UL}) {
+            const std::span<const std::uint8_t> HAY_VIEW{HAY.data(), SIZE};
+            EXPECT_EQ(searched(SET, HAY_VIEW), naive(patterns, HAY_VIEW))
+                << "size " << SIZE;
+        }
+    }
+}
+
+TEST(PatternSetTest, ManyPatternsFoundInOnePass) {
+    const auto HAY = randomHay(4096, 2);
+    std::vector<BytePattern> patterns;
+    std::mt19937 rng{3};
+    for (int i = 0; i < 200; ++i) {
+        const std::size_t START = rng() % (HAY.size() - 8);
+        std::vector<std::uint8_t> bytes(HAY.begin() + static_cast<long>(START),
+                                        HAY.begin() + static_cast<long>(START) +
+                                            3 + rng() % 5);
+        patterns.push_back(fixed(std::move(bytes)));
+    }
+    // One anchored on a single byte, one made of wildcards only
+    patterns.push_back({.bytes = {0x43, 0x00, 0x42}, .mask = {0xFF, 0x00, 0xFF}});
+    patterns.push_back({.bytes = {0x00, 0x00}, .mask = {0x00, 0x0F}});
+
+    const auto SET = PatternSet::compile(patterns);
+    EXPECT_EQ(SET.size(), patterns.size());
+    EXPECT_EQ(searched(SET, HAY), naive(patterns, HAY));
+}
+
+TEST(PatternSetTest, MatchAtAndFindFirstPreferLongest) {
+    const std::vector<std::uint8_t> HAY = {0x10, 0xAA, 0xBB, 0xCC, 0xDD};
+    const auto SET = PatternSet::compile(
+        {fixed({0xAA, 0xBB}), fixed({0xAA, 0xBB, 0xCC}), fixed({0xDD})});
+    EXPECT_EQ(SET.matchAt(std::span(HAY).subspan(1)), 1U);
+    EXPECT_EQ(SET.matchAt(HAY), PatternSet::NPOS);
+
+    const auto FIRST = SET.findFirst(HAY);
+    ASSERT_TRUE(FIRST.has_value());
+    EXPECT_EQ(FIRST->offset, 1U);
+    EXPECT_EQ(FIRST->length, 3U);
+    EXPECT_FALSE(PatternSet::compile({}).findFirst(HAY).has_value());
+}
@@ -0,0 +1,134 @@
+// Tests for the pointer index, path search and rescans
+
+import core.maps;          // Region, readProcessMaps
+import scan.pointer_scan;  // PointerIndex, findPointerPaths, rescanPointerPaths
+import utils.thread_pool;  // ThreadPool
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "child_process.h"
+
+using test_support::ChildProcess;
+
+namespace {
+
+struct Leaf {
+    std::array<std::uint8_t, 0x40> pad{};
+    std::int32_t value{1234};
+};
+
+struct Inner {
+    std::array<std::uint8_t, 0x18> pad{};
+    Leaf* leaf{nullptr};
+};
+
+// A static base in this executable's image: g_root -> Inner -> Leaf
+Inner* volatile g_root = nullptr;
+
+auto address(const void* pointer) -> std::uint64_t {
+    return reinterpret_cast<std::uint64_t>(pointer);
+}
+
+auto findsChain(const scan::PointerSearchResult& result) -> bool {
+    return std::ranges::any_of(result.paths, [](const scan::PointerPath& path) {
+        return path.offsets == std::vector<std::uint64_t>{0x18, 0x40};
+    });
+}
+
+}  // namespace
+
+TEST(PointerScan, StaticModulesCoverImagesAndTheirBss) {
+    std::vector<core::Region> regions(4);
+    regions[0] = {.start = reinterpret_cast<void*>(0x1000), .size = 0x1000,
+                  .filename = "/usr/bin/game"};
+    regions[1] = {.start = reinterpret_cast<void*>(0x2000), .size = 0x1000,
+                  .filename = "/usr/bin/game"};
+    regions[2] = {.start = reinterpret_cast<void*>(0x3000), .size = 0x1000};
+    regions[3] = {.start = reinterpret_cast<void*>(0x9000), .size = 0x1000,
+                  .filename = "[heap]"};
+    const scan::StaticModules MODULES{regions};
+
+    ASSERT_EQ(MODULES.modules().size(), 1U);
+    EXPECT_EQ(MODULES.base("/usr/bin/game"), 0x1000U);
+    ASSERT_NE(MODULES.containing(0x3ff8), nullptr);  // the anonymous .bss
+    EXPECT_EQ(MODULES.containing(0x3ff8)->name, "/usr/bin/game");
+    EXPECT_EQ(MODULES.containing(0x4000), nullptr);
+    EXPECT_EQ(MODULES.containing(0x9000), nullptr);
+    EXPECT_FALSE(MODULES.base("[heap]").has_value());
+}
+
+TEST(PointerScan, FindsStaticPathAndRescansAfterRestart) {
+    auto leaf = std::make_unique<Leaf>();
+    auto inner = std::make_unique<Inner>();
+    inner->leaf = leaf.get();
+    g_root = inner.get();
+
+    scan::PointerSearchResult found;
+    {
+        const ChildProcess TARGET;
+        ASSERT_GT(TARGET.pid(), 0);
+        utils::ThreadPool pool(2);
+        auto index = scan::PointerIndex::build(TARGET.pid(), {}, &pool);
+        ASSERT_TRUE(index.has_value()) << index.error();
+        EXPECT_FALSE(index->fileBacked());
+        EXPECT_GT(index->sourceBytes(), 0U);
+        EXPECT_TRUE(std::ranges::is_sorted(index->records()));
+
+        const auto INTO = index->pointersInto(address(leaf.get()),
+                                              address(leaf.get()));
+        EXPECT_TRUE(std::ranges::any_of(INTO, [&](const auto& record) {
+            return record.source == address(&inner->leaf);
+        }));
+
+        found = scan::findPointerPaths(
+            *index, address(&leaf->value),
+            {.maxDepth = 3, .maxOffset = 0x100});
+        ASSERT_TRUE(findsChain(found));
+        EXPECT_TRUE(std::ranges::is_sorted(
+            found.paths, {}, [](const auto& path) { return path.offsets.size(); }));
+
+        auto again = scan::rescanPointerPaths(TARGET.pid(), found.paths,
+                                              address(&leaf->value));
+        ASSERT_TRUE(again.has_value()) << again.error();
+        EXPECT_EQ(*again, found.paths);
+    }
+
+    // "Restart": the value moved, and only paths through g_root follow it
+    auto moved = std::make_unique<Leaf>();
+    inner->leaf = moved.get();
+    const ChildProcess RESTARTED;
+    ASSERT_GT(RESTARTED.pid(), 0);
+    auto kept = scan::rescanPointerPaths(RESTARTED.pid(), found.paths,
+                                         address(&moved->value));
+    ASSERT_TRUE(kept.has_value()) << kept.error();
+    EXPECT_TRUE(findsChain({.paths = *kept}));
+    auto stale = scan::rescanPointerPaths(RESTARTED.pid(), *kept,
+                                          address(&leaf->value));
+    ASSERT_TRUE(stale.has_value());
+    EXPECT_TRUE(stale->empty());
+    g_root = nullptr;
+}
+
+TEST(PointerScan, LargeIndexLivesInATempFile) {
+    auto leaf = std::make_unique<Leaf>();
+    auto inner = std::make_unique<Inner>();
+    inner->leaf = leaf.get();
+    g_root = inner.get();
+    const ChildProcess TARGET;
+    ASSERT_GT(TARGET.pid(), 0);
+
+    auto index = scan::PointerIndex::build(TARGET.pid(),
+                                           {.fileBackedBytes = 0});
+    ASSERT_TRUE(index.has_value()) << index.error();
+    EXPECT_TRUE(index->fileBacked());
+    EXPECT_TRUE(std::ranges::is_sorted(index->records()));
+    EXPECT_TRUE(findsChain(scan::findPointerPaths(
+        *index, address(&leaf->value), {.maxDepth = 2, .maxOffset = 0x40})));
+    g_root = nullptr;
+}
@@ -0,0 +1,123 @@
+// Unit tests for scan.simd - every vector path must agree with the scalar one
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <random>
+#include <span>
+#include <vector>
+
+import scan.simd;
+import scan.types;
+
+namespace {
+
+// Bytes seeded with a few copies of the target so equality has hits
+template <typename T>
+auto makeBlock(std::size_t size, T target) -> std::vector<uint8_t> {
+    std::mt19937 rng(1234);
+    std::vector<uint8_t> bytes(size);
+    for (auto& byte : bytes) {
+        byte = static_cast<uint8_t>(rng() % 4);
+    }
+    for (std::size_t offset = 3; offset + sizeof(T) <= size; offset += 97) {
+        std::memcpy(bytes.data() + offset, &target, sizeof(T));
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        const T NAN_VALUE = std::numeric_limits<T>::quiet_NaN();
+        std::memcpy(bytes.data() + 40, &NAN_VALUE, sizeof(T));
+    }
+    return bytes;
+}
+
+template <typename T, ScanMatchType MATCH>
+void expectLevelAgrees(scan::SimdLevel level, T low, T high) {
+    const auto BYTES = makeBlock<T>(1000, low);
+    for (std::size_t step : {1U, 2U, 3U, 4U, 8U}) {
+        std::vector<uint64_t> expected(scan::maskWordsFor(BYTES.size()));
+        const auto EXPECTED_COUNT = scan::compareBlockMask<T, MATCH>(
+            BYTES, step, low, high, expected, scan::SimdLevel::SCALAR);
+        std::vector<uint64_t> actual(expected.size());
+        const auto COUNT = scan::compareBlockMask<T, MATCH>(
+            BYTES, step, low, high, actual, level);
+        EXPECT_EQ(COUNT, EXPECTED_COUNT)
+            << scan::simdLevelName(level) << " step " << step;
+        EXPECT_EQ(actual, expected)
+            << scan::simdLevelName(level) << " step " << step;
+    }
+}
+
+template <typename T>
+void expectAllMatchesAgree(scan::SimdLevel level, T low, T high) {
+    expectLevelAgrees<T, ScanMatchType::MATCH_EQUAL_TO>(level, low, high);
+    expectLevelAgrees<T, ScanMatchType::MATCH_NOT_EQUAL_TO>(level, low, high);
+    expectLevelAgrees<T, ScanMatchType::MATCH_GREATER_THAN>(level, low, high);
+    expectLevelAgrees<T, ScanMatchType::MATCH_LESS_THAN>(level, low, high);
+    expectLevelAgrees<T, ScanMatchType::MATCH_RANGE>(level, low, high);
+}
+
+// Whether compareBlockMask really takes level's vector path on this CPU;
+// otherwise it falls back to scalar and the comparison proves nothing
+auto runsOwnPath(scan::SimdLevel level) -> bool {
+    const auto DETECTED = scan::detectSimdLevel();
+    if (level == scan::SimdLevel::NEON || DETECTED == scan::SimdLevel::NEON) {
+        return level == DETECTED;
+    }
+    return level <= DETECTED;
+}
+
+class ScanSimdLevelTest : public testing::TestWithParam<scan::SimdLevel> {
+   protected:
+    void SetUp() override {
+        if (!runsOwnPath(GetParam())) {
+            GTEST_SKIP() << scan::simdLevelName(GetParam())
+                         << " is not supported here";
+        }
+    }
+};
+
+}  // namespace
+
+TEST(ScanSimdTest, ScalarEqualFindsSeededValues) {
+    const auto BYTES = makeBlock<int32_t>(256, 0x01020304);
+    std::vector<uint64_t> mask(scan::maskWordsFor(BYTES.size()));
+    const auto COUNT =
+        scan::compareBlockMask<int32_t, ScanMatchType::MATCH_EQUAL_TO>(
+            BYTES, 1, 0x01020304, 0, mask, scan::SimdLevel::SCALAR);
+    EXPECT_GE(COUNT, 3U);
+    EXPECT_TRUE((mask[0] >> 3) & 1U);
+}
+
+TEST_P(ScanSimdLevelTest, Int32PathsAgree) {
+    expectAllMatchesAgree<int32_t>(GetParam(), 0x01020304, 0x02000000);
+}
+
+TEST_P(ScanSimdLevelTest, Int64PathsAgree) {
+    expectAllMatchesAgree<int64_t>(GetParam(), 0x0102030405060708LL, 0x0300000000000000LL);
+}
+
+TEST_P(ScanSimdLevelTest, FloatPathsAgree) {
+    expectAllMatchesAgree<float>(GetParam(), 1.5F, 1.0e-30F);
+}
+
+TEST_P(ScanSimdLevelTest, DoublePathsAgree) {
+    expectAllMatchesAgree<double>(GetParam(), 2.25, 1.0e-300);
+}
+
+INSTANTIATE_TEST_SUITE_P(VectorLevels, ScanSimdLevelTest,
+                         testing::Values(scan::SimdLevel::NEON,
+                                         scan::SimdLevel::AVX2,
+                                         scan::SimdLevel::AVX512),
+                         [](const auto& info) {
+                             return std::string(
+                                 scan::simdLevelName(info.param));
+                         });
+
+TEST(ScanSimdTest, DetectedLevelIsKnown) {
+    const auto LEVEL = scan::detectSimdLevel();
+    EXPECT_NE(std::string(scan::simdLevelName(LEVEL)), "");
+}
@@ -0,0 +1,161 @@
+// Tests for the on-disk snapshot format
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+import scan.match_storage;  // MatchesAndOldValuesArray
+import scan.snapshot_file;  // writeSnapshotFile, SnapshotFile
+import scan.types;          // ScanDataType
+import value.flags;         // MatchFlags
+
+using scan::MatchesAndOldValuesArray;
+using scan::MatchesAndOldValuesSwath;
+using scan::SnapshotFile;
+
+namespace {
+
+class TempDir {
+   public:
+    TempDir() {
+        std::string pattern =
+            (std::filesystem::temp_directory_path() / "snapfile-XXXXXX").string();
+        if (::mkdtemp(pattern.data()) != nullptr) {
+            m_path = pattern;
+        }
+    }
+    ~TempDir() {
+        std::error_code ignored;
+        std::filesystem::remove_all(m_path, ignored);
+    }
+    [[nodiscard]] auto file(const std::string& name) const -> std::string {
+        return m_path + "/" + name;
+    }
+
+   private:
+    std::string m_path;
+};
+
+auto makeSwath(std::uintptr_t base, std::size_t size, std::uint8_t seed)
+    -> MatchesAndOldValuesSwath {
+    scan::ByteBuffer bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(seed + i * 7);
+    }
+    return MatchesAndOldValuesSwath{reinterpret_cast<void*>(base),
+                                    std::move(bytes)};
+}
+
+auto sampleMatches() -> MatchesAndOldValuesArray {
+    MatchesAndOldValuesArray arr;
+    auto first = makeSwath(0x10000, 4096, 1);
+    for (std::size_t i = 0; i < first.size(); i += 4) {
+        first.setMatch(i, MatchFlags::B32, 0);
+    }
+    first.setMatch(130, MatchFlags::B8 | MatchFlags::B16, 0);  // an override
+    first.setMatch(4093, MatchFlags::B8, 3);
+    arr.addSwath(std::move(first));
+    arr.addSwath(makeSwath(0x40000, 100, 9));  // bytes only, no matches
+    auto third = makeSwath(0x90000, 300000, 3);
+    third.setMatch(299999, MatchFlags::B8, 0);  // a long gap
+    arr.addSwath(std::move(third));
+    return arr;
+}
+
+struct Seen {
+    std::uintptr_t address;
+    std::uint8_t firstByte;
+    scan::MatchInfo info;
+    friend auto operator==(const Seen&, const Seen&) -> bool = default;
+};
+
+template <typename Source>
+auto collect(const Source& source) -> std::vector<Seen> {
+    std::vector<Seen> seen;
+    source.forEachMatch([&](const scan::MatchView& match) {
+        seen.push_back({match.address, match.oldBytes.front(), match.info});
+    });
+    return seen;
+}
+
+}  // namespace
+
+TEST(SnapshotFileTest, RoundTripsBytesAndMatches) {
+    TempDir dir;
+    const auto ORIGINAL = sampleMatches();
+    const std::string PATH = dir.file("a.snap");
+    ASSERT_TRUE(
+        scan::writeSnapshotFile(PATH, ORIGINAL, ScanDataType::INTEGER_32));
+
+    auto file = SnapshotFile::open(PATH);
+    ASSERT_TRUE(file.has_value()) << file.error();
+    EXPECT_EQ(file->regionCount(), 3U);
+    EXPECT_EQ(file->matchCount(), ORIGINAL.matchCount());
+    EXPECT_EQ(file->byteCount(), 4096U + 100U + 300000U);
+    EXPECT_EQ(file->dataType(), ScanDataType::INTEGER_32);
+
+    // The mmap view and a full load both see what was written
+    EXPECT_EQ(collect(*file), collect(ORIGINAL));
+    const auto LOADED = file->load();
+    EXPECT_EQ(collect(LOADED), collect(ORIGINAL));
+    ASSERT_EQ(LOADED.swaths.size(), ORIGINAL.swaths.size());
+    for (std::size_t i = 0; i < LOADED.swaths.size(); ++i) {
+        EXPECT_EQ(LOADED.swaths[i].firstByteInChild,
+                  ORIGINAL.swaths[i].firstByteInChild);
+        EXPECT_TRUE(std::ranges::equal(LOADED.swaths[i].bytes(),
+                                       ORIGINAL.swaths[i].bytes()));
+    }
+    // Delta coding keeps the match section near a byte per match
+    EXPECT_LT(file->fileSize(), file->byteCount() + 2 * file->matchCount() + 512);
+}
+
+TEST(SnapshotFileTest, WritesSparseArrays) {
+    TempDir dir;
+    auto arr = sampleMatches();
+    arr.sparsify(8);
+    ASSERT_TRUE(arr.isSparse());
+    const std::string PATH = dir.file("sparse.snap");
+    ASSERT_TRUE(scan::writeSnapshotFile(PATH, arr, std::nullopt));
+    auto file = SnapshotFile::open(PATH);
+    ASSERT_TRUE(file.has_value()) << file.error();
+    EXPECT_FALSE(file->dataType().has_value());
+    EXPECT_EQ(collect(*file), collect(arr));
+}
+
+TEST(SnapshotFileTest, KeepsTheMatchAlignment) {
+    TempDir dir;
+    const std::string PLAIN = dir.file("plain.snap");
+    const std::string ALIGNED = dir.file("aligned.snap");
+    ASSERT_TRUE(scan::writeSnapshotFile(PLAIN, sampleMatches(), std::nullopt));
+    ASSERT_TRUE(scan::writeSnapshotFile(ALIGNED, sampleMatches(),
+                                        ScanDataType::ANY_NUMBER,
+                                        ScanAlignment::NATURAL));
+    auto plain = SnapshotFile::open(PLAIN);
+    auto aligned = SnapshotFile::open(ALIGNED);
+    ASSERT_TRUE(plain.has_value() && aligned.has_value());
+    EXPECT_EQ(plain->alignment(), ScanAlignment::NONE);
+    EXPECT_EQ(aligned->alignment(), ScanAlignment::NATURAL);
+}
+
+TEST(SnapshotFileTest, RejectsForeignAndTruncatedFiles) {
+    TempDir dir;
+    const std::string PATH = dir.file("a.snap");
+    ASSERT_TRUE(scan::writeSnapshotFile(PATH, sampleMatches(), std::nullopt));
+
+    const std::string TRUNCATED = dir.file("short.snap");
+    std::filesystem::copy_file(PATH, TRUNCATED);
+    std::filesystem::resize_file(TRUNCATED,
+                                 std::filesystem::file_size(PATH) - 16);
+    EXPECT_FALSE(SnapshotFile::open(TRUNCATED).has_value());
+
+    const std::string FOREIGN = dir.file("foreign.snap");
+    std::ofstream(FOREIGN) << std::string(256, 'x');
+    EXPECT_FALSE(SnapshotFile::open(FOREIGN).has_value());
+
+    EXPECT_FALSE(SnapshotFile::open(dir.file("missing.snap")).has_value());
+}
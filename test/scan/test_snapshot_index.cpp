@@ -0,0 +1,84 @@
+// Unit tests for scan.snapshot_index
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+import scan.match_storage;
+import scan.snapshot_index;
+
+namespace {
+
+auto addr(std::uintptr_t value) -> void* {
+    return reinterpret_cast<void*>(value);
+}
+
+auto makeSnapshot() -> scan::MatchesAndOldValuesArray {
+    std::vector<uint8_t> bytes(64);
+    std::iota(bytes.begin(), bytes.end(), 0);
+    scan::MatchesAndOldValuesArray snapshot;
+    scan::MatchesAndOldValuesSwath high;
+    high.appendRange(addr(0x2000), bytes.data(), 32);
+    scan::MatchesAndOldValuesSwath low;
+    low.appendRange(addr(0x1000), bytes.data() + 32, 32);
+    // Deliberately out of address order
+    snapshot.addSwath(high);
+    snapshot.addSwath(low);
+    return snapshot;
+}
+
+}  // namespace
+
+TEST(SnapshotIndexTest, SortsSwathsByAddress) {
+    auto snapshot = makeSnapshot();
+    const scan::SnapshotIndex INDEX{snapshot};
+    ASSERT_EQ(INDEX.entries().size(), 2U);
+    EXPECT_EQ(INDEX.entries()[0].begin, 0x1000U);
+    EXPECT_EQ(INDEX.entries()[1].begin, 0x2000U);
+}
+
+TEST(SnapshotIndexTest, SegmentIncludesWindowPastBlockEnd) {
+    auto snapshot = makeSnapshot();
+    const scan::SnapshotIndex INDEX{snapshot};
+    scan::SnapshotCursor cursor{&INDEX};
+
+    const auto SEGMENTS = cursor.segmentsFor(addr(0x1008), 8, 4);
+    ASSERT_EQ(SEGMENTS.size(), 1U);
+    EXPECT_EQ(SEGMENTS[0].blockOffset, 0U);
+    EXPECT_EQ(SEGMENTS[0].bytes.size(), 11U);
+    EXPECT_EQ(SEGMENTS[0].bytes[0], 40);
+    EXPECT_TRUE(SEGMENTS[0].covers(7, 4));
+}
+
+TEST(SnapshotIndexTest, SegmentStopsAtSwathEnd) {
+    auto snapshot = makeSnapshot();
+    const scan::SnapshotIndex INDEX{snapshot};
+    scan::SnapshotCursor cursor{&INDEX};
+
+    const auto SEGMENTS = cursor.segmentsFor(addr(0x101C), 16, 4);
+    ASSERT_EQ(SEGMENTS.size(), 1U);
+    EXPECT_EQ(SEGMENTS[0].bytes.size(), 4U);
+    EXPECT_TRUE(SEGMENTS[0].covers(0, 4));
+    EXPECT_FALSE(SEGMENTS[0].covers(1, 4));
+}
+
+TEST(SnapshotIndexTest, CursorHandlesBackwardJumpsAndGaps) {
+    auto snapshot = makeSnapshot();
+    const scan::SnapshotIndex INDEX{snapshot};
+    scan::SnapshotCursor cursor{&INDEX};
+
+    EXPECT_EQ(cursor.segmentsFor(addr(0x2010), 8, 1).size(), 1U);
+    EXPECT_TRUE(cursor.segmentsFor(addr(0x1800), 8, 1).empty());
+
+    const auto SEGMENTS = cursor.segmentsFor(addr(0x1000), 8, 1);
+    ASSERT_EQ(SEGMENTS.size(), 1U);
+    EXPECT_EQ(SEGMENTS[0].bytes[0], 32);
+
+    // A block straddling the start of a swath gets a non-zero offset
+    const auto STRADDLE = cursor.segmentsFor(addr(0x1FF8), 16, 1);
+    ASSERT_EQ(STRADDLE.size(), 1U);
+    EXPECT_EQ(STRADDLE[0].blockOffset, 8U);
+    EXPECT_EQ(STRADDLE[0].bytes[0], 0);
+}
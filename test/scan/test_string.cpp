@@ -98,3 +98,79 @@ TEST_F(ScanStringTest, GetCachedRegexInvalidPatternReturnsNull) {
 
     EXPECT_EQ(regex, nullptr);
 }
+
+namespace {
+
+auto searchAll(const scan::StringSearcher& searcher, const std::string& text)
+    -> std::vector<ByteMatch> {
+    std::vector<ByteMatch> out;
+    searcher.search(std::span(reinterpret_cast<const uint8_t*>(text.data()),
+                              text.size()),
+                    out);
+    return out;
+}
+
+auto utf16(const std::string& ascii) -> std::string {
+    std::string out;
+    for (char chr : ascii) {
+        out += chr;
+        out += '\0';
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(StringSearcherTest, RegexReportsEveryMatchAtItsStart) {
+    auto searcher = scan::StringSearcher::create(
+        ScanMatchType::MATCH_REGEX, UserValue::fromString("[0-9]+"),
+        StringEncoding::UTF8);
+    ASSERT_TRUE(searcher.has_value());
+    const auto HITS = searchAll(*searcher, "ab12cd345e6");
+    ASSERT_EQ(HITS.size(), 3U);
+    EXPECT_EQ(HITS[0].offset, 2U);
+    EXPECT_EQ(HITS[0].length, 2U);
+    EXPECT_EQ(HITS[1].offset, 6U);
+    EXPECT_EQ(HITS[1].length, 3U);
+    EXPECT_EQ(HITS[2].offset, 10U);
+    EXPECT_EQ(searcher->lookBehind(64), 64U);
+}
+
+TEST(StringSearcherTest, FindsUtf16LeLiteralsAndRegexes) {
+    const std::string TEXT = "hi " + utf16("hello") + " hello " + "x" +
+                             utf16("ab12");
+    auto both = scan::StringSearcher::create(ScanMatchType::MATCH_EQUAL_TO,
+                                             UserValue::fromString("hello"),
+                                             StringEncoding::BOTH);
+    ASSERT_TRUE(both.has_value());
+    const auto HITS = searchAll(*both, TEXT);
+    ASSERT_EQ(HITS.size(), 2U);
+    EXPECT_EQ(HITS[0].offset, 3U);
+    EXPECT_EQ(HITS[0].length, 10U);
+    EXPECT_EQ(HITS[1].offset, 14U);
+    EXPECT_EQ(HITS[1].length, 5U);
+    EXPECT_EQ(both->lookBehind(64), 9U);
+
+    // The wide pattern starts at an odd offset; both alignments are tried
+    auto regex = scan::StringSearcher::create(ScanMatchType::MATCH_REGEX,
+                                              UserValue::fromString("b[0-9]+"),
+                                              StringEncoding::UTF16LE);
+    ASSERT_TRUE(regex.has_value());
+    const auto WIDE = searchAll(*regex, TEXT);
+    ASSERT_EQ(WIDE.size(), 1U);
+    EXPECT_EQ(WIDE[0].offset, 23U);
+    EXPECT_EQ(WIDE[0].length, 6U);
+}
+
+TEST(StringSearcherTest, InvalidRegexIsAnError) {
+    auto searcher = scan::StringSearcher::create(
+        ScanMatchType::MATCH_REGEX, UserValue::fromString("[invalid("),
+        StringEncoding::UTF8);
+    EXPECT_FALSE(searcher.has_value());
+}
+
+TEST(StringSearcherTest, Utf8PatternsReencodeAsUtf16) {
+    const auto WIDE = scan::utf8ToUtf16le("\xE4\xBD\xA0\xF0\x9F\x98\x80");
+    const std::vector<uint8_t> EXPECTED{0x60, 0x4F, 0x3D, 0xD8, 0x00, 0xDE};
+    EXPECT_EQ(WIDE, EXPECTED);
+}
@@ -0,0 +1,76 @@
+// Forked copy of the test process to scan, shared by the unit tests
+#pragma once
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+namespace test_support {
+
+/**
+ * @brief Child forked at construction and killed at destruction
+ *
+ * The child runs setup(), reports the address it returns (e.g. a heap
+ * block it filled) through a pipe, and then waits until killed: in
+ * pause() by default, or busy on a CPU with Idle::SPIN so that it is
+ * running whenever it is not stopped.
+ */
+class ChildProcess {
+   public:
+    enum class Idle { PAUSE, SPIN };
+
+    explicit ChildProcess(Idle idle = Idle::PAUSE)
+        : ChildProcess([]() { return std::uintptr_t{0}; }, idle) {}
+
+    template <typename Setup>
+    explicit ChildProcess(Setup setup, Idle idle = Idle::PAUSE) {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            return;
+        }
+        m_pid = ::fork();
+        if (m_pid == 0) {
+            ::close(fds[0]);
+            const std::uintptr_t BASE = setup();
+            (void)::write(fds[1], &BASE, sizeof(BASE));
+            ::close(fds[1]);
+            volatile std::uint64_t spins = 0;
+            while (true) {
+                if (idle == Idle::SPIN) {
+                    spins = spins + 1;
+                } else {
+                    ::pause();
+                }
+            }
+        }
+        ::close(fds[1]);
+        if (m_pid > 0 &&
+            ::read(fds[0], &m_base, sizeof(m_base)) != sizeof(m_base)) {
+            m_base = 0;
+        }
+        ::close(fds[0]);
+    }
+
+    ~ChildProcess() {
+        if (m_pid > 0) {
+            ::kill(m_pid, SIGKILL);
+            ::waitpid(m_pid, nullptr, 0);
+        }
+    }
+
+    ChildProcess(const ChildProcess&) = delete;
+    auto operator=(const ChildProcess&) -> ChildProcess& = delete;
+
+    [[nodiscard]] auto pid() const -> pid_t { return m_pid; }
+    [[nodiscard]] auto valid() const -> bool { return m_pid > 0; }
+    /** @brief What setup() returned in the child */
+    [[nodiscard]] auto base() const -> std::uintptr_t { return m_base; }
+
+   private:
+    pid_t m_pid{-1};
+    std::uintptr_t m_base{0};
+};
+
+}  // namespace test_support
@@ -0,0 +1,64 @@
+// Unit tests for utils::PeriodicWorker
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+import utils.periodic_worker;
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Wait until pred holds or about two seconds passed
+template <typename Pred>
+auto eventually(Pred pred) -> bool {
+    for (int i = 0; i < 400 && !pred(); ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    return pred();
+}
+
+}  // namespace
+
+TEST(PeriodicWorkerTest, TicksOnlyWhileThereIsWork) {
+    std::size_t items = 0;  // guarded by the worker
+    std::atomic<int> rebuilds{0};
+    std::atomic<int> ticks{0};
+    utils::PeriodicWorker worker;
+    worker.start({
+        .hasWork = [&]() { return items > 0; },
+        .rebuild = [&]() { ++rebuilds; },
+        .period = []() { return std::chrono::nanoseconds(1ms); },
+        .tick = [&]() { ++ticks; },
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(ticks.load(), 0);
+
+    EXPECT_TRUE(worker.update([&]() {
+        items = 2;
+        return true;
+    }));
+    EXPECT_TRUE(eventually([&]() { return ticks.load() >= 3; }));
+    EXPECT_EQ(rebuilds.load(), 1);
+
+    // An edit that changes nothing does not rebuild
+    EXPECT_FALSE(worker.update([]() { return false; }));
+    EXPECT_EQ(worker.locked([&]() { return items; }), 2U);
+    const int TICKS = ticks.load();
+    EXPECT_TRUE(eventually([&]() { return ticks.load() > TICKS + 2; }));
+    EXPECT_EQ(rebuilds.load(), 1);
+
+    worker.update([&]() {
+        items = 0;
+        return true;
+    });
+    // An empty set idles the helper before it would rebuild
+    std::this_thread::sleep_for(20ms);
+    const int IDLE = ticks.load();
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(ticks.load(), IDLE);
+    EXPECT_EQ(rebuilds.load(), 1);
+}
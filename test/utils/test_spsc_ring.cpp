@@ -0,0 +1,44 @@
+// Unit tests for utils::SpscRing
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+import utils.spsc_ring;
+
+using utils::SpscRing;
+
+TEST(SpscRingTest, FifoAndCapacity) {
+    SpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4U);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(99));
+    EXPECT_EQ(ring.dropped(), 1U);
+    EXPECT_EQ(ring.size(), 4U);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(ring.pop(), i);
+    }
+    EXPECT_FALSE(ring.pop().has_value());
+}
+
+TEST(SpscRingTest, ProducerAndConsumerThreads) {
+    constexpr std::uint64_t COUNT = 200000;
+    SpscRing<std::uint64_t> ring(64);
+    std::thread producer([&]() {
+        for (std::uint64_t i = 0; i < COUNT; ++i) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint64_t expected = 0;
+    while (expected < COUNT) {
+        if (auto item = ring.pop()) {
+            ASSERT_EQ(*item, expected);
+            ++expected;
+        }
+    }
+    producer.join();
+}
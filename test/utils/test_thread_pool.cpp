@@ -0,0 +1,117 @@
+// Unit tests for utils::ThreadPool
+#include <gtest/gtest.h>
+#include <sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+import utils.thread_pool;
+
+using utils::ThreadPool;
+using utils::ThreadPoolOptions;
+
+TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4U);
+
+    std::vector<std::atomic_int> hits(1000);
+    std::atomic_bool badWorker{false};
+    pool.parallelFor(hits.size(), [&](std::size_t task, std::size_t worker) {
+        hits[task].fetch_add(1);
+        if (worker >= 4) {
+            badWorker = true;
+        }
+    });
+
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+    EXPECT_FALSE(badWorker.load());
+}
+
+TEST(ThreadPoolTest, ReusedAcrossCalls) {
+    ThreadPool pool(3);
+    std::atomic_size_t total{0};
+    for (int round = 0; round < 50; ++round) {
+        pool.parallelFor(17, [&](std::size_t task, std::size_t /*worker*/) {
+            total.fetch_add(task);
+        });
+    }
+    EXPECT_EQ(total.load(), 50U * (16U * 17U / 2U));
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealFromSlowOnes) {
+    ThreadPool pool(4);
+    // Worker 0's initial range holds all the slow tasks
+    std::vector<std::atomic_int> ranOn(8);
+    pool.parallelFor(8, [&](std::size_t task, std::size_t worker) {
+        if (task < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        ranOn[task] = static_cast<int>(worker);
+    });
+    EXPECT_NE(ranOn[0].load(), ranOn[1].load());
+}
+
+TEST(ThreadPoolTest, ConcurrentCallersShareTheWorkers) {
+    ThreadPool pool(2);
+    // A's only task waits for B's, so B must run while A is unfinished
+    std::atomic_bool ranB{false};
+    std::atomic_bool sawB{false};
+    std::jthread first([&]() {
+        pool.parallelFor(1, [&](std::size_t /*task*/, std::size_t /*worker*/) {
+            const auto DEADLINE =
+                std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!ranB && std::chrono::steady_clock::now() < DEADLINE) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            sawB = ranB.load();
+        });
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pool.parallelFor(4, [&](std::size_t /*task*/, std::size_t /*worker*/) {
+        ranB = true;
+    });
+    first.join();
+    EXPECT_TRUE(sawB.load());
+}
+
+TEST(ThreadPoolTest, ZeroTasksReturnsImmediately) {
+    ThreadPool pool(2);
+    bool ran = false;
+    pool.parallelFor(0, [&](std::size_t, std::size_t) { ran = true; });
+    EXPECT_FALSE(ran);
+}
+
+TEST(ThreadPoolTest, PinsWorkersToRequestedCpus) {
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = 0;
+    while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed)) {
+        ++cpu;
+    }
+    ASSERT_LT(cpu, CPU_SETSIZE);
+
+    ThreadPool pool(ThreadPoolOptions{.threads = 2, .cpus = {cpu}, .pin = true});
+    EXPECT_EQ(pool.size(), 2U);
+    EXPECT_TRUE(pool.affinityError().empty()) << pool.affinityError();
+
+    std::vector<std::atomic_int> ranOn(64);
+    pool.parallelFor(ranOn.size(), [&](std::size_t task, std::size_t) {
+        ranOn[task] = sched_getcpu();
+    });
+    for (const auto& ran : ranOn) {
+        EXPECT_EQ(ran.load(), cpu);
+    }
+}
+
+TEST(ThreadPoolTest, CpuListSizesDefaultPool) {
+    ThreadPool pool(ThreadPoolOptions{.cpus = {0, 1, 2}});
+    EXPECT_EQ(pool.size(), 3U);
+
+    ThreadPool bad(ThreadPoolOptions{.threads = 1, .cpus = {-1}});
+    EXPECT_FALSE(bad.affinityError().empty());
+}
@@ -49,3 +49,64 @@ TEST(ValueTest, ParserBuildsRangeAsPrimaryAndSecondary) {
     EXPECT_EQ(value->primary.as<int32_t>().value_or(0), 10);
     EXPECT_EQ(value->secondary->as<int32_t>().value_or(0), 20);
 }
+
+TEST(ValueTest, ParserSplitsBytePatternsOnBar) {
+    std::vector<std::string> args = {"48 8B ?? | E8", "?? ?? 90"};
+    auto value = value::buildUserValue(ScanDataType::BYTE_ARRAY,
+                                       ScanMatchType::MATCH_EQUAL_TO, args, 0);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(value->primary.bytes, (std::vector<uint8_t>{0x48, 0x8B, 0x00}));
+    EXPECT_EQ(value->primary.mask, (std::vector<uint8_t>{0xFF, 0xFF, 0x00}));
+    ASSERT_EQ(value->alternatives.size(), 1U);
+    EXPECT_EQ(value->alternatives[0].bytes,
+              (std::vector<uint8_t>{0xE8, 0x00, 0x00, 0x90}));
+
+    args = {"48 8B | | E8"};
+    EXPECT_FALSE(value::buildUserValue(ScanDataType::BYTE_ARRAY,
+                                       ScanMatchType::MATCH_EQUAL_TO, args, 0)
+                     .has_value());
+}
+
+TEST(ValueTest, ParserBuildsGroupWithAnchorFirst) {
+    std::vector<std::string> args = {"i32:100", "I32:100@4", "i16:30",
+                                     "float:1.5@0x10", "window:32"};
+    auto value = value::buildUserValue(ScanDataType::GROUP,
+                                       ScanMatchType::MATCH_EQUAL_TO, args, 0);
+    ASSERT_TRUE(value.has_value());
+    ASSERT_EQ(value->group.size(), 4U);
+    EXPECT_EQ(value->groupWindow, 32U);
+    EXPECT_EQ(value->primary.as<int32_t>().value_or(0), 100);
+    EXPECT_EQ(value->group[0].offset, 0U);
+    EXPECT_EQ(value->group[1].offset, 4U);
+    EXPECT_FALSE(value->group[2].offset.has_value());
+    EXPECT_EQ(value->group[2].value.as<int16_t>().value_or(0), 30);
+    EXPECT_TRUE(value->group[3].isFloat);
+    EXPECT_EQ(value->group[3].offset, 16U);
+    EXPECT_EQ(value->group[3].value.as<float>().value_or(0.0F), 1.5F);
+
+    // Free members get the default window
+    args = {"i64:7", "i8:1"};
+    value = value::buildUserValue(ScanDataType::GROUP,
+                                  ScanMatchType::MATCH_EQUAL_TO, args, 0);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(value->groupWindow, UserValue::GROUP_WINDOW);
+
+    for (const auto& bad :
+         std::vector<std::vector<std::string>>{{"i32:1@4", "i32:2"},
+                                               {"any:1"},
+                                               {"i32:1", "i8:300"},
+                                               {"i32:1", "window:0"},
+                                               {"i32:1", "i64:2", "w:4"},
+                                               {"i32:1", "i16:2@2"},
+                                               {"i8:1", "i32:2@4", "i16:3@6"},
+                                               {"100"}}) {
+        EXPECT_FALSE(value::buildUserValue(ScanDataType::GROUP,
+                                           ScanMatchType::MATCH_EQUAL_TO, bad,
+                                           0)
+                         .has_value());
+    }
+    EXPECT_FALSE(value::buildUserValue(ScanDataType::GROUP,
+                                       ScanMatchType::MATCH_GREATER_THAN,
+                                       args, 0)
+                     .has_value());
+}